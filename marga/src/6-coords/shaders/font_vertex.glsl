@@ -1,7 +1,9 @@
 #version 330 core
 layout (location = 0) in vec4 vertex; // vec2 pos, vec2 tex
+layout (location = 1) in vec4 glyphColor;
 
 out vec2 TexCoords;
+out vec4 GlyphColor;
 
 uniform mat4 model;
 uniform mat4 projection;
@@ -9,4 +11,5 @@ uniform mat4 projection;
 void main() {
     gl_Position = projection * model * vec4(vertex.xy, 0.0, 1.0);
     TexCoords = vertex.zw;
+    GlyphColor = glyphColor;
 }
@@ -0,0 +1,111 @@
+#include <glad/gl.h>
+#include <GLFW/glfw3.h>
+#include <iostream>
+#include <format>
+#include <string>
+#include <vector>
+#include "shader.h"
+#include "write_text.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+// Draws 10 000 glyphs per frame (100 lines of 100 characters) and prints the average frame
+// time once per second. B switches between queueing every line and flushing once per frame
+// (one draw call) and flushing after each line (one draw call per line).
+
+const int WIDTH = 1280, HEIGHT = 720;
+const int LINES = 100, LINE_LENGTH = 100;
+
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+    glViewport(0, 0, width, height);
+}
+
+int main()
+{
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    GLFWwindow* window = glfwCreateWindow(WIDTH, HEIGHT, "Text benchmark", NULL, NULL);
+    if (window == NULL)
+    {
+        std::cout << "Failed to create GLFW window" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+    // Measure the rendering, not the vsync
+    glfwSwapInterval(0);
+
+    int version = gladLoadGL(glfwGetProcAddress);
+    if (!version)
+    {
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        return -1;
+    }
+
+    glViewport(0, 0, WIDTH, HEIGHT);
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+
+    TextWriter writer = TextWriter("../media/Roboto-Regular.ttf");
+    Shader fontShader("shaders/font_vertex.glsl", "shaders/font_fragment.glsl");
+
+    std::vector<std::string> lines(LINES);
+    for (int i = 0; i < LINES; i++)
+        for (int j = 0; j < LINE_LENGTH; j++)
+            lines[i] += (char)('!' + (i + j) % 94);
+
+    bool batched = true, bPressed = false;
+    int frames = 0;
+    double lastReport = glfwGetTime();
+
+    while(!glfwWindowShouldClose(window))
+    {
+        if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+            glfwSetWindowShouldClose(window, true);
+        bool bDown = glfwGetKey(window, GLFW_KEY_B) == GLFW_PRESS;
+        if (bDown && !bPressed)
+            batched = !batched;
+        bPressed = bDown;
+
+        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        fontShader.use();
+        fontShader.setVec4f("textColor", glm::value_ptr(glm::vec4(1.0f)));
+        glm::mat4 textProj = glm::ortho(0.0f, (float)WIDTH, 0.0f, (float)HEIGHT);
+        fontShader.setMatrix4fv("projection", glm::value_ptr(textProj));
+        glm::mat4 textModel = glm::mat4(1.0f);
+        fontShader.setMatrix4fv("model", glm::value_ptr(textModel));
+
+        // 7px glyphs so the whole block fits on screen; the color varies per line
+        for (int i = 0; i < LINES; i++) {
+            float shade = 0.5f + 0.5f * i / LINES;
+            writer.queue(lines[i], 5.0f, HEIGHT - 7.0f * (i + 1), 7.0f, glm::vec4(shade, 1.0f, 1.0f - shade, 1.0f));
+            if (!batched)
+                writer.flush();
+        }
+        writer.flush();
+
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+
+        frames++;
+        double now = glfwGetTime();
+        if (now - lastReport >= 1.0) {
+            std::cout << std::format("{}: {:.3f} ms/frame ({} glyphs, {} draw calls)",
+                                     batched ? "batched" : "per line",
+                                     1000.0 * (now - lastReport) / frames, LINES * LINE_LENGTH,
+                                     batched ? 1 : LINES) << std::endl;
+            frames = 0;
+            lastReport = now;
+        }
+    }
+
+    glfwTerminate();
+    return 0;
+}
@@ -1,11 +1,16 @@
 #version 330 core
 in vec2 TexCoords;
+in vec4 GlyphColor;
 out vec4 color;
 
 uniform sampler2D text;
 uniform vec4 textColor;
 
 void main() {
-    float alpha = texture(text, TexCoords).r;
-    color = vec4(textColor.rgb, textColor.a * alpha);
+    // The atlas stores a distance field (0.5 on the outline): keep the edge about one
+    // screen pixel wide whatever the text size.
+    float distance = texture(text, TexCoords).r;
+    float width = fwidth(distance);
+    float alpha = smoothstep(0.5 - width, 0.5 + width, distance);
+    color = vec4(textColor.rgb * GlyphColor.rgb, textColor.a * GlyphColor.a * alpha);
 }
@@ -1,4 +1,5 @@
 #include "basic_main.h"
+#include "shader.h"
 
 // Global state, defined in the application source
 extern SceneState state;
@@ -45,6 +46,8 @@ int main()
     // Create and init SceneRenderer
     AbstractSceneRenderer* renderer = createSceneRenderer();
     renderer->init();
+    // init() builds the scene's shaders
+    std::cout << shaderSetupReport() << std::endl;
 
     ImguiDock dock;
     dock.init(window);
@@ -1,5 +1,24 @@
 #include "shader.h"
 
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+
+ShaderSetupStats shaderSetupStats;
+bool shaderCacheEnabled = true;
+
+static const char *CACHE_DIR = "shader_cache";
+static const uint32_t CACHE_MAGIC = 0x4250474c; // "LGPB"
+
+struct CacheHeader {
+        uint32_t magic;
+        uint32_t format;
+        uint64_t key;
+        uint64_t length;
+};
+
 std::string readShader(const char* shaderPath) { 
     // 1. retrieve the source code from filePath
     std::string shaderCode;
@@ -25,9 +44,110 @@ std::string readShader(const char* shaderPath) {
     return shaderCode;
 }
 
-int compileShader(const char* shaderPath, GLenum shaderType) {
-    // 1. read the shaderCode
-    std::string shaderString = readShader(shaderPath);
+static bool cacheAvailable()
+{
+    if (!shaderCacheEnabled || !GLAD_GL_VERSION_4_1)
+        return false;
+    int formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+// FNV-1a, with a separator after each string
+static void hashString(uint64_t &hash, const std::string &bytes)
+{
+    for (unsigned char c : bytes) {
+        hash ^= c;
+        hash *= 0x100000001b3ull;
+    }
+    hash ^= 0xff;
+    hash *= 0x100000001b3ull;
+}
+
+// the stage types count too: the same files as vertex+fragment and as vertex+geometry
+// must not share an entry
+static uint64_t cacheKey(const std::vector<GLenum> &types, const std::vector<std::string> &sources)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+        const GLubyte *value = glGetString(name);
+        hashString(hash, value ? (const char*)value : "");
+    }
+    for (size_t i = 0; i < sources.size(); i++) {
+        hashString(hash, std::to_string(types[i]));
+        hashString(hash, sources[i]);
+    }
+    return hash;
+}
+
+static std::filesystem::path cachePath(uint64_t key)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+    return std::filesystem::path(CACHE_DIR) / name;
+}
+
+// Returns 0 when the program has to be built from source
+static unsigned int loadCachedProgram(uint64_t key)
+{
+    if (!cacheAvailable())
+        return 0;
+    std::ifstream file(cachePath(key), std::ios::binary);
+    CacheHeader header{};
+    if (!file || !file.read((char*)&header, sizeof(header)) || header.magic != CACHE_MAGIC || header.key != key)
+        return 0;
+    std::vector<char> binary(header.length);
+    if (!file.read(binary.data(), binary.size()))
+        return 0;
+
+    unsigned int program = glCreateProgram();
+    glProgramBinary(program, header.format, binary.data(), (GLsizei)binary.size());
+    int success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        glDeleteProgram(program);
+        file.close();
+        std::error_code ignored;
+        std::filesystem::remove(cachePath(key), ignored);
+        shaderSetupStats.rejected++;
+        return 0;
+    }
+    return program;
+}
+
+static void storeCachedProgram(uint64_t key, unsigned int program)
+{
+    if (!cacheAvailable())
+        return;
+    int length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &length, &format, binary.data());
+
+    // no cache dir, no entry: nothing breaks, the shader is compiled again next time
+    std::error_code error;
+    std::filesystem::create_directories(CACHE_DIR, error);
+    if (error)
+        return;
+    std::ofstream file(cachePath(key), std::ios::binary | std::ios::trunc);
+    CacheHeader header{ CACHE_MAGIC, format, key, (uint64_t)length };
+    file.write((const char*)&header, sizeof(header));
+    file.write(binary.data(), length);
+}
+
+std::string shaderSetupReport()
+{
+    char line[160];
+    std::snprintf(line, sizeof(line), "Shader setup: %u programs (%u from the binary cache, %u rejected) in %.1f ms",
+                  shaderSetupStats.programs, shaderSetupStats.cached, shaderSetupStats.rejected,
+                  shaderSetupStats.seconds * 1000.0);
+    return line;
+}
+
+int compileShader(const std::string &shaderString, const char* shaderPath, GLenum shaderType) {
     const char *shaderCode = shaderString.c_str();
     // 2. compile shaders
     unsigned int shader;
@@ -43,7 +163,7 @@ int compileShader(const char* shaderPath, GLenum shaderType) {
     if(!success)
     {
         glGetShaderInfoLog(shader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::COMPILATION_FAILED\n" << infoLog << std::endl;
+        std::cout << "ERROR::SHADER::COMPILATION_FAILED (" << shaderPath << ")\n" << infoLog << std::endl;
     };
     return shader;
 }
@@ -53,37 +173,55 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath): Shader(vertexP
 
 Shader::Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath)
 {
-    int vertex = compileShader(vertexPath, GL_VERTEX_SHADER);
-    int fragment = compileShader(fragmentPath, GL_FRAGMENT_SHADER);
-      
-    // shader Program
-    ID = glCreateProgram();
-    glAttachShader(ID, vertex);
-    glAttachShader(ID, fragment);
-    
-    int geometry = 0;
+    auto start = std::chrono::steady_clock::now();
+    shaderSetupStats.programs++;
+
+    // 1. read the sources; their hash, with the stage types, is the cache key
+    std::vector<const char*> paths = { vertexPath, fragmentPath };
+    std::vector<GLenum> types = { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER };
     if (geometryPath != NULL) {
-        geometry = compileShader(geometryPath, GL_GEOMETRY_SHADER);
-        glAttachShader(ID, geometry);
+        paths.push_back(geometryPath);
+        types.push_back(GL_GEOMETRY_SHADER);
     }
+    std::vector<std::string> sources;
+    for (const char* path : paths)
+        sources.push_back(readShader(path));
+    uint64_t key = cacheKey(types, sources);
 
-    glLinkProgram(ID);
-    int success;
-    char infoLog[512];
-    // print linking errors if any
-    glGetProgramiv(ID, GL_LINK_STATUS, &success);
-    if(!success)
-    {
-        glGetProgramInfoLog(ID, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-    }
-      
-    // delete the shaders as they're linked into our program now and no longer necessary
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
-    if (geometry) {
-        glDeleteShader(geometry);
+    ID = loadCachedProgram(key);
+    if (ID) {
+        shaderSetupStats.cached++;
+    } else {
+        // shader Program
+        ID = glCreateProgram();
+        if (cacheAvailable())
+            glProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        std::vector<int> shaders;
+        for (size_t i = 0; i < sources.size(); i++) {
+            shaders.push_back(compileShader(sources[i], paths[i], types[i]));
+            glAttachShader(ID, shaders.back());
+        }
+
+        glLinkProgram(ID);
+        int success;
+        char infoLog[512];
+        // print linking errors if any
+        glGetProgramiv(ID, GL_LINK_STATUS, &success);
+        if(!success)
+        {
+            glGetProgramInfoLog(ID, 512, NULL, infoLog);
+            std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+        } else {
+            storeCachedProgram(key, ID);
+        }
+
+        // delete the shaders as they're linked into our program now and no longer necessary
+        for (int shader : shaders)
+            glDeleteShader(shader);
     }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    shaderSetupStats.seconds += elapsed.count();
 }
 
 
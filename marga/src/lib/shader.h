@@ -29,5 +29,17 @@ public:
     void setVec4f(const std::string &name, const float* value) const;
     void setMatrix4fv(const std::string &name, float* value) const;
 };
+
+// The Shader constructors keep each linked program in shader_cache/ (GL 4.1+) and load it
+// from there on the next run instead of compiling. Counted here, printed by basic_main.
+struct ShaderSetupStats {
+        unsigned programs = 0;
+        unsigned cached = 0;   // loaded from a binary
+        unsigned rejected = 0; // binaries the driver refused, then rebuilt
+        double seconds = 0.0;  // total time in the Shader constructors
+};
+extern ShaderSetupStats shaderSetupStats;
+extern bool shaderCacheEnabled;
+std::string shaderSetupReport();
   
 #endif
@@ -1,5 +1,8 @@
 #include "write_text.h"
 
+#include <algorithm>
+#include <stdexcept>
+
 
 TextWriter::TextWriter(std::string font_filename)
 {
@@ -8,78 +11,148 @@ TextWriter::TextWriter(std::string font_filename)
     std::ifstream file(font_filename, std::ios::binary);
     fontBuffer.assign(std::istreambuf_iterator<char>(file), {});
 
-    // Bake a 512x512 bitmap atlas for ASCII chars 32–127
+    stbtt_fontinfo font;
+    if (!stbtt_InitFont(&font, fontBuffer.data(), stbtt_GetFontOffsetForIndex(fontBuffer.data(), 0)))
+        throw std::runtime_error("Failed to load font " + font_filename);
+    float scale = stbtt_ScaleForPixelHeight(&font, BASE_SIZE);
+
+    // Bake a 512x512 distance field atlas for ASCII chars 32–127, packed in rows.
+    // Each glyph gets PADDING pixels of falloff around its outline; 128 is the edge.
+    const int PADDING = 4;
+    const unsigned char ON_EDGE = 128;
+    const float DIST_SCALE = 128.0f / PADDING;
     ATLAS_W = 512, ATLAS_H = 512;
     std::vector<unsigned char> atlasBitmap(ATLAS_W * ATLAS_H);
-    // cdata contains 96 chars starting at ASCII 32
-    stbtt_BakeFontBitmap(fontBuffer.data(), 0,
-        32.0f,                  // font size in pixels
-        atlasBitmap.data(), ATLAS_W, ATLAS_H,
-        32, 96,                 // first char, num chars
-        cdata);
+    int penX = 0, penY = 0, rowHeight = 0;
+    for (int i = 0; i < NUM_CHARS; i++) {
+        int codepoint = FIRST_CHAR + i;
+        int advance, lsb;
+        stbtt_GetCodepointHMetrics(&font, codepoint, &advance, &lsb);
+
+        int w = 0, h = 0, xoff = 0, yoff = 0;
+        unsigned char *sdf = stbtt_GetCodepointSDF(&font, scale, codepoint, PADDING, ON_EDGE,
+                                                   DIST_SCALE, &w, &h, &xoff, &yoff);
+        if (penX + w > ATLAS_W) {
+            penX = 0;
+            penY += rowHeight + 1;
+            rowHeight = 0;
+        }
+        if (penY + h > ATLAS_H)
+            throw std::runtime_error("Font atlas too small for " + font_filename);
+        for (int row = 0; row < h; row++)
+            std::copy(sdf + row * w, sdf + (row + 1) * w, &atlasBitmap[(penY + row) * ATLAS_W + penX]);
+        stbtt_FreeSDF(sdf, nullptr);
+
+        // stb_truetype offsets grow downwards; glyphs store them y up
+        glyphs[i] = {
+            (float)penX / ATLAS_W, (float)penY / ATLAS_H,
+            (float)(penX + w) / ATLAS_W, (float)(penY + h) / ATLAS_H,
+            (float)xoff, (float)-yoff, (float)(xoff + w), (float)-(yoff + h),
+            advance * scale,
+        };
+        penX += w + 1;
+        rowHeight = std::max(rowHeight, h);
+    }
 
     // Upload atlas to a GL texture
     glGenTextures(1, &textureID);
     glBindTexture(GL_TEXTURE_2D, textureID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RED,
         ATLAS_W, ATLAS_H, 0,
         GL_RED, GL_UNSIGNED_BYTE, atlasBitmap.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
-    // textVAO and textVBO are instance attributes as they get used for writing
+    // textVBO holds the quads of every queued string, textEBO indexes them as two triangles each
     glGenVertexArrays(1, &textVAO);
     glBindVertexArray(textVAO);
 
     glGenBuffers(1, &textVBO);
+    glGenBuffers(1, &textEBO);
     glBindBuffer(GL_ARRAY_BUFFER, textVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, nullptr, GL_DYNAMIC_DRAW);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, textEBO);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(GlyphVertex), (void*)0);
     glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(GlyphVertex), (void*)(4 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    capacity = 0;
+    reserve(256);
+
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
+}
 
+// Grows the GL buffers to hold at least `quads` glyphs. Expects textVAO to be bound.
+void TextWriter::reserve(size_t quads)
+{
+    if (quads <= capacity) return;
+    while (capacity < quads)
+        capacity = capacity ? capacity * 2 : quads;
+
+    std::vector<GLuint> indices(capacity * 6);
+    for (size_t i = 0; i < capacity; i++) {
+        GLuint v = i * 4;
+        GLuint quad[6] = { v, v + 1, v + 2, v, v + 2, v + 3 };
+        std::copy(quad, quad + 6, &indices[i * 6]);
+    }
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, textVBO);
+    glBufferData(GL_ARRAY_BUFFER, capacity * 4 * sizeof(GlyphVertex), nullptr, GL_STREAM_DRAW);
 }
 
-void TextWriter::write(std::string message)
+void TextWriter::queue(const std::string &message, float x, float y, float size, glm::vec4 color)
 {
+    float k = size / BASE_SIZE;
+    for (const char* p = message.c_str(); *p; p++) {
+        if (*p < FIRST_CHAR || *p >= FIRST_CHAR + NUM_CHARS) continue;
+        const Glyph &g = glyphs[*p - FIRST_CHAR];
+        if (g.x1 > g.x0) {
+            float x0 = x + g.x0 * k, x1 = x + g.x1 * k;
+            float y0 = y + g.y0 * k, y1 = y + g.y1 * k;
+            // top-left, top-right, bottom-right, bottom-left
+            vertices.push_back({ x0, y0, g.s0, g.t0, color.r, color.g, color.b, color.a });
+            vertices.push_back({ x1, y0, g.s1, g.t0, color.r, color.g, color.b, color.a });
+            vertices.push_back({ x1, y1, g.s1, g.t1, color.r, color.g, color.b, color.a });
+            vertices.push_back({ x0, y1, g.s0, g.t1, color.r, color.g, color.b, color.a });
+        }
+        x += g.advance * k;
+    }
+}
+
+void TextWriter::flush()
+{
+    if (vertices.empty()) return;
 
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    
+
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, textureID);
     glBindVertexArray(textVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, textVBO);
-    
-    float x = 10.0f;
-    float y = 10.0f; // 10px from the bottom
-    
-    for (const char* p = message.c_str(); *p; p++) {
-        if (*p < 32 || *p >= 128) continue;
-        stbtt_aligned_quad q;
-        stbtt_GetBakedQuad(cdata, ATLAS_W, ATLAS_H,
-            *p - 32,  // char index
-            &x, &y,   // position, updated per glyph
-            &q, 1);   // 1 = opengl y-direction
-    
-        // q gives two triangles forming the glyph quad
-        float verts[6][4] = {
-            { q.x0, -q.y1,  q.s0, q.t1 },
-            { q.x0, -q.y0,  q.s0, q.t0 },
-            { q.x1, -q.y0,  q.s1, q.t0 },
-    
-            { q.x0, -q.y1,  q.s0, q.t1 },
-            { q.x1, -q.y0,  q.s1, q.t0 },
-            { q.x1, -q.y1,  q.s1, q.t1 },
-        };
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(verts), verts);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+
+    // Orphan last frame's storage so the upload does not wait for the GPU to finish with it
+    size_t quads = queued();
+    if (quads > capacity)
+        reserve(quads);
+    else {
+        glBindBuffer(GL_ARRAY_BUFFER, textVBO);
+        glBufferData(GL_ARRAY_BUFFER, capacity * 4 * sizeof(GlyphVertex), nullptr, GL_STREAM_DRAW);
     }
-    
+    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(GlyphVertex), vertices.data());
+    glDrawElements(GL_TRIANGLES, quads * 6, GL_UNSIGNED_INT, 0);
+    vertices.clear();
+
     glBindVertexArray(0);
     glDisable(GL_BLEND);
 }
 
-
-
+void TextWriter::write(std::string message)
+{
+    // 10px from the bottom-left of the model transform, as before
+    queue(message, 10.0f, -10.0f);
+    flush();
+}
@@ -15,21 +15,56 @@
 #include "shader.h"
 
 
+// Text is drawn from a signed distance field atlas, so one atlas serves every font size
+// (the font shaders turn the distance into coverage). Strings are queued as quads into one
+// vertex buffer and drawn with a single glDrawElements per flush().
 class TextWriter {
 
     private:
+        // Placement of one glyph, in pixels at BASE_SIZE relative to the pen (y up)
+        struct Glyph {
+            float s0, t0, s1, t1;
+            float x0, y0, x1, y1;
+            float advance;
+        };
+        // One vertex: position, atlas coordinates, color
+        struct GlyphVertex {
+            float x, y, s, t;
+            float r, g, b, a;
+        };
+
+        static constexpr int FIRST_CHAR = 32, NUM_CHARS = 96;
+        static constexpr float BASE_SIZE = 32.0f;
+
         // Internal texture id
         GLuint textureID;
-        // Internal VAO, VBO
-        GLuint textVAO, textVBO;
+        // Internal VAO, VBO and the index buffer shared by every quad
+        GLuint textVAO, textVBO, textEBO;
         // Internal character data
-        stbtt_bakedchar cdata[96];
+        Glyph glyphs[NUM_CHARS];
         // Size of the character atlas
         int ATLAS_W, ATLAS_H;
 
+        // Quads queued since the last flush, and how many quads the GL buffers hold
+        std::vector<GlyphVertex> vertices;
+        size_t capacity;
+
+        void reserve(size_t quads);
+
     public:
         TextWriter(std::string font_filename);
+
+        // Queue a string with its baseline starting at (x, y), in the units of the projection
+        // the font shader uses (pixels for the usual ortho one).
+        void queue(const std::string &message, float x, float y, float size = BASE_SIZE,
+                   glm::vec4 color = glm::vec4(1.0f));
+        // Draw everything queued so far with the currently bound font shader.
+        void flush();
+        // Number of glyphs waiting for the next flush()
+        size_t queued() const { return vertices.size() / 4; }
+
+        // Immediate mode: queue message at the default position and flush it.
         void write(std::string message);
 };
 
-#endif  
+#endif
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/assets.hpp"
+#include "common/memory.hpp"
+#include "common/model.hpp"
+#include "common/texture_streamer.hpp"
+#include "common/types.hpp"
+
+// Owns a GL texture; the name is deleted when the last reference goes away.
+struct texture_asset_t {
+    id_t id;
+
+    explicit texture_asset_t(id_t id) : id(id) {}
+    texture_asset_t(const texture_asset_t &)            = delete;
+    texture_asset_t &operator=(const texture_asset_t &) = delete;
+    ~texture_asset_t() { glDeleteTextures(1, &id); }
+};
+
+// Only unreferenced entries are ever evicted, so a scene larger than the budget still loads; the
+// cache just stops keeping assets around that nothing uses. SIZE_MAX means no limit.
+struct asset_budget_t {
+    size_t vram = size_t{512} << 20;
+    size_t ram  = size_t{256} << 20;
+};
+
+enum class asset_kind_t { texture, model };
+
+struct asset_info_t {
+    asset_kind_t kind;
+    std::string  key;
+    long         references; // held outside the cache
+    size_t       vram;
+    size_t       ram;
+    uint64_t     last_use;
+    const Model *model; // nullptr for textures; valid until the cache next changes
+};
+
+struct asset_usage_t {
+    size_t vram;
+    size_t ram;
+    size_t entries;
+    size_t hits;
+    size_t misses;
+    size_t evictions;
+};
+
+// Textures and models keyed on their resolved path, so two models that both reference a
+// "diffuse.png" in their own directory get two textures, and loading the same file twice gets
+// one. Handles are shared_ptrs: an entry whose only owner is the cache is unreferenced, and
+// those are evicted least recently used first when a lookup, hit or miss, finds the totals over
+// the budget; handles released in between are picked up by the next lookup or trim(). Models
+// hold references to their textures through their meshes, so evicting a model can make its
+// textures evictable in the same pass.
+//
+// Byte counts come from texture_memory() for textures and Model::memory() for models, so a
+// model only counts against the RAM budget when its meshes retain their CPU copies.
+class AssetCache {
+public:
+    explicit AssetCache(asset_budget_t budget = {}) : m_budget(budget) {}
+    AssetCache(const AssetCache &)            = delete;
+    AssetCache &operator=(const AssetCache &) = delete;
+
+    std::expected<std::shared_ptr<const texture_asset_t>, std::string> texture(
+        const std::string &filename, const texture_options_t &options = DEFAULT_TEXTURE_OPTIONS,
+        TextureStreamer *streamer = nullptr
+    );
+    std::expected<std::shared_ptr<Model>, std::string>
+    model(const std::string &filename, TextureStreamer *streamer = nullptr);
+
+    asset_budget_t budget() const { return m_budget; }
+    void           set_budget(asset_budget_t budget);
+
+    // Evicts unreferenced entries until the totals fit the budget; returns how many went.
+    size_t trim();
+    // Evicts every unreferenced entry regardless of the budget.
+    size_t drop_unused();
+
+    asset_usage_t             usage() const;
+    std::vector<asset_info_t> entries() const;
+
+private:
+    struct texture_entry_t {
+        std::shared_ptr<const texture_asset_t> asset;
+        size_t                                 vram;
+        bool                                   streamed; // vram is remeasured once uploaded
+        uint64_t                               last_use;
+    };
+    struct model_entry_t {
+        std::shared_ptr<Model> model;
+        memory_usage_t         memory;
+        uint64_t               last_use;
+    };
+
+    asset_budget_t                                   m_budget;
+    std::unordered_map<std::string, texture_entry_t> m_textures;
+    std::unordered_map<std::string, model_entry_t>   m_models;
+    uint64_t                                         m_clock     = 0;
+    size_t                                           m_hits      = 0;
+    size_t                                           m_misses    = 0;
+    size_t                                           m_evictions = 0;
+
+    void remeasure_streamed();
+    bool evict_least_recently_used();
+};
+
+// The cache Model::load puts its textures in. Dropped by ~GLContext while a context is current.
+AssetCache &default_asset_cache();
+
+// ImGui window with the totals against the budget, budget controls and one row per entry.
+// Call between ImGui::NewFrame and ImGui::Render.
+void draw_asset_cache_panel(AssetCache &cache);
@@ -1,17 +1,27 @@
 #pragma once
 
-#include "common/assets.hpp"       // IWYU pragma: export
-#include "common/buffers.hpp"      // IWYU pragma: export
-#include "common/camera.hpp"       // IWYU pragma: export
-#include "common/event_loop.hpp"   // IWYU pragma: export
-#include "common/geometry.hpp"     // IWYU pragma: export
-#include "common/gl_context.hpp"   // IWYU pragma: export
-#include "common/helpers.hpp"      // IWYU pragma: export
-#include "common/input.hpp"        // IWYU pragma: export
-#include "common/light.hpp"        // IWYU pragma: export
-#include "common/materials.hpp"    // IWYU pragma: export
-#include "common/mesh.hpp"         // IWYU pragma: export
-#include "common/model.hpp"        // IWYU pragma: export
-#include "common/shader.hpp"       // IWYU pragma: export
-#include "common/types.hpp"        // IWYU pragma: export
-#include "common/window_state.hpp" // IWYU pragma: export
+#include "common/asset_cache.hpp"      // IWYU pragma: export
+#include "common/assets.hpp"           // IWYU pragma: export
+#include "common/buffers.hpp"          // IWYU pragma: export
+#include "common/camera.hpp"           // IWYU pragma: export
+#include "common/event_loop.hpp"       // IWYU pragma: export
+#include "common/frame_clock.hpp"      // IWYU pragma: export
+#include "common/frame_pacing.hpp"     // IWYU pragma: export
+#include "common/geometry.hpp"         // IWYU pragma: export
+#include "common/gl_context.hpp"       // IWYU pragma: export
+#include "common/gl_state.hpp"         // IWYU pragma: export
+#include "common/helpers.hpp"          // IWYU pragma: export
+#include "common/input.hpp"            // IWYU pragma: export
+#include "common/light.hpp"            // IWYU pragma: export
+#include "common/materials.hpp"        // IWYU pragma: export
+#include "common/memory.hpp"           // IWYU pragma: export
+#include "common/mesh.hpp"             // IWYU pragma: export
+#include "common/model.hpp"            // IWYU pragma: export
+#include "common/model_batch.hpp"      // IWYU pragma: export
+#include "common/program_cache.hpp"    // IWYU pragma: export
+#include "common/shader.hpp"           // IWYU pragma: export
+#include "common/texture_streamer.hpp" // IWYU pragma: export
+#include "common/transforms.hpp"       // IWYU pragma: export
+#include "common/types.hpp"            // IWYU pragma: export
+#include "common/visualizers.hpp"      // IWYU pragma: export
+#include "common/window_state.hpp"     // IWYU pragma: export
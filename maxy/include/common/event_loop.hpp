@@ -1,21 +1,15 @@
 #pragma once
 
+#include <iostream>
+
 #include <glad/gl.h>
 
+#include "common/frame_clock.hpp"
+#include "common/frame_pacing.hpp"
 #include "common/input.hpp"
+#include "common/program_cache.hpp"
 #include "common/window_state.hpp"
 
-struct frame_time_t {
-    float last_time{};
-    float delta{};
-};
-
-inline void update_delta(frame_time_t &d) {
-    float now = static_cast<float>(glfwGetTime());
-    d.delta = now - d.last_time;
-    d.last_time = now;
-}
-
 constexpr float keyboard_yaw_speed = 120.f;
 
 inline void process_camera_events(
@@ -47,20 +41,59 @@ inline void process_camera_events(
         );
 }
 
+// Renderers that simulate at the fixed rate take the whole frame_timing_t: `steps` updates of
+// `step` seconds each, then a draw interpolated by `alpha`. The rest get the wall time delta.
+template <typename Renderer>
+concept fixed_step_renderer = requires(Renderer &renderer, input_t input, frame_timing_t timing) {
+    renderer.render(input, timing);
+};
+
 template <typename Renderer, typename InputFn>
-void event_loop(GLFWwindow *window, Renderer &renderer, InputFn process_input) {
-    input_t input{};
-    frame_time_t delta{};
+void event_loop(
+    GLFWwindow *window, Renderer &renderer, InputFn process_input, loop_options_t options = {}
+) {
+    input_t          input{};
+    frame_clock_t    clock{};
+    fixed_timestep_t timestep{};
+    frame_limiter_t  limiter{.target_fps = options.target_fps};
+    frame_stats_t    stats{};
+    if (options.simulation_hz > 0.) timestep.step = 1. / options.simulation_hz;
+
+    // The renderer has built its programs by now: this is the scene's shader setup cost.
+    std::cout << program_cache::report() << "\n";
 
+    clock.reset();
+    double next_report = options.report_interval;
     while (!glfwWindowShouldClose(window)) {
-        update_delta(delta);
+        double const elapsed = clock.tick();
+        stats.add(elapsed);
 
         input = {};
         process_input(window, input);
 
-        renderer.render(input, delta.delta);
+        frame_timing_t timing{
+            .delta = static_cast<float>(elapsed),
+            .steps = 1,
+            .step  = static_cast<float>(elapsed),
+            .alpha = 1.f,
+        };
+        if (options.simulation_hz > 0.) {
+            timing.steps = timestep.advance(elapsed);
+            timing.step  = static_cast<float>(timestep.step);
+            timing.alpha = timestep.alpha();
+        }
+
+        if constexpr (fixed_step_renderer<Renderer>) renderer.render(input, timing);
+        else renderer.render(input, timing.delta);
 
         glfwSwapBuffers(window);
         glfwPollEvents();
+        limiter.wait([&] { return clock.now(); });
+
+        if (options.report_interval > 0. && clock.now() >= next_report) {
+            std::cout << frame_report(stats, options) << "\n";
+            next_report += options.report_interval;
+        }
     }
+    if (options.report_interval > 0.) std::cout << frame_report(stats, options) << "\n";
 }
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+
+// Seconds from glfwGetTimerValue, which unlike glfwGetTime keeps its full resolution however long
+// the program has been running.
+struct frame_clock_t {
+    uint64_t start = 0;
+    uint64_t last  = 0;
+
+    // Starts counting from now; the first tick() returns the time since reset().
+    void   reset();
+    double now() const;
+    // Seconds since the previous tick (or reset).
+    double tick();
+};
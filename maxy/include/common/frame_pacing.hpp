@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Frame scheduling shared by the GL event_loop and the SDL3 engine's run loops. Nothing here
+// reads a clock, so it builds without GLFW (see FRAME_PACING in src/CMakeLists.txt): callers
+// pass seconds from their own, frame_clock_t for GL and SDL_GetTicksNS for SDL3.
+
+// Accumulator for a fixed simulation rate: wall time goes in, whole steps come out, and the
+// remainder becomes the interpolation factor between the last two simulated states.
+struct fixed_timestep_t {
+    double step        = 1. / 60.;
+    int    max_steps   = 8; // after a stall the backlog is dropped instead of spiralling
+    double accumulator = 0.;
+
+    // Adds `elapsed` seconds and returns how many steps are due.
+    int   advance(double elapsed);
+    float alpha() const { return static_cast<float>(accumulator / step); }
+};
+
+// What a renderer needs to know about the frame it is drawing.
+struct frame_timing_t {
+    float delta; // wall time since the previous frame
+    int   steps; // simulation steps due this frame, 1 without a fixed rate
+    float step;  // length of each step, delta without a fixed rate
+    float alpha; // between the previous (0) and the latest (1) simulated state
+};
+
+// Caps the frame rate by sleeping until shortly before the deadline and spinning the rest, since
+// a plain sleep routinely overshoots by a scheduler quantum. Deadlines advance by whole periods
+// so one late frame does not shift every later one.
+struct frame_limiter_t {
+    double target_fps  = 0.;    // 0 disables the limiter
+    double spin_window = 0.002; // seconds before the deadline to stop sleeping
+    double deadline    = 0.;
+
+    // `now` returns the caller's clock in seconds; it is polled while spinning.
+    void wait(const std::function<double()> &now);
+};
+
+// The most recent frame times, for percentiles rather than a mean that hides hitches.
+struct frame_stats_t {
+    std::vector<float> samples; // milliseconds, a ring once full
+    size_t             next     = 0;
+    size_t             capacity = 1024;
+
+    void  add(double seconds);
+    void  clear();
+    float percentile(float p) const;
+};
+
+struct loop_options_t {
+    double simulation_hz   = 0.; // > 0: fixed timestep, renderers get steps and alpha
+    double target_fps      = 0.; // > 0: frame limiter on top of whatever vsync does
+    double report_interval = 0.; // seconds between frame time lines, 0 for none
+    // Diagnostics the loop leaves to the sample that reads them.
+    bool state_cache   = true;  // false: gl_state issues every call
+    bool state_stats   = false; // print gl_state's issued and skipped counts once a second
+    bool memory_report = false; // print the memory of the loaded assets once they are up
+};
+
+// --sim-hz=N, --fps=N, --frame-report (every 5 s), --no-state-cache, --state-stats and
+// --memory-report; other arguments are left to the caller.
+loop_options_t parse_loop_options(int argc, char **argv);
+
+// "frame time p50 ... p99 ..." over the samples in `stats`.
+std::string frame_report(const frame_stats_t &stats, double simulation_hz, double target_fps);
+inline std::string frame_report(const frame_stats_t &stats, const loop_options_t &options) {
+    return frame_report(stats, options.simulation_hz, options.target_fps);
+}
@@ -5,10 +5,19 @@
 
 struct GLFWwindow;
 
+struct gl_version_t {
+    int major;
+    int minor;
+};
+
+constexpr gl_version_t DEFAULT_GL_VERSION{.major = 3, .minor = 3};
+
 class GLContext {
 public:
+    // Asks for a core profile of the given version; if the driver cannot create one, falls back
+    // to DEFAULT_GL_VERSION. version() reports what was actually created.
     static std::expected<GLContext, std::string>
-    create(int width, int height, const char *title);
+    create(int width, int height, const char *title, gl_version_t version = DEFAULT_GL_VERSION);
 
     ~GLContext();
     GLContext(const GLContext &) = delete;
@@ -16,10 +25,16 @@ public:
     GLContext(GLContext &&) noexcept;
     GLContext &operator=(GLContext &&) noexcept;
 
-    GLFWwindow *window() const { return m_window; }
+    GLFWwindow  *window() const { return m_window; }
+    gl_version_t version() const { return m_version; }
+    bool         supports(gl_version_t required) const {
+        return m_version.major > required.major ||
+               (m_version.major == required.major && m_version.minor >= required.minor);
+    }
 
 private:
-    GLFWwindow *m_window = nullptr;
+    GLFWwindow  *m_window = nullptr;
+    gl_version_t m_version{};
 
-    GLContext(GLFWwindow *window) : m_window(window) {}
+    GLContext(GLFWwindow *window, gl_version_t version) : m_window(window), m_version(version) {}
 };
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glad/gl.h>
+
+#include "common/types.hpp"
+
+// Shadow copy of the GL state that changes most often between draws (program, vertex array,
+// texture bindings, blend/depth/stencil/cull state), used to skip driver calls that would not
+// change anything.
+//
+// install() wraps glad's entry points for the tracked calls, so raw glBindTexture & co. keep the
+// shadow state in sync and are filtered too; the functions below are the same calls for code
+// that wants to be explicit about it. Until install() runs (or while disabled) every call goes
+// straight to the driver. Only the GL_TEXTURE_2D and GL_TEXTURE_CUBE_MAP bindings of the first
+// max_tracked_units units are cached; other targets and units always pass through.
+namespace gl_state {
+
+constexpr GLuint max_tracked_units = 32;
+
+struct call_counts_t {
+    std::uint64_t issued{};
+    std::uint64_t skipped{};
+};
+
+struct stats_t {
+    call_counts_t program;
+    call_counts_t vertex_array;
+    call_counts_t active_texture;
+    call_counts_t texture;
+    call_counts_t capability; // glEnable / glDisable
+    call_counts_t blend;
+    call_counts_t depth;
+    call_counts_t stencil;
+    call_counts_t cull;
+    call_counts_t sampler; // sampler uniforms set through Shader::set_sampler
+};
+
+// Call once right after gladLoadGL (GLContext::create does).
+void install();
+
+// Disabled: every call is issued and the shadow state is forgotten. For before/after timings.
+void set_enabled(bool enabled);
+bool enabled();
+
+// Forget everything, e.g. after code that changed state through another loader.
+void invalidate();
+
+// Bumped by set_enabled and invalidate, so caches kept elsewhere (Shader's sampler units) know
+// to forget too.
+std::uint64_t epoch();
+
+void use_program(id_t program);
+void bind_vertex_array(id_t vertex_array);
+void active_texture(GLuint unit); // unit index, not GL_TEXTUREi
+void bind_texture(GLenum target, id_t texture);
+void bind_texture(GLuint unit, GLenum target, id_t texture);
+void set_capability(GLenum capability, bool on);
+void blend_func(GLenum source, GLenum destination);
+void depth_func(GLenum func);
+void depth_mask(bool write);
+void stencil_func(GLenum func, GLint ref, GLuint mask);
+void stencil_op(GLenum stencil_fail, GLenum depth_fail, GLenum depth_pass);
+void stencil_mask(GLuint mask);
+void cull_face(GLenum mode);
+
+stats_t &stats();
+void     reset_stats();
+
+// Sums of all categories.
+call_counts_t totals();
+
+} // namespace gl_state
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "common/memory_usage.hpp"
+#include "common/types.hpp"
+
+class AssetCache;
+class Model;
+
+// Estimate for a 2D texture: level 0 as the driver reports it plus a third for the mip chain,
+// with three channel formats rounded up to four bytes a texel as drivers store them.
+size_t texture_memory(id_t texture);
+
+// One line per mesh of `model` and a total; textures are shared, so they are left to the
+// report of whatever owns them.
+std::string memory_report(std::string_view name, const Model &model);
+// Every model (with its meshes) and texture in the cache, and the totals.
+std::string memory_report(const AssetCache &cache);
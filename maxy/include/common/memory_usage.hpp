@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Memory accounting shared by the GL common library and the SDL3 engine. Only std, so it builds
+// without either (see MEMORY_USAGE in src/CMakeLists.txt).
+
+// Bytes an asset keeps resident on each side of the bus.
+struct memory_usage_t {
+    size_t cpu = 0;
+    size_t gpu = 0;
+
+    memory_usage_t &operator+=(const memory_usage_t &other) {
+        cpu += other.cpu;
+        gpu += other.gpu;
+        return *this;
+    }
+};
+
+// Appends one report line: `name` indented by `indent` spaces and padded to a column, then both
+// sizes in KiB.
+void append_memory_line(std::string &out, int indent, std::string_view name, memory_usage_t usage);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -7,6 +8,7 @@
 
 #include <glm/glm.hpp>
 
+#include "common/memory.hpp"
 #include "common/shader.hpp"
 #include "common/types.hpp"
 
@@ -16,9 +18,13 @@ struct Vertex {
     glm::vec2 tex_coords;
 };
 
+struct texture_asset_t;
+
 struct Texture {
     id_t        id;
     std::string type;
+    // Keeps a cached texture alive while a mesh uses it; empty for textures the caller owns.
+    std::shared_ptr<const texture_asset_t> asset{};
 };
 
 constexpr std::string_view texture_type_diffuse  = "texture_diffuse";
@@ -26,21 +32,25 @@ constexpr std::string_view texture_type_specular = "texture_specular";
 constexpr std::string_view texture_type_height   = "texture_height";
 constexpr std::string_view texture_type_ambient  = "texture_ambient";
 
+// The vertices and indices are uploaded on construction and, unless retain_cpu_copy is set
+// (for picking, physics and the like), freed right after: only the counts stay on the CPU.
 class Mesh {
 public:
     Mesh(
         std::vector<Vertex> vertices, std::vector<unsigned int> indices,
-        std::vector<Texture> textures
+        std::vector<Texture> textures, bool retain_cpu_copy = false
     )
         : m_vertices(std::move(vertices)), m_indices(std::move(indices)),
           m_textures(std::move(textures)) {
-        setup_mesh();
+        setup_mesh(retain_cpu_copy);
     };
     Mesh(const Mesh &)            = delete;
     Mesh &operator=(const Mesh &) = delete;
     Mesh(Mesh &&o) noexcept
         : m_vertices(std::move(o.m_vertices)), m_indices(std::move(o.m_indices)),
-          m_textures(std::move(o.m_textures)), m_vertex_array(std::exchange(o.m_vertex_array, 0)),
+          m_textures(std::move(o.m_textures)), m_sampler_names(std::move(o.m_sampler_names)),
+          m_vertex_count(o.m_vertex_count), m_index_count(o.m_index_count),
+          m_vertex_array(std::exchange(o.m_vertex_array, 0)),
           m_vertex_buffer(std::exchange(o.m_vertex_buffer, 0)),
           m_element_buffer(std::exchange(o.m_element_buffer, 0)) {}
     Mesh &operator=(Mesh &&o) noexcept {
@@ -51,6 +61,9 @@ public:
             m_vertices       = std::move(o.m_vertices);
             m_indices        = std::move(o.m_indices);
             m_textures       = std::move(o.m_textures);
+            m_sampler_names  = std::move(o.m_sampler_names);
+            m_vertex_count   = o.m_vertex_count;
+            m_index_count    = o.m_index_count;
             m_vertex_array   = std::exchange(o.m_vertex_array, 0);
             m_vertex_buffer  = std::exchange(o.m_vertex_buffer, 0);
             m_element_buffer = std::exchange(o.m_element_buffer, 0);
@@ -68,14 +81,37 @@ public:
 
     void set_instance_model_transform(id_t layout_id);
 
+    // Empty unless the mesh was built with retain_cpu_copy.
+    const std::vector<Vertex>       &vertices() const { return m_vertices; }
+    const std::vector<unsigned int> &indices() const { return m_indices; }
+    const std::vector<Texture>      &textures() const { return m_textures; }
+
+    // The retained copy, or else a read back from the GL buffers; for one-off work such as
+    // building a ModelBatch, not per frame.
+    std::vector<Vertex>       read_vertices() const;
+    std::vector<unsigned int> read_indices() const;
+
+    size_t vertex_count() const { return m_vertex_count; }
+    size_t index_count() const { return m_index_count; }
+
+    // For other vertex arrays over the same vertices, such as the instances of NormalLines.
+    id_t vertex_buffer() const { return m_vertex_buffer; }
+
+    // Geometry only: the textures are shared and accounted for by their owner.
+    memory_usage_t memory() const;
+
 private:
     std::vector<Vertex>       m_vertices;
     std::vector<unsigned int> m_indices;
     std::vector<Texture>      m_textures;
+    std::vector<std::string>  m_sampler_names; // uniform name for each of m_textures
+    size_t                    m_vertex_count{};
+    size_t                    m_index_count{};
 
     id_t m_vertex_array{};
     id_t m_vertex_buffer{};
     id_t m_element_buffer{};
 
-    void setup_mesh();
+    void setup_mesh(bool retain_cpu_copy);
+    void bind(Shader &shader);
 };
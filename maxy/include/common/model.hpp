@@ -2,28 +2,64 @@
 
 #include <expected>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #include "common/mesh.hpp"
 #include "common/shader.hpp"
+#include "common/texture_streamer.hpp"
+#include "scene_graph.hpp"
+
+class AssetCache;
 
 class Model {
 public:
-    Model(std::vector<Mesh> meshes) : m_meshes{std::move(meshes)} {};
+    // mesh_nodes[i] is the node of `nodes` that meshes[i] hangs from; without any, every mesh
+    // is drawn with the model matrix as is.
+    Model(
+        std::vector<Mesh> meshes, scene_graph_t nodes = {}, std::vector<node_id_t> mesh_nodes = {}
+    )
+        : m_meshes{std::move(meshes)}, m_nodes{std::move(nodes)},
+          m_mesh_nodes{std::move(mesh_nodes)} {};
     Model(const Model &)            = delete;
     Model &operator=(const Model &) = delete;
     Model(Model &&) noexcept        = default;
     Model &operator=(Model &&)      = default;
 
-    static std::expected<Model, std::string> load(const std::string &path);
+    // With a streamer the textures are decoded in the background and show a placeholder until
+    // streamer->update() uploads them; without one they are loaded before this returns. The
+    // textures come from `cache`, or default_asset_cache() in the first overload. The meshes
+    // only keep their vertices and indices in memory with retain_cpu_copy.
+    static std::expected<Model, std::string> load(
+        const std::string &path, TextureStreamer *streamer = nullptr, bool retain_cpu_copy = false
+    );
+    static std::expected<Model, std::string> load(
+        const std::string &path, AssetCache &cache, TextureStreamer *streamer = nullptr,
+        bool retain_cpu_copy = false
+    );
 
+    // Leaves "model" to the caller, so every mesh gets the same matrix and the file's node
+    // transforms are ignored. Fine for single-node models and the instanced draws.
     void draw(Shader &shader);
+    // Sets "model" to model * the world matrix of each mesh's node before drawing it.
+    void draw(Shader &shader, const glm::mat4 &model);
     void draw_instanced(Shader &shader, int amount);
 
     void set_instance_model_transform(id_t layout_id);
 
+    const std::vector<Mesh> &meshes() const { return m_meshes; }
+
+    // The aiNode hierarchy of the file, one node per aiNode, with mTransformation as the local
+    // matrix. Move nodes with set_local(); draw() picks the change up. To place the model in a
+    // larger scene graph, attach() these nodes there.
+    scene_graph_t                &nodes() { return m_nodes; }
+    const scene_graph_t          &nodes() const { return m_nodes; }
+    const std::vector<node_id_t> &mesh_nodes() const { return m_mesh_nodes; }
+
+    // Sum over the meshes; textures are not included.
+    memory_usage_t memory() const;
+
 private:
-    std::vector<Mesh>                               m_meshes;
-    static std::unordered_map<std::string, Texture> m_textures_loaded;
+    std::vector<Mesh>      m_meshes;
+    scene_graph_t          m_nodes;
+    std::vector<node_id_t> m_mesh_nodes;
 };
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <expected>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+
+#include "common/gl_context.hpp"
+#include "common/model.hpp"
+#include "common/shader.hpp"
+#include "common/types.hpp"
+
+// Layout of one glMultiDrawElementsIndirect record (DrawElementsIndirectCommand in the spec).
+struct draw_elements_indirect_command_t {
+    GLuint count;
+    GLuint instance_count;
+    GLuint first_index;
+    GLint  base_vertex;
+    GLuint base_instance;
+};
+
+// Vertex of the merged buffer: Vertex plus the texture array layer of the mesh it came from.
+struct batch_vertex_t {
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 tex_coords;
+    GLuint    layer;
+};
+
+constexpr gl_version_t MODEL_BATCH_GL_VERSION{.major = 4, .minor = 3};
+
+// Several models merged into one VAO/VBO/EBO and drawn with a single glMultiDrawElementsIndirect.
+// Every mesh becomes one indirect command; its first diffuse texture is copied into a layer of a
+// shared GL_TEXTURE_2D_ARRAY (sampler "material_array") and the layer goes in each vertex at
+// layer_location. Needs MODEL_BATCH_GL_VERSION; on older contexts draw the Models themselves.
+//
+// Transforms are per instance (set_instance_model_transform), with the instances of each model
+// stored one after another in the instance buffer, in the order the models were given.
+class ModelBatch {
+public:
+    static constexpr GLuint layer_location = 3;
+
+    static std::expected<ModelBatch, std::string> create(std::span<const Model *const> models);
+
+    ModelBatch(const ModelBatch &)            = delete;
+    ModelBatch &operator=(const ModelBatch &) = delete;
+    ModelBatch(ModelBatch &&o) noexcept
+        : m_commands(std::move(o.m_commands)), m_model_commands(std::move(o.m_model_commands)),
+          m_vertex_array(std::exchange(o.m_vertex_array, 0)),
+          m_vertex_buffer(std::exchange(o.m_vertex_buffer, 0)),
+          m_element_buffer(std::exchange(o.m_element_buffer, 0)),
+          m_command_buffer(std::exchange(o.m_command_buffer, 0)),
+          m_texture_array(std::exchange(o.m_texture_array, 0)) {}
+    ModelBatch &operator=(ModelBatch &&o) noexcept {
+        if (this != &o) {
+            release();
+            m_commands       = std::move(o.m_commands);
+            m_model_commands = std::move(o.m_model_commands);
+            m_vertex_array   = std::exchange(o.m_vertex_array, 0);
+            m_vertex_buffer  = std::exchange(o.m_vertex_buffer, 0);
+            m_element_buffer = std::exchange(o.m_element_buffer, 0);
+            m_command_buffer = std::exchange(o.m_command_buffer, 0);
+            m_texture_array  = std::exchange(o.m_texture_array, 0);
+        }
+        return *this;
+    }
+    ~ModelBatch() { release(); }
+
+    // Instances per model (one entry per model, default 1 each).
+    void set_instance_counts(std::span<const GLuint> counts);
+
+    // Binds the GL_ARRAY_BUFFER currently bound as a per-instance mat4 at layout_id..layout_id+3.
+    void set_instance_model_transform(id_t layout_id);
+
+    void draw(Shader &shader);
+
+    size_t command_count() const { return m_commands.size(); }
+
+private:
+    struct command_range_t {
+        size_t first;
+        size_t count;
+    };
+
+    std::vector<draw_elements_indirect_command_t> m_commands;
+    std::vector<command_range_t>                  m_model_commands; // meshes of each model
+
+    id_t m_vertex_array{};
+    id_t m_vertex_buffer{};
+    id_t m_element_buffer{};
+    id_t m_command_buffer{};
+    id_t m_texture_array{};
+
+    ModelBatch() = default;
+    void release();
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+
+#include <glad/gl.h>
+
+#include "common/types.hpp"
+
+// On-disk cache of linked programs as driver binaries (glGetProgramBinary / glProgramBinary).
+// Entries are keyed on a hash of every stage's source plus GL_VENDOR, GL_RENDERER and
+// GL_VERSION, so another GPU or a driver update misses instead of loading a binary the driver
+// would reject; a binary it rejects anyway is deleted and the program rebuilt from source.
+// Needs GL 4.1: on older contexts load() always misses and store() does nothing.
+namespace program_cache {
+
+struct shader_source_t {
+    GLenum      type;
+    std::string code;
+};
+
+struct stats_t {
+    size_t hits;     // programs loaded from a binary
+    size_t misses;   // programs compiled and linked from source
+    size_t rejected; // binaries the driver refused, counted in misses as well
+    double seconds;  // time spent building programs, cached or not
+};
+
+constexpr const char *DEFAULT_DIRECTORY = "shader_cache";
+
+void set_directory(std::filesystem::path directory);
+void set_enabled(bool enabled);
+bool enabled();
+
+uint64_t            key(std::span<const shader_source_t> sources);
+std::optional<id_t> load(uint64_t key);
+void                store(uint64_t key, id_t program);
+
+stats_t    &stats();
+void        reset_stats();
+std::string report();
+
+} // namespace program_cache
@@ -4,9 +4,11 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <cstdint>
 #include <expected>
 #include <span>
 #include <string>
+#include <unordered_map>
 #include <utility>
 
 #include "common/types.hpp"
@@ -19,11 +21,15 @@ public:
 
     Shader(const Shader &)            = delete;
     Shader &operator=(const Shader &) = delete;
-    Shader(Shader &&o) noexcept : m_program_id(std::exchange(o.m_program_id, 0)) {}
+    Shader(Shader &&o) noexcept
+        : m_program_id(std::exchange(o.m_program_id, 0)),
+          m_sampler_units(std::move(o.m_sampler_units)), m_sampler_epoch(o.m_sampler_epoch) {}
     Shader &operator=(Shader &&o) noexcept {
         if (this != &o) {
             glDeleteProgram(m_program_id);
-            m_program_id = std::exchange(o.m_program_id, 0);
+            m_program_id    = std::exchange(o.m_program_id, 0);
+            m_sampler_units = std::move(o.m_sampler_units);
+            m_sampler_epoch = o.m_sampler_epoch;
         }
         return *this;
     }
@@ -44,8 +50,16 @@ public:
     void set_vec4(const std::string &name, const glm::vec4 &value) const;
     void set_mat4(const std::string &name, const glm::mat4 &value) const;
 
+    // set_int for sampler uniforms: the unit is remembered per name and only uploaded when it
+    // changes, which for mesh materials is once per program.
+    void set_sampler(const std::string &name, int unit) const;
+
 private:
     id_t m_program_id{};
+
+    // What set_sampler last uploaded, valid while gl_state::epoch() still equals m_sampler_epoch.
+    mutable std::unordered_map<std::string, int> m_sampler_units;
+    mutable std::uint64_t                        m_sampler_epoch{};
 };
 
 using compile_shader_res = std::expected<id_t, std::string>;
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <expected>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glad/gl.h>
+
+#include "common/assets.hpp"
+#include "common/types.hpp"
+
+struct texture_streamer_options_t {
+    unsigned worker_count      = 2;
+    size_t   staging_buffers   = 4;        // pixel buffer objects in the ring
+    size_t   staging_size      = 16 << 20; // bytes each; bigger images upload from client memory
+    size_t   uploads_per_frame = 2;        // caps the glTexSubImage2D + mipmap work per update()
+};
+
+// Asynchronous replacement for load_texture: images are decoded on worker threads and copied
+// into a ring of pixel buffer objects, from which update() (on the GL thread) issues
+// glTexSubImage2D. load() returns the texture name straight away; until its upload lands the
+// texture holds a 1x1 placeholder, so callers can keep the id as is.
+//
+// With GL 4.4 the staging buffers are persistently mapped; on older contexts each upload maps
+// its buffer with glMapBufferRange. Either way a fence per buffer keeps the CPU from overwriting
+// a buffer the GPU is still reading. Needs a current context to construct; destroying it drops
+// the images not uploaded yet, whose textures keep the placeholder.
+class TextureStreamer {
+public:
+    explicit TextureStreamer(texture_streamer_options_t options = {});
+    ~TextureStreamer();
+
+    TextureStreamer(const TextureStreamer &)            = delete;
+    TextureStreamer &operator=(const TextureStreamer &) = delete;
+    TextureStreamer(TextureStreamer &&)                 = delete;
+    TextureStreamer &operator=(TextureStreamer &&)      = delete;
+
+    std::expected<id_t, std::string>
+    load(const std::string &filename, const texture_options_t &options = DEFAULT_TEXTURE_OPTIONS);
+
+    // Once per frame on the GL thread: recycles staging buffers whose fence has signalled and
+    // uploads up to uploads_per_frame decoded images.
+    void update();
+
+    // Runs update() until every requested texture has been uploaded.
+    void finish();
+
+    // Textures requested but not uploaded yet.
+    size_t pending() const;
+
+private:
+    struct request_t {
+        id_t              texture;
+        std::string       path;
+        texture_options_t options;
+    };
+    struct decoded_t {
+        id_t                              texture;
+        texture_options_t                 options;
+        std::expected<Image, std::string> image;
+    };
+    struct staging_t {
+        id_t   buffer;
+        void  *mapped; // persistent mapping, or nullptr when mapped per upload
+        GLsync fence;
+    };
+
+    texture_streamer_options_t m_options;
+    std::vector<staging_t>     m_staging;
+    size_t                     m_next_staging = 0;
+    size_t                     m_in_flight    = 0; // requested, not uploaded
+
+    mutable std::mutex          m_mutex;
+    std::condition_variable_any m_requests_ready;
+    std::deque<request_t>       m_requests; // guarded by m_mutex
+    std::deque<decoded_t>       m_decoded;  // guarded by m_mutex
+    std::vector<std::jthread>   m_workers;
+
+    void       decode_loop(std::stop_token stop);
+    staging_t *acquire_staging(size_t size);
+    void       upload(decoded_t &decoded);
+};
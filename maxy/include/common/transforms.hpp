@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// Transforms in structure-of-arrays layout, one array per component, so a batch of them is a few
+// contiguous loads rather than strided gathers. compose() turns them into the column-major
+// glm::mat4 array that set_mat4 or an instance buffer takes, 8 at a time with AVX2 (configure
+// with -DENABLE_AVX2=ON), 4 at a time with SSE2, one at a time elsewhere.
+struct transform_store_t {
+    std::vector<float> px, py, pz;     // position
+    std::vector<float> qx, qy, qz, qw; // rotation, a unit quaternion
+    std::vector<float> sx, sy, sz;     // scale
+
+    size_t size() const { return px.size(); }
+    void   resize(size_t count);
+
+    void
+    set(size_t i, const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale);
+    // translate * mat4_cast * scale through glm, one transform: the reference for compose().
+    glm::mat4 matrix(size_t i) const;
+
+    // Writes the matrices of [first, last) to out[first, last). Disjoint ranges may be composed
+    // from different threads.
+    void compose(std::span<glm::mat4> out, size_t first, size_t last) const;
+    void compose(std::span<glm::mat4> out) const { compose(out, 0, size()); }
+};
+
+// Bodies circling the Y axis while spinning about an axis of their own, also one array per
+// parameter. Where a body is depends only on the time, so any moment can be evaluated directly:
+// nothing accumulates error, and drawing between two fixed steps is evaluating in between.
+struct orbits_t {
+    std::vector<float> radius, height, phase, speed; // speed in radians per second
+    std::vector<float> axis_x, axis_y, axis_z;       // unit spin axis
+    std::vector<float> spin_phase, spin;             // spin in radians per second
+
+    size_t size() const { return radius.size(); }
+    void   resize(size_t count);
+};
+
+// Sets position and rotation of transforms [first, last) to where `orbits` has them `time`
+// seconds in; scales are left alone. Uses a polynomial sine, vectorized like compose(), as
+// accurate as sine_error_bound says.
+void animate_orbits(
+    const orbits_t &orbits, float time, transform_store_t &transforms, size_t first, size_t last
+);
+
+// Largest difference between animate_orbits' sine or cosine of `angle` and the exact value: the
+// polynomial is good to 2e-7, and reducing the angle to [-pi, pi] in float costs up to 1.5e-7 more
+// per radian, so bodies lose precision as the clock runs. bench_transforms checks it.
+inline double sine_error_bound(float angle) { return 2e-7 + 1.5e-7 * std::abs(angle); }
+
+// xoshiro128+ running 8 independent streams side by side, for filling arrays of procedural
+// placement data many times faster than std::mt19937 one value at a time. Fine for scattering
+// rocks; not for anything that needs a statistically strong generator.
+class fast_random_t {
+public:
+    explicit fast_random_t(uint64_t seed);
+
+    // Fills `out` with uniform floats in [lo, hi).
+    void fill(std::span<float> out, float lo, float hi);
+
+private:
+    alignas(32) uint32_t m_state[4][8];
+};
+
+struct ring_params_t {
+    float radius    = 150.f;
+    float spread    = 2.5f;   // radial and vertical offsets are in [-spread, spread]
+    float flatten   = 0.4f;   // vertical offsets are scaled by this
+    float min_scale = 0.05f;
+    float max_scale = 0.25f;
+    float speed     = 0.035f; // radians per second at `radius`; Kepler's third law elsewhere
+    float max_spin  = 1.f;    // radians per second
+};
+
+// Scatters transforms.size() bodies evenly around a ring, with random offsets, scales and spins
+// drawn from `random`, and sizes `orbits` to match.
+void scatter_ring(
+    const ring_params_t &params, fast_random_t &random, orbits_t &orbits,
+    transform_store_t &transforms
+);
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "common/mesh.hpp"
+#include "common/model.hpp"
+#include "common/shader.hpp"
+#include "common/types.hpp"
+#include "scene_graph.hpp"
+
+// Replacements for the geometry shaders of chapter 30, which expand every primitive again each
+// frame on a path drivers handle poorly (and SDL_GPU does not have at all). What the geometry
+// shader computed per frame is either already in the vertex buffer or built once here, and the
+// draws are ordinary (instanced) draws.
+
+// A copy of model with no shared vertices: every triangle has its own three, and their normal
+// is the face normal in the space of the mesh, so a vertex shader can push whole triangles
+// apart along it (30_exploding_mesh.vert). The textures and node hierarchy are shared with
+// model; the vertices are read back from the GL buffers unless model kept a CPU copy.
+Model exploded_model(const Model &model);
+
+// The vertex normals of a model as lines, one instance per vertex of each mesh and two vertices
+// per instance: the instances are the mesh's own vertex buffer, read at attribute 0 (position)
+// and 1 (normal) with a divisor of one, and gl_VertexID says which end of the line a vertex is
+// (30_normal_lines.vert). Nothing is copied, so the model has to outlive this.
+class NormalLines {
+public:
+    explicit NormalLines(const Model &model);
+
+    NormalLines(const NormalLines &)            = delete;
+    NormalLines &operator=(const NormalLines &) = delete;
+    NormalLines(NormalLines &&o) noexcept
+        : m_meshes(std::exchange(o.m_meshes, {})), m_mesh_nodes(std::move(o.m_mesh_nodes)) {}
+    NormalLines &operator=(NormalLines &&o) noexcept {
+        if (this != &o) {
+            release();
+            m_meshes     = std::exchange(o.m_meshes, {});
+            m_mesh_nodes = std::move(o.m_mesh_nodes);
+        }
+        return *this;
+    }
+    ~NormalLines() { release(); }
+
+    // Sets "model" to model * the world matrix of each mesh's node, as Model::draw does, with
+    // the node matrices taken from `nodes` (the model's, after any update()).
+    void draw(Shader &shader, const scene_graph_t &nodes, const glm::mat4 &model);
+
+    size_t line_count() const;
+
+private:
+    struct lines_t {
+        id_t    vertex_array;
+        GLsizei count; // vertices of the mesh, one line each
+    };
+
+    std::vector<lines_t>   m_meshes;
+    std::vector<node_id_t> m_mesh_nodes;
+
+    void release();
+};
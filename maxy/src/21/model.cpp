@@ -1,5 +1,6 @@
 #include <expected>
 #include <iostream>
+#include <memory>
 #include <utility>
 
 #include <glad/gl.h>
@@ -20,8 +21,9 @@ constexpr GLuint      WIDTH  = 1024;
 constexpr GLuint      HEIGHT = 768;
 
 struct model_preset_t {
-    glm::vec3 position;
-    float     scale;
+    std::string path;
+    glm::vec3   position;
+    float       scale;
 };
 struct preset_t {
     std::string    name;
@@ -48,11 +50,12 @@ public:
     void render(input_t input, float delta);
 
 private:
-    GLFWwindow *m_window{};
-    Shader      m_shader{};
-    Model       m_model;
+    GLFWwindow            *m_window{};
+    Shader                 m_shader{};
+    std::shared_ptr<Model> m_model;
+    size_t                 m_model_preset = 0; // preset m_model was loaded for
 
-    SceneRenderer(GLFWwindow *window, Shader shader, Model model)
+    SceneRenderer(GLFWwindow *window, Shader shader, std::shared_ptr<Model> model)
         : m_window{window}, m_shader{std::move(shader)}, m_model{std::move(model)} {};
 
     void render_scene();
@@ -79,11 +82,41 @@ int main() {
     return 0;
 }
 
-const std::array<preset_t, 1> presets = {{
+// Switching presets goes through default_asset_cache(): the model left behind stays cached
+// until the budget set in the asset cache panel needs its memory back.
+const std::array<preset_t, 4> presets = {{
     {
-        .name        = "simple",
+        .name        = "backpack",
         .clear_color = glm::vec4(.75f, .52f, .3f, 1.f),
         .model       = {
+            .path     = "objects/backpack/backpack.obj",
+            .position = glm::vec3(0.f, 0.f, 0.f),
+            .scale    = 1.f,
+        },
+    },
+    {
+        .name        = "nanosuit",
+        .clear_color = glm::vec4(.3f, .45f, .6f, 1.f),
+        .model       = {
+            .path     = "objects/nanosuit/nanosuit.obj",
+            .position = glm::vec3(0.f, -1.75f, 0.f),
+            .scale    = .2f,
+        },
+    },
+    {
+        .name        = "planet",
+        .clear_color = glm::vec4(.05f, .05f, .1f, 1.f),
+        .model       = {
+            .path     = "objects/planet/planet.obj",
+            .position = glm::vec3(0.f, 0.f, -4.f),
+            .scale    = .5f,
+        },
+    },
+    {
+        .name        = "rock",
+        .clear_color = glm::vec4(.4f, .4f, .4f, 1.f),
+        .model       = {
+            .path     = "objects/rock/rock.obj",
             .position = glm::vec3(0.f, 0.f, 0.f),
             .scale    = 1.f,
         },
@@ -95,7 +128,7 @@ std::expected<SceneRenderer, std::string> SceneRenderer::create(GLFWwindow *wind
     if (!shader) {
         return std::unexpected(shader.error());
     }
-    auto model = Model::load("objects/backpack/backpack.obj");
+    auto model = default_asset_cache().model(presets[state.preset_index].model.path);
     if (!model) {
         return std::unexpected(model.error());
     }
@@ -106,6 +139,16 @@ void SceneRenderer::render(input_t input, float delta) {
     process_camera_events(state.window, input, delta);
 
     const preset_t &preset = presets[state.preset_index];
+    if (m_model_preset != state.preset_index) {
+        // Keep the old model on failure; the panel shows what is loaded.
+        if (auto model = default_asset_cache().model(preset.model.path)) {
+            m_model        = std::move(*model);
+            m_model_preset = state.preset_index;
+        } else {
+            std::cerr << model.error() << "\n";
+            state.preset_index = m_model_preset;
+        }
+    }
     glClearColor(
         preset.clear_color.x, preset.clear_color.y, preset.clear_color.z, preset.clear_color.w
     );
@@ -134,7 +177,7 @@ void SceneRenderer::render_scene() {
     model_transform           = glm::scale(model_transform, glm::vec3(preset.model.scale));
     m_shader.set_mat4("model", model_transform);
 
-    m_model.draw(m_shader);
+    m_model->draw(m_shader);
 }
 
 void SceneRenderer::render_imgui() {
@@ -162,10 +205,19 @@ void SceneRenderer::render_imgui() {
     double x, y;
     glfwGetCursorPos(m_window, &x, &y);
     ImGui::LabelText("Mouse", "(%.2f, %.2f)", x, y);
+    if (ImGui::BeginCombo("Model", presets[state.preset_index].name.c_str())) {
+        for (size_t i = 0; i < presets.size(); ++i) {
+            if (ImGui::Selectable(presets[i].name.c_str(), i == state.preset_index))
+                state.preset_index = i;
+        }
+        ImGui::EndCombo();
+    }
     ImGui::PopItemWidth();
 
     ImGui::End();
 
+    draw_asset_cache_panel(default_asset_cache());
+
     ImGui::Render();
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 }
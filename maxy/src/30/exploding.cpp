@@ -1,4 +1,8 @@
+#include <algorithm>
+#include <chrono>
+#include <format>
 #include <iostream>
+#include <string_view>
 
 #include "common/common.hpp"
 
@@ -21,9 +25,45 @@ struct shaders_t {
     Shader exploding;
 };
 
+// Time to first frame and worst frame time over the first seconds, when the textures are still
+// streaming in. Compare with --sync-textures, and --no-shader-cache for the program build time
+// event_loop reports.
+struct load_metrics_t {
+    static constexpr float window = 5.f; // seconds
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    bool                                  first_frame_done{};
+    float                                 elapsed{};
+    float                                 worst_frame{};
+    bool                                  reported{};
+
+    void frame(float delta) {
+        if (!first_frame_done) {
+            auto const ttff = std::chrono::steady_clock::now() - start;
+            std::cerr << std::format(
+                "time to first frame: {:.1f} ms\n",
+                std::chrono::duration<float, std::milli>(ttff).count()
+            );
+            first_frame_done = true;
+            return; // its delta includes the loading
+        }
+        elapsed += delta;
+        worst_frame = std::max(worst_frame, delta);
+        if (!reported && elapsed >= window) {
+            std::cerr << std::format(
+                "worst frame in the first {:.0f} s: {:.1f} ms\n", window, 1000.f * worst_frame
+            );
+            reported = true;
+        }
+    }
+};
+
+load_metrics_t load_metrics;
+
 class SceneRenderer {
 public:
-    static std::expected<std::unique_ptr<SceneRenderer>, std::string> create(GLFWwindow *window);
+    static std::expected<std::unique_ptr<SceneRenderer>, std::string>
+    create(GLFWwindow *window, bool stream_textures, bool geometry_shader);
 
     SceneRenderer(const SceneRenderer &)            = delete;
     SceneRenderer &operator=(const SceneRenderer &) = delete;
@@ -34,36 +74,49 @@ public:
     void render(input_t input, float delta);
 
 private:
-    shaders_t m_shaders;
-    Model     m_model;
-
-    SceneRenderer(shaders_t shaders, Model model)
-        : m_shaders{std::move(shaders)}, m_model(std::move(model)) {}
+    // Declared first so it outlives the model whose textures it is filling in.
+    std::unique_ptr<TextureStreamer> m_streamer;
+    shaders_t                        m_shaders;
+    Model                            m_model;
+
+    SceneRenderer(std::unique_ptr<TextureStreamer> streamer, shaders_t shaders, Model model)
+        : m_streamer(std::move(streamer)), m_shaders{std::move(shaders)},
+          m_model(std::move(model)) {}
 };
 
-std::expected<shaders_t, std::string> load_shaders() {
-    auto shader = Shader::build(
-        "shaders/30_exploding.vert", "shaders/30_exploding.frag", "shaders/30_exploding.geom"
-    );
+// The geometry shader works out each face normal and moves the triangle every frame; the
+// default path draws exploded_model(), whose vertices already carry the face normals.
+std::expected<shaders_t, std::string> load_shaders(bool geometry_shader) {
+    auto shader =
+        geometry_shader
+            ? Shader::build(
+                  "shaders/30_exploding.vert", "shaders/30_exploding.frag",
+                  "shaders/30_exploding.geom"
+              )
+            : Shader::build("shaders/30_exploding_mesh.vert", "shaders/30_exploding.frag");
     if (!shader) return std::unexpected(shader.error());
     return shaders_t{.exploding = std::move(*shader)};
 }
 
 std::expected<std::unique_ptr<SceneRenderer>, std::string>
-SceneRenderer::create(GLFWwindow *window) {
-    auto shaders = load_shaders();
+SceneRenderer::create(GLFWwindow *window, bool stream_textures, bool geometry_shader) {
+    auto shaders = load_shaders(geometry_shader);
     if (!shaders) return std::unexpected(shaders.error());
 
-    auto model = Model::load("objects/nanosuit/nanosuit.obj");
+    auto streamer = stream_textures ? std::make_unique<TextureStreamer>() : nullptr;
+    auto model    = Model::load("objects/nanosuit/nanosuit.obj", streamer.get());
     if (!model) return std::unexpected(model.error());
+    if (!geometry_shader) *model = exploded_model(*model);
 
-    auto renderer = new SceneRenderer{std::move(*shaders), std::move(*model)};
+    auto renderer =
+        new SceneRenderer{std::move(streamer), std::move(*shaders), std::move(*model)};
 
     return std::unique_ptr<SceneRenderer>{renderer};
 }
 
 void SceneRenderer::render(input_t input, float delta) {
     process_camera_events(state.window, input, delta);
+    if (m_streamer) m_streamer->update();
 
     glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -81,10 +134,10 @@ void SceneRenderer::render(input_t input, float delta) {
 
     m_shaders.exploding.set_mat4("view", view);
     m_shaders.exploding.set_mat4("projection", projection);
-    m_shaders.exploding.set_mat4("model", model_transform);
     m_shaders.exploding.set_float("time", static_cast<float>(glfwGetTime()));
 
-    m_model.draw(m_shaders.exploding);
+    m_model.draw(m_shaders.exploding, model_transform);
+    load_metrics.frame(delta);
 }
 
 int error_exit(std::string error) {
@@ -92,13 +145,21 @@ int error_exit(std::string error) {
     return -1;
 }
 
-int main() {
+int main(int argc, char **argv) {
+    bool stream_textures = true;
+    bool geometry_shader = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string_view(argv[i]) == "--sync-textures") stream_textures = false;
+        if (std::string_view(argv[i]) == "--no-shader-cache") program_cache::set_enabled(false);
+        if (std::string_view(argv[i]) == "--geometry-shader") geometry_shader = true;
+    }
+
     auto ctx = GLContext::create(WIDTH, HEIGHT, TITLE);
     if (!ctx) return error_exit(ctx.error());
 
     init_window_callbacks(ctx->window(), state.window);
 
-    auto expected_renderer = SceneRenderer::create(ctx->window());
+    auto expected_renderer = SceneRenderer::create(ctx->window(), stream_textures, geometry_shader);
     if (!expected_renderer) return error_exit(expected_renderer.error());
     auto renderer = std::move(*expected_renderer);
 
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <string_view>
 
 #include "common/common.hpp"
 
@@ -23,6 +24,7 @@ struct shaders_t {
 
 struct vaos_t {
     id_t points;
+    id_t houses; // the same buffer, one instance per point
 };
 struct vbos_t {
     id_t points;
@@ -42,7 +44,8 @@ inline const std::array<position_color_t, 4> points_vertices = {{
 
 class SceneRenderer {
 public:
-    static std::expected<std::unique_ptr<SceneRenderer>, std::string> create(GLFWwindow *window);
+    static std::expected<std::unique_ptr<SceneRenderer>, std::string>
+    create(GLFWwindow *window, bool geometry_shader);
 
     SceneRenderer(const SceneRenderer &)            = delete;
     SceneRenderer &operator=(const SceneRenderer &) = delete;
@@ -60,56 +63,73 @@ private:
     shaders_t m_shaders;
     vaos_t    m_vaos;
     vbos_t    m_vbos;
+    bool      m_geometry_shader;
 
-    SceneRenderer(shaders_t shaders, vaos_t vaos, vbos_t vbos)
-        : m_shaders{std::move(shaders)}, m_vaos{vaos}, m_vbos{vbos} {}
+    SceneRenderer(shaders_t shaders, vaos_t vaos, vbos_t vbos, bool geometry_shader)
+        : m_shaders{std::move(shaders)}, m_vaos{vaos}, m_vbos{vbos},
+          m_geometry_shader{geometry_shader} {}
 };
 
-std::expected<shaders_t, std::string> load_shaders() {
+// The geometry shader turns every point into a house; the default path draws one instance of a
+// 5 vertex triangle strip per point and places the corners in the vertex shader.
+std::expected<shaders_t, std::string> load_shaders(bool geometry_shader) {
     auto shader =
-        Shader::build("shaders/30_houses.vert", "shaders/30_houses.frag", "shaders/30_houses.geom");
+        geometry_shader
+            ? Shader::build(
+                  "shaders/30_houses.vert", "shaders/30_houses.frag", "shaders/30_houses.geom"
+              )
+            : Shader::build("shaders/30_houses_instanced.vert", "shaders/30_houses.frag");
     if (!shader) return std::unexpected(shader.error());
     return shaders_t{.houses = std::move(*shader)};
 }
 
-void load_vertices(
-    std::span<const position_color_t> vertices, id_t vertex_array_object, id_t vertex_buffer_object
-) {
+// divisor 1 steps the attributes once per instance instead of once per vertex.
+void set_attributes(id_t vertex_array_object, id_t vertex_buffer_object, GLuint divisor) {
     glBindVertexArray(vertex_array_object);
     glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_object);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size_bytes(), vertices.data(), GL_STATIC_DRAW);
     glVertexAttribPointer(
         0, 3, GL_FLOAT, GL_FALSE, sizeof(position_color_t),
         reinterpret_cast<void *>(offsetof(position_color_t, position))
     );
     glEnableVertexAttribArray(0);
+    glVertexAttribDivisor(0, divisor);
     glVertexAttribPointer(
         1, 4, GL_FLOAT, GL_FALSE, sizeof(position_color_t),
         reinterpret_cast<void *>(offsetof(position_color_t, color))
     );
     glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, divisor);
+}
+
+void load_vertices(
+    std::span<const position_color_t> vertices, id_t vertex_array_object, id_t vertex_buffer_object
+) {
+    glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_object);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size_bytes(), vertices.data(), GL_STATIC_DRAW);
+    set_attributes(vertex_array_object, vertex_buffer_object, 0);
 }
 
 std::pair<vaos_t, vbos_t> load_buffers() {
     vaos_t vaos{};
     vbos_t vbos{};
 
-    glGenVertexArrays(1, reinterpret_cast<id_t *>(&vaos));
-    glGenBuffers(1, reinterpret_cast<id_t *>(&vbos));
+    glGenVertexArrays(sizeof(vaos) / sizeof(id_t), reinterpret_cast<id_t *>(&vaos));
+    glGenBuffers(sizeof(vbos) / sizeof(id_t), reinterpret_cast<id_t *>(&vbos));
 
     load_vertices(points_vertices, vaos.points, vbos.points);
+    set_attributes(vaos.houses, vbos.points, 1);
 
     return {vaos, vbos};
 }
 
 std::expected<std::unique_ptr<SceneRenderer>, std::string>
-SceneRenderer::create(GLFWwindow *window) {
-    auto shaders = load_shaders();
+SceneRenderer::create(GLFWwindow *window, bool geometry_shader) {
+    auto shaders = load_shaders(geometry_shader);
     if (!shaders) return std::unexpected(shaders.error());
 
     auto [vaos, vbos] = load_buffers();
 
-    auto renderer = new SceneRenderer{std::move(*shaders), vaos, vbos};
+    auto renderer = new SceneRenderer{std::move(*shaders), vaos, vbos, geometry_shader};
 
     return std::unique_ptr<SceneRenderer>{renderer};
 }
@@ -121,8 +141,13 @@ void SceneRenderer::render(input_t input, float delta) {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     m_shaders.houses.use();
-    glBindVertexArray(m_vaos.points);
-    glDrawArrays(GL_POINTS, 0, points_vertices.size());
+    if (m_geometry_shader) {
+        glBindVertexArray(m_vaos.points);
+        glDrawArrays(GL_POINTS, 0, points_vertices.size());
+    } else {
+        glBindVertexArray(m_vaos.houses);
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 5, points_vertices.size());
+    }
 }
 
 int error_exit(std::string error) {
@@ -130,13 +155,17 @@ int error_exit(std::string error) {
     return -1;
 }
 
-int main() {
+int main(int argc, char **argv) {
+    bool geometry_shader = false;
+    for (int i = 1; i < argc; ++i)
+        if (std::string_view(argv[i]) == "--geometry-shader") geometry_shader = true;
+
     auto ctx = GLContext::create(WIDTH, HEIGHT, TITLE);
     if (!ctx) return error_exit(ctx.error());
 
     init_window_callbacks(ctx->window(), state.window);
 
-    auto expected_renderer = SceneRenderer::create(ctx->window());
+    auto expected_renderer = SceneRenderer::create(ctx->window(), geometry_shader);
     if (!expected_renderer) return error_exit(expected_renderer.error());
     auto renderer = std::move(*expected_renderer);
 
@@ -1,4 +1,6 @@
 #include <iostream>
+#include <optional>
+#include <string_view>
 
 #include "common/common.hpp"
 
@@ -24,7 +26,8 @@ struct shaders_t {
 
 class SceneRenderer {
 public:
-    static std::expected<std::unique_ptr<SceneRenderer>, std::string> create(GLFWwindow *window);
+    static std::expected<std::unique_ptr<SceneRenderer>, std::string>
+    create(GLFWwindow *window, bool geometry_shader);
 
     SceneRenderer(const SceneRenderer &)            = delete;
     SceneRenderer &operator=(const SceneRenderer &) = delete;
@@ -37,31 +40,38 @@ public:
 private:
     shaders_t m_shaders;
     Model     m_model;
+    // Empty with --geometry-shader, where 30_normals.geom expands the model's triangles instead.
+    std::optional<NormalLines> m_lines;
 
-    SceneRenderer(shaders_t shaders, Model model)
-        : m_shaders{std::move(shaders)}, m_model(std::move(model)) {}
+    SceneRenderer(shaders_t shaders, Model model, bool geometry_shader)
+        : m_shaders{std::move(shaders)}, m_model(std::move(model)) {
+        if (!geometry_shader) m_lines.emplace(m_model);
+    }
 };
 
-std::expected<shaders_t, std::string> load_shaders() {
+std::expected<shaders_t, std::string> load_shaders(bool geometry_shader) {
     auto model_shader = Shader::build("shaders/30_model.vert", "shaders/30_model.frag");
     if (!model_shader) return std::unexpected(model_shader.error());
 
-    auto normals_shader = Shader::build(
-        "shaders/30_normals.vert", "shaders/30_normals.frag", "shaders/30_normals.geom"
-    );
+    auto normals_shader =
+        geometry_shader
+            ? Shader::build(
+                  "shaders/30_normals.vert", "shaders/30_normals.frag", "shaders/30_normals.geom"
+              )
+            : Shader::build("shaders/30_normal_lines.vert", "shaders/30_normals.frag");
     if (!normals_shader) return std::unexpected(normals_shader.error());
     return shaders_t{.model = std::move(*model_shader), .normals = std::move(*normals_shader)};
 }
 
 std::expected<std::unique_ptr<SceneRenderer>, std::string>
-SceneRenderer::create(GLFWwindow *window) {
-    auto shaders = load_shaders();
+SceneRenderer::create(GLFWwindow *window, bool geometry_shader) {
+    auto shaders = load_shaders(geometry_shader);
     if (!shaders) return std::unexpected(shaders.error());
 
     auto model = Model::load("objects/backpack/backpack.obj");
     if (!model) return std::unexpected(model.error());
 
-    auto renderer = new SceneRenderer{std::move(*shaders), std::move(*model)};
+    auto renderer = new SceneRenderer{std::move(*shaders), std::move(*model), geometry_shader};
 
     return std::unique_ptr<SceneRenderer>{renderer};
 }
@@ -84,14 +94,13 @@ void SceneRenderer::render(input_t input, float delta) {
     m_shaders.model.use();
     m_shaders.model.set_mat4("view", view);
     m_shaders.model.set_mat4("projection", projection);
-    m_shaders.model.set_mat4("model", model_transform);
-    m_model.draw(m_shaders.model);
+    m_model.draw(m_shaders.model, model_transform);
 
     m_shaders.normals.use();
     m_shaders.normals.set_mat4("view", view);
     m_shaders.normals.set_mat4("projection", projection);
-    m_shaders.normals.set_mat4("model", model_transform);
-    m_model.draw(m_shaders.normals);
+    if (m_lines) m_lines->draw(m_shaders.normals, m_model.nodes(), model_transform);
+    else m_model.draw(m_shaders.normals, model_transform);
 }
 
 int error_exit(std::string error) {
@@ -99,13 +108,17 @@ int error_exit(std::string error) {
     return -1;
 }
 
-int main() {
+int main(int argc, char **argv) {
+    bool geometry_shader = false;
+    for (int i = 1; i < argc; ++i)
+        if (std::string_view(argv[i]) == "--geometry-shader") geometry_shader = true;
+
     auto ctx = GLContext::create(WIDTH, HEIGHT, TITLE);
     if (!ctx) return error_exit(ctx.error());
 
     init_window_callbacks(ctx->window(), state.window);
 
-    auto expected_renderer = SceneRenderer::create(ctx->window());
+    auto expected_renderer = SceneRenderer::create(ctx->window(), geometry_shader);
     if (!expected_renderer) return error_exit(expected_renderer.error());
     auto renderer = std::move(*expected_renderer);
 
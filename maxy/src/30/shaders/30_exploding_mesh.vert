@@ -0,0 +1,23 @@
+#version 330 core
+// For exploded_model(): a_normal is the face normal, the same for the three corners.
+layout (location = 0) in vec3 a_pos;
+layout (location = 1) in vec3 a_normal;
+layout (location = 2) in vec2 a_tex_coords;
+
+out vec2 tex_coords;
+
+uniform mat4 projection;
+uniform mat4 view;
+uniform mat4 model;
+uniform float time;
+
+vec3 explode(vec3 position, vec3 normal) {
+    float magnitude = 2.0;
+    vec3 direction = normal * ((sin(time) + 1.0) / 2.0) * magnitude;
+    return position + direction;
+}
+
+void main() {
+    tex_coords = a_tex_coords;
+    gl_Position = projection * view * model * vec4(explode(a_pos, a_normal), 1.0);
+}
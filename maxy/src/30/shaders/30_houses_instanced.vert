@@ -0,0 +1,20 @@
+#version 330 core
+// One instance per house, drawn as a 5 vertex triangle strip: the attributes step once per
+// instance and gl_VertexID picks the corner.
+layout (location = 0) in vec3 a_pos;
+layout (location = 1) in vec4 a_color;
+
+out vec4 f_color;
+
+const vec2 corners[5] = vec2[](
+    vec2(-0.2, -0.2), // 1:bottom-left
+    vec2( 0.2, -0.2), // 2:bottom-right
+    vec2(-0.2,  0.2), // 3:top-left
+    vec2( 0.2,  0.2), // 4:top-right
+    vec2( 0.0,  0.4)  // 5:top
+);
+
+void main() {
+    f_color = gl_VertexID == 4 ? vec4(1.0, 1.0, 1.0, 1.0) : a_color;
+    gl_Position = vec4(a_pos, 1.0) + vec4(corners[gl_VertexID], 0.0, 0.0);
+}
@@ -0,0 +1,18 @@
+#version 330 core
+// Instanced over the vertices of a mesh: the attributes step once per instance and the two
+// vertices of each instance are the two ends of its normal line.
+layout (location = 0) in vec3 a_pos;
+layout (location = 1) in vec3 a_normal;
+
+const float MAGNITUDE = 0.2;
+
+uniform mat4 projection;
+uniform mat4 view;
+uniform mat4 model;
+
+void main() {
+    mat3 normal_matrix = mat3(transpose(inverse(view * model)));
+    vec3 normal = normal_matrix * a_normal;
+    vec4 position = view * model * vec4(a_pos, 1.0);
+    gl_Position = projection * (position + vec4(normal, 0.0) * MAGNITUDE * float(gl_VertexID));
+}
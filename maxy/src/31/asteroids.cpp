@@ -1,6 +1,9 @@
+#include <cmath>
+#include <format>
 #include <iostream>
 
 #include "common/common.hpp"
+#include "jobs.hpp"
 
 constexpr const char *TITLE  = "Asteroids";
 constexpr GLuint      WIDTH  = 1024;
@@ -27,7 +30,8 @@ struct models_t {
 
 class SceneRenderer {
 public:
-    static std::expected<std::unique_ptr<SceneRenderer>, std::string> create(GLFWwindow *window);
+    static std::expected<std::unique_ptr<SceneRenderer>, std::string>
+    create(GLFWwindow *window, const loop_options_t &options);
 
     SceneRenderer(const SceneRenderer &)            = delete;
     SceneRenderer &operator=(const SceneRenderer &) = delete;
@@ -35,7 +39,7 @@ public:
     SceneRenderer &operator=(SceneRenderer &&o)     = delete;
     ~SceneRenderer() noexcept                       = default;
 
-    void render(input_t input, float delta);
+    void render(input_t input, frame_timing_t timing);
 
 private:
     static constexpr int     N = 100000;
@@ -43,34 +47,30 @@ private:
     models_t                 m_models;
     std::array<glm::mat4, N> m_model_transformations;
 
+    // Every rock follows its own orbit and spin, kept in SoA form and composed into
+    // m_model_transformations each frame. The clock advances at a fixed simulation rate
+    // (--sim-hz); frames draw the rocks between the last two simulated times.
+    transform_store_t m_rocks;
+    orbits_t          m_orbits;
+    float             m_time          = 0.f;
+    float             m_previous_time = 0.f;
+
+    void update(float step);
+    void animate(float time);
+
+    // With --state-stats, once-per-second frame time and gl_state counters, to compare with
+    // --no-state-cache.
+    bool  m_state_stats   = false;
+    float m_report_time   = 0.0f;
+    int   m_report_frames = 0;
+
+    void report(float delta);
+
     SceneRenderer(shaders_t shaders, models_t models)
         : m_shaders{std::move(shaders)}, m_models(std::move(models)) {
-        float radius = 150.0;
-        float offset = 2.5f;
-        for (unsigned int i = 0; i < N; ++i) {
-            glm::mat4 model = glm::mat4(1.0f);
-            // 1. translation: displace along circle with 'radius' in range [-offset, offset]
-            float angle        = static_cast<float>(i) / static_cast<float>(N) * 360.0f;
-            float displacement = random_float(0, 2 * offset) - offset;
-            float x            = sin(angle) * radius + displacement;
-            displacement       = random_float(0, 2 * offset) - offset;
-            float y = displacement *
-                      0.4f; // keep height of asteroid field smaller compared to width of x and z
-            displacement = random_float(0, 2 * offset) - offset;
-            float z      = cos(angle) * radius + displacement;
-            model        = glm::translate(model, glm::vec3(x, y, z));
-
-            // 2. scale: Scale between 0.05 and 0.25f
-            float scale = random_float(0.05, 0.25);
-            model       = glm::scale(model, glm::vec3(scale));
-
-            // 3. rotation: add random rotation around a (semi)randomly picked rotation axis vector
-            float rot_angle = random_float(0, 360);
-            model           = glm::rotate(model, rot_angle, glm::vec3(0.4f, 0.6f, 0.8f));
-
-            // 4. now add to list of matrices
-            m_model_transformations[i] = model;
-        }
+        m_rocks.resize(N);
+        fast_random_t random(1);
+        scatter_ring({}, random, m_orbits, m_rocks);
     }
 };
 
@@ -82,7 +82,7 @@ std::expected<shaders_t, std::string> load_shaders() {
 }
 
 std::expected<std::unique_ptr<SceneRenderer>, std::string>
-SceneRenderer::create(GLFWwindow *window) {
+SceneRenderer::create(GLFWwindow *window, const loop_options_t &options) {
     auto shaders = load_shaders();
     if (!shaders) return std::unexpected(shaders.error());
 
@@ -92,15 +92,35 @@ SceneRenderer::create(GLFWwindow *window) {
     auto planet_model = Model::load("objects/planet/planet.obj");
     if (!planet_model) return std::unexpected(planet_model.error());
 
+    // Meshes free their CPU copies once uploaded, so the cpu column should read 0.
+    if (options.memory_report)
+        std::cout << memory_report("rock", *rock_model) << memory_report("planet", *planet_model)
+                  << memory_report(default_asset_cache());
+
     auto models = models_t{std::move(*rock_model), std::move(*planet_model)};
 
-    auto renderer = new SceneRenderer{std::move(*shaders), std::move(models)};
+    auto renderer           = new SceneRenderer{std::move(*shaders), std::move(models)};
+    renderer->m_state_stats = options.state_stats;
 
     return std::unique_ptr<SceneRenderer>{renderer};
 }
 
-void SceneRenderer::render(input_t input, float delta) {
-    process_camera_events(state.window, input, delta);
+void SceneRenderer::update(float step) {
+    m_previous_time = m_time;
+    m_time += step;
+}
+
+void SceneRenderer::animate(float time) {
+    default_job_system().parallel_for(0, N, [this, time](size_t first, size_t last) {
+        animate_orbits(m_orbits, time, m_rocks, first, last);
+        m_rocks.compose(m_model_transformations, first, last);
+    });
+}
+
+void SceneRenderer::render(input_t input, frame_timing_t timing) {
+    process_camera_events(state.window, input, timing.delta);
+    for (int i = 0; i < timing.steps; ++i)
+        update(timing.step);
 
     glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -119,14 +139,32 @@ void SceneRenderer::render(input_t input, float delta) {
     m_shaders.model.use();
     m_shaders.model.set_mat4("view", view);
     m_shaders.model.set_mat4("projection", projection);
-    m_shaders.model.set_mat4("model", model_transform);
 
-    m_models.planet.draw(m_shaders.model);
+    m_models.planet.draw(m_shaders.model, model_transform);
 
-    for (auto &rock_model_transform : m_model_transformations) {
-        m_shaders.model.set_mat4("model", rock_model_transform);
-        m_models.rock.draw(m_shaders.model);
-    }
+    animate(glm::mix(m_previous_time, m_time, timing.alpha));
+    for (auto &rock_model_transform : m_model_transformations)
+        m_models.rock.draw(m_shaders.model, rock_model_transform);
+
+    report(timing.delta);
+}
+
+void SceneRenderer::report(float delta) {
+    if (!m_state_stats) return;
+    m_report_time += delta;
+    ++m_report_frames;
+    if (m_report_time < 1.0f) return;
+
+    auto const totals = gl_state::totals();
+    auto const frames = static_cast<std::uint64_t>(m_report_frames);
+    std::cerr << std::format(
+        "state cache {}: {:.2f} ms/frame, {} GL calls issued, {} skipped per frame\n",
+        gl_state::enabled() ? "on" : "off", 1000.0f * m_report_time / m_report_frames,
+        totals.issued / frames, totals.skipped / frames
+    );
+    gl_state::reset_stats();
+    m_report_time   = 0.0f;
+    m_report_frames = 0;
 }
 
 int error_exit(std::string error) {
@@ -134,16 +172,19 @@ int error_exit(std::string error) {
     return -1;
 }
 
-int main() {
+int main(int argc, char **argv) {
     auto ctx = GLContext::create(WIDTH, HEIGHT, TITLE);
     if (!ctx) return error_exit(ctx.error());
 
+    auto const options = parse_loop_options(argc, argv);
+    gl_state::set_enabled(options.state_cache);
+
     init_window_callbacks(ctx->window(), state.window);
 
-    auto expected_renderer = SceneRenderer::create(ctx->window());
+    auto expected_renderer = SceneRenderer::create(ctx->window(), options);
     if (!expected_renderer) return error_exit(expected_renderer.error());
     auto renderer = std::move(*expected_renderer);
 
-    event_loop(ctx->window(), *renderer, process_common_input);
+    event_loop(ctx->window(), *renderer, process_common_input, options);
     return 0;
 }
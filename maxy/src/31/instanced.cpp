@@ -1,6 +1,8 @@
 #include <iostream>
+#include <optional>
 
 #include "common/common.hpp"
+#include "jobs.hpp"
 
 constexpr const char *TITLE  = "Instanced Asteroids";
 constexpr GLuint      WIDTH  = 1024;
@@ -20,6 +22,7 @@ state_t state{
 struct shaders_t {
     Shader planet;
     Shader asteroids;
+    Shader batch; // only built when the context supports ModelBatch
 };
 struct models_t {
     Model rock;
@@ -27,11 +30,13 @@ struct models_t {
 };
 struct vbos_t {
     id_t instance;
+    id_t batch_instance; // planet transform followed by the rock ones
 };
 
 class SceneRenderer {
 public:
-    static std::expected<std::unique_ptr<SceneRenderer>, std::string> create(GLFWwindow *window);
+    static std::expected<std::unique_ptr<SceneRenderer>, std::string>
+    create(GLFWwindow *window, bool use_batch);
 
     SceneRenderer(const SceneRenderer &)            = delete;
     SceneRenderer &operator=(const SceneRenderer &) = delete;
@@ -47,64 +52,89 @@ private:
     static constexpr int     N = 100000;
     shaders_t                m_shaders;
     models_t                 m_models;
-    vbos_t                   m_vbos;
+    vbos_t                   m_vbos{};
     std::array<glm::mat4, N> m_model_transformations;
-
-    SceneRenderer(shaders_t shaders, models_t models)
-        : m_shaders{std::move(shaders)}, m_models(std::move(models)) {
-
+    glm::mat4                m_planet_transformation;
+    // Rock orbits and spins, composed into m_model_transformations and streamed into the
+    // instance buffer every frame.
+    transform_store_t m_rocks;
+    orbits_t          m_orbits;
+    float             m_time = 0.f;
+    // Planet and rocks in one glMultiDrawElementsIndirect; empty on GL 3.3, which draws each
+    // Model on its own.
+    std::optional<ModelBatch> m_batch;
+
+    SceneRenderer(shaders_t shaders, models_t models, std::optional<ModelBatch> batch)
+        : m_shaders{std::move(shaders)}, m_models(std::move(models)), m_batch(std::move(batch)) {
+
+        m_planet_transformation = glm::translate(glm::mat4(1.f), glm::vec3(0.0f, -3.0f, 0.0f));
+        m_planet_transformation = glm::scale(m_planet_transformation, glm::vec3(4.0f, 4.0f, 4.0f));
         init_model_transformations();
         load_buffers();
     }
 
     void init_model_transformations() {
-        float radius = 150.0;
-        float offset = 2.5f;
-        for (unsigned int i = 0; i < N; ++i) {
-            glm::mat4 model = glm::mat4(1.0f);
-            // 1. translation: displace along circle with 'radius' in range [-offset, offset]
-            float angle        = static_cast<float>(i) / static_cast<float>(N) * 360.0f;
-            float displacement = random_float(0, 2 * offset) - offset;
-            float x            = sin(angle) * radius + displacement;
-            displacement       = random_float(0, 2 * offset) - offset;
-            float y = displacement *
-                      0.4f; // keep height of asteroid field smaller compared to width of x and z
-            displacement = random_float(0, 2 * offset) - offset;
-            float z      = cos(angle) * radius + displacement;
-            model        = glm::translate(model, glm::vec3(x, y, z));
-
-            // 2. scale: Scale between 0.05 and 0.25f
-            float scale = random_float(0.05, 0.25);
-            model       = glm::scale(model, glm::vec3(scale));
-
-            // 3. rotation: add random rotation around a (semi)randomly picked rotation axis vector
-            float rot_angle = random_float(0, 360);
-            model           = glm::rotate(model, rot_angle, glm::vec3(0.4f, 0.6f, 0.8f));
-
-            // 4. now add to list of matrices
-            m_model_transformations[i] = model;
-        }
+        m_rocks.resize(N);
+        fast_random_t random(1);
+        scatter_ring({}, random, m_orbits, m_rocks);
+        m_rocks.compose(m_model_transformations);
+    }
+
+    void animate(float delta) {
+        m_time += delta;
+        default_job_system().parallel_for(0, N, [this](size_t first, size_t last) {
+            animate_orbits(m_orbits, m_time, m_rocks, first, last);
+            m_rocks.compose(m_model_transformations, first, last);
+        });
+        // The rocks' range only: in the batch buffer the planet's transform stays in front.
+        glBindBuffer(GL_ARRAY_BUFFER, m_batch ? m_vbos.batch_instance : m_vbos.instance);
+        glBufferSubData(
+            GL_ARRAY_BUFFER, m_batch ? sizeof(glm::mat4) : 0, N * sizeof(glm::mat4),
+            m_model_transformations.data()
+        );
     }
 
     void load_buffers() {
         glGenBuffers(1, &m_vbos.instance);
         glBindBuffer(GL_ARRAY_BUFFER, m_vbos.instance);
         glBufferData(
-            GL_ARRAY_BUFFER, N * sizeof(glm::mat4), m_model_transformations.data(), GL_STATIC_DRAW
+            GL_ARRAY_BUFFER, N * sizeof(glm::mat4), m_model_transformations.data(), GL_DYNAMIC_DRAW
         );
         m_models.rock.set_instance_model_transform(3);
+
+        if (!m_batch) return;
+        glGenBuffers(1, &m_vbos.batch_instance);
+        glBindBuffer(GL_ARRAY_BUFFER, m_vbos.batch_instance);
+        glBufferData(GL_ARRAY_BUFFER, (N + 1) * sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(glm::mat4), &m_planet_transformation);
+        glBufferSubData(
+            GL_ARRAY_BUFFER, sizeof(glm::mat4), N * sizeof(glm::mat4),
+            m_model_transformations.data()
+        );
+        m_batch->set_instance_model_transform(4);
+        const std::array<GLuint, 2> instance_counts{1, N}; // same order as the batch's models
+        m_batch->set_instance_counts(instance_counts);
     }
 };
 
-std::expected<shaders_t, std::string> load_shaders() {
+std::expected<shaders_t, std::string> load_shaders(bool use_batch) {
     auto planet_shader = Shader::build("shaders/31_planet.vert", "shaders/31_planet.frag");
     if (!planet_shader) return std::unexpected(planet_shader.error());
 
     auto asteroids_shader = Shader::build("shaders/31_asteroids.vert", "shaders/31_asteroids.frag");
     if (!asteroids_shader) return std::unexpected(asteroids_shader.error());
 
+    Shader batch_shader;
+    if (use_batch) {
+        auto shader = Shader::build("shaders/31_batch.vert", "shaders/31_batch.frag");
+        if (!shader) return std::unexpected(shader.error());
+        batch_shader = std::move(*shader);
+    }
+
     return shaders_t{
-        .planet = std::move(*planet_shader), .asteroids = std::move(*asteroids_shader)
+        .planet    = std::move(*planet_shader),
+        .asteroids = std::move(*asteroids_shader),
+        .batch     = std::move(batch_shader),
     };
 }
 
@@ -119,20 +149,29 @@ std::expected<models_t, std::string> load_models() {
 }
 
 std::expected<std::unique_ptr<SceneRenderer>, std::string>
-SceneRenderer::create(GLFWwindow *window) {
-    auto shaders = load_shaders();
+SceneRenderer::create(GLFWwindow *window, bool use_batch) {
+    auto shaders = load_shaders(use_batch);
     if (!shaders) return std::unexpected(shaders.error());
 
     auto models = load_models();
     if (!models) return std::unexpected(models.error());
 
-    auto renderer = new SceneRenderer{std::move(*shaders), std::move(*models)};
+    std::optional<ModelBatch> batch;
+    if (use_batch) {
+        const std::array<const Model *, 2> batch_models{&models->planet, &models->rock};
+        auto                               created = ModelBatch::create(batch_models);
+        if (!created) return std::unexpected(created.error());
+        batch = std::move(*created);
+    }
+
+    auto renderer = new SceneRenderer{std::move(*shaders), std::move(*models), std::move(batch)};
 
     return std::unique_ptr<SceneRenderer>{renderer};
 }
 
 void SceneRenderer::render(input_t input, float delta) {
     process_camera_events(state.window, input, delta);
+    animate(delta);
 
     glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -144,16 +183,20 @@ void SceneRenderer::render(input_t input, float delta) {
             static_cast<float>(state.window.viewport.height),
         .1f, 1000.f
     );
-    glm::mat4 model_transform = glm::mat4(1.f);
-    model_transform           = glm::translate(model_transform, glm::vec3(0.0f, -3.0f, 0.0f));
-    model_transform           = glm::scale(model_transform, glm::vec3(4.0f, 4.0f, 4.0f));
+
+    if (m_batch) {
+        m_shaders.batch.use();
+        m_shaders.batch.set_mat4("view", view);
+        m_shaders.batch.set_mat4("projection", projection);
+        m_batch->draw(m_shaders.batch);
+        return;
+    }
 
     m_shaders.planet.use();
     m_shaders.planet.set_mat4("view", view);
     m_shaders.planet.set_mat4("projection", projection);
-    m_shaders.planet.set_mat4("model", model_transform);
 
-    m_models.planet.draw(m_shaders.planet);
+    m_models.planet.draw(m_shaders.planet, m_planet_transformation);
 
     m_shaders.asteroids.use();
     m_shaders.asteroids.set_mat4("view", view);
@@ -167,12 +210,14 @@ int error_exit(std::string error) {
 }
 
 int main() {
-    auto ctx = GLContext::create(WIDTH, HEIGHT, TITLE);
+    // Falls back to a 3.3 context (and per-model draws) where 4.6 is not available.
+    auto ctx = GLContext::create(WIDTH, HEIGHT, TITLE, {.major = 4, .minor = 6});
     if (!ctx) return error_exit(ctx.error());
 
     init_window_callbacks(ctx->window(), state.window);
 
-    auto expected_renderer = SceneRenderer::create(ctx->window());
+    auto expected_renderer =
+        SceneRenderer::create(ctx->window(), ctx->supports(MODEL_BATCH_GL_VERSION));
     if (!expected_renderer) return error_exit(expected_renderer.error());
     auto renderer = std::move(*expected_renderer);
 
@@ -0,0 +1,11 @@
+#version 430 core
+in vec2 tex_coords;
+flat in uint layer;
+
+out vec4 frag_color;
+
+uniform sampler2DArray material_array;
+
+void main() {
+    frag_color = texture(material_array, vec3(tex_coords, float(layer)));
+}
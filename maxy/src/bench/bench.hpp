@@ -0,0 +1,116 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <format>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Minimal benchmark harness: a few untimed warmup runs, then `iterations` timed ones, reported as
+// min / median / mean / p99 in milliseconds. Run the benchmarks from a Release build.
+// Every result is also recorded, and write_bench_json() saves the run for comparing commits.
+
+struct bench_options_t {
+    int warmup     = 3;
+    int iterations = 20;
+};
+
+struct bench_result_t {
+    double min_ms;
+    double median_ms;
+    double mean_ms;
+    double p99_ms;
+    double stddev_ms;
+};
+
+struct bench_record_t {
+    std::string     name;
+    bench_options_t options;
+    bench_result_t  result;
+};
+
+// The results of every bench() call so far, in order.
+inline std::vector<bench_record_t> &bench_records() {
+    static std::vector<bench_record_t> records;
+    return records;
+}
+
+template <typename Fn>
+bench_result_t bench(std::string_view name, Fn &&fn, bench_options_t const &options = {}) {
+    using clock = std::chrono::steady_clock;
+
+    for (int i = 0; i < options.warmup; ++i)
+        fn();
+
+    std::vector<double> samples;
+    samples.reserve(static_cast<size_t>(options.iterations));
+    for (int i = 0; i < options.iterations; ++i) {
+        auto const start = clock::now();
+        fn();
+        samples.push_back(std::chrono::duration<double, std::milli>(clock::now() - start).count());
+    }
+    std::ranges::sort(samples);
+
+    double total = 0.0;
+    for (double sample : samples)
+        total += sample;
+    double const mean     = total / static_cast<double>(samples.size());
+    double       variance = 0.0;
+    for (double sample : samples)
+        variance += (sample - mean) * (sample - mean);
+    bench_result_t const result = {
+        .min_ms    = samples.front(),
+        .median_ms = samples[samples.size() / 2],
+        .mean_ms   = mean,
+        .p99_ms    = samples[(samples.size() - 1) * 99 / 100],
+        .stddev_ms = std::sqrt(variance / static_cast<double>(samples.size())),
+    };
+    std::println(
+        "{:<40} min {:9.3f} ms  median {:9.3f} ms  mean {:9.3f} ms  p99 {:9.3f} ms", name,
+        result.min_ms, result.median_ms, result.mean_ms, result.p99_ms
+    );
+    bench_records().push_back({std::string(name), options, result});
+    return result;
+}
+
+// Writes bench_records() to path as
+//   {"suite": ..., "results": [{"name": ..., "warmup": ..., "iterations": ...,
+//                               "min_ms": ..., "median_ms": ..., ...}, ...]}
+// Returns false if the file cannot be written.
+inline bool write_bench_json(std::string const &path, std::string_view suite) {
+    auto const quoted = [](std::string_view text) {
+        std::string out = "\"";
+        for (char c : text) {
+            if (c == '"' || c == '\\') out += '\\';
+            if (static_cast<unsigned char>(c) < 0x20) out += std::format("\\u{:04x}", c);
+            else out += c;
+        }
+        return out + '"';
+    };
+
+    std::FILE *file = std::fopen(path.c_str(), "w");
+    if (!file) return false;
+    std::println(file, "{{\"suite\": {}, \"results\": [", quoted(suite));
+    auto const &records = bench_records();
+    for (size_t i = 0; i < records.size(); ++i) {
+        auto const &[name, options, result] = records[i];
+        std::println(
+            file,
+            "  {{\"name\": {}, \"warmup\": {}, \"iterations\": {}, \"min_ms\": {}, "
+            "\"median_ms\": {}, \"mean_ms\": {}, \"p99_ms\": {}, \"stddev_ms\": {}}}{}",
+            quoted(name), options.warmup, options.iterations, result.min_ms, result.median_ms,
+            result.mean_ms, result.p99_ms, result.stddev_ms, i + 1 < records.size() ? "," : ""
+        );
+    }
+    std::println(file, "]}}");
+    return std::fclose(file) == 0;
+}
+
+// Keeps the optimizer from discarding a result that is otherwise unused.
+template <typename T> void do_not_optimize(T const &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
@@ -0,0 +1,284 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <format>
+#include <functional>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <SDL3_image/SDL_image.h>
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <stb_image.h>
+
+#include "bench.hpp"
+#include "engine.hpp"
+#include "lights.hpp"
+#include "model.hpp"
+#include "placement.hpp"
+
+// CPU side of the SDL3 engine, no GPU or window needed: the per-frame work of the samples
+// (camera, light uniforms, transparent sorting, run_loop's callbacks) and the load-time work of
+// load_model and load_texture (Assimp import, vertex conversion, image decoding). Per-frame
+// cases time a batch of OPS calls and report nanoseconds per call.
+//
+//   bench_engine [--json results.json]
+//
+// With --json every result is also written out, so a run on each of two commits can be diffed.
+// Run from anywhere: assets are found through ASSETS_PATH.
+
+constexpr int OPS = 100'000;
+
+namespace {
+
+std::string asset(std::string_view path) { return std::string(ASSETS_PATH) + std::string(path); }
+
+void per_op(bench_result_t const &result, int ops = OPS) {
+    std::println("  -> {:.1f} ns per call", result.median_ms * 1e6 / ops);
+}
+
+// A frame of input as run_loop builds it: flying forward and turning.
+input_t flying(bool const *keys) {
+    return {
+        .keys         = keys,
+        .dx           = 3.0f,
+        .dy           = -1.0f,
+        .scroll       = 0.0f,
+        .dt           = 1.0f / 60.0f,
+        .aspect_ratio = 16.0f / 9.0f,
+        .steps        = 1,
+        .step         = 1.0f / 60.0f,
+        .alpha        = 1.0f,
+    };
+}
+
+void camera() {
+    std::array<bool, SDL_SCANCODE_COUNT> keys{};
+    keys[SDL_SCANCODE_W] = true;
+    input_t const in     = flying(keys.data());
+
+    camera_t cam({0.0f, 1.0f, 3.0f});
+    per_op(bench("camera_t::update", [&] {
+        for (int i = 0; i < OPS; ++i) {
+            cam.update(in);
+            cam.pitch = 0.0f; // keep turning instead of pinning at the clamp
+        }
+        do_not_optimize(cam.position);
+    }));
+    per_op(bench("camera_t::view_matrix", [&] {
+        for (int i = 0; i < OPS; ++i) {
+            glm::mat4 const view = cam.view_matrix();
+            do_not_optimize(view);
+        }
+    }));
+    per_op(bench("camera_t::rotation_view", [&] {
+        for (int i = 0; i < OPS; ++i) {
+            glm::mat4 const view = cam.rotation_view();
+            do_not_optimize(view);
+        }
+    }));
+}
+
+// Full blocks, as in sdl3_25/cull.cpp render() with every light slot used.
+void lights() {
+    std::vector<pos_light_state_t>  pos(MAX_POS_LIGHTS);
+    std::vector<spot_light_state_t> spot(MAX_SPOT_LIGHTS);
+    for (int i = 0; i < MAX_POS_LIGHTS; ++i)
+        pos[i].position = {static_cast<float>(i), 2.0f, -static_cast<float>(i)};
+    for (int i = 0; i < MAX_SPOT_LIGHTS; ++i)
+        spot[i].position = {-static_cast<float>(i), 3.0f, static_cast<float>(i)};
+    glm::vec3 camera{0.5f, 1.0f, 3.0f};
+
+    per_op(bench(std::format("pack_pos_lights<{}>", MAX_POS_LIGHTS), [&] {
+        for (int i = 0; i < OPS; ++i) {
+            camera.x += 1e-6f;
+            auto const block = pack_pos_lights<MAX_POS_LIGHTS>(pos, camera);
+            do_not_optimize(block);
+        }
+    }));
+    per_op(bench(std::format("pack_spot_lights<{}>", MAX_SPOT_LIGHTS), [&] {
+        for (int i = 0; i < OPS; ++i) {
+            camera.x += 1e-6f;
+            auto const block = pack_spot_lights<MAX_SPOT_LIGHTS>(spot, camera);
+            do_not_optimize(block);
+        }
+    }));
+}
+
+// sdl3_25/cull.cpp render(): sorted_back_to_front over the preset's windows.
+void transparent_sort() {
+    for (size_t const count : {6uz, 100uz, 10'000uz}) {
+        std::vector<model_placement_t> windows(count);
+        for (size_t i = 0; i < count; ++i) {
+            float const t = static_cast<float>(i) * 2.39996f; // golden angle: no sorted runs
+            windows[i]    = {{std::cos(t) * (1.0f + t), 0.5f, std::sin(t) * (1.0f + t)}, 1.0f};
+        }
+        glm::vec3  camera{0.0f, 1.0f, 3.0f};
+        int const  ops = std::max(1, OPS / static_cast<int>(count));
+        auto const result = bench(std::format("sort {} windows back to front", count), [&] {
+            for (int i = 0; i < ops; ++i) {
+                camera.x = std::sin(static_cast<float>(i));
+                auto const sorted = sorted_back_to_front(windows, camera);
+                do_not_optimize(sorted.front());
+            }
+        });
+        per_op(result, ops);
+    }
+}
+
+constexpr std::string_view MODELS[] = {
+    "objects/nanosuit/nanosuit.obj",
+    "objects/planet/planet.obj",
+    "objects/rock/rock.obj",
+};
+
+constexpr bench_options_t SLOW = {.warmup = 1, .iterations = 5};
+
+// load_model's import (same flags) and its per-mesh vertex conversion.
+void models() {
+    for (auto const path : MODELS) {
+        auto const full = asset(path);
+        bench(
+            std::format("Assimp import {}", path),
+            [&] {
+                Assimp::Importer importer;
+                aiScene const   *scene = importer.ReadFile(
+                    full, static_cast<unsigned>(aiProcess_Triangulate | aiProcess_FlipUVs)
+                );
+                do_not_optimize(scene);
+            },
+            SLOW
+        );
+
+        Assimp::Importer importer;
+        aiScene const   *scene = importer.ReadFile(
+            full, static_cast<unsigned>(aiProcess_Triangulate | aiProcess_FlipUVs)
+        );
+        if (!scene) {
+            std::println(stderr, "Assimp: {}", importer.GetErrorString());
+            continue;
+        }
+        size_t vertices = 0;
+        for (unsigned i = 0; i < scene->mNumMeshes; ++i)
+            vertices += scene->mMeshes[i]->mNumVertices;
+        auto const result = bench(std::format("convert_mesh {}", path), [&] {
+            for (unsigned i = 0; i < scene->mNumMeshes; ++i) {
+                mesh_data_t const data = convert_mesh(scene->mMeshes[i]);
+                do_not_optimize(data.vertices.data());
+            }
+        });
+        std::println(
+            "  -> {} vertices, {:.2f} ns per vertex", vertices,
+            result.median_ms * 1e6 / static_cast<double>(std::max<size_t>(vertices, 1))
+        );
+    }
+}
+
+constexpr std::string_view IMAGES[] = {
+    "textures/container2.png",
+    "textures/marble.jpg",
+    "textures/wood.png",
+    "objects/nanosuit/body_dif.png",
+};
+
+// The GL samples decode with stb_image, the SDL3 engine with SDL3_image (decode_texture adds
+// the RGBA32 conversion and row flip on top of IMG_Load).
+void images() {
+    for (auto const path : IMAGES) {
+        auto const full = asset(path);
+        bench(
+            std::format("stbi_load {}", path),
+            [&] {
+                int      w, h, channels;
+                stbi_uc *pixels = stbi_load(full.c_str(), &w, &h, &channels, 4);
+                do_not_optimize(pixels);
+                stbi_image_free(pixels);
+            },
+            SLOW
+        );
+        bench(
+            std::format("IMG_Load {}", path),
+            [&] {
+                SDL_Surface *surface = IMG_Load(full.c_str());
+                do_not_optimize(surface);
+                SDL_DestroySurface(surface);
+            },
+            SLOW
+        );
+        bench(
+            std::format("decode_texture {}", path),
+            [&] {
+                auto rgba = decode_texture(full);
+                do_not_optimize(rgba);
+            },
+            SLOW
+        );
+    }
+}
+
+bool update_frame(input_t const &in) { return in.dt > 0.0f; }
+
+// run_loop calls update through a std::function reference once per frame and each pass's draw
+// through a draw_fn; against calling the same lambda directly.
+void dispatch() {
+    std::array<bool, SDL_SCANCODE_COUNT> keys{};
+    input_t const                        in = flying(keys.data());
+    int                                  frames = 0;
+    auto const update = [&](input_t const &frame) { return frames++ >= 0 && frame.dt > 0.0f; };
+
+    per_op(bench("update, direct lambda call", [&] {
+        bool running = true;
+        for (int i = 0; i < OPS; ++i)
+            running &= update(in);
+        do_not_optimize(running);
+    }));
+    std::function<bool(input_t const &)> const wrapped = update;
+    per_op(bench("update, std::function", [&] {
+        bool running = true;
+        for (int i = 0; i < OPS; ++i)
+            running &= wrapped(in);
+        do_not_optimize(running);
+    }));
+    std::function<bool(input_t const &)> const pointer = update_frame;
+    per_op(bench("update, std::function over a function", [&] {
+        bool running = true;
+        for (int i = 0; i < OPS; ++i)
+            running &= pointer(in);
+        do_not_optimize(running);
+    }));
+
+    int           draws = 0;
+    draw_fn const draw  = [&](SDL_GPUCommandBuffer *, SDL_GPURenderPass *) { ++draws; };
+    per_op(bench("draw_fn", [&] {
+        for (int i = 0; i < OPS; ++i)
+            draw(nullptr, nullptr);
+        do_not_optimize(draws);
+    }));
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    std::string json;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view const arg(argv[i]);
+        if (arg == "--json" && i + 1 < argc) json = argv[++i];
+    }
+
+    camera();
+    lights();
+    transparent_sort();
+    dispatch();
+    models();
+    images();
+
+    if (!json.empty() && !write_bench_json(json, "bench_engine")) {
+        std::println(stderr, "Could not write {}", json);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,145 @@
+#include <cstdlib>
+#include <format>
+#include <print>
+#include <string_view>
+
+#include <glad/gl.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "bench.hpp"
+#include "common/common.hpp"
+
+// Chapter 30's visualisers on the nanosuit, with the geometry shader against the replacements in
+// common/visualizers.hpp: normal lines instanced over the vertex buffer, and a model exploded
+// once on load. Every sample draws REPEATS frames into an offscreen 1080p target and waits for
+// them with glFinish, so the wall time is the GPU time plus a small fixed overhead; the plain
+// model is there to subtract. Run from the build directory once the chapter 30 shaders have been
+// copied there (build any 30_* target).
+
+constexpr int WIDTH   = 1920;
+constexpr int HEIGHT  = 1080;
+constexpr int REPEATS = 10;
+
+namespace {
+
+struct target_t {
+    id_t framebuffer{};
+    id_t renderbuffers[2]{};
+
+    target_t() {
+        glGenFramebuffers(1, &framebuffer);
+        glGenRenderbuffers(2, renderbuffers);
+        glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, WIDTH, HEIGHT);
+        glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, WIDTH, HEIGHT);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glFramebufferRenderbuffer(
+            GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]
+        );
+        glFramebufferRenderbuffer(
+            GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]
+        );
+    }
+    ~target_t() {
+        glDeleteFramebuffers(1, &framebuffer);
+        glDeleteRenderbuffers(2, renderbuffers);
+    }
+};
+
+// Builds the program or exits: a benchmark with a case missing is no use.
+Shader build(const char *vertex, const char *fragment, const char *geometry = nullptr) {
+    auto shader = geometry ? Shader::build(vertex, fragment, geometry)
+                           : Shader::build(vertex, fragment);
+    if (!shader) {
+        std::println(stderr, "{}", shader.error());
+        std::exit(1);
+    }
+    return std::move(*shader);
+}
+
+template <typename Fn> void frames(std::string_view name, Fn &&draw) {
+    auto const result = bench(std::format("{} x{}", name, REPEATS), [&] {
+        for (int i = 0; i < REPEATS; ++i) {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            draw();
+        }
+        glFinish();
+    });
+    std::println("  -> {:.3f} ms per frame", result.median_ms / REPEATS);
+}
+
+} // namespace
+
+int main() {
+    auto ctx = GLContext::create(WIDTH, HEIGHT, "bench_geometry_shader");
+    if (!ctx) {
+        std::println(stderr, "{}", ctx.error());
+        return 1;
+    }
+
+    auto model = Model::load("objects/nanosuit/nanosuit.obj");
+    if (!model) {
+        std::println(stderr, "{}", model.error());
+        return 1;
+    }
+    Model       exploded = exploded_model(*model);
+    NormalLines lines{*model};
+
+    Shader plain = build("shaders/30_model.vert", "shaders/30_model.frag");
+    Shader normals_gs =
+        build("shaders/30_normals.vert", "shaders/30_normals.frag", "shaders/30_normals.geom");
+    Shader normals = build("shaders/30_normal_lines.vert", "shaders/30_normals.frag");
+    Shader exploding_gs = build(
+        "shaders/30_exploding.vert", "shaders/30_exploding.frag", "shaders/30_exploding.geom"
+    );
+    Shader exploding = build("shaders/30_exploding_mesh.vert", "shaders/30_exploding.frag");
+
+    target_t target;
+    glViewport(0, 0, WIDTH, HEIGHT);
+    glEnable(GL_DEPTH_TEST);
+
+    glm::mat4 const view = glm::lookAt(glm::vec3(0.f, 8.f, 18.f), {0.f, 8.f, 0.f}, {0.f, 1.f, 0.f});
+    glm::mat4 const projection =
+        glm::perspective(glm::radians(45.f), static_cast<float>(WIDTH) / HEIGHT, .1f, 100.f);
+    glm::mat4 const transform{1.f};
+    for (Shader *shader : {&plain, &normals_gs, &normals, &exploding_gs, &exploding}) {
+        shader->use();
+        shader->set_mat4("view", view);
+        shader->set_mat4("projection", projection);
+        shader->set_float("time", 0.f); // halfway out; only the explode shaders use it
+    }
+
+    size_t vertices = 0, indices = 0;
+    for (const auto &mesh : model->meshes()) {
+        vertices += mesh.vertex_count();
+        indices += mesh.index_count();
+    }
+    // The geometry shader draws a line per triangle corner, so shared vertices get several.
+    std::println("nanosuit: {} vertices, {} triangles", vertices, indices / 3);
+    std::println(
+        "normal lines: {} from the geometry shader, {} instanced", indices, lines.line_count()
+    );
+
+    frames("model", [&] {
+        plain.use();
+        model->draw(plain, transform);
+    });
+    frames("normals, geometry shader", [&] {
+        normals_gs.use();
+        model->draw(normals_gs, transform);
+    });
+    frames("normals, instanced lines", [&] {
+        normals.use();
+        lines.draw(normals, model->nodes(), transform);
+    });
+    frames("explode, geometry shader", [&] {
+        exploding_gs.use();
+        model->draw(exploding_gs, transform);
+    });
+    frames("explode, exploded model", [&] {
+        exploding.use();
+        exploded.draw(exploding, transform);
+    });
+    return 0;
+}
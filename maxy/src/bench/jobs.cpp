@@ -0,0 +1,97 @@
+#include <cmath>
+#include <format>
+#include <print>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "jobs.hpp"
+
+// Job system microbenchmarks: the fixed cost of a job, and how parallel_for scales from the
+// calling thread alone up to one worker per remaining core.
+
+constexpr int    EMPTY_JOBS = 100'000;
+constexpr size_t ELEMENTS   = 1 << 22;
+constexpr int    TERMS      = 16;
+
+namespace {
+
+// Enough arithmetic per element that the loop is compute bound rather than memory bound.
+void heavy_range(std::vector<float> &out, size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i) {
+        float x   = static_cast<float>(i) * 1e-6f;
+        float sum = 0.0f;
+        for (int t = 0; t < TERMS; ++t)
+            sum += std::sin(x * static_cast<float>(t + 1)) / static_cast<float>(t + 1);
+        out[i] = sum;
+    }
+}
+
+void job_overhead(unsigned workers) {
+    job_system_t system(workers);
+
+    auto const plain = bench(std::format("{} empty jobs, {} workers", EMPTY_JOBS, workers), [&] {
+        job_counter_t counter;
+        for (int i = 0; i < EMPTY_JOBS; ++i)
+            system.run([] {}, &counter);
+        system.wait(counter);
+    });
+
+    // Every job queued as a continuation of the previous one: the dependency path end to end.
+    constexpr int CHAIN = EMPTY_JOBS / 10;
+    auto const    chain = bench(std::format("{} chained jobs, {} workers", CHAIN, workers), [&] {
+        std::vector<job_counter_t> counters(CHAIN);
+        system.run([] {}, &counters[0]);
+        for (int i = 1; i < CHAIN; ++i)
+            system.run_after(counters[i - 1], [] {}, &counters[i]);
+        system.wait(counters.back());
+        for (auto &counter : counters)
+            system.wait(counter);
+    });
+
+    std::println(
+        "  -> {:.0f} ns per job, {:.0f} ns per dependent job", plain.median_ms * 1e6 / EMPTY_JOBS,
+        chain.median_ms * 1e6 / CHAIN
+    );
+}
+
+void parallel_for_scaling(unsigned max_workers) {
+    std::vector<float> out(ELEMENTS);
+    double             baseline = 0.0;
+
+    for (unsigned workers = 0; workers <= max_workers; ++workers) {
+        job_system_t system(workers);
+        auto const   result = bench(std::format("parallel_for, {} threads", workers + 1), [&] {
+            system.parallel_for(0, out.size(), [&](size_t first, size_t last) {
+                heavy_range(out, first, last);
+            });
+            do_not_optimize(out.front());
+        });
+        if (workers == 0) baseline = result.median_ms;
+        std::println(
+            "  -> speedup {:.2f}x, efficiency {:.0f}%", baseline / result.median_ms,
+            100.0 * baseline / result.median_ms / (workers + 1)
+        );
+    }
+
+    // A small fixed grain instead of the automatic one, to show what the adaptive split saves.
+    job_system_t system(max_workers);
+    bench(std::format("parallel_for grain 64, {} threads", max_workers + 1), [&] {
+        system.parallel_for(
+            0, out.size(), [&](size_t first, size_t last) { heavy_range(out, first, last); }, 64
+        );
+        do_not_optimize(out.front());
+    });
+}
+
+} // namespace
+
+int main() {
+    unsigned const max_workers = job_system_t::default_worker_count();
+    std::println("{} hardware threads", std::thread::hardware_concurrency());
+
+    job_overhead(0);
+    job_overhead(max_workers);
+    parallel_for_scaling(max_workers);
+    return 0;
+}
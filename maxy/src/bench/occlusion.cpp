@@ -0,0 +1,278 @@
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <format>
+#include <print>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "bench.hpp"
+#include "occlusion.hpp"
+
+// Software occlusion culling without a GPU. First a handful of boxes whose answer is known,
+// then a random city classified by occlusion_buffer_t and by a plain per-pixel reference (no
+// SIMD, no tile level), and the time each spends rasterizing and testing. Exits with 1 when a
+// known answer is wrong.
+
+constexpr int   WIDTH     = 320;
+constexpr int   HEIGHT    = 180;
+constexpr float FAR_PLANE = 400.0f;
+constexpr int   OCCLUDERS = 32;
+constexpr int   OCCLUDEES = 10'000;
+
+// Same as occlusion.cpp: occludee depths are pulled this much towards the camera.
+constexpr float DEPTH_BIAS = 1e-5f;
+
+namespace {
+
+char const *name(visibility_t v) {
+    switch (v) {
+    case visibility_t::visible: return "visible";
+    case visibility_t::occluded: return "occluded";
+    case visibility_t::off_screen: return "off_screen";
+    }
+    return "?";
+}
+
+glm::mat4 view_proj(glm::vec3 eye, glm::vec3 target) {
+    glm::mat4 const proj = glm::perspective(
+        glm::radians(60.0f), static_cast<float>(WIDTH) / HEIGHT, 0.1f, FAR_PLANE
+    );
+    return proj * glm::lookAt(eye, target, {0.0f, 1.0f, 0.0f});
+}
+
+// Every triangle edge-tested at every pixel centre of its bounds, every box tested against
+// every pixel it covers.
+struct reference_buffer_t {
+    glm::mat4          m_view_proj;
+    std::vector<float> m_depth;
+
+    void begin(glm::mat4 const &vp) {
+        m_view_proj = vp;
+        m_depth.assign(static_cast<size_t>(WIDTH) * HEIGHT, 1.0f);
+    }
+
+    static bool behind_near_plane(glm::vec4 const &clip) {
+        return clip.w <= 0.0f || clip.z < -clip.w;
+    }
+
+    void rasterize_box(aabb_t const &box) {
+        std::array<glm::vec4, 8> clip;
+        auto const               corners = box_corners(box);
+        for (int i = 0; i < 8; ++i) clip[i] = m_view_proj * glm::vec4(corners[i], 1.0f);
+
+        for (size_t i = 0; i < std::size(box_indices); i += 3) {
+            glm::vec4 const c[3] = {
+                clip[box_indices[i]], clip[box_indices[i + 1]], clip[box_indices[i + 2]]
+            };
+            if (behind_near_plane(c[0]) || behind_near_plane(c[1]) || behind_near_plane(c[2]))
+                continue;
+            glm::vec3 v[3];
+            for (int k = 0; k < 3; ++k) {
+                glm::vec3 const ndc = glm::vec3(c[k]) / c[k].w;
+                v[k] = {(ndc.x * 0.5f + 0.5f) * WIDTH, (0.5f - ndc.y * 0.5f) * HEIGHT, ndc.z};
+            }
+            triangle(v[0], v[1], v[2]);
+        }
+    }
+
+    void triangle(glm::vec3 v0, glm::vec3 v1, glm::vec3 v2) {
+        auto const edge = [](glm::vec3 const &a, glm::vec3 const &b, float x, float y) {
+            return (a.y - b.y) * x + (b.x - a.x) * y + (a.x * b.y - a.y * b.x);
+        };
+        float const area = edge(v0, v1, v2.x, v2.y);
+        if (std::abs(area) < 1e-8f) return;
+        if (area < 0.0f) std::swap(v1, v2);
+
+        int const x0 = std::max(0, static_cast<int>(std::floor(std::min({v0.x, v1.x, v2.x}))));
+        int const x1 =
+            std::min(WIDTH - 1, static_cast<int>(std::ceil(std::max({v0.x, v1.x, v2.x}))));
+        int const y0 = std::max(0, static_cast<int>(std::floor(std::min({v0.y, v1.y, v2.y}))));
+        int const y1 =
+            std::min(HEIGHT - 1, static_cast<int>(std::ceil(std::max({v0.y, v1.y, v2.y}))));
+        float const total = std::abs(area);
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                float const px = static_cast<float>(x) + 0.5f;
+                float const py = static_cast<float>(y) + 0.5f;
+                float const w0 = edge(v1, v2, px, py);
+                float const w1 = edge(v2, v0, px, py);
+                float const w2 = edge(v0, v1, px, py);
+                if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) continue;
+                float const z   = (w0 * v0.z + w1 * v1.z + w2 * v2.z) / total;
+                float      &out = m_depth[static_cast<size_t>(y) * WIDTH + x];
+                out             = std::min(out, z);
+            }
+        }
+    }
+
+    visibility_t test(aabb_t const &box) const {
+        glm::vec2 lo{FLT_MAX};
+        glm::vec2 hi{-FLT_MAX};
+        float     z_min = FLT_MAX;
+        for (auto const &corner : box_corners(box)) {
+            glm::vec4 const clip = m_view_proj * glm::vec4(corner, 1.0f);
+            if (behind_near_plane(clip)) return visibility_t::visible;
+            glm::vec3 const ndc = glm::vec3(clip) / clip.w;
+            lo                  = glm::min(lo, glm::vec2(ndc));
+            hi                  = glm::max(hi, glm::vec2(ndc));
+            z_min               = std::min(z_min, ndc.z);
+        }
+        if (hi.x < -1.0f || lo.x > 1.0f || hi.y < -1.0f || lo.y > 1.0f || z_min > 1.0f)
+            return visibility_t::off_screen;
+
+        auto const to_pixel = [](float v, int size) {
+            int const pixel = static_cast<int>(std::floor(v * static_cast<float>(size)));
+            return std::clamp(pixel, 0, size - 1);
+        };
+        int const   x0 = to_pixel(lo.x * 0.5f + 0.5f, WIDTH);
+        int const   x1 = to_pixel(hi.x * 0.5f + 0.5f, WIDTH);
+        int const   y0 = to_pixel(0.5f - hi.y * 0.5f, HEIGHT);
+        int const   y1 = to_pixel(0.5f - lo.y * 0.5f, HEIGHT);
+        float const z  = z_min - DEPTH_BIAS;
+        for (int y = y0; y <= y1; ++y)
+            for (int x = x0; x <= x1; ++x)
+                if (m_depth[static_cast<size_t>(y) * WIDTH + x] >= z) return visibility_t::visible;
+        return visibility_t::occluded;
+    }
+};
+
+// A wall 10 units ahead of a camera at the origin looking down -z, and boxes around it.
+bool known_answers() {
+    struct case_t {
+        char const  *what;
+        aabb_t       box;
+        visibility_t expected;
+    };
+    case_t const cases[] = {
+        {"behind the wall", {{-1.0f, -1.0f, -21.0f}, {1.0f, 1.0f, -20.0f}},
+         visibility_t::occluded},
+        {"in front of the wall", {{-1.0f, -1.0f, -6.0f}, {1.0f, 1.0f, -5.0f}},
+         visibility_t::visible},
+        {"peeking past its edge", {{8.0f, -1.0f, -21.0f}, {12.0f, 1.0f, -20.0f}},
+         visibility_t::visible},
+        {"left of the frustum", {{-60.0f, -1.0f, -21.0f}, {-50.0f, 1.0f, -20.0f}},
+         visibility_t::off_screen},
+        {"across the near plane", {{-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}},
+         visibility_t::visible},
+        {"past the far plane", {{-1.0f, -1.0f, -502.0f}, {1.0f, 1.0f, -500.0f}},
+         visibility_t::off_screen},
+    };
+    aabb_t const wall = {{-5.0f, -5.0f, -11.0f}, {5.0f, 5.0f, -10.0f}};
+
+    occlusion_buffer_t buffer(WIDTH, HEIGHT);
+    buffer.begin(view_proj({0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}));
+    buffer.rasterize_box(wall);
+    buffer.finalize();
+
+    bool ok = true;
+    for (auto const &[what, box, expected] : cases) {
+        visibility_t const got = buffer.test(box);
+        std::println("{:<24} {:<10} {}", what, name(got), got == expected ? "ok" : "WRONG");
+        ok &= got == expected;
+    }
+    return ok;
+}
+
+struct city_t {
+    std::vector<aabb_t> occluders;
+    std::vector<aabb_t> occludees;
+};
+
+// Tall blocks near the camera as occluders, crates scattered over the whole ground.
+city_t make_city() {
+    std::mt19937                          rng(42);
+    std::uniform_real_distribution<float> near_xz(-60.0f, 60.0f);
+    std::uniform_real_distribution<float> far_xz(-200.0f, 200.0f);
+    std::uniform_real_distribution<float> footprint(4.0f, 10.0f);
+    std::uniform_real_distribution<float> height(6.0f, 30.0f);
+    std::uniform_real_distribution<float> crate(0.5f, 2.0f);
+
+    city_t city;
+    for (int i = 0; i < OCCLUDERS; ++i) {
+        glm::vec3 const at   = {near_xz(rng), 0.0f, near_xz(rng)};
+        glm::vec3 const half = {footprint(rng) * 0.5f, height(rng), footprint(rng) * 0.5f};
+        city.occluders.push_back({at - glm::vec3(half.x, 0.0f, half.z), at + half});
+    }
+    for (int i = 0; i < OCCLUDEES; ++i) {
+        glm::vec3 const at   = {far_xz(rng), 0.0f, far_xz(rng)};
+        float const     size = crate(rng);
+        city.occludees.push_back({at - glm::vec3(size, 0.0f, size), at + glm::vec3(size)});
+    }
+    return city;
+}
+
+template <typename Buffer>
+void classify(Buffer &buffer, city_t const &city, std::span<visibility_t> out) {
+    for (size_t i = 0; i < city.occludees.size(); ++i) out[i] = buffer.test(city.occludees[i]);
+}
+
+void city(glm::mat4 const &vp) {
+    city_t const       scene = make_city();
+    occlusion_buffer_t buffer(WIDTH, HEIGHT);
+    reference_buffer_t reference;
+
+    bench(std::format("rasterize {} occluders", OCCLUDERS), [&] {
+        buffer.begin(vp);
+        for (auto const &box : scene.occluders) buffer.rasterize_box(box);
+        buffer.finalize();
+        do_not_optimize(buffer.tile_max_at(0, 0));
+    });
+    bench(std::format("rasterize {} occluders, reference", OCCLUDERS), [&] {
+        reference.begin(vp);
+        for (auto const &box : scene.occluders) reference.rasterize_box(box);
+        do_not_optimize(reference.m_depth.front());
+    });
+
+    std::vector<visibility_t> fast(scene.occludees.size());
+    std::vector<visibility_t> slow(scene.occludees.size());
+    bench(std::format("test {} boxes", OCCLUDEES), [&] {
+        classify(buffer, scene, fast);
+        do_not_optimize(fast.front());
+    });
+    bench(std::format("test {} boxes, reference", OCCLUDEES), [&] {
+        classify(reference, scene, slow);
+        do_not_optimize(slow.front());
+    });
+
+    // Only edge pixels may differ (the SIMD rows step the edge functions instead of evaluating
+    // them), so the two should agree on nearly every box. A box culled that the reference keeps
+    // is the costly direction: it pops out of view.
+    size_t occluded = 0, off_screen = 0, culled = 0, kept = 0;
+    for (size_t i = 0; i < fast.size(); ++i) {
+        occluded += fast[i] == visibility_t::occluded;
+        off_screen += fast[i] == visibility_t::off_screen;
+        culled += fast[i] == visibility_t::occluded && slow[i] == visibility_t::visible;
+        kept += fast[i] == visibility_t::visible && slow[i] == visibility_t::occluded;
+    }
+    std::println(
+        "  -> {} occluded, {} off screen; against the reference {} more culled, {} more kept",
+        occluded, off_screen, culled, kept
+    );
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    std::string json;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view const arg(argv[i]);
+        if (arg == "--json" && i + 1 < argc) json = argv[++i];
+    }
+
+    bool const ok = known_answers();
+    city(view_proj({0.0f, 1.7f, 0.0f}, {1.0f, 1.7f, -1.0f}));
+
+    if (!json.empty() && !write_bench_json(json, "bench_occlusion")) {
+        std::println(stderr, "Could not write {}", json);
+        return 1;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <format>
+#include <print>
+
+#include "bench.hpp"
+#include "engine.hpp"
+#include "post.hpp"
+
+// GPU cost of each post-processing effect on its own at 1080p and 4K, on a headless device.
+// SDL_GPU has no timestamp queries, so every sample records REPEATS applications into one
+// command buffer and times the submission up to its fence; the same for an empty command buffer
+// is subtracted before dividing by REPEATS.
+
+constexpr int        REPEATS       = 20;
+constexpr glm::ivec2 RESOLUTIONS[] = {{1920, 1080}, {3840, 2160}};
+
+namespace {
+
+constexpr std::array<float, 9> OLD_BLUR = {
+    1.0f / 16, 2.0f / 16, 1.0f / 16, //
+    2.0f / 16, 4.0f / 16, 2.0f / 16, //
+    1.0f / 16, 2.0f / 16, 1.0f / 16,
+};
+
+struct named_effect_t {
+    char const   *name;
+    post_effect_t effect;
+};
+
+post_effect_t blur(float radius, Uint32 downsample, bool compute) {
+    return {.radius = radius, .downsample = downsample, .compute = compute};
+}
+
+named_effect_t const EFFECTS[] = {
+    {"invert", {.kind = post_effect_kind_t::invert}},
+    {"3x3 kernel (old 1-2-1 blur)", {.kind = post_effect_kind_t::kernel, .kernel = OLD_BLUR}},
+    {"blur r8 full, fragment", blur(8.0f, 1, false)},
+    {"blur r8 full, compute", blur(8.0f, 1, true)},
+    {"blur r32 full, fragment", blur(32.0f, 1, false)},
+    {"blur r32 full, compute", blur(32.0f, 1, true)},
+    {"blur r32 half, fragment", blur(32.0f, 2, false)},
+    {"blur r32 half, compute", blur(32.0f, 2, true)},
+    {"blur r64 quarter, fragment", blur(64.0f, 4, false)},
+    {"blur r64 quarter, compute", blur(64.0f, 4, true)},
+};
+
+// Records `record` into a command buffer, submits it and waits. Exits on failure: a benchmark
+// with half its samples missing is no use.
+template <typename Fn> void submit_and_wait(engine_t const &engine, Fn &&record) {
+    SDL_GPUCommandBuffer *cmd = SDL_AcquireGPUCommandBuffer(engine.gpu_device);
+    if (!cmd) {
+        std::println(stderr, "SDL_AcquireGPUCommandBuffer failed: {}", SDL_GetError());
+        std::exit(1);
+    }
+    record(cmd);
+    SDL_GPUFence *fence = SDL_SubmitGPUCommandBufferAndAcquireFence(cmd);
+    if (!fence || !SDL_WaitForGPUFences(engine.gpu_device, true, &fence, 1)) {
+        std::println(stderr, "GPU submission failed: {}", SDL_GetError());
+        std::exit(1);
+    }
+    SDL_ReleaseGPUFence(engine.gpu_device, fence);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    engine_config_t config = parse_engine_args(argc, argv);
+    config.headless        = true;
+    auto engine            = create_engine("bench_post", 0, 0, config);
+    if (!engine) {
+        std::println(stderr, "{}", engine.error());
+        return 1;
+    }
+    auto stack = create_post_stack(*engine);
+    if (!stack) {
+        std::println(stderr, "{}", stack.error());
+        return 1;
+    }
+
+    bench_result_t const empty = bench("empty submission", [&] {
+        submit_and_wait(*engine, [](SDL_GPUCommandBuffer *) {});
+    });
+
+    for (glm::ivec2 size : RESOLUTIONS) {
+        auto source = create_color_target_texture(
+            *engine, size.x, size.y, SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM
+        );
+        if (!source) {
+            std::println(stderr, "{}", source.error());
+            return 1;
+        }
+        for (auto const &[name, effect] : EFFECTS) {
+            auto const result = bench(std::format("{}x{} {}", size.x, size.y, name), [&] {
+                submit_and_wait(*engine, [&](SDL_GPUCommandBuffer *cmd) {
+                    for (int i = 0; i < REPEATS; ++i)
+                        stack->apply(*engine, cmd, effect, source->get(), size);
+                });
+            });
+            std::println(
+                "  -> {:.3f} ms per application",
+                std::max(result.median_ms - empty.median_ms, 0.0) / REPEATS
+            );
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <format>
+#include <print>
+#include <random>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "bench.hpp"
+#include "scene_graph.hpp"
+
+// update() on a 100k node hierarchy when a few nodes move against when all of them do. Moving
+// nodes are picked at random, so what gets recomputed is them and their subtrees.
+
+constexpr size_t NODES          = 100'000;
+constexpr double MOVING_SHARE[] = {0.001, 0.01, 0.1, 1.0};
+
+namespace {
+
+void moving(scene_graph_t &graph, double share, std::mt19937 &rng) {
+    size_t const count = std::max<size_t>(1, static_cast<size_t>(share * NODES));
+    std::uniform_int_distribution<node_id_t> pick(0, static_cast<node_id_t>(NODES - 1));
+    std::uniform_real_distribution<float>    offset(-1.f, 1.f);
+
+    // Picked up front so the timed loop is set_local() and update() only.
+    std::vector<node_id_t> nodes(count);
+    std::vector<glm::mat4> locals(count);
+    for (size_t i = 0; i < count; ++i) {
+        nodes[i]  = share >= 1.0 ? static_cast<node_id_t>(i) : pick(rng);
+        locals[i] = glm::translate(glm::mat4(1.0f), {offset(rng), offset(rng), offset(rng)});
+    }
+
+    size_t recomputed = 0;
+    auto   result     = bench(std::format("{} nodes, {:.1f}% moving", NODES, share * 100), [&] {
+        for (size_t i = 0; i < count; ++i)
+            graph.set_local(nodes[i], locals[i]);
+        recomputed = graph.update();
+        do_not_optimize(graph.world(static_cast<node_id_t>(NODES - 1)));
+    });
+    std::println(
+        "  -> {} recomputed, {:.2f} ns per recomputed node", recomputed,
+        result.median_ms * 1e6 / static_cast<double>(std::max<size_t>(recomputed, 1))
+    );
+}
+
+} // namespace
+
+int main() {
+    // Each node's parent is any node before it, uniformly: a random recursive tree, a dozen or so
+    // levels deep with most nodes near the leaves, closer to a scene than a chain or a star.
+    std::mt19937  rng(1);
+    scene_graph_t graph;
+    graph.add(no_node);
+    for (node_id_t i = 1; i < NODES; ++i) {
+        std::uniform_int_distribution<node_id_t> parent(0, i - 1);
+        graph.add(parent(rng), glm::translate(glm::mat4(1.0f), {1.f, 0.f, 0.f}));
+    }
+    graph.update();
+
+    for (double share : MOVING_SHARE)
+        moving(graph, share, rng);
+    return 0;
+}
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <print>
+#include <random>
+#include <vector>
+
+#include "bench.hpp"
+#include "common/transforms.hpp"
+#include "jobs.hpp"
+
+// Per-frame cost of animating and composing N transforms (the 31/asteroids belt), against
+// composing the same transforms one glm call chain at a time, and of the placement generator
+// against std::mt19937. Also checks compose() against matrix() and animate_orbits' sine against
+// std::sin, and exits with 1 when either is off.
+
+constexpr size_t COUNTS[]      = {100'000, 250'000, 500'000, 1'000'000};
+constexpr size_t RANDOM_FLOATS = 8'000'000;
+
+namespace {
+
+// animate_orbits' positions and rotations against std::sin and std::cos in double, evaluated at
+// the same float angles, over the first minute of the belt. Each error is held to the bound
+// transforms.hpp gives for its angle.
+bool sine_accuracy() {
+    constexpr size_t count = 100'000;
+
+    transform_store_t store;
+    orbits_t          orbits;
+    fast_random_t     random(1);
+    store.resize(count);
+    scatter_ring({}, random, orbits, store);
+
+    double worst = 0.0, worst_bound = 0.0, excess = 0.0;
+    for (float const time : {0.f, 1.f, 10.f, 60.f}) {
+        animate_orbits(orbits, time, store, 0, count);
+        for (size_t i = 0; i < count; ++i) {
+            float const  angle  = orbits.phase[i] + orbits.speed[i] * time;
+            float const  half   = (orbits.spin_phase[i] + orbits.spin[i] * time) * 0.5f;
+            double const radius = orbits.radius[i];
+
+            double const errors[] = {
+                std::abs(store.px[i] / radius - std::sin(static_cast<double>(angle))),
+                std::abs(store.pz[i] / radius - std::cos(static_cast<double>(angle))),
+                std::abs(store.qw[i] - std::cos(static_cast<double>(half))),
+            };
+            double const bounds[] = {
+                sine_error_bound(angle), sine_error_bound(angle), sine_error_bound(half)
+            };
+            for (size_t k = 0; k < std::size(errors); ++k) {
+                if (errors[k] > worst) {
+                    worst       = errors[k];
+                    worst_bound = bounds[k];
+                }
+                excess = std::max(excess, errors[k] / bounds[k]);
+            }
+        }
+    }
+    std::println(
+        "sine accuracy: worst error {:.2e} (bound there {:.2e}), {:.0f}% of the bound at most",
+        worst, worst_bound, excess * 100.0
+    );
+    return excess <= 1.0;
+}
+
+// compose() over a ring whose size is not a whole number of vectors, in full and over a range
+// that starts and ends mid-vector, against matrix(i). Matrices outside the range must be left
+// alone. Untimed; every SIMD path the build has is exercised, the scalar tail included.
+bool compose_matches() {
+    constexpr size_t count   = 1'003;
+    constexpr size_t first   = 13, last = 998;
+    constexpr float  epsilon = 1e-5f; // relative, for entries past 1
+
+    transform_store_t store;
+    orbits_t          orbits;
+    fast_random_t     random(2);
+    store.resize(count);
+    scatter_ring({}, random, orbits, store);
+    animate_orbits(orbits, 3.7f, store, 0, count);
+
+    glm::mat4 const        untouched(-1.f);
+    std::vector<glm::mat4> full(count, untouched), part(count, untouched);
+    store.compose(full);
+    store.compose(part, first, last);
+
+    size_t mismatches = 0;
+    auto   same       = [&](glm::mat4 const &a, glm::mat4 const &b) {
+        for (int c = 0; c < 4; ++c)
+            for (int r = 0; r < 4; ++r)
+                if (std::abs(a[c][r] - b[c][r]) > epsilon * std::max(1.f, std::abs(b[c][r])))
+                    return false;
+        return true;
+    };
+    for (size_t i = 0; i < count; ++i) {
+        glm::mat4 const reference = store.matrix(i);
+        mismatches += !same(full[i], reference);
+        mismatches += !same(part[i], i >= first && i < last ? reference : untouched);
+    }
+    std::println(
+        "compose against matrix(): {} transforms, [{}, {}) range, {} mismatches", count, first,
+        last, mismatches
+    );
+    return mismatches == 0;
+}
+
+void transforms(size_t count, job_system_t &jobs) {
+    transform_store_t      store;
+    orbits_t               orbits;
+    std::vector<glm::mat4> out(count);
+    fast_random_t          random(1);
+    store.resize(count);
+    scatter_ring({}, random, orbits, store);
+
+    float time     = 0.f;
+    auto  per_item = [count](bench_result_t const &result) {
+        std::println("  -> {:.2f} ns per transform", result.median_ms * 1e6 / count);
+    };
+
+    per_item(bench(std::format("{} glm chain, 1 thread", count), [&] {
+        animate_orbits(orbits, time += 0.016f, store, 0, count);
+        for (size_t i = 0; i < count; ++i)
+            out[i] = store.matrix(i);
+        do_not_optimize(out.back());
+    }));
+    per_item(bench(std::format("{} SoA compose, 1 thread", count), [&] {
+        animate_orbits(orbits, time += 0.016f, store, 0, count);
+        store.compose(out);
+        do_not_optimize(out.back());
+    }));
+    per_item(bench(std::format("{} SoA compose, {} threads", count, jobs.worker_count() + 1), [&] {
+        time += 0.016f;
+        jobs.parallel_for(0, count, [&](size_t first, size_t last) {
+            animate_orbits(orbits, time, store, first, last);
+            store.compose(out, first, last);
+        });
+        do_not_optimize(out.back());
+    }));
+}
+
+void random_fill() {
+    std::vector<float> out(RANDOM_FLOATS);
+
+    std::mt19937 mt(1);
+    bench(std::format("{} floats, std::mt19937", RANDOM_FLOATS), [&] {
+        std::uniform_real_distribution<float> uniform(0.f, 1.f);
+        for (auto &value : out)
+            value = uniform(mt);
+        do_not_optimize(out.back());
+    });
+
+    fast_random_t fast(1);
+    bench(std::format("{} floats, fast_random_t", RANDOM_FLOATS), [&] {
+        fast.fill(out, 0.f, 1.f);
+        do_not_optimize(out.back());
+    });
+}
+
+} // namespace
+
+int main() {
+    bool const   ok = compose_matches() & sine_accuracy();
+    job_system_t jobs;
+    for (size_t count : COUNTS)
+        transforms(count, jobs);
+    random_fill();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <cstdlib>
+#include <format>
+#include <print>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "bench.hpp"
+#include "engine.hpp"
+#include "vegetation.hpp"
+
+// GPU cost of a frame of the sdl3_24 vegetation field (about half a million plants) at 1080p on a
+// headless device, drawn whole and with chunk culling and distance thinning, with and without
+// MSAA. Timing is as in bench_post: REPEATS frames per submission, minus an empty submission.
+//
+// The frame budget at 60 FPS is 16.7 ms. To measure against a software rasteriser rather than
+// the GPU, point the Vulkan loader at Mesa's lavapipe, e.g.
+//   VK_ICD_FILENAMES=/usr/share/vulkan/icd.d/lvp_icd.x86_64.json ./bench_vegetation
+// Run from the build directory, with the shaders and assets of the SDL3 samples.
+
+constexpr int        REPEATS   = 10;
+constexpr glm::ivec2 SIZE      = {1920, 1080};
+constexpr double     BUDGET_MS = 1000.0 / 60.0;
+
+constexpr SDL_GPUTextureFormat FORMAT = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM;
+
+namespace {
+
+struct view_t {
+    char const *name;
+    glm::vec3   eye;
+    glm::vec3   target;
+};
+
+// Standing in the field looking across it, and from above looking down into it.
+constexpr view_t VIEWS[] = {
+    {"eye level", {0.0f, 1.7f, 0.0f}, {0.0f, 1.2f, -40.0f}},
+    {"overhead", {0.0f, 40.0f, 60.0f}, {0.0f, 0.0f, 0.0f}},
+};
+
+glm::mat4 projection() {
+    return glm::perspective(
+        glm::radians(45.0f), static_cast<float>(SIZE.x) / SIZE.y, 0.1f, 250.0f
+    );
+}
+
+glm::mat4 look(view_t const &view) {
+    return glm::lookAt(view.eye, view.target, {0.0f, 1.0f, 0.0f});
+}
+
+template <typename Fn> void submit_and_wait(engine_t const &engine, Fn &&record) {
+    SDL_GPUCommandBuffer *cmd = SDL_AcquireGPUCommandBuffer(engine.gpu_device);
+    if (!cmd) {
+        std::println(stderr, "SDL_AcquireGPUCommandBuffer failed: {}", SDL_GetError());
+        std::exit(1);
+    }
+    record(cmd);
+    SDL_GPUFence *fence = SDL_SubmitGPUCommandBufferAndAcquireFence(cmd);
+    if (!fence || !SDL_WaitForGPUFences(engine.gpu_device, true, &fence, 1)) {
+        std::println(stderr, "GPU submission failed: {}", SDL_GetError());
+        std::exit(1);
+    }
+    SDL_ReleaseGPUFence(engine.gpu_device, fence);
+}
+
+gpu_texture_t
+target(engine_t const &engine, SDL_GPUTextureFormat format, SDL_GPUSampleCount samples) {
+    SDL_GPUTextureCreateInfo info{
+        .type                 = SDL_GPU_TEXTURETYPE_2D,
+        .format               = format,
+        .usage                = format == DEPTH_FORMAT ? SDL_GPU_TEXTUREUSAGE_DEPTH_STENCIL_TARGET
+                                                       : SDL_GPU_TEXTUREUSAGE_COLOR_TARGET,
+        .width                = SIZE.x,
+        .height               = SIZE.y,
+        .layer_count_or_depth = 1,
+        .num_levels           = 1,
+        .sample_count         = samples,
+    };
+    gpu_texture_t texture{
+        engine.gpu_device, SDL_CreateGPUTexture(engine.gpu_device, &info),
+        gpu_texture_bytes(info)
+    };
+    if (!texture) {
+        std::println(stderr, "SDL_CreateGPUTexture failed: {}", SDL_GetError());
+        std::exit(1);
+    }
+    return texture;
+}
+
+// Everything one configuration draws into: the field's pipeline matches its sample count.
+struct setup_t {
+    vegetation_field_t field;
+    gpu_texture_t      color, depth, resolve; // resolve only with MSAA
+};
+
+setup_t setup(engine_t const &engine, density_map_t const &density, SDL_GPUSampleCount samples) {
+    auto field = create_vegetation_field(engine, density, {}, FORMAT, samples);
+    if (!field) {
+        std::println(stderr, "{}", field.error());
+        std::exit(1);
+    }
+    setup_t s{
+        .field = std::move(*field),
+        .color = target(engine, FORMAT, samples),
+        .depth = target(engine, DEPTH_FORMAT, samples),
+    };
+    if (samples != SDL_GPU_SAMPLECOUNT_1)
+        s.resolve = target(engine, FORMAT, SDL_GPU_SAMPLECOUNT_1);
+    return s;
+}
+
+void frame(SDL_GPUCommandBuffer *cmd, setup_t const &s, view_t const &view) {
+    SDL_GPUColorTargetInfo color{
+        .texture         = s.color.get(),
+        .clear_color     = {0.5f, 0.7f, 1.0f, 1.0f},
+        .load_op         = SDL_GPU_LOADOP_CLEAR,
+        .store_op        = s.resolve ? SDL_GPU_STOREOP_RESOLVE : SDL_GPU_STOREOP_STORE,
+        .resolve_texture = s.resolve.get(),
+    };
+    SDL_GPUDepthStencilTargetInfo depth{
+        .texture          = s.depth.get(),
+        .clear_depth      = 1.0f,
+        .load_op          = SDL_GPU_LOADOP_CLEAR,
+        .store_op         = SDL_GPU_STOREOP_DONT_CARE,
+        .stencil_load_op  = SDL_GPU_LOADOP_CLEAR,
+        .stencil_store_op = SDL_GPU_STOREOP_DONT_CARE,
+    };
+    SDL_GPURenderPass *pass = SDL_BeginGPURenderPass(cmd, &color, 1, &depth);
+
+    s.field.draw(cmd, pass, glm::mat4(glm::mat3(look(view))), projection(), view.eye, 0.0f);
+    SDL_EndGPURenderPass(pass);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    engine_config_t config = parse_engine_args(argc, argv);
+    config.headless        = true;
+    auto engine            = create_engine("bench_vegetation", 0, 0, config);
+    if (!engine) {
+        std::println(stderr, "{}", engine.error());
+        return 1;
+    }
+
+    // The field and sample count of sdl3_24/grass.
+    density_map_t const density = noise_density_map({256, 256}, 24);
+
+    SDL_GPUSampleCount const msaa = supported_sample_count(*engine, FORMAT, SDL_GPU_SAMPLECOUNT_4);
+
+    bench_result_t const empty = bench("empty submission", [&] {
+        submit_and_wait(*engine, [](SDL_GPUCommandBuffer *) {});
+    });
+
+    for (SDL_GPUSampleCount samples : {SDL_GPU_SAMPLECOUNT_1, msaa}) {
+        setup_t s = setup(*engine, density, samples);
+        std::println(
+            "{} plants, {}x MSAA, {}", s.field.instance_count, 1 << samples,
+            s.field.alpha_to_coverage ? "alpha to coverage" : "discard"
+        );
+        for (view_t const &view : VIEWS) {
+            for (bool const whole : {true, false}) {
+                s.field.culling = s.field.thinning = !whole;
+                s.field.cull(projection() * look(view), view.eye);
+
+                auto const result = bench(
+                    std::format(
+                        "{}, {}: {} plants in {} draws", view.name,
+                        whole ? "whole field" : "culled and thinned", s.field.stats().instances,
+                        s.field.stats().chunks
+                    ),
+                    [&] {
+                        submit_and_wait(*engine, [&](SDL_GPUCommandBuffer *cmd) {
+                            for (int i = 0; i < REPEATS; ++i) frame(cmd, s, view);
+                        });
+                    }
+                );
+                double const ms = std::max(result.median_ms - empty.median_ms, 0.0) / REPEATS;
+                std::println(
+                    "  -> {:.3f} ms per frame, {:.0f}% of 60 FPS", ms, 100.0 * ms / BUDGET_MS
+                );
+            }
+        }
+        if (msaa == SDL_GPU_SAMPLECOUNT_1) break; // no second configuration
+    }
+    return 0;
+}
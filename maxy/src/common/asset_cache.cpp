@@ -0,0 +1,258 @@
+#include <algorithm>
+#include <filesystem>
+#include <format>
+#include <iostream>
+
+#include <imgui.h>
+
+#include "common/asset_cache.hpp"
+
+namespace fs = std::filesystem;
+
+constexpr size_t unlimited = std::numeric_limits<size_t>::max();
+
+// What a streamed texture measures until its upload lands: the 1x1 RGBA placeholder.
+constexpr size_t placeholder_bytes = 4 + 4 / 3;
+
+static std::expected<std::string, std::string> resolve(const std::string &filename) {
+    auto path = get_asset_path(filename);
+    if (!path) return std::unexpected(path.error());
+    return fs::weakly_canonical(*path).string();
+}
+
+static std::string texture_key(const std::string &path, const texture_options_t &options) {
+    std::string key = path;
+    if (options.gamma_correction) key += " (sRGB)";
+    if (options.wrap != DEFAULT_TEXTURE_OPTIONS.wrap)
+        key += std::format(" (wrap {:#x})", options.wrap);
+    return key;
+}
+
+std::expected<std::shared_ptr<const texture_asset_t>, std::string> AssetCache::texture(
+    const std::string &filename, const texture_options_t &options, TextureStreamer *streamer
+) {
+    auto path = resolve(filename);
+    if (!path) return std::unexpected(path.error());
+
+    auto key = texture_key(*path, options);
+    if (auto it = m_textures.find(key); it != m_textures.end()) {
+        ++m_hits;
+        it->second.last_use = ++m_clock;
+        auto asset          = it->second.asset; // referenced, so trim() keeps it
+        trim();
+        return asset;
+    }
+
+    ++m_misses;
+    auto id = streamer ? streamer->load(*path, options) : load_texture(*path, options);
+    if (!id) return std::unexpected(id.error());
+    auto asset = std::make_shared<const texture_asset_t>(*id);
+    m_textures.emplace(
+        key, texture_entry_t{
+                 .asset    = asset,
+                 .vram     = texture_memory(*id),
+                 .streamed = streamer != nullptr,
+                 .last_use = ++m_clock,
+             }
+    );
+    trim();
+    return asset;
+}
+
+std::expected<std::shared_ptr<Model>, std::string>
+AssetCache::model(const std::string &filename, TextureStreamer *streamer) {
+    auto path = resolve(filename);
+    if (!path) return std::unexpected(path.error());
+
+    if (auto it = m_models.find(*path); it != m_models.end()) {
+        ++m_hits;
+        it->second.last_use = ++m_clock;
+        auto model          = it->second.model;
+        trim();
+        return model;
+    }
+
+    ++m_misses;
+    auto loaded = Model::load(*path, *this, streamer);
+    if (!loaded) return std::unexpected(loaded.error());
+    auto model = std::make_shared<Model>(std::move(*loaded));
+    m_models.emplace(
+        *path, model_entry_t{.model = model, .memory = model->memory(), .last_use = ++m_clock}
+    );
+    trim();
+    return model;
+}
+
+void AssetCache::set_budget(asset_budget_t budget) {
+    m_budget = budget;
+    trim();
+}
+
+void AssetCache::remeasure_streamed() {
+    for (auto &[key, entry] : m_textures) {
+        if (!entry.streamed) continue;
+        entry.vram     = texture_memory(entry.asset->id);
+        entry.streamed = entry.vram == placeholder_bytes;
+    }
+}
+
+bool AssetCache::evict_least_recently_used() {
+    // Linear scans: caches hold a few hundred entries at most, and this only runs over budget.
+    auto oldest_texture = m_textures.end();
+    for (auto it = m_textures.begin(); it != m_textures.end(); ++it) {
+        if (it->second.asset.use_count() > 1) continue;
+        if (oldest_texture == m_textures.end() ||
+            it->second.last_use < oldest_texture->second.last_use)
+            oldest_texture = it;
+    }
+    auto oldest_model = m_models.end();
+    for (auto it = m_models.begin(); it != m_models.end(); ++it) {
+        if (it->second.model.use_count() > 1) continue;
+        if (oldest_model == m_models.end() || it->second.last_use < oldest_model->second.last_use)
+            oldest_model = it;
+    }
+
+    bool const have_texture = oldest_texture != m_textures.end();
+    bool const have_model   = oldest_model != m_models.end();
+    if (!have_texture && !have_model) return false;
+    if (have_model &&
+        (!have_texture || oldest_model->second.last_use < oldest_texture->second.last_use)) {
+        m_models.erase(oldest_model);
+    } else {
+        m_textures.erase(oldest_texture);
+    }
+    ++m_evictions;
+    return true;
+}
+
+size_t AssetCache::trim() {
+    remeasure_streamed();
+    size_t evicted = 0;
+    for (auto current = usage(); current.vram > m_budget.vram || current.ram > m_budget.ram;
+         current     = usage()) {
+        if (!evict_least_recently_used()) break;
+        ++evicted;
+    }
+    return evicted;
+}
+
+size_t AssetCache::drop_unused() {
+    size_t evicted = 0;
+    while (evict_least_recently_used())
+        ++evicted;
+    return evicted;
+}
+
+asset_usage_t AssetCache::usage() const {
+    asset_usage_t usage{
+        .vram      = 0,
+        .ram       = 0,
+        .entries   = m_textures.size() + m_models.size(),
+        .hits      = m_hits,
+        .misses    = m_misses,
+        .evictions = m_evictions,
+    };
+    for (auto const &[key, entry] : m_textures)
+        usage.vram += entry.vram;
+    for (auto const &[key, entry] : m_models) {
+        usage.vram += entry.memory.gpu;
+        usage.ram += entry.memory.cpu;
+    }
+    return usage;
+}
+
+std::vector<asset_info_t> AssetCache::entries() const {
+    std::vector<asset_info_t> entries;
+    entries.reserve(m_textures.size() + m_models.size());
+    for (auto const &[key, entry] : m_textures) {
+        entries.push_back({
+            .kind       = asset_kind_t::texture,
+            .key        = key,
+            .references = entry.asset.use_count() - 1,
+            .vram       = entry.vram,
+            .ram        = 0,
+            .last_use   = entry.last_use,
+            .model      = nullptr,
+        });
+    }
+    for (auto const &[key, entry] : m_models) {
+        entries.push_back({
+            .kind       = asset_kind_t::model,
+            .key        = key,
+            .references = entry.model.use_count() - 1,
+            .vram       = entry.memory.gpu,
+            .ram        = entry.memory.cpu,
+            .last_use   = entry.last_use,
+            .model      = entry.model.get(),
+        });
+    }
+    std::ranges::sort(entries, std::ranges::greater{}, &asset_info_t::last_use);
+    return entries;
+}
+
+AssetCache &default_asset_cache() {
+    static AssetCache cache;
+    return cache;
+}
+
+static float to_mib(size_t bytes) {
+    return static_cast<float>(bytes) / (1024.f * 1024.f);
+}
+
+// The panel edits budgets in MiB, with 0 standing for no limit.
+static bool budget_input(const char *label, size_t &budget) {
+    int mib = budget == unlimited ? 0 : static_cast<int>(budget >> 20);
+    if (!ImGui::DragInt(label, &mib, 1.f, 0, 1 << 16, mib ? "%d MiB" : "unlimited")) return false;
+    budget = mib ? static_cast<size_t>(mib) << 20 : unlimited;
+    return true;
+}
+
+void draw_asset_cache_panel(AssetCache &cache) {
+    ImGui::SetNextWindowSize(ImVec2(560.f, 360.f), ImGuiCond_Once);
+    ImGui::Begin("Asset cache");
+
+    auto budget  = cache.budget();
+    bool changed = budget_input("VRAM budget", budget.vram);
+    changed |= budget_input("RAM budget", budget.ram);
+    if (changed) cache.set_budget(budget);
+
+    auto const usage = cache.usage();
+    ImGui::Text(
+        "VRAM %.1f MiB, RAM %.1f MiB in %zu entries", to_mib(usage.vram), to_mib(usage.ram),
+        usage.entries
+    );
+    ImGui::Text("%zu hits, %zu misses, %zu evictions", usage.hits, usage.misses, usage.evictions);
+    if (ImGui::Button("Drop unused")) cache.drop_unused();
+    ImGui::SameLine();
+    if (ImGui::Button("Print memory report")) std::cout << memory_report(cache);
+
+    ImGuiTableFlags const flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg |
+                                  ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY;
+    if (ImGui::BeginTable("assets", 5, flags)) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Asset", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("Refs");
+        ImGui::TableSetupColumn("VRAM KiB");
+        ImGui::TableSetupColumn("RAM KiB");
+        ImGui::TableSetupColumn("Last use");
+        ImGui::TableHeadersRow();
+        for (auto const &entry : cache.entries()) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            auto const name = fs::path(entry.key).filename().string();
+            ImGui::Text("%s %s", entry.kind == asset_kind_t::model ? "[M]" : "[T]", name.c_str());
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("%s", entry.key.c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%ld", entry.references);
+            ImGui::TableNextColumn();
+            ImGui::Text("%zu", entry.vram >> 10);
+            ImGui::TableNextColumn();
+            ImGui::Text("%zu", entry.ram >> 10);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(entry.last_use));
+        }
+        ImGui::EndTable();
+    }
+
+    ImGui::End();
+}
@@ -4,6 +4,7 @@
 #include <string>
 
 #include "common/assets.hpp"
+#include "common/gl_state.hpp"
 #include <stb/stb_image.h>
 
 namespace fs = std::filesystem;
@@ -52,7 +53,7 @@ load_texture(const std::string &filename, const texture_options_t &options) {
     });
     id_t texture;
     glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
+    gl_state::bind_texture(GL_TEXTURE_2D, texture);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, options.wrap);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, options.wrap);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
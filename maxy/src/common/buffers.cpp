@@ -1,4 +1,5 @@
 #include "common/buffers.hpp"
+#include "common/gl_state.hpp"
 
 namespace buffers {
 void uniform_block_alloc(id_t uniform_buffer, id_t index, size_t size) {
@@ -11,7 +12,7 @@ void load_vertices(
     std::span<const vertex_t> vertices, id_t vertex_array_object, id_t vertex_buffer_object
 ) {
 
-    glBindVertexArray(vertex_array_object);
+    gl_state::bind_vertex_array(vertex_array_object);
     glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_object);
     glBufferData(GL_ARRAY_BUFFER, vertices.size_bytes(), vertices.data(), GL_STATIC_DRAW);
     glVertexAttribPointer(
@@ -0,0 +1,21 @@
+#include "common/frame_clock.hpp"
+
+#include <GLFW/glfw3.h>
+
+void frame_clock_t::reset() {
+    start = glfwGetTimerValue();
+    last  = start;
+}
+
+double frame_clock_t::now() const {
+    return static_cast<double>(glfwGetTimerValue() - start) /
+           static_cast<double>(glfwGetTimerFrequency());
+}
+
+double frame_clock_t::tick() {
+    uint64_t const current = glfwGetTimerValue();
+    double const   elapsed =
+        static_cast<double>(current - last) / static_cast<double>(glfwGetTimerFrequency());
+    last = current;
+    return elapsed;
+}
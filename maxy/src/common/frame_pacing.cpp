@@ -0,0 +1,98 @@
+#include "common/frame_pacing.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <string_view>
+#include <thread>
+
+int fixed_timestep_t::advance(double elapsed) {
+    accumulator += elapsed;
+    int steps    = static_cast<int>(accumulator / step);
+    if (steps > max_steps) {
+        accumulator = std::fmod(accumulator, step);
+        return max_steps;
+    }
+    accumulator -= steps * step;
+    return steps;
+}
+
+void frame_limiter_t::wait(const std::function<double()> &now) {
+    if (target_fps <= 0.) return;
+
+    double const period  = 1. / target_fps;
+    double const current = now();
+    if (deadline == 0. || current - deadline > period) {
+        // First frame, or too far behind to catch up: restart the schedule from here.
+        deadline = current + period;
+        return;
+    }
+
+    double const sleep = deadline - current - spin_window;
+    if (sleep > 0.) std::this_thread::sleep_for(std::chrono::duration<double>(sleep));
+    while (now() < deadline)
+        std::this_thread::yield();
+    deadline += period;
+}
+
+void frame_stats_t::add(double seconds) {
+    auto const ms = static_cast<float>(seconds * 1000.);
+    if (samples.size() < capacity) {
+        samples.push_back(ms);
+        return;
+    }
+    samples[next] = ms;
+    next          = (next + 1) % capacity;
+}
+
+void frame_stats_t::clear() {
+    samples.clear();
+    next = 0;
+}
+
+float frame_stats_t::percentile(float p) const {
+    if (samples.empty()) return 0.f;
+    std::vector<float> sorted = samples;
+    auto const rank = static_cast<size_t>(p / 100.f * static_cast<float>(sorted.size() - 1));
+    std::nth_element(sorted.begin(), sorted.begin() + static_cast<ptrdiff_t>(rank), sorted.end());
+    return sorted[rank];
+}
+
+namespace {
+
+bool parse_value(std::string_view arg, std::string_view prefix, double &value) {
+    if (!arg.starts_with(prefix)) return false;
+    arg.remove_prefix(prefix.size());
+    std::from_chars(arg.data(), arg.data() + arg.size(), value);
+    return true;
+}
+
+} // namespace
+
+loop_options_t parse_loop_options(int argc, char **argv) {
+    loop_options_t options{};
+    for (int i = 1; i < argc; ++i) {
+        std::string_view const arg(argv[i]);
+        if (arg == "--frame-report") options.report_interval = 5.;
+        else if (arg == "--no-state-cache") options.state_cache = false;
+        else if (arg == "--state-stats") options.state_stats = true;
+        else if (arg == "--memory-report") options.memory_report = true;
+        else if (!parse_value(arg, "--sim-hz=", options.simulation_hz))
+            parse_value(arg, "--fps=", options.target_fps);
+    }
+    return options;
+}
+
+std::string frame_report(const frame_stats_t &stats, double simulation_hz, double target_fps) {
+    auto const p50 = stats.percentile(50.f);
+    auto const p99 = stats.percentile(99.f);
+    return std::format(
+        "frame time p50 {:.2f} ms, p99 {:.2f} ms, spread {:.2f} ms over {} frames "
+        "(simulation {}, limiter {})",
+        p50, p99, p99 - p50, stats.samples.size(),
+        simulation_hz > 0. ? std::format("{} Hz", simulation_hz) : "per frame",
+        target_fps > 0. ? std::format("{} fps", target_fps) : "off"
+    );
+}
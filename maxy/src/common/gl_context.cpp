@@ -1,7 +1,9 @@
 #include <format>
 
+#include "common/asset_cache.hpp"
 #include "common/assets.hpp"
 #include "common/gl_context.hpp"
+#include "common/gl_state.hpp"
 
 #include <GLFW/glfw3.h>
 #include <backends/imgui_impl_glfw.h>
@@ -10,37 +12,55 @@
 #include <imgui.h>
 #include <stb/stb_image.h>
 
-static std::expected<GLFWwindow *, std::string>
-init_glfw(int width, int height, const char *title) {
+static GLFWwindow *create_window(int width, int height, const char *title, gl_version_t version) {
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, version.major);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, version.minor);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    return glfwCreateWindow(width, height, title, nullptr, nullptr);
+}
+
+struct glfw_window_t {
+    GLFWwindow  *window;
+    gl_version_t version;
+};
+
+static std::expected<glfw_window_t, std::string>
+init_glfw(int width, int height, const char *title, gl_version_t version) {
     if (glfwInit() == GLFW_FALSE) {
         char *error_description;
         glfwGetError((const char **)&error_description);
         return std::unexpected(std::format("failed to init GLFW: {}", error_description));
     }
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
-    GLFWwindow *window = glfwCreateWindow(width, height, title, nullptr, nullptr);
+    GLFWwindow *window = create_window(width, height, title, version);
+    if (!window && (version.major != DEFAULT_GL_VERSION.major ||
+                    version.minor != DEFAULT_GL_VERSION.minor)) {
+        window = create_window(width, height, title, DEFAULT_GL_VERSION);
+    }
     if (!window) {
         glfwTerminate();
         return std::unexpected("failed to create GLFW window");
     }
     glfwMakeContextCurrent(window);
-    if (gladLoadGL(glfwGetProcAddress) == 0) {
+    int loaded_version = gladLoadGL(glfwGetProcAddress);
+    if (loaded_version == 0) {
         glfwTerminate();
         return std::unexpected("failed to init glad");
     }
+    gl_state::install();
     glViewport(0, 0, width, height);
 
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LESS);
-    glEnable(GL_STENCIL_TEST);
-    glEnable(GL_MULTISAMPLE);
+    gl_state::set_capability(GL_DEPTH_TEST, true);
+    gl_state::depth_func(GL_LESS);
+    gl_state::set_capability(GL_STENCIL_TEST, true);
+    gl_state::set_capability(GL_MULTISAMPLE, true);
 
     stbi_set_flip_vertically_on_load(true);
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-    return window;
+    return glfw_window_t{
+        .window  = window,
+        .version = {GLAD_VERSION_MAJOR(loaded_version), GLAD_VERSION_MINOR(loaded_version)},
+    };
 }
 
 static std::expected<void, std::string> init_imgui(GLFWwindow *w) {
@@ -59,21 +79,24 @@ static std::expected<void, std::string> init_imgui(GLFWwindow *w) {
     return {};
 }
 
-std::expected<GLContext, std::string> GLContext::create(int width, int height, const char *title) {
-    auto window = init_glfw(width, height, title);
+std::expected<GLContext, std::string>
+GLContext::create(int width, int height, const char *title, gl_version_t version) {
+    auto window = init_glfw(width, height, title, version);
     if (!window) {
         return std::unexpected(window.error());
     }
-    auto imgui_res = init_imgui(*window);
+    auto imgui_res = init_imgui(window->window);
     if (!imgui_res) {
         glfwTerminate();
         return std::unexpected(imgui_res.error());
     }
-    return GLContext{*window};
+    return GLContext{window->window, window->version};
 }
 
 GLContext::~GLContext() {
     if (!m_window) return;
+    // Cached textures nobody holds any more must go while their context still exists.
+    default_asset_cache().drop_unused();
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
@@ -81,19 +104,22 @@ GLContext::~GLContext() {
     glfwTerminate();
 }
 
-GLContext::GLContext(GLContext &&other) noexcept : m_window(other.m_window) {
+GLContext::GLContext(GLContext &&other) noexcept
+    : m_window(other.m_window), m_version(other.m_version) {
     other.m_window = nullptr;
 }
 
 GLContext &GLContext::operator=(GLContext &&other) noexcept {
     if (this != &other) {
         if (m_window) {
+            default_asset_cache().drop_unused();
             ImGui_ImplOpenGL3_Shutdown();
             ImGui_ImplGlfw_Shutdown();
             ImGui::DestroyContext();
             glfwTerminate();
         }
         m_window       = other.m_window;
+        m_version      = other.m_version;
         other.m_window = nullptr;
     }
     return *this;
@@ -0,0 +1,373 @@
+#include "common/gl_state.hpp"
+
+#include <array>
+#include <optional>
+#include <tuple>
+
+namespace gl_state {
+namespace {
+
+constexpr std::array<GLenum, 7> tracked_capabilities{
+    GL_BLEND,        GL_CULL_FACE,   GL_DEPTH_TEST,       GL_STENCIL_TEST,
+    GL_SCISSOR_TEST, GL_MULTISAMPLE, GL_FRAMEBUFFER_SRGB,
+};
+
+// std::nullopt means unknown: the next call is always issued.
+struct shadow_t {
+    std::optional<id_t>                                          program;
+    std::optional<id_t>                                          vertex_array;
+    std::optional<GLuint>                                        active_unit;
+    std::array<std::optional<id_t>, max_tracked_units>           texture_2d;
+    std::array<std::optional<id_t>, max_tracked_units>           texture_cube_map;
+    std::array<std::optional<bool>, tracked_capabilities.size()> capabilities;
+    std::optional<std::tuple<GLenum, GLenum>>                    blend_func;
+    std::optional<GLenum>                                        depth_func;
+    std::optional<bool>                                          depth_mask;
+    std::optional<std::tuple<GLenum, GLint, GLuint>>             stencil_func;
+    std::optional<std::tuple<GLenum, GLenum, GLenum>>            stencil_op;
+    std::optional<GLuint>                                        stencil_mask;
+    std::optional<GLenum>                                        cull_face;
+};
+
+// Driver entry points, captured by install() before the glad pointers are replaced.
+struct driver_t {
+    PFNGLUSEPROGRAMPROC          use_program;
+    PFNGLBINDVERTEXARRAYPROC     bind_vertex_array;
+    PFNGLACTIVETEXTUREPROC       active_texture;
+    PFNGLBINDTEXTUREPROC         bind_texture;
+    PFNGLENABLEPROC              enable;
+    PFNGLDISABLEPROC             disable;
+    PFNGLBLENDFUNCPROC           blend_func;
+    PFNGLDEPTHFUNCPROC           depth_func;
+    PFNGLDEPTHMASKPROC           depth_mask;
+    PFNGLSTENCILFUNCPROC         stencil_func;
+    PFNGLSTENCILOPPROC           stencil_op;
+    PFNGLSTENCILMASKPROC         stencil_mask;
+    PFNGLCULLFACEPROC            cull_face;
+    PFNGLDELETEVERTEXARRAYSPROC  delete_vertex_arrays;
+    PFNGLDELETETEXTURESPROC      delete_textures;
+    PFNGLENABLEIPROC             enable_indexed;
+    PFNGLDISABLEIPROC            disable_indexed;
+    PFNGLBLENDFUNCSEPARATEPROC   blend_func_separate;
+    PFNGLSTENCILFUNCSEPARATEPROC stencil_func_separate;
+    PFNGLSTENCILOPSEPARATEPROC   stencil_op_separate;
+    PFNGLSTENCILMASKSEPARATEPROC stencil_mask_separate;
+};
+
+shadow_t      shadow;
+driver_t      driver;
+stats_t       counters;
+bool          installed  = false;
+bool          caching    = true;
+std::uint64_t generation = 0;
+
+// Issues the call unless the shadow already holds value, then records value.
+template <typename T, typename Issue>
+void apply(std::optional<T> &cached, T const &value, call_counts_t &counts, Issue issue) {
+    if (caching && cached == value) {
+        ++counts.skipped;
+        return;
+    }
+    issue();
+    ++counts.issued;
+    if (caching) cached = value;
+}
+
+std::optional<id_t> *texture_slot(GLuint unit, GLenum target) {
+    if (unit >= max_tracked_units) return nullptr;
+    if (target == GL_TEXTURE_2D) return &shadow.texture_2d[unit];
+    if (target == GL_TEXTURE_CUBE_MAP) return &shadow.texture_cube_map[unit];
+    return nullptr;
+}
+
+std::optional<bool> *capability_slot(GLenum capability) {
+    for (size_t i = 0; i < tracked_capabilities.size(); ++i)
+        if (tracked_capabilities[i] == capability) return &shadow.capabilities[i];
+    return nullptr;
+}
+
+// Replacements for the glad pointers. Deleting a bound object rebinds 0; the *Separate and
+// indexed variants are not cached, they only make the affected shadow entries unknown.
+
+void GLAD_API_PTR use_program_hook(GLuint program) {
+    use_program(program);
+}
+void GLAD_API_PTR bind_vertex_array_hook(GLuint vertex_array) {
+    bind_vertex_array(vertex_array);
+}
+void GLAD_API_PTR active_texture_hook(GLenum texture) {
+    active_texture(texture - GL_TEXTURE0);
+}
+void GLAD_API_PTR bind_texture_hook(GLenum target, GLuint texture) {
+    bind_texture(target, texture);
+}
+void GLAD_API_PTR enable_hook(GLenum capability) {
+    set_capability(capability, true);
+}
+void GLAD_API_PTR disable_hook(GLenum capability) {
+    set_capability(capability, false);
+}
+void GLAD_API_PTR blend_func_hook(GLenum source, GLenum destination) {
+    blend_func(source, destination);
+}
+void GLAD_API_PTR depth_func_hook(GLenum func) {
+    depth_func(func);
+}
+void GLAD_API_PTR depth_mask_hook(GLboolean write) {
+    depth_mask(write == GL_TRUE);
+}
+void GLAD_API_PTR stencil_func_hook(GLenum func, GLint ref, GLuint mask) {
+    stencil_func(func, ref, mask);
+}
+void GLAD_API_PTR stencil_op_hook(GLenum stencil_fail, GLenum depth_fail, GLenum depth_pass) {
+    stencil_op(stencil_fail, depth_fail, depth_pass);
+}
+void GLAD_API_PTR stencil_mask_hook(GLuint mask) {
+    stencil_mask(mask);
+}
+void GLAD_API_PTR cull_face_hook(GLenum mode) {
+    cull_face(mode);
+}
+
+void GLAD_API_PTR delete_vertex_arrays_hook(GLsizei count, GLuint const *vertex_arrays) {
+    driver.delete_vertex_arrays(count, vertex_arrays);
+    for (GLsizei i = 0; i < count; ++i)
+        if (shadow.vertex_array == vertex_arrays[i]) shadow.vertex_array = 0;
+}
+
+void GLAD_API_PTR delete_textures_hook(GLsizei count, GLuint const *textures) {
+    driver.delete_textures(count, textures);
+    for (GLsizei i = 0; i < count; ++i) {
+        for (auto &bound : shadow.texture_2d)
+            if (bound == textures[i]) bound = 0;
+        for (auto &bound : shadow.texture_cube_map)
+            if (bound == textures[i]) bound = 0;
+    }
+}
+
+void GLAD_API_PTR enable_indexed_hook(GLenum capability, GLuint index) {
+    driver.enable_indexed(capability, index);
+    if (auto *slot = capability_slot(capability)) slot->reset();
+}
+void GLAD_API_PTR disable_indexed_hook(GLenum capability, GLuint index) {
+    driver.disable_indexed(capability, index);
+    if (auto *slot = capability_slot(capability)) slot->reset();
+}
+void GLAD_API_PTR blend_func_separate_hook(
+    GLenum source_rgb, GLenum destination_rgb, GLenum source_alpha, GLenum destination_alpha
+) {
+    driver.blend_func_separate(source_rgb, destination_rgb, source_alpha, destination_alpha);
+    shadow.blend_func.reset();
+}
+void GLAD_API_PTR stencil_func_separate_hook(GLenum face, GLenum func, GLint ref, GLuint mask) {
+    driver.stencil_func_separate(face, func, ref, mask);
+    shadow.stencil_func.reset();
+}
+void GLAD_API_PTR stencil_op_separate_hook(
+    GLenum face, GLenum stencil_fail, GLenum depth_fail, GLenum depth_pass
+) {
+    driver.stencil_op_separate(face, stencil_fail, depth_fail, depth_pass);
+    shadow.stencil_op.reset();
+}
+void GLAD_API_PTR stencil_mask_separate_hook(GLenum face, GLuint mask) {
+    driver.stencil_mask_separate(face, mask);
+    shadow.stencil_mask.reset();
+}
+
+} // namespace
+
+void install() {
+    if (installed) return;
+    driver = {
+        .use_program           = glad_glUseProgram,
+        .bind_vertex_array     = glad_glBindVertexArray,
+        .active_texture        = glad_glActiveTexture,
+        .bind_texture          = glad_glBindTexture,
+        .enable                = glad_glEnable,
+        .disable               = glad_glDisable,
+        .blend_func            = glad_glBlendFunc,
+        .depth_func            = glad_glDepthFunc,
+        .depth_mask            = glad_glDepthMask,
+        .stencil_func          = glad_glStencilFunc,
+        .stencil_op            = glad_glStencilOp,
+        .stencil_mask          = glad_glStencilMask,
+        .cull_face             = glad_glCullFace,
+        .delete_vertex_arrays  = glad_glDeleteVertexArrays,
+        .delete_textures       = glad_glDeleteTextures,
+        .enable_indexed        = glad_glEnablei,
+        .disable_indexed       = glad_glDisablei,
+        .blend_func_separate   = glad_glBlendFuncSeparate,
+        .stencil_func_separate = glad_glStencilFuncSeparate,
+        .stencil_op_separate   = glad_glStencilOpSeparate,
+        .stencil_mask_separate = glad_glStencilMaskSeparate,
+    };
+    glad_glUseProgram          = use_program_hook;
+    glad_glBindVertexArray     = bind_vertex_array_hook;
+    glad_glActiveTexture       = active_texture_hook;
+    glad_glBindTexture         = bind_texture_hook;
+    glad_glEnable              = enable_hook;
+    glad_glDisable             = disable_hook;
+    glad_glBlendFunc           = blend_func_hook;
+    glad_glDepthFunc           = depth_func_hook;
+    glad_glDepthMask           = depth_mask_hook;
+    glad_glStencilFunc         = stencil_func_hook;
+    glad_glStencilOp           = stencil_op_hook;
+    glad_glStencilMask         = stencil_mask_hook;
+    glad_glCullFace            = cull_face_hook;
+    glad_glDeleteVertexArrays  = delete_vertex_arrays_hook;
+    glad_glDeleteTextures      = delete_textures_hook;
+    glad_glEnablei             = enable_indexed_hook;
+    glad_glDisablei            = disable_indexed_hook;
+    glad_glBlendFuncSeparate   = blend_func_separate_hook;
+    glad_glStencilFuncSeparate = stencil_func_separate_hook;
+    glad_glStencilOpSeparate   = stencil_op_separate_hook;
+    glad_glStencilMaskSeparate = stencil_mask_separate_hook;
+
+    // A fresh context is in the GL default state, but install() may run later than that.
+    shadow    = {};
+    installed = true;
+}
+
+void set_enabled(bool enabled) {
+    caching = enabled;
+    shadow  = {};
+    ++generation;
+}
+
+bool enabled() {
+    return caching;
+}
+
+void invalidate() {
+    shadow = {};
+    ++generation;
+}
+
+std::uint64_t epoch() {
+    return generation;
+}
+
+void use_program(id_t program) {
+    if (!installed) return glUseProgram(program);
+    apply(shadow.program, program, counters.program, [&] { driver.use_program(program); });
+}
+
+void bind_vertex_array(id_t vertex_array) {
+    if (!installed) return glBindVertexArray(vertex_array);
+    apply(shadow.vertex_array, vertex_array, counters.vertex_array, [&] {
+        driver.bind_vertex_array(vertex_array);
+    });
+}
+
+void active_texture(GLuint unit) {
+    if (!installed) return glActiveTexture(GL_TEXTURE0 + unit);
+    apply(shadow.active_unit, unit, counters.active_texture, [&] {
+        driver.active_texture(GL_TEXTURE0 + unit);
+    });
+}
+
+void bind_texture(GLenum target, id_t texture) {
+    if (!installed) return glBindTexture(target, texture);
+    if (!shadow.active_unit) {
+        driver.bind_texture(target, texture);
+        ++counters.texture.issued;
+        return;
+    }
+    auto *slot = texture_slot(*shadow.active_unit, target);
+    if (!slot) {
+        driver.bind_texture(target, texture);
+        ++counters.texture.issued;
+        return;
+    }
+    apply(*slot, texture, counters.texture, [&] { driver.bind_texture(target, texture); });
+}
+
+void bind_texture(GLuint unit, GLenum target, id_t texture) {
+    if (installed && caching) {
+        // Already bound: neither the unit switch nor the bind is needed.
+        auto *slot = texture_slot(unit, target);
+        if (slot && *slot == texture) {
+            ++counters.texture.skipped;
+            return;
+        }
+    }
+    active_texture(unit);
+    bind_texture(target, texture);
+}
+
+void set_capability(GLenum capability, bool on) {
+    if (!installed) return on ? glEnable(capability) : glDisable(capability);
+    auto const issue = [&] { on ? driver.enable(capability) : driver.disable(capability); };
+    if (auto *slot = capability_slot(capability)) {
+        apply(*slot, on, counters.capability, issue);
+    } else {
+        issue();
+        ++counters.capability.issued;
+    }
+}
+
+void blend_func(GLenum source, GLenum destination) {
+    if (!installed) return glBlendFunc(source, destination);
+    apply(shadow.blend_func, std::tuple{source, destination}, counters.blend, [&] {
+        driver.blend_func(source, destination);
+    });
+}
+
+void depth_func(GLenum func) {
+    if (!installed) return glDepthFunc(func);
+    apply(shadow.depth_func, func, counters.depth, [&] { driver.depth_func(func); });
+}
+
+void depth_mask(bool write) {
+    if (!installed) return glDepthMask(write ? GL_TRUE : GL_FALSE);
+    apply(shadow.depth_mask, write, counters.depth, [&] {
+        driver.depth_mask(write ? GL_TRUE : GL_FALSE);
+    });
+}
+
+void stencil_func(GLenum func, GLint ref, GLuint mask) {
+    if (!installed) return glStencilFunc(func, ref, mask);
+    apply(shadow.stencil_func, std::tuple{func, ref, mask}, counters.stencil, [&] {
+        driver.stencil_func(func, ref, mask);
+    });
+}
+
+void stencil_op(GLenum stencil_fail, GLenum depth_fail, GLenum depth_pass) {
+    if (!installed) return glStencilOp(stencil_fail, depth_fail, depth_pass);
+    apply(
+        shadow.stencil_op, std::tuple{stencil_fail, depth_fail, depth_pass}, counters.stencil,
+        [&] { driver.stencil_op(stencil_fail, depth_fail, depth_pass); }
+    );
+}
+
+void stencil_mask(GLuint mask) {
+    if (!installed) return glStencilMask(mask);
+    apply(shadow.stencil_mask, mask, counters.stencil, [&] { driver.stencil_mask(mask); });
+}
+
+void cull_face(GLenum mode) {
+    if (!installed) return glCullFace(mode);
+    apply(shadow.cull_face, mode, counters.cull, [&] { driver.cull_face(mode); });
+}
+
+stats_t &stats() {
+    return counters;
+}
+
+void reset_stats() {
+    counters = {};
+}
+
+call_counts_t totals() {
+    call_counts_t sum;
+    for (auto const *counts :
+         {&counters.program, &counters.vertex_array, &counters.active_texture, &counters.texture,
+          &counters.capability, &counters.blend, &counters.depth, &counters.stencil, &counters.cull,
+          &counters.sampler}) {
+        sum.issued += counts->issued;
+        sum.skipped += counts->skipped;
+    }
+    return sum;
+}
+
+} // namespace gl_state
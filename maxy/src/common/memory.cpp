@@ -0,0 +1,50 @@
+#include <format>
+
+#include "common/asset_cache.hpp"
+#include "common/gl_state.hpp"
+#include "common/memory.hpp"
+#include "common/model.hpp"
+
+size_t texture_memory(id_t texture) {
+    GLint width, height, format;
+    gl_state::bind_texture(GL_TEXTURE_2D, texture);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &format);
+    size_t const texel  = format == GL_RED || format == GL_R8 ? 1 : 4;
+    size_t const level0 = static_cast<size_t>(width) * static_cast<size_t>(height) * texel;
+    return level0 + level0 / 3;
+}
+
+static void append_model(std::string &out, int indent, std::string_view name, const Model &model) {
+    append_memory_line(out, indent, std::format("model {}", name), model.memory());
+    for (size_t i = 0; i < model.meshes().size(); ++i) {
+        auto const &mesh  = model.meshes()[i];
+        auto const  label = std::format(
+            "mesh {} ({} vertices, {} indices)", i, mesh.vertex_count(), mesh.index_count()
+        );
+        append_memory_line(out, indent + 2, label, mesh.memory());
+    }
+}
+
+std::string memory_report(std::string_view name, const Model &model) {
+    std::string out;
+    append_model(out, 0, name, model);
+    return out;
+}
+
+std::string memory_report(const AssetCache &cache) {
+    std::string    out;
+    memory_usage_t total;
+    for (auto const &entry : cache.entries()) {
+        if (entry.model) {
+            append_model(out, 2, entry.key, *entry.model);
+        } else {
+            auto const label = std::format("texture {}", entry.key);
+            append_memory_line(out, 2, label, {.cpu = 0, .gpu = entry.vram});
+        }
+        total += {.cpu = entry.ram, .gpu = entry.vram};
+    }
+    append_memory_line(out, 0, "asset cache total", total);
+    return out;
+}
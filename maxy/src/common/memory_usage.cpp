@@ -0,0 +1,15 @@
+#include "common/memory_usage.hpp"
+
+#include <format>
+#include <iterator>
+
+static double to_kib(size_t bytes) {
+    return static_cast<double>(bytes) / 1024.;
+}
+
+void append_memory_line(std::string &out, int indent, std::string_view name, memory_usage_t usage) {
+    std::format_to(
+        std::back_inserter(out), "{:{}}{:<{}} cpu {:>10.1f} KiB  gpu {:>10.1f} KiB\n", "",
+        indent, name, 48 - indent, to_kib(usage.cpu), to_kib(usage.gpu)
+    );
+}
@@ -3,7 +3,29 @@
 #include <format>
 #include <iostream>
 
-void Mesh::setup_mesh() {
+#include "common/gl_state.hpp"
+
+constexpr size_t first_texture_number = 1;
+
+struct texture_counters_t {
+    size_t diffuse;
+    size_t specular;
+    size_t height;
+    size_t ambient;
+};
+
+static std::string material_uniform_name(std::string_view type, texture_counters_t &counters) {
+    if (type == texture_type_diffuse) return std::format("{}{}", type, counters.diffuse++);
+    if (type == texture_type_specular) return std::format("{}{}", type, counters.specular++);
+    if (type == texture_type_height) return std::format("{}{}", type, counters.height++);
+    if (type == texture_type_ambient) return std::format("{}{}", type, counters.ambient++);
+    return std::string(type);
+}
+
+void Mesh::setup_mesh(bool retain_cpu_copy) {
+    m_vertex_count = m_vertices.size();
+    m_index_count  = m_indices.size();
+
     glGenVertexArrays(1, &m_vertex_array);
     glGenBuffers(1, &m_vertex_buffer);
     glGenBuffers(1, &m_element_buffer);
@@ -29,59 +51,74 @@ void Mesh::setup_mesh() {
         reinterpret_cast<void *>(offsetof(Vertex, tex_coords))
     );
     glBindVertexArray(0);
+
+    // The names only depend on the texture list, so they are built once instead of per draw.
+    texture_counters_t counters{
+        first_texture_number, first_texture_number, first_texture_number, first_texture_number
+    };
+    m_sampler_names.reserve(m_textures.size());
+    for (auto const &texture : m_textures)
+        m_sampler_names.push_back(material_uniform_name(texture.type, counters));
+
+    if (!retain_cpu_copy) {
+        // GL_STATIC_DRAW has its own copy now; swapping frees the storage, clear() would not.
+        std::vector<Vertex>().swap(m_vertices);
+        std::vector<unsigned int>().swap(m_indices);
+    }
 }
 
-constexpr size_t first_texture_number = 1;
+template <typename T> static std::vector<T> read_buffer(id_t buffer, size_t count) {
+    std::vector<T> data(count);
+    // The copy target is not part of the vertex array state, unlike GL_ELEMENT_ARRAY_BUFFER.
+    glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+    glGetBufferSubData(
+        GL_COPY_READ_BUFFER, 0, static_cast<GLsizeiptr>(count * sizeof(T)), data.data()
+    );
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    return data;
+}
 
-struct texture_counters_t {
-    size_t diffuse;
-    size_t specular;
-    size_t height;
-    size_t ambient;
-};
+std::vector<Vertex> Mesh::read_vertices() const {
+    if (m_vertices.size() == m_vertex_count) return m_vertices;
+    return read_buffer<Vertex>(m_vertex_buffer, m_vertex_count);
+}
 
-static std::string material_uniform_name(std::string_view type, texture_counters_t &counters) {
-    if (type == texture_type_diffuse) return std::format("{}{}", type, counters.diffuse++);
-    if (type == texture_type_specular) return std::format("{}{}", type, counters.specular++);
-    if (type == texture_type_height) return std::format("{}{}", type, counters.height++);
-    if (type == texture_type_ambient) return std::format("{}{}", type, counters.ambient++);
-    return std::string(type);
+std::vector<unsigned int> Mesh::read_indices() const {
+    if (m_indices.size() == m_index_count) return m_indices;
+    return read_buffer<unsigned int>(m_element_buffer, m_index_count);
 }
 
-void Mesh::draw(Shader &shader) {
-    texture_counters_t counters{
-        first_texture_number, first_texture_number, first_texture_number, first_texture_number
+memory_usage_t Mesh::memory() const {
+    return {
+        .cpu = m_vertices.capacity() * sizeof(Vertex) +
+               m_indices.capacity() * sizeof(unsigned int),
+        .gpu = m_vertex_count * sizeof(Vertex) + m_index_count * sizeof(unsigned int),
     };
+}
+
+void Mesh::bind(Shader &shader) {
     for (size_t i = 0; i < m_textures.size(); ++i) {
-        glActiveTexture(GL_TEXTURE0 + i);
-        shader.set_int(material_uniform_name(m_textures[i].type, counters), i);
-        glBindTexture(GL_TEXTURE_2D, m_textures[i].id);
+        shader.set_sampler(m_sampler_names[i], static_cast<int>(i));
+        gl_state::bind_texture(static_cast<GLuint>(i), GL_TEXTURE_2D, m_textures[i].id);
     }
-    glActiveTexture(GL_TEXTURE0);
+    gl_state::active_texture(0);
+    gl_state::bind_vertex_array(m_vertex_array);
+}
 
-    glBindVertexArray(m_vertex_array);
-    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_indices.size()), GL_UNSIGNED_INT, 0);
+void Mesh::draw(Shader &shader) {
+    bind(shader);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_index_count), GL_UNSIGNED_INT, 0);
 }
 
 void Mesh::draw_instanced(Shader &shader, int amount) {
-    texture_counters_t counters{
-        first_texture_number, first_texture_number, first_texture_number, first_texture_number
-    };
-    for (size_t i = 0; i < m_textures.size(); ++i) {
-        glActiveTexture(GL_TEXTURE0 + i);
-        shader.set_int(material_uniform_name(m_textures[i].type, counters), i);
-        glBindTexture(GL_TEXTURE_2D, m_textures[i].id);
-    }
-    glActiveTexture(GL_TEXTURE0);
-
-    glBindVertexArray(m_vertex_array);
+    bind(shader);
     glDrawElementsInstanced(
-        GL_TRIANGLES, static_cast<GLsizei>(m_indices.size()), GL_UNSIGNED_INT, 0, amount
+        GL_TRIANGLES, static_cast<GLsizei>(m_index_count), GL_UNSIGNED_INT, 0, amount
     );
 }
 
 void Mesh::set_instance_model_transform(id_t layout_id) {
-    glBindVertexArray(m_vertex_array);
+    gl_state::bind_vertex_array(m_vertex_array);
     // set attribute pointers for matrix (4 times vec4)
     glEnableVertexAttribArray(layout_id);
     glVertexAttribPointer(
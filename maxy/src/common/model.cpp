@@ -1,29 +1,33 @@
 #include <filesystem>
 #include <format>
-#include <unordered_map>
 
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
+#include <glm/gtc/type_ptr.hpp>
 
+#include "common/asset_cache.hpp"
 #include "common/assets.hpp"
 #include "common/mesh.hpp"
 #include "common/model.hpp"
 
 namespace fs = std::filesystem;
 
-std::unordered_map<std::string, Texture> Model::m_textures_loaded;
-
 struct ModelLoader {
-    std::vector<Mesh>                         meshes;
-    fs::path                                  directory;
-    std::unordered_map<std::string, Texture> &textures_loaded;
+    std::vector<Mesh>      meshes;
+    scene_graph_t          nodes;
+    std::vector<node_id_t> mesh_nodes;
+    fs::path               directory;
+    AssetCache            &cache;
+    TextureStreamer       *streamer;
+    bool                   retain_cpu_copy;
 
-    explicit ModelLoader(std::unordered_map<std::string, Texture> &cache)
-        : textures_loaded(cache) {}
+    ModelLoader(AssetCache &cache, TextureStreamer *streamer, bool retain_cpu_copy)
+        : cache(cache), streamer(streamer), retain_cpu_copy(retain_cpu_copy) {}
 
     std::expected<void, std::string> load(const std::string &path);
-    std::expected<void, std::string> process_node(aiNode *node, const aiScene *scene);
+    std::expected<void, std::string>
+    process_node(aiNode *node, const aiScene *scene, node_id_t parent);
     std::expected<Mesh, std::string> process_mesh(aiMesh *mesh, const aiScene *scene);
     std::expected<std::vector<Texture>, std::string>
     load_material_textures(aiMaterial *material, aiTextureType type, std::string_view name);
@@ -35,19 +39,43 @@ void Model::draw(Shader &shader) {
     }
 }
 
+void Model::draw(Shader &shader, const glm::mat4 &model) {
+    m_nodes.update();
+    for (size_t i = 0; i < m_meshes.size(); ++i) {
+        shader.set_mat4(
+            "model", i < m_mesh_nodes.size() ? model * m_nodes.world(m_mesh_nodes[i]) : model
+        );
+        m_meshes[i].draw(shader);
+    }
+}
+
 void Model::draw_instanced(Shader &shader, int amount) {
     for (auto &mesh : m_meshes) {
         mesh.draw_instanced(shader, amount);
     }
 }
 
-std::expected<Model, std::string> Model::load(const std::string &path) {
-    ModelLoader loader{m_textures_loaded};
+memory_usage_t Model::memory() const {
+    memory_usage_t usage;
+    for (auto const &mesh : m_meshes)
+        usage += mesh.memory();
+    return usage;
+}
+
+std::expected<Model, std::string>
+Model::load(const std::string &path, TextureStreamer *streamer, bool retain_cpu_copy) {
+    return load(path, default_asset_cache(), streamer, retain_cpu_copy);
+}
+
+std::expected<Model, std::string> Model::load(
+    const std::string &path, AssetCache &cache, TextureStreamer *streamer, bool retain_cpu_copy
+) {
+    ModelLoader loader{cache, streamer, retain_cpu_copy};
     auto        load_res = loader.load(path);
     if (!load_res) {
         return std::unexpected(load_res.error());
     }
-    return Model{std::move(loader.meshes)};
+    return Model{std::move(loader.meshes), std::move(loader.nodes), std::move(loader.mesh_nodes)};
 }
 
 std::expected<void, std::string> ModelLoader::load(const std::string &path) {
@@ -61,10 +89,17 @@ std::expected<void, std::string> ModelLoader::load(const std::string &path) {
     if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
         return std::unexpected(std::format("assimp: {}", importer.GetErrorString()));
     }
-    return process_node(scene->mRootNode, scene);
+    return process_node(scene->mRootNode, scene, no_node);
+}
+
+// aiMatrix4x4 is row-major, glm column-major.
+static glm::mat4 to_glm(const aiMatrix4x4 &m) {
+    return glm::transpose(glm::make_mat4(&m.a1));
 }
 
-std::expected<void, std::string> ModelLoader::process_node(aiNode *node, const aiScene *scene) {
+std::expected<void, std::string>
+ModelLoader::process_node(aiNode *node, const aiScene *scene, node_id_t parent) {
+    const node_id_t id = nodes.add(parent, to_glm(node->mTransformation));
     for (size_t i = 0; i < node->mNumMeshes; ++i) {
         aiMesh *mesh           = scene->mMeshes[node->mMeshes[i]];
         auto    processed_mesh = process_mesh(mesh, scene);
@@ -72,9 +107,10 @@ std::expected<void, std::string> ModelLoader::process_node(aiNode *node, const a
             return std::unexpected(std::format("mesh[{}]: {}", i, processed_mesh.error()));
         }
         meshes.push_back(std::move(*processed_mesh));
+        mesh_nodes.push_back(id);
     }
     for (size_t i = 0; i < node->mNumChildren; ++i) {
-        auto result = process_node(node->mChildren[i], scene);
+        auto result = process_node(node->mChildren[i], scene, id);
         if (!result) {
             return std::unexpected(std::format("node[{}]: {}", i, result.error()));
         }
@@ -133,7 +169,7 @@ std::expected<Mesh, std::string> ModelLoader::process_mesh(aiMesh *mesh, const a
         }
         textures.insert(textures.end(), ambient_maps->begin(), ambient_maps->end());
     }
-    return Mesh(std::move(vertices), std::move(indices), std::move(textures));
+    return Mesh(std::move(vertices), std::move(indices), std::move(textures), retain_cpu_copy);
 }
 
 std::expected<std::vector<Texture>, std::string> ModelLoader::load_material_textures(
@@ -144,18 +180,13 @@ std::expected<std::vector<Texture>, std::string> ModelLoader::load_material_text
         aiString str;
         material->GetTexture(type, i, &str);
 
-        std::string path = str.C_Str();
-        auto        it   = textures_loaded.find(path);
-        if (it != textures_loaded.end()) {
-            textures.push_back(it->second);
-        } else {
-            auto id = load_texture(str.C_Str(), directory.string());
-            if (!id) {
-                return std::unexpected(std::format("image {}: {}", path, id.error()));
-            }
-            Texture tex{.id = *id, .type = std::string(name)};
-            textures.push_back(textures_loaded.emplace(path, tex).first->second);
+        // Relative to the model, so the cache sees the file and not just its name.
+        auto asset =
+            cache.texture((directory / str.C_Str()).string(), DEFAULT_TEXTURE_OPTIONS, streamer);
+        if (!asset) {
+            return std::unexpected(std::format("image {}: {}", str.C_Str(), asset.error()));
         }
+        textures.push_back({.id = (*asset)->id, .type = std::string(name), .asset = *asset});
     }
     return textures;
 }
@@ -0,0 +1,235 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <format>
+#include <unordered_map>
+
+#include "common/gl_state.hpp"
+#include "common/model_batch.hpp"
+
+struct texture_layers_t {
+    std::vector<id_t>                sources; // one GL_TEXTURE_2D per layer
+    std::unordered_map<id_t, GLuint> layer_of;
+};
+
+// First diffuse texture of a mesh, or 0 when it has none.
+static id_t diffuse_texture(const Mesh &mesh) {
+    for (const auto &texture : mesh.textures())
+        if (texture.type == texture_type_diffuse) return texture.id;
+    return 0;
+}
+
+// Copies every source texture into one layer of a new GL_TEXTURE_2D_ARRAY, scaled to the size of
+// the largest one with a framebuffer blit, then builds the mip chain. Meshes without a diffuse
+// texture sample layer 0, which is plain white when no mesh has one.
+static std::expected<id_t, std::string> build_texture_array(const texture_layers_t &layers) {
+    GLint width  = 1;
+    GLint height = 1;
+    for (id_t source : layers.sources) {
+        GLint w, h;
+        gl_state::bind_texture(GL_TEXTURE_2D, source);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &w);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &h);
+        width  = std::max(width, w);
+        height = std::max(height, h);
+    }
+    auto const layer_count = static_cast<GLsizei>(std::max<size_t>(layers.sources.size(), 1));
+    auto const levels      = static_cast<GLsizei>(
+        std::bit_width(static_cast<unsigned>(std::max(width, height)))
+    );
+
+    id_t array;
+    glGenTextures(1, &array);
+    gl_state::bind_texture(GL_TEXTURE_2D_ARRAY, array);
+    glTexStorage3D(GL_TEXTURE_2D_ARRAY, levels, GL_RGBA8, width, height, layer_count);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    if (layers.sources.empty()) {
+        constexpr std::array<unsigned char, 4> white{255, 255, 255, 255};
+        glTexSubImage3D(
+            GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0, 1, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, white.data()
+        );
+        return array;
+    }
+
+    GLint read_framebuffer, draw_framebuffer;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &read_framebuffer);
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &draw_framebuffer);
+
+    std::array<id_t, 2> framebuffers;
+    glGenFramebuffers(framebuffers.size(), framebuffers.data());
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffers[0]);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffers[1]);
+
+    std::string error;
+    for (size_t layer = 0; layer < layers.sources.size(); ++layer) {
+        GLint w, h;
+        id_t  source = layers.sources[layer];
+        gl_state::bind_texture(GL_TEXTURE_2D, source);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &w);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &h);
+        glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, source, 0);
+        glFramebufferTextureLayer(
+            GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, array, 0, static_cast<GLint>(layer)
+        );
+        if (glCheckFramebufferStatus(GL_READ_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE ||
+            glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            error = std::format("texture {} cannot be copied into the texture array", source);
+            break;
+        }
+        glBlitFramebuffer(0, 0, w, h, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    }
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, read_framebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, draw_framebuffer);
+    glDeleteFramebuffers(framebuffers.size(), framebuffers.data());
+    if (!error.empty()) {
+        glDeleteTextures(1, &array);
+        return std::unexpected(error);
+    }
+
+    gl_state::bind_texture(GL_TEXTURE_2D_ARRAY, array);
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    return array;
+}
+
+std::expected<ModelBatch, std::string> ModelBatch::create(std::span<const Model *const> models) {
+    ModelBatch batch;
+
+    texture_layers_t            layers;
+    std::vector<batch_vertex_t> vertices;
+    std::vector<unsigned int>   indices;
+    for (const Model *model : models) {
+        batch.m_model_commands.push_back({.first = batch.m_commands.size(), .count = 0});
+        for (const auto &mesh : model->meshes()) {
+            GLuint layer = 0;
+            if (id_t texture = diffuse_texture(mesh)) {
+                auto [it, inserted] = layers.layer_of.try_emplace(
+                    texture, static_cast<GLuint>(layers.sources.size())
+                );
+                if (inserted) layers.sources.push_back(texture);
+                layer = it->second;
+            }
+
+            batch.m_commands.push_back({
+                .count          = static_cast<GLuint>(mesh.index_count()),
+                .instance_count = 1,
+                .first_index    = static_cast<GLuint>(indices.size()),
+                .base_vertex    = static_cast<GLint>(vertices.size()),
+                .base_instance  = 0,
+            });
+            ++batch.m_model_commands.back().count;
+
+            for (const auto &vertex : mesh.read_vertices())
+                vertices.push_back({vertex.position, vertex.normal, vertex.tex_coords, layer});
+            auto const mesh_indices = mesh.read_indices();
+            indices.insert(indices.end(), mesh_indices.begin(), mesh_indices.end());
+        }
+    }
+    if (batch.m_commands.empty()) return std::unexpected("model batch: no meshes");
+
+    auto texture_array = build_texture_array(layers);
+    if (!texture_array) {
+        return std::unexpected(std::format("model batch: {}", texture_array.error()));
+    }
+    batch.m_texture_array = *texture_array;
+
+    glGenVertexArrays(1, &batch.m_vertex_array);
+    glGenBuffers(1, &batch.m_vertex_buffer);
+    glGenBuffers(1, &batch.m_element_buffer);
+    glGenBuffers(1, &batch.m_command_buffer);
+
+    gl_state::bind_vertex_array(batch.m_vertex_array);
+    glBindBuffer(GL_ARRAY_BUFFER, batch.m_vertex_buffer);
+    glBufferData(
+        GL_ARRAY_BUFFER, vertices.size() * sizeof(batch_vertex_t), vertices.data(), GL_STATIC_DRAW
+    );
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch.m_element_buffer);
+    glBufferData(
+        GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(),
+        GL_STATIC_DRAW
+    );
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(
+        0, 3, GL_FLOAT, GL_FALSE, sizeof(batch_vertex_t),
+        reinterpret_cast<void *>(offsetof(batch_vertex_t, position))
+    );
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(
+        1, 3, GL_FLOAT, GL_FALSE, sizeof(batch_vertex_t),
+        reinterpret_cast<void *>(offsetof(batch_vertex_t, normal))
+    );
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(
+        2, 2, GL_FLOAT, GL_FALSE, sizeof(batch_vertex_t),
+        reinterpret_cast<void *>(offsetof(batch_vertex_t, tex_coords))
+    );
+    glEnableVertexAttribArray(layer_location);
+    glVertexAttribIPointer(
+        layer_location, 1, GL_UNSIGNED_INT, sizeof(batch_vertex_t),
+        reinterpret_cast<void *>(offsetof(batch_vertex_t, layer))
+    );
+    gl_state::bind_vertex_array(0);
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, batch.m_command_buffer);
+    glBufferData(
+        GL_DRAW_INDIRECT_BUFFER, batch.m_commands.size() * sizeof(draw_elements_indirect_command_t),
+        nullptr, GL_DYNAMIC_DRAW
+    );
+    std::vector<GLuint> one_each(batch.m_model_commands.size(), 1);
+    batch.set_instance_counts(one_each);
+
+    return batch;
+}
+
+void ModelBatch::release() {
+    glDeleteVertexArrays(1, &m_vertex_array);
+    glDeleteBuffers(1, &m_vertex_buffer);
+    glDeleteBuffers(1, &m_element_buffer);
+    glDeleteBuffers(1, &m_command_buffer);
+    glDeleteTextures(1, &m_texture_array);
+}
+
+void ModelBatch::set_instance_counts(std::span<const GLuint> counts) {
+    GLuint first_instance = 0;
+    for (size_t model = 0; model < m_model_commands.size(); ++model) {
+        GLuint     count = model < counts.size() ? counts[model] : 0;
+        auto const range = m_model_commands[model];
+        for (size_t i = range.first; i < range.first + range.count; ++i) {
+            m_commands[i].instance_count = count;
+            m_commands[i].base_instance  = first_instance;
+        }
+        first_instance += count;
+    }
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_command_buffer);
+    glBufferSubData(
+        GL_DRAW_INDIRECT_BUFFER, 0, m_commands.size() * sizeof(draw_elements_indirect_command_t),
+        m_commands.data()
+    );
+}
+
+void ModelBatch::set_instance_model_transform(id_t layout_id) {
+    gl_state::bind_vertex_array(m_vertex_array);
+    for (id_t column = 0; column < 4; ++column) {
+        glEnableVertexAttribArray(layout_id + column);
+        glVertexAttribPointer(
+            layout_id + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+            reinterpret_cast<void *>(column * sizeof(glm::vec4))
+        );
+        glVertexAttribDivisor(layout_id + column, 1);
+    }
+}
+
+void ModelBatch::draw(Shader &shader) {
+    shader.set_sampler("material_array", 0);
+    gl_state::bind_texture(0, GL_TEXTURE_2D_ARRAY, m_texture_array);
+    gl_state::bind_vertex_array(m_vertex_array);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_command_buffer);
+    glMultiDrawElementsIndirect(
+        GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(m_commands.size()), 0
+    );
+}
@@ -0,0 +1,160 @@
+#include "common/program_cache.hpp"
+
+#include <format>
+#include <fstream>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace program_cache {
+namespace {
+
+constexpr uint32_t file_magic = 0x4250474c; // "LGPB"
+
+// Precedes the binary in every cache file.
+struct file_header_t {
+    uint32_t magic;
+    uint32_t format; // as returned by glGetProgramBinary
+    uint64_t key;
+    uint64_t length;
+};
+
+std::filesystem::path directory = DEFAULT_DIRECTORY;
+bool                  is_enabled = true;
+stats_t               counters{};
+
+bool supported() {
+    if (!GLAD_GL_VERSION_4_1) return false;
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+// FNV-1a, 64 bit.
+constexpr uint64_t fnv_offset = 0xcbf29ce484222325;
+constexpr uint64_t fnv_prime  = 0x100000001b3;
+
+void hash_bytes(uint64_t &hash, std::string_view bytes) {
+    for (unsigned char c : bytes) {
+        hash ^= c;
+        hash *= fnv_prime;
+    }
+    // Separator, so ("ab", "c") and ("a", "bc") differ.
+    hash ^= 0xff;
+    hash *= fnv_prime;
+}
+
+std::string_view gl_string(GLenum name) {
+    auto const *value = reinterpret_cast<const char *>(glGetString(name));
+    return value ? value : "";
+}
+
+std::filesystem::path entry_path(uint64_t key) {
+    return directory / std::format("{:016x}.bin", key);
+}
+
+} // namespace
+
+void set_directory(std::filesystem::path path) {
+    directory = std::move(path);
+}
+
+void set_enabled(bool enabled) {
+    is_enabled = enabled;
+}
+
+bool enabled() {
+    return is_enabled && supported();
+}
+
+uint64_t key(std::span<const shader_source_t> sources) {
+    uint64_t hash = fnv_offset;
+    hash_bytes(hash, gl_string(GL_VENDOR));
+    hash_bytes(hash, gl_string(GL_RENDERER));
+    hash_bytes(hash, gl_string(GL_VERSION));
+    for (auto const &source : sources) {
+        hash_bytes(hash, std::format("{}", source.type));
+        hash_bytes(hash, source.code);
+    }
+    return hash;
+}
+
+std::optional<id_t> load(uint64_t key) {
+    if (!enabled()) {
+        ++counters.misses;
+        return std::nullopt;
+    }
+
+    auto          path = entry_path(key);
+    std::ifstream file(path, std::ios::binary);
+    file_header_t header{};
+    if (!file || !file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        header.magic != file_magic || header.key != key) {
+        ++counters.misses;
+        return std::nullopt;
+    }
+    std::vector<char> binary(header.length);
+    if (!file.read(binary.data(), static_cast<std::streamsize>(binary.size()))) {
+        ++counters.misses;
+        return std::nullopt;
+    }
+
+    id_t program = glCreateProgram();
+    glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+    GLint success = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        glDeleteProgram(program);
+        file.close();
+        std::error_code ignored;
+        std::filesystem::remove(path, ignored);
+        ++counters.rejected;
+        ++counters.misses;
+        return std::nullopt;
+    }
+    ++counters.hits;
+    return program;
+}
+
+void store(uint64_t key, id_t program) {
+    if (!enabled()) return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+    std::vector<char> binary(static_cast<size_t>(length));
+    GLenum            format = 0;
+    glGetProgramBinary(program, length, &length, &format, binary.data());
+
+    // A cache that cannot be written only costs the next launch its speed-up.
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) return;
+    std::ofstream file(entry_path(key), std::ios::binary | std::ios::trunc);
+    file_header_t header{
+        .magic  = file_magic,
+        .format = format,
+        .key    = key,
+        .length = static_cast<uint64_t>(length),
+    };
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(binary.data(), length);
+}
+
+stats_t &stats() {
+    return counters;
+}
+
+void reset_stats() {
+    counters = {};
+}
+
+std::string report() {
+    return std::format(
+        "shader setup: {} programs ({} from the binary cache, {} rejected) in {:.1f} ms",
+        counters.hits + counters.misses, counters.hits, counters.rejected,
+        counters.seconds * 1000.
+    );
+}
+
+} // namespace program_cache
@@ -1,9 +1,14 @@
 #include "common/shader.hpp"
 
-#include <array>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <initializer_list>
 #include <iostream>
+#include <vector>
+
+#include "common/gl_state.hpp"
+#include "common/program_cache.hpp"
 
 namespace fs = std::filesystem;
 
@@ -16,81 +21,82 @@ static std::string_view type_to_view(GLenum type) {
         return "vertex";
     case GL_FRAGMENT_SHADER:
         return "fragment";
+    case GL_GEOMETRY_SHADER:
+        return "geometry";
     default:
         return "unknown";
     }
 }
 
-static compile_shader_res compile_file(std::string_view path, GLenum type) {
-    auto code = read_file(fs::path(path));
-    if (!code) {
-        return std::unexpected(std::format("error reading {}: {}", path, code.error()));
-    }
-    auto object = compile_shader(type, code->c_str());
-    if (!object) {
-        return std::unexpected(std::format("error compiling {}: {}", path, object.error()));
-    }
-    return object;
-}
-
-struct vertex_fragment_shaders_t {
-    id_t vertex;
-    id_t fragment;
+struct shader_stage_t {
+    std::string_view path;
+    GLenum           type;
 };
 
-inline void delete_vertex_fragment_shaders(vertex_fragment_shaders_t shaders) {
-    glDeleteShader(shaders.vertex);
-    glDeleteShader(shaders.fragment);
-}
+// Adds the time until it goes out of scope to program_cache::stats().seconds.
+struct setup_timer_t {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    ~setup_timer_t() {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        program_cache::stats().seconds += elapsed.count();
+    }
+};
 
-inline std::expected<vertex_fragment_shaders_t, std::string>
-build_vertex_fragment(std::string_view vertexPath, std::string_view fragmentPath) {
-    auto vertex = compile_file(vertexPath, GL_VERTEX_SHADER);
-    if (!vertex) return std::unexpected(vertex.error());
+static Shader::build_res build_program(std::initializer_list<shader_stage_t> stages) {
+    setup_timer_t timer;
 
-    auto fragment = compile_file(fragmentPath, GL_FRAGMENT_SHADER);
-    if (!fragment) {
-        glDeleteShader(*vertex);
-        return std::unexpected(fragment.error());
+    std::vector<program_cache::shader_source_t> sources;
+    for (auto const &stage : stages) {
+        auto code = read_file(fs::path(stage.path));
+        if (!code) {
+            return std::unexpected(std::format("error reading {}: {}", stage.path, code.error()));
+        }
+        sources.push_back({.type = stage.type, .code = std::move(*code)});
     }
-    return vertex_fragment_shaders_t{.vertex = *vertex, .fragment = *fragment};
-}
 
-Shader::build_res Shader::build(std::string_view vertexPath, std::string_view fragmentPath) {
-    auto vertex_fragment_shaders = build_vertex_fragment(vertexPath, fragmentPath);
-    if (!vertex_fragment_shaders) return std::unexpected(vertex_fragment_shaders.error());
+    auto const key = program_cache::key(sources);
+    if (auto program = program_cache::load(key)) return Shader(*program);
 
-    const std::array ids{vertex_fragment_shaders->vertex, vertex_fragment_shaders->fragment};
-    auto             program = link_shaders(ids);
-    delete_vertex_fragment_shaders(*vertex_fragment_shaders);
+    std::vector<id_t> objects;
+    auto              delete_objects = [&objects] {
+        for (auto object : objects)
+            glDeleteShader(object);
+    };
+    for (size_t i = 0; i < sources.size(); ++i) {
+        auto object = compile_shader(sources[i].type, sources[i].code.c_str());
+        if (!object) {
+            delete_objects();
+            auto const path = std::data(stages)[i].path;
+            return std::unexpected(std::format("error compiling {}: {}", path, object.error()));
+        }
+        objects.push_back(*object);
+    }
+    auto program = link_shaders(objects);
+    delete_objects();
     if (!program) return std::unexpected(program.error());
 
+    program_cache::store(key, *program);
     return Shader(*program);
 }
+
+Shader::build_res Shader::build(std::string_view vertexPath, std::string_view fragmentPath) {
+    return build_program({
+        {.path = vertexPath, .type = GL_VERTEX_SHADER},
+        {.path = fragmentPath, .type = GL_FRAGMENT_SHADER},
+    });
+}
 Shader::build_res Shader::build(
     std::string_view vertexPath, std::string_view fragmentPath, std::string_view geometryPath
 ) {
-    auto vertex_fragment_shaders = build_vertex_fragment(vertexPath, fragmentPath);
-    if (!vertex_fragment_shaders) return std::unexpected(vertex_fragment_shaders.error());
-
-    auto geometry_shader = compile_file(geometryPath, GL_GEOMETRY_SHADER);
-    if (!geometry_shader) {
-        delete_vertex_fragment_shaders(*vertex_fragment_shaders);
-        return std::unexpected(geometry_shader.error());
-    }
-
-    const std::array ids{
-        vertex_fragment_shaders->vertex, vertex_fragment_shaders->fragment, *geometry_shader
-    };
-    auto program = link_shaders(ids);
-    delete_vertex_fragment_shaders(*vertex_fragment_shaders);
-    glDeleteShader(*geometry_shader);
-
-    return Shader(*program);
+    return build_program({
+        {.path = vertexPath, .type = GL_VERTEX_SHADER},
+        {.path = fragmentPath, .type = GL_FRAGMENT_SHADER},
+        {.path = geometryPath, .type = GL_GEOMETRY_SHADER},
+    });
 }
 
 void Shader::use() {
-    glUseProgram(m_program_id);
+    gl_state::use_program(m_program_id);
 }
 
 void Shader::set_bool(const std::string &name, bool value) const {
@@ -98,6 +104,8 @@ void Shader::set_bool(const std::string &name, bool value) const {
 }
 void Shader::set_int(const std::string &name, int value) const {
     glUniform1i(glGetUniformLocation(m_program_id, name.c_str()), value);
+    // Keep set_sampler's view of the uniform in sync.
+    if (auto it = m_sampler_units.find(name); it != m_sampler_units.end()) it->second = value;
 }
 void Shader::set_float(const std::string &name, float value) const {
     glUniform1f(glGetUniformLocation(m_program_id, name.c_str()), value);
@@ -114,6 +122,24 @@ void Shader::set_mat4(const std::string &name, const glm::mat4 &value) const {
     );
 }
 
+void Shader::set_sampler(const std::string &name, int unit) const {
+    auto &counts = gl_state::stats().sampler;
+    if (m_sampler_epoch != gl_state::epoch()) {
+        m_sampler_units.clear();
+        m_sampler_epoch = gl_state::epoch();
+    }
+    // Recorded even while caching is off, so turning it back on starts from the truth.
+    auto [it, inserted] = m_sampler_units.try_emplace(name, unit);
+    bool const unchanged = !inserted && it->second == unit;
+    it->second           = unit;
+    if (unchanged && gl_state::enabled()) {
+        ++counts.skipped;
+        return;
+    }
+    glUniform1i(glGetUniformLocation(m_program_id, name.c_str()), unit);
+    ++counts.issued;
+}
+
 constexpr int shader_info_log_size = 512;
 
 compile_shader_res compile_shader(GLenum type, const char *source) {
@@ -138,6 +164,8 @@ link_shaders_res link_shaders(std::span<const id_t> shaders) {
     char info_log[shader_info_log_size];
 
     id_t program = glCreateProgram();
+    if (program_cache::enabled())
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     for (auto shader : shaders) {
         glAttachShader(program, shader);
     }
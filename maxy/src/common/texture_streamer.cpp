@@ -0,0 +1,207 @@
+#include <array>
+#include <cstring>
+#include <format>
+#include <iostream>
+
+#include "common/gl_state.hpp"
+#include "common/texture_streamer.hpp"
+
+// Shown until the real image is uploaded.
+constexpr std::array<unsigned char, 4> placeholder_texel{128, 128, 128, 255};
+
+static GLenum internal_format_for(GLenum format, const texture_options_t &options) {
+    if (options.gamma_correction && format == GL_RGB) return GL_SRGB;
+    if (options.gamma_correction && format == GL_RGBA) return GL_SRGB_ALPHA;
+    return format;
+}
+
+TextureStreamer::TextureStreamer(texture_streamer_options_t options) : m_options(options) {
+    bool const persistent = GLAD_GL_VERSION_4_4;
+    m_staging.resize(m_options.staging_buffers);
+    for (auto &staging : m_staging) {
+        glGenBuffers(1, &staging.buffer);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging.buffer);
+        if (persistent) {
+            GLbitfield const flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glBufferStorage(
+                GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(m_options.staging_size), nullptr,
+                flags
+            );
+            staging.mapped = glMapBufferRange(
+                GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(m_options.staging_size), flags
+            );
+            // The buffer still works mapped per upload, like on contexts before 4.4.
+            if (!staging.mapped)
+                std::cerr << std::format(
+                    "texture streamer: persistent glMapBufferRange failed ({:#x})\n", glGetError()
+                );
+        } else {
+            glBufferData(
+                GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(m_options.staging_size), nullptr,
+                GL_STREAM_DRAW
+            );
+            staging.mapped = nullptr;
+        }
+        staging.fence = nullptr;
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    for (unsigned i = 0; i < m_options.worker_count; ++i) {
+        m_workers.emplace_back([this](std::stop_token stop) { decode_loop(stop); });
+    }
+}
+
+TextureStreamer::~TextureStreamer() {
+    for (auto &worker : m_workers)
+        worker.request_stop();
+    m_workers.clear();
+
+    for (auto &staging : m_staging) {
+        if (staging.fence) glDeleteSync(staging.fence);
+        if (staging.mapped) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging.buffer);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        }
+        glDeleteBuffers(1, &staging.buffer);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+std::expected<id_t, std::string>
+TextureStreamer::load(const std::string &filename, const texture_options_t &options) {
+    // Resolve the path now so a missing file fails here, like load_texture does.
+    auto path = get_asset_path(filename);
+    if (!path) return std::unexpected(path.error());
+
+    id_t texture;
+    glGenTextures(1, &texture);
+    gl_state::bind_texture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, options.wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, options.wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexImage2D(
+        GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, placeholder_texel.data()
+    );
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    {
+        std::lock_guard lock(m_mutex);
+        m_requests.push_back({.texture = texture, .path = filename, .options = options});
+    }
+    m_requests_ready.notify_one();
+    ++m_in_flight;
+    return texture;
+}
+
+void TextureStreamer::decode_loop(std::stop_token stop) {
+    while (true) {
+        request_t request;
+        {
+            std::unique_lock lock(m_mutex);
+            if (!m_requests_ready.wait(lock, stop, [this] { return !m_requests.empty(); })) return;
+            request = std::move(m_requests.front());
+            m_requests.pop_front();
+        }
+
+        auto image = load_image(request.path);
+
+        std::lock_guard lock(m_mutex);
+        m_decoded.push_back(
+            {.texture = request.texture, .options = request.options, .image = std::move(image)}
+        );
+    }
+}
+
+TextureStreamer::staging_t *TextureStreamer::acquire_staging(size_t size) {
+    if (size > m_options.staging_size || m_staging.empty()) return nullptr;
+
+    // Ring order: the next buffer is the one used longest ago, so the most likely to be free.
+    auto &staging = m_staging[m_next_staging];
+    if (staging.fence) {
+        if (glClientWaitSync(staging.fence, 0, 0) == GL_TIMEOUT_EXPIRED) return nullptr;
+        glDeleteSync(staging.fence);
+        staging.fence = nullptr;
+    }
+    m_next_staging = (m_next_staging + 1) % m_staging.size();
+    return &staging;
+}
+
+void TextureStreamer::upload(decoded_t &decoded) {
+    --m_in_flight;
+    if (!decoded.image) {
+        std::cerr << std::format("texture streamer: {}\n", decoded.image.error());
+        return;
+    }
+    auto const &image  = *decoded.image;
+    auto        format = guess_format(image);
+    if (!format) {
+        std::cerr << std::format("texture streamer: {}\n", format.error());
+        return;
+    }
+    auto const size = static_cast<size_t>(image.width) * image.height * image.channel_count;
+
+    gl_state::bind_texture(GL_TEXTURE_2D, decoded.texture);
+    glTexImage2D(
+        GL_TEXTURE_2D, 0, internal_format_for(*format, decoded.options), image.width,
+        image.height, 0, *format, GL_UNSIGNED_BYTE, nullptr
+    );
+
+    staging_t *staging = acquire_staging(size);
+    void      *mapped  = nullptr;
+    if (staging) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging->buffer);
+        mapped = staging->mapped ? staging->mapped
+                                 : glMapBufferRange(
+                                       GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(size),
+                                       GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT
+                                   );
+        if (!mapped) {
+            std::cerr << std::format(
+                "texture streamer: glMapBufferRange failed ({:#x}), uploading from client memory\n",
+                glGetError()
+            );
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+    }
+    if (mapped) {
+        std::memcpy(mapped, image.data.get(), size);
+        if (!staging->mapped) glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glTexSubImage2D(
+            GL_TEXTURE_2D, 0, 0, 0, image.width, image.height, *format, GL_UNSIGNED_BYTE, nullptr
+        );
+        staging->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    } else {
+        // Too big for a staging buffer, all of them still in use by the GPU, or not mappable.
+        glTexSubImage2D(
+            GL_TEXTURE_2D, 0, 0, 0, image.width, image.height, *format, GL_UNSIGNED_BYTE,
+            image.data.get()
+        );
+    }
+    glGenerateMipmap(GL_TEXTURE_2D);
+}
+
+void TextureStreamer::update() {
+    for (size_t uploads = 0; uploads < m_options.uploads_per_frame; ++uploads) {
+        decoded_t decoded;
+        {
+            std::lock_guard lock(m_mutex);
+            if (m_decoded.empty()) return;
+            decoded = std::move(m_decoded.front());
+            m_decoded.pop_front();
+        }
+        upload(decoded);
+    }
+}
+
+void TextureStreamer::finish() {
+    while (m_in_flight > 0) {
+        update();
+        std::this_thread::yield();
+    }
+}
+
+size_t TextureStreamer::pending() const {
+    return m_in_flight;
+}
@@ -0,0 +1,420 @@
+#include "common/transforms.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define TRANSFORMS_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TRANSFORMS_SSE2 1
+#endif
+
+// The arithmetic below is written once against a small "lanes" interface (load, store, set,
+// + - *, min, max, round) and instantiated for the widest vector type the build allows plus
+// plain floats for the tail of each range. Only the final transpose into column-major matrices
+// and the integer ops of the random generator are spelled out per instruction set.
+
+namespace {
+
+struct scalar_lanes_t {
+    static constexpr size_t width = 1;
+    float                   v;
+
+    static scalar_lanes_t load(const float *p) { return {*p}; }
+    static scalar_lanes_t set(float f) { return {f}; }
+    void                  store(float *p) const { *p = v; }
+};
+
+scalar_lanes_t operator+(scalar_lanes_t a, scalar_lanes_t b) { return {a.v + b.v}; }
+scalar_lanes_t operator-(scalar_lanes_t a, scalar_lanes_t b) { return {a.v - b.v}; }
+scalar_lanes_t operator*(scalar_lanes_t a, scalar_lanes_t b) { return {a.v * b.v}; }
+scalar_lanes_t min(scalar_lanes_t a, scalar_lanes_t b) { return {std::min(a.v, b.v)}; }
+scalar_lanes_t max(scalar_lanes_t a, scalar_lanes_t b) { return {std::max(a.v, b.v)}; }
+scalar_lanes_t round(scalar_lanes_t a) { return {std::nearbyint(a.v)}; }
+
+void store_matrices(const scalar_lanes_t (&m)[16], float *out) {
+    for (size_t k = 0; k < 16; ++k)
+        out[k] = m[k].v;
+}
+
+#if TRANSFORMS_AVX2
+struct wide_lanes_t {
+    static constexpr size_t width = 8;
+    __m256                  v;
+
+    static wide_lanes_t load(const float *p) { return {_mm256_loadu_ps(p)}; }
+    static wide_lanes_t set(float f) { return {_mm256_set1_ps(f)}; }
+    void                store(float *p) const { _mm256_storeu_ps(p, v); }
+};
+
+wide_lanes_t operator+(wide_lanes_t a, wide_lanes_t b) { return {_mm256_add_ps(a.v, b.v)}; }
+wide_lanes_t operator-(wide_lanes_t a, wide_lanes_t b) { return {_mm256_sub_ps(a.v, b.v)}; }
+wide_lanes_t operator*(wide_lanes_t a, wide_lanes_t b) { return {_mm256_mul_ps(a.v, b.v)}; }
+wide_lanes_t min(wide_lanes_t a, wide_lanes_t b) { return {_mm256_min_ps(a.v, b.v)}; }
+wide_lanes_t max(wide_lanes_t a, wide_lanes_t b) { return {_mm256_max_ps(a.v, b.v)}; }
+wide_lanes_t round(wide_lanes_t a) {
+    return {_mm256_round_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)};
+}
+
+// Rows j of the transposed 8x8 block: element k of matrix j is m[k] lane j.
+void transpose_8x8(const __m256 *in, __m256 *out) {
+    __m256 t[8], s[8];
+    for (int i = 0; i < 8; i += 2) {
+        t[i]     = _mm256_unpacklo_ps(in[i], in[i + 1]);
+        t[i + 1] = _mm256_unpackhi_ps(in[i], in[i + 1]);
+    }
+    for (int i = 0; i < 8; i += 4) {
+        s[i]     = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(1, 0, 1, 0));
+        s[i + 1] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(3, 2, 3, 2));
+        s[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(1, 0, 1, 0));
+        s[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(3, 2, 3, 2));
+    }
+    for (int i = 0; i < 4; ++i) {
+        out[i]     = _mm256_permute2f128_ps(s[i], s[i + 4], 0x20);
+        out[i + 4] = _mm256_permute2f128_ps(s[i], s[i + 4], 0x31);
+    }
+}
+
+void store_matrices(const wide_lanes_t (&m)[16], float *out) {
+    __m256 in[8], rows[8];
+    for (size_t half = 0; half < 2; ++half) {
+        for (size_t k = 0; k < 8; ++k)
+            in[k] = m[half * 8 + k].v;
+        transpose_8x8(in, rows);
+        for (size_t j = 0; j < 8; ++j)
+            _mm256_storeu_ps(out + j * 16 + half * 8, rows[j]);
+    }
+}
+#elif TRANSFORMS_SSE2
+struct wide_lanes_t {
+    static constexpr size_t width = 4;
+    __m128                  v;
+
+    static wide_lanes_t load(const float *p) { return {_mm_loadu_ps(p)}; }
+    static wide_lanes_t set(float f) { return {_mm_set1_ps(f)}; }
+    void                store(float *p) const { _mm_storeu_ps(p, v); }
+};
+
+wide_lanes_t operator+(wide_lanes_t a, wide_lanes_t b) { return {_mm_add_ps(a.v, b.v)}; }
+wide_lanes_t operator-(wide_lanes_t a, wide_lanes_t b) { return {_mm_sub_ps(a.v, b.v)}; }
+wide_lanes_t operator*(wide_lanes_t a, wide_lanes_t b) { return {_mm_mul_ps(a.v, b.v)}; }
+wide_lanes_t min(wide_lanes_t a, wide_lanes_t b) { return {_mm_min_ps(a.v, b.v)}; }
+wide_lanes_t max(wide_lanes_t a, wide_lanes_t b) { return {_mm_max_ps(a.v, b.v)}; }
+// SSE2 has no round instruction; the conversion rounds to nearest in the default MXCSR mode,
+// and the angles that reach it are far below 2^31.
+wide_lanes_t round(wide_lanes_t a) { return {_mm_cvtepi32_ps(_mm_cvtps_epi32(a.v))}; }
+
+void store_matrices(const wide_lanes_t (&m)[16], float *out) {
+    for (size_t quarter = 0; quarter < 4; ++quarter) {
+        __m128 r0 = m[quarter * 4].v, r1 = m[quarter * 4 + 1].v;
+        __m128 r2 = m[quarter * 4 + 2].v, r3 = m[quarter * 4 + 3].v;
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        _mm_storeu_ps(out + 0 * 16 + quarter * 4, r0);
+        _mm_storeu_ps(out + 1 * 16 + quarter * 4, r1);
+        _mm_storeu_ps(out + 2 * 16 + quarter * 4, r2);
+        _mm_storeu_ps(out + 3 * 16 + quarter * 4, r3);
+    }
+}
+#else
+using wide_lanes_t = scalar_lanes_t;
+#endif
+
+// Runs block<V>(i) over [first, last): whole vectors first, then the remainder one at a time.
+template <template <typename> typename Block, typename... Args>
+void for_lanes(size_t first, size_t last, Args &&...args) {
+    size_t i = first;
+    for (; i + wide_lanes_t::width <= last; i += wide_lanes_t::width)
+        Block<wide_lanes_t>::run(i, args...);
+    for (; i < last; ++i)
+        Block<scalar_lanes_t>::run(i, args...);
+}
+
+template <typename V> struct compose_block {
+    static void run(size_t i, const transform_store_t &t, float *out) {
+        V const qx = V::load(&t.qx[i]), qy = V::load(&t.qy[i]);
+        V const qz = V::load(&t.qz[i]), qw = V::load(&t.qw[i]);
+        V const sx = V::load(&t.sx[i]), sy = V::load(&t.sy[i]), sz = V::load(&t.sz[i]);
+
+        V const x2 = qx + qx, y2 = qy + qy, z2 = qz + qz;
+        V const xx = qx * x2, yy = qy * y2, zz = qz * z2;
+        V const xy = qx * y2, xz = qx * z2, yz = qy * z2;
+        V const wx = qw * x2, wy = qw * y2, wz = qw * z2;
+        V const one = V::set(1.f), zero = V::set(0.f);
+
+        V const m[16] = {
+            (one - (yy + zz)) * sx, (xy + wz) * sx, (xz - wy) * sx, zero,
+            (xy - wz) * sy, (one - (xx + zz)) * sy, (yz + wx) * sy, zero,
+            (xz + wy) * sz, (yz - wx) * sz, (one - (xx + yy)) * sz, zero,
+            V::load(&t.px[i]), V::load(&t.py[i]), V::load(&t.pz[i]), one,
+        };
+        store_matrices(m, out + i * 16);
+    }
+};
+
+// sin x for any x: reduced to [-pi, pi], folded onto [-pi/2, pi/2] (where sin x = sin(pi - x)),
+// then the Taylor series to x^11, which is within 6e-8 there before float rounding. See
+// sine_error_bound for the whole.
+template <typename V> V sin_lanes(V x) {
+    constexpr float pi = std::numbers::pi_v<float>;
+
+    x      = x - V::set(2.f * pi) * round(x * V::set(0.5f / pi));
+    V fold = min(x, V::set(pi) - x);
+    x      = max(fold, V::set(-pi) - fold);
+    V x_2  = x * x;
+    V poly = V::set(-1.f / 39916800.f);
+    poly   = poly * x_2 + V::set(1.f / 362880.f);
+    poly   = poly * x_2 + V::set(-1.f / 5040.f);
+    poly   = poly * x_2 + V::set(1.f / 120.f);
+    poly   = poly * x_2 + V::set(-1.f / 6.f);
+    return x + x * x_2 * poly;
+}
+
+template <typename V> V cos_lanes(V x) {
+    return sin_lanes(x + V::set(std::numbers::pi_v<float> / 2.f));
+}
+
+template <typename V> struct orbit_block {
+    static void run(size_t i, const orbits_t &o, float time, transform_store_t &t) {
+        V const now    = V::set(time);
+        V const angle  = V::load(&o.phase[i]) + V::load(&o.speed[i]) * now;
+        V const radius = V::load(&o.radius[i]);
+        (sin_lanes(angle) * radius).store(&t.px[i]);
+        V::load(&o.height[i]).store(&t.py[i]);
+        (cos_lanes(angle) * radius).store(&t.pz[i]);
+
+        V const half = (V::load(&o.spin_phase[i]) + V::load(&o.spin[i]) * now) * V::set(0.5f);
+        V const s    = sin_lanes(half);
+        (V::load(&o.axis_x[i]) * s).store(&t.qx[i]);
+        (V::load(&o.axis_y[i]) * s).store(&t.qy[i]);
+        (V::load(&o.axis_z[i]) * s).store(&t.qz[i]);
+        cos_lanes(half).store(&t.qw[i]);
+    }
+};
+
+#if TRANSFORMS_AVX2
+struct random_lanes_t {
+    __m256i v;
+
+    static random_lanes_t load(const uint32_t *p) {
+        return {_mm256_load_si256(reinterpret_cast<const __m256i *>(p))};
+    }
+    void store(uint32_t *p) const { _mm256_store_si256(reinterpret_cast<__m256i *>(p), v); }
+};
+
+random_lanes_t operator+(random_lanes_t a, random_lanes_t b) {
+    return {_mm256_add_epi32(a.v, b.v)};
+}
+random_lanes_t operator^(random_lanes_t a, random_lanes_t b) {
+    return {_mm256_xor_si256(a.v, b.v)};
+}
+random_lanes_t shl(random_lanes_t a, int n) { return {_mm256_slli_epi32(a.v, n)}; }
+random_lanes_t rotl(random_lanes_t a, int n) {
+    return {_mm256_or_si256(_mm256_slli_epi32(a.v, n), _mm256_srli_epi32(a.v, 32 - n))};
+}
+// Top 23 bits as the mantissa of a float in [1, 2), minus one: uniform in [0, 1).
+void store_unit(random_lanes_t a, float *out) {
+    __m256i const bits = _mm256_or_si256(_mm256_srli_epi32(a.v, 9), _mm256_set1_epi32(0x3f800000));
+    _mm256_storeu_ps(out, _mm256_sub_ps(_mm256_castsi256_ps(bits), _mm256_set1_ps(1.f)));
+}
+#elif TRANSFORMS_SSE2
+// Eight streams as two SSE2 halves.
+struct random_lanes_t {
+    __m128i lo, hi;
+
+    static random_lanes_t load(const uint32_t *p) {
+        auto const *v = reinterpret_cast<const __m128i *>(p);
+        return {_mm_load_si128(v), _mm_load_si128(v + 1)};
+    }
+    void store(uint32_t *p) const {
+        auto *v = reinterpret_cast<__m128i *>(p);
+        _mm_store_si128(v, lo);
+        _mm_store_si128(v + 1, hi);
+    }
+};
+
+random_lanes_t operator+(random_lanes_t a, random_lanes_t b) {
+    return {_mm_add_epi32(a.lo, b.lo), _mm_add_epi32(a.hi, b.hi)};
+}
+random_lanes_t operator^(random_lanes_t a, random_lanes_t b) {
+    return {_mm_xor_si128(a.lo, b.lo), _mm_xor_si128(a.hi, b.hi)};
+}
+random_lanes_t shl(random_lanes_t a, int n) {
+    return {_mm_slli_epi32(a.lo, n), _mm_slli_epi32(a.hi, n)};
+}
+random_lanes_t rotl(random_lanes_t a, int n) {
+    return {
+        _mm_or_si128(_mm_slli_epi32(a.lo, n), _mm_srli_epi32(a.lo, 32 - n)),
+        _mm_or_si128(_mm_slli_epi32(a.hi, n), _mm_srli_epi32(a.hi, 32 - n)),
+    };
+}
+void store_unit(random_lanes_t a, float *out) {
+    __m128i const one = _mm_set1_epi32(0x3f800000);
+    __m128  const lo  = _mm_castsi128_ps(_mm_or_si128(_mm_srli_epi32(a.lo, 9), one));
+    __m128  const hi  = _mm_castsi128_ps(_mm_or_si128(_mm_srli_epi32(a.hi, 9), one));
+    _mm_storeu_ps(out, _mm_sub_ps(lo, _mm_set1_ps(1.f)));
+    _mm_storeu_ps(out + 4, _mm_sub_ps(hi, _mm_set1_ps(1.f)));
+}
+#else
+struct random_lanes_t {
+    uint32_t v[8];
+
+    static random_lanes_t load(const uint32_t *p) {
+        random_lanes_t a;
+        std::memcpy(a.v, p, sizeof(a.v));
+        return a;
+    }
+    void store(uint32_t *p) const { std::memcpy(p, v, sizeof(v)); }
+};
+
+template <typename Op> random_lanes_t lanewise(random_lanes_t a, Op op) {
+    for (auto &lane : a.v)
+        lane = op(lane);
+    return a;
+}
+random_lanes_t operator+(random_lanes_t a, random_lanes_t b) {
+    for (size_t i = 0; i < 8; ++i)
+        a.v[i] += b.v[i];
+    return a;
+}
+random_lanes_t operator^(random_lanes_t a, random_lanes_t b) {
+    for (size_t i = 0; i < 8; ++i)
+        a.v[i] ^= b.v[i];
+    return a;
+}
+random_lanes_t shl(random_lanes_t a, int n) {
+    return lanewise(a, [n](uint32_t x) { return x << n; });
+}
+random_lanes_t rotl(random_lanes_t a, int n) {
+    return lanewise(a, [n](uint32_t x) { return (x << n) | (x >> (32 - n)); });
+}
+void store_unit(random_lanes_t a, float *out) {
+    for (size_t i = 0; i < 8; ++i) {
+        uint32_t const bits = (a.v[i] >> 9) | 0x3f800000u;
+        std::memcpy(&out[i], &bits, sizeof(bits));
+        out[i] -= 1.f;
+    }
+}
+#endif
+
+uint64_t splitmix64(uint64_t &state) {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+    z          = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z          = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+} // namespace
+
+void transform_store_t::resize(size_t count) {
+    for (auto *component : {&px, &py, &pz, &qx, &qy, &qz, &qw, &sx, &sy, &sz})
+        component->resize(count);
+}
+
+void transform_store_t::set(
+    size_t i, const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale
+) {
+    px[i] = position.x, py[i] = position.y, pz[i] = position.z;
+    qx[i] = rotation.x, qy[i] = rotation.y, qz[i] = rotation.z, qw[i] = rotation.w;
+    sx[i] = scale.x, sy[i] = scale.y, sz[i] = scale.z;
+}
+
+glm::mat4 transform_store_t::matrix(size_t i) const {
+    glm::mat4 model = glm::translate(glm::mat4(1.f), {px[i], py[i], pz[i]});
+    model *= glm::mat4_cast(glm::quat(qw[i], qx[i], qy[i], qz[i]));
+    return glm::scale(model, {sx[i], sy[i], sz[i]});
+}
+
+void transform_store_t::compose(std::span<glm::mat4> out, size_t first, size_t last) const {
+    for_lanes<compose_block>(first, last, *this, reinterpret_cast<float *>(out.data()));
+}
+
+void orbits_t::resize(size_t count) {
+    for (auto *parameter :
+         {&radius, &height, &phase, &speed, &axis_x, &axis_y, &axis_z, &spin_phase, &spin})
+        parameter->resize(count);
+}
+
+void animate_orbits(
+    const orbits_t &orbits, float time, transform_store_t &transforms, size_t first, size_t last
+) {
+    for_lanes<orbit_block>(first, last, orbits, time, transforms);
+}
+
+fast_random_t::fast_random_t(uint64_t seed) {
+    // xoshiro must not start from all zeroes; splitmix64 is the seeding its authors recommend.
+    for (auto &word : m_state)
+        for (size_t lane = 0; lane < 8; lane += 2) {
+            uint64_t const bits = splitmix64(seed);
+            word[lane]          = static_cast<uint32_t>(bits);
+            word[lane + 1]      = static_cast<uint32_t>(bits >> 32);
+        }
+}
+
+void fast_random_t::fill(std::span<float> out, float lo, float hi) {
+    random_lanes_t s0 = random_lanes_t::load(m_state[0]);
+    random_lanes_t s1 = random_lanes_t::load(m_state[1]);
+    random_lanes_t s2 = random_lanes_t::load(m_state[2]);
+    random_lanes_t s3 = random_lanes_t::load(m_state[3]);
+
+    float const range = hi - lo;
+    for (size_t i = 0; i < out.size(); i += 8) {
+        float unit[8];
+        store_unit(s0 + s3, unit);
+
+        random_lanes_t const t = shl(s1, 9);
+        s2                     = s2 ^ s0;
+        s3                     = s3 ^ s1;
+        s1                     = s1 ^ s2;
+        s0                     = s0 ^ s3;
+        s2                     = s2 ^ t;
+        s3                     = rotl(s3, 11);
+
+        size_t const count = std::min<size_t>(8, out.size() - i);
+        for (size_t j = 0; j < count; ++j)
+            out[i + j] = lo + unit[j] * range;
+    }
+
+    s0.store(m_state[0]);
+    s1.store(m_state[1]);
+    s2.store(m_state[2]);
+    s3.store(m_state[3]);
+}
+
+void scatter_ring(
+    const ring_params_t &params, fast_random_t &random, orbits_t &orbits,
+    transform_store_t &transforms
+) {
+    size_t const count = transforms.size();
+    orbits.resize(count);
+
+    std::vector<float> radial(count), scale(count);
+    random.fill(radial, -params.spread, params.spread);
+    random.fill(orbits.height, -params.spread * params.flatten, params.spread * params.flatten);
+    random.fill(scale, params.min_scale, params.max_scale);
+    random.fill(orbits.axis_x, -1.f, 1.f);
+    random.fill(orbits.axis_y, -1.f, 1.f);
+    random.fill(orbits.axis_z, -1.f, 1.f);
+    random.fill(orbits.spin_phase, 0.f, 2.f * std::numbers::pi_v<float>);
+    random.fill(orbits.spin, -params.max_spin, params.max_spin);
+
+    for (size_t i = 0; i < count; ++i) {
+        float const r    = params.radius + radial[i];
+        orbits.radius[i] = r;
+        orbits.phase[i]  = static_cast<float>(i) / static_cast<float>(count) * 2.f *
+                          std::numbers::pi_v<float>;
+        orbits.speed[i]  = params.speed * std::pow(params.radius / r, 1.5f);
+
+        glm::vec3 axis = {orbits.axis_x[i], orbits.axis_y[i], orbits.axis_z[i]};
+        axis = glm::length(axis) > 1e-3f ? glm::normalize(axis) : glm::vec3(0.f, 1.f, 0.f);
+        orbits.axis_x[i] = axis.x, orbits.axis_y[i] = axis.y, orbits.axis_z[i] = axis.z;
+
+        transforms.sx[i] = transforms.sy[i] = transforms.sz[i] = scale[i];
+    }
+    animate_orbits(orbits, 0.f, transforms, 0, count);
+}
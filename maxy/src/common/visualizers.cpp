@@ -0,0 +1,82 @@
+#include <cstddef>
+
+#include "common/gl_state.hpp"
+#include "common/visualizers.hpp"
+
+static Mesh exploded_mesh(const Mesh &mesh) {
+    auto const vertices = mesh.read_vertices();
+    auto const indices  = mesh.read_indices();
+
+    std::vector<Vertex>       corners;
+    std::vector<unsigned int> order;
+    corners.reserve(indices.size());
+    order.reserve(indices.size());
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        Vertex a = vertices[indices[i]];
+        Vertex b = vertices[indices[i + 1]];
+        Vertex c = vertices[indices[i + 2]];
+        // Counter-clockwise is the front: outwards. (The geometry shader crossed the other way
+        // round, but in clip space, whose handedness the projection flips.)
+        glm::vec3 const face = glm::cross(b.position - a.position, c.position - a.position);
+        glm::vec3 const normal =
+            glm::dot(face, face) > 0.f ? glm::normalize(face) : glm::vec3(0.f);
+        for (Vertex *corner : {&a, &b, &c}) {
+            corner->normal = normal;
+            order.push_back(static_cast<unsigned int>(corners.size()));
+            corners.push_back(*corner);
+        }
+    }
+    return Mesh{std::move(corners), std::move(order), mesh.textures()};
+}
+
+Model exploded_model(const Model &model) {
+    std::vector<Mesh> meshes;
+    meshes.reserve(model.meshes().size());
+    for (const auto &mesh : model.meshes())
+        meshes.push_back(exploded_mesh(mesh));
+    return Model{std::move(meshes), model.nodes(), model.mesh_nodes()};
+}
+
+NormalLines::NormalLines(const Model &model) : m_mesh_nodes(model.mesh_nodes()) {
+    m_meshes.reserve(model.meshes().size());
+    for (const auto &mesh : model.meshes()) {
+        lines_t lines{.vertex_array = 0, .count = static_cast<GLsizei>(mesh.vertex_count())};
+        glGenVertexArrays(1, &lines.vertex_array);
+        gl_state::bind_vertex_array(lines.vertex_array);
+        glBindBuffer(GL_ARRAY_BUFFER, mesh.vertex_buffer());
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), nullptr);
+        glVertexAttribDivisor(0, 1);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(
+            1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+            reinterpret_cast<void *>(offsetof(Vertex, normal))
+        );
+        glVertexAttribDivisor(1, 1);
+        m_meshes.push_back(lines);
+    }
+    gl_state::bind_vertex_array(0);
+}
+
+void NormalLines::draw(Shader &shader, const scene_graph_t &nodes, const glm::mat4 &model) {
+    for (size_t i = 0; i < m_meshes.size(); ++i) {
+        shader.set_mat4(
+            "model", i < m_mesh_nodes.size() ? model * nodes.world(m_mesh_nodes[i]) : model
+        );
+        gl_state::bind_vertex_array(m_meshes[i].vertex_array);
+        glDrawArraysInstanced(GL_LINES, 0, 2, m_meshes[i].count);
+    }
+}
+
+size_t NormalLines::line_count() const {
+    size_t count = 0;
+    for (const auto &lines : m_meshes)
+        count += static_cast<size_t>(lines.count);
+    return count;
+}
+
+void NormalLines::release() {
+    for (auto &lines : m_meshes)
+        glDeleteVertexArrays(1, &lines.vertex_array);
+    m_meshes.clear();
+}
@@ -0,0 +1,175 @@
+#include <atomic>
+#include <memory>
+#include <print>
+#include <string>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <imgui.h>
+
+#include "engine.hpp"
+#include "geometry.hpp"
+
+constexpr int        WINDOW_WIDTH     = 1024;
+constexpr int        WINDOW_HEIGHT    = 768;
+constexpr SDL_FColor BACKGROUND_COLOR = {0.2f, 0.3f, 0.3f, 1.0f};
+
+// CPU-bound synthetic scene for run_pipelined: every cube's transform is rebuilt each frame from
+// `work` chained rotations, so update costs milliseconds while the GPU does very little. Compare
+// the exit report with and without --no-pipeline.
+constexpr int   GRID         = 48;
+constexpr float GRID_SPACING = 1.6f;
+
+// Built by update on the worker thread, read by render on the main thread.
+struct snapshot_t {
+    std::vector<glm::mat4> models;
+};
+
+struct scene_t {
+    gpu_pipeline_t pipeline;
+    gpu_geometry_t geometry;
+    gpu_material_t material;
+
+    // Main thread only: ui moves the camera and render reads it, so the view is as fresh as the
+    // frame being recorded even though the cubes are a frame behind.
+    camera_t camera;
+    float    m_aspect_ratio = static_cast<float>(WINDOW_WIDTH) / WINDOW_HEIGHT;
+    bool     m_pipelined    = true;
+
+    // Set by ui, read by update.
+    std::atomic<int> work{48};
+
+    // Worker thread only.
+    float m_time = 0.0f;
+
+    bool       ui(input_t const &in);
+    snapshot_t update(input_t const &in);
+    void render(snapshot_t const &snapshot, SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass);
+};
+
+std::expected<std::unique_ptr<scene_t>, std::string> create_scene(engine_t &engine) {
+    auto scene         = std::make_unique<scene_t>();
+    scene->camera      = camera_t(engine.window, {0.0f, 0.0f, GRID * GRID_SPACING});
+    scene->m_pipelined = engine.pipelined;
+
+    if (auto r = init_imgui(engine); !r) return std::unexpected(r.error());
+    ImGui::GetIO().IniFilename = nullptr;
+
+    auto pipeline = create_pipeline(
+        engine, {
+                    .vertex_shader          = "shaders/sdl3_09/going_3d.vert.spv",
+                    .fragment_shader        = "shaders/sdl3_09/going_3d.frag.spv",
+                    .vertex_uniform_buffers = 3,
+                    .fragment_samplers      = 2,
+                    .vertex_buffer_descs    = pos_uv_buffer_descs,
+                    .vertex_attributes      = pos_uv_vertex_attributes,
+                    .enable_depth_test      = true,
+                }
+    );
+    if (!pipeline) return std::unexpected(pipeline.error());
+    scene->pipeline = std::move(*pipeline);
+
+    auto geometry = create_vertex_geometry(
+        engine, unit_cube.data(), static_cast<Uint32>(unit_cube.size() * sizeof(pos_uv_vertex_t)),
+        static_cast<Uint32>(unit_cube.size())
+    );
+    if (!geometry) return std::unexpected(geometry.error());
+    scene->geometry = std::move(*geometry);
+
+    auto material = create_material(
+        engine, {
+                    .texture_paths = {
+                        std::string(ASSETS_PATH) + "textures/container.jpg",
+                        std::string(ASSETS_PATH) + "textures/awesomeface.png",
+                    },
+                }
+    );
+    if (!material) return std::unexpected(material.error());
+    scene->material = std::move(*material);
+
+    return scene;
+}
+
+bool scene_t::ui(input_t const &in) {
+    m_aspect_ratio = in.aspect_ratio;
+    if (in.keys[SDL_SCANCODE_ESCAPE]) return false;
+
+    camera.update(in);
+
+    ImGui::SetNextWindowPos(ImVec2(6.0f, 6.0f), ImGuiCond_Once);
+    ImGui::Begin("Scene", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+    ImGui::PushItemWidth(160.0f);
+    ImGui::LabelText("Cubes", "%d", GRID * GRID);
+    ImGui::LabelText("Update", "%s", m_pipelined ? "pipelined" : "serial (--no-pipeline)");
+    int value = work.load(std::memory_order_relaxed);
+    if (ImGui::SliderInt("Rotations per cube", &value, 1, 256))
+        work.store(value, std::memory_order_relaxed);
+    float const fps = ImGui::GetIO().Framerate;
+    ImGui::LabelText("Frame time", "%.2f ms (%.0f fps)", 1000.0f / fps, fps);
+    ImGui::LabelText("Mode", "%s", camera.ui_mode() ? "UI (` to fly)" : "Fly (` for UI)");
+    ImGui::PopItemWidth();
+    ImGui::End();
+
+    return true;
+}
+
+snapshot_t scene_t::update(input_t const &in) {
+    for (int i = 0; i < in.steps; ++i)
+        m_time += in.step;
+
+    int const  rotations = work.load(std::memory_order_relaxed);
+    snapshot_t snapshot;
+    snapshot.models.reserve(GRID * GRID);
+    for (int y = 0; y < GRID; ++y) {
+        for (int x = 0; x < GRID; ++x) {
+            glm::vec3 const position = {
+                (static_cast<float>(x) - GRID / 2.0f) * GRID_SPACING,
+                (static_cast<float>(y) - GRID / 2.0f) * GRID_SPACING, 0.0f
+            };
+            float const speed = 10.0f + static_cast<float>((x * 7 + y * 13) % 23);
+            float const angle = glm::radians(m_time * speed) / static_cast<float>(rotations);
+
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
+            for (int r = 0; r < rotations; ++r)
+                model = glm::rotate(model, angle, glm::vec3(1.0f, 0.3f, 0.5f));
+            snapshot.models.push_back(glm::scale(model, glm::vec3(0.5f)));
+        }
+    }
+    return snapshot;
+}
+
+void scene_t::render(
+    snapshot_t const &snapshot, SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass
+) {
+    glm::mat4 const projection =
+        glm::perspective(glm::radians(camera.fov), m_aspect_ratio, 0.1f, 500.0f);
+    push_vertex_uniform(cmd, 1, camera.view_matrix());
+    push_vertex_uniform(cmd, 2, projection);
+    for (auto const &model : snapshot.models) {
+        push_vertex_uniform(cmd, 0, model);
+        draw(pipeline, geometry, material, pass);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    auto engine = create_engine(
+        "LOpenGL SDL3 - Pipelined Cubes", WINDOW_WIDTH, WINDOW_HEIGHT,
+        parse_engine_args(argc, argv)
+    );
+    if (!engine) {
+        std::println(stderr, "Engine init failed: {}", engine.error());
+        return 1;
+    }
+    auto scene = create_scene(*engine);
+    if (!scene) {
+        std::println(stderr, "Scene init failed: {}", scene.error());
+        return 1;
+    }
+    if (auto result = run_pipelined(*engine, BACKGROUND_COLOR, **scene); !result) {
+        std::println(stderr, "{}", result.error());
+        return 1;
+    }
+    return 0;
+}
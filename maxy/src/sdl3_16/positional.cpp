@@ -36,15 +36,22 @@ struct scene_t {
     float     light_constant  = 1.0f;
     float     light_linear    = 0.09f;
     float     light_quadratic = 0.032f;
-    float     m_time          = 0.0f;
     float     m_aspect_ratio  = static_cast<float>(WINDOW_WIDTH) / WINDOW_HEIGHT;
+    // Cube spin is simulated in input_t steps (fixed with --sim-hz) and drawn interpolated.
+    float m_time          = 0.0f;
+    float m_previous_time = 0.0f;
+    float m_alpha         = 1.0f;
 
     bool update(input_t const &in);
     void render(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass);
 };
 
 bool scene_t::update(input_t const &in) {
-    m_time += in.dt;
+    for (int i = 0; i < in.steps; ++i) {
+        m_previous_time = m_time;
+        m_time += in.step;
+    }
+    m_alpha        = in.alpha;
     m_aspect_ratio = in.aspect_ratio;
 
     if (in.keys[SDL_SCANCODE_ESCAPE]) return false;
@@ -107,8 +114,9 @@ void scene_t::render(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
     push_fragment_uniform(cmd, 0, MATERIAL);
     push_fragment_uniform(cmd, 1, frame_light);
 
+    float const time = glm::mix(m_previous_time, m_time, m_alpha);
     for (Uint32 i = 0; i < example_cube_positions.size(); ++i) {
-        float     angle  = m_time * static_cast<float>(i % 3) * 25.0f;
+        float     angle  = time * static_cast<float>(i % 3) * 25.0f;
         glm::vec3 camrel = example_cube_positions[i] - camera.position;
         glm::mat4 model  = glm::rotate(
             glm::translate(glm::mat4(1.0f), camrel), glm::radians(angle),
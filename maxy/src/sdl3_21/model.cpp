@@ -46,10 +46,9 @@ void scene_t::render(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
     glm::mat4 projection = glm::perspective(glm::radians(camera.fov), m_aspect_ratio, 0.1f, 100.0f);
 
     SDL_BindGPUGraphicsPipeline(pass, pipeline.get());
-    push_vertex_uniform(cmd, 0, model_mat);
     push_vertex_uniform(cmd, 1, view);
     push_vertex_uniform(cmd, 2, projection);
-    draw_model(model, {texture_slot_t::diffuse}, pass);
+    draw_model(cmd, model, model_mat, 0, {texture_slot_t::diffuse}, pass);
 }
 
 std::expected<scene_t, std::string> create_scene(engine_t &engine) {
@@ -1,4 +1,6 @@
 #include "engine.hpp"
+#include "render_graph.hpp"
+#include "vegetation.hpp"
 #include <SDL3/SDL_main.h>
 #include <array>
 #include <glm/gtc/matrix_transform.hpp>
@@ -19,27 +21,34 @@ static constexpr std::array<model_placement_t, 2> CUBES = {{
     {{2.0f, 1.0f, 0.0f}, 2.0f},
 }};
 
-static constexpr std::array<model_placement_t, 5> VEGETATION = {{
-    {{-1.5f, 0.0f, -0.48f}, 0.8f},
-    {{1.5f, 0.0f, 0.51f}, 0.9f},
-    {{0.0f, 0.0f, 0.7f}, 1.0f},
-    {{-0.3f, 0.0f, -2.3f}, 1.1f},
-    {{0.5f, 0.0f, -0.6f}, 1.2f},
+// 200 m across, under the whole vegetation field; UV tiles every 5 m.
+static constexpr std::array<pos_normal_uv_vertex_t, 6> meadow_floor_vertices = {{
+    {{100.f, 0.f, 100.f}, {0.f, 1.f, 0.f}, {40.f, 0.f}},
+    {{-100.f, 0.f, -100.f}, {0.f, 1.f, 0.f}, {0.f, 40.f}},
+    {{-100.f, 0.f, 100.f}, {0.f, 1.f, 0.f}, {0.f, 0.f}},
+    {{100.f, 0.f, 100.f}, {0.f, 1.f, 0.f}, {40.f, 0.f}},
+    {{100.f, 0.f, -100.f}, {0.f, 1.f, 0.f}, {40.f, 40.f}},
+    {{-100.f, 0.f, -100.f}, {0.f, 1.f, 0.f}, {0.f, 40.f}},
 }};
 
-static constexpr model_placement_t PLANE = {{0.0f, 0.0f, 0.0f}, 1.0f};
+constexpr float FAR_PLANE = 250.0f;
 
 struct scene_t {
-    gpu_pipeline_t pipeline;
-    gpu_geometry_t cube_geometry;
-    gpu_geometry_t plane_geometry;
-    gpu_geometry_t grass_geometry;
-    gpu_material_t marble_material;
-    gpu_material_t metal_material;
-    gpu_material_t grass_material;
+    gpu_pipeline_t     pipeline;
+    gpu_geometry_t     cube_geometry;
+    gpu_geometry_t     plane_geometry;
+    gpu_material_t     marble_material;
+    gpu_material_t     metal_material;
+    vegetation_field_t vegetation;
+    SDL_GPUSampleCount samples = SDL_GPU_SAMPLECOUNT_1;
 
     camera_t camera;
     float    m_aspect_ratio = static_cast<float>(WINDOW_WIDTH) / WINDOW_HEIGHT;
+    float    m_time         = 0.0f;
+
+    glm::mat4 projection() const {
+        return glm::perspective(glm::radians(camera.fov), m_aspect_ratio, 0.1f, FAR_PLANE);
+    }
 
     bool update(input_t const &in);
     void render(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass);
@@ -49,6 +58,13 @@ std::expected<scene_t, std::string> create_scene(engine_t &engine) {
     if (auto r = init_imgui(engine); !r) return std::unexpected(r.error());
     ImGui::GetIO().IniFilename = nullptr;
 
+    // The floor, cubes and vegetation all render into one multisampled target when the device
+    // has one; alpha-to-coverage then replaces discard for the grass.
+    SDL_GPUTextureFormat const format =
+        SDL_GetGPUSwapchainTextureFormat(engine.gpu_device, engine.window);
+    SDL_GPUSampleCount const samples =
+        supported_sample_count(engine, format, SDL_GPU_SAMPLECOUNT_4);
+
     auto pipeline = create_pipeline(
         engine, {
                     .vertex_shader          = "shaders/sdl3_24/grass.vert.spv",
@@ -58,6 +74,7 @@ std::expected<scene_t, std::string> create_scene(engine_t &engine) {
                     .vertex_buffer_descs    = pos_normal_uv_buffer_descs,
                     .vertex_attributes      = pos_normal_uv_vertex_attributes,
                     .enable_depth_test      = true,
+                    .sample_count           = samples,
                 }
     );
     if (!pipeline) return std::unexpected(pipeline.error());
@@ -69,17 +86,11 @@ std::expected<scene_t, std::string> create_scene(engine_t &engine) {
     if (!cube_geometry) return std::unexpected(cube_geometry.error());
 
     auto plane_geometry = create_vertex_geometry(
-        engine, floor_plane_vertices.data(), static_cast<Uint32>(sizeof(floor_plane_vertices)),
-        static_cast<Uint32>(floor_plane_vertices.size())
+        engine, meadow_floor_vertices.data(), static_cast<Uint32>(sizeof(meadow_floor_vertices)),
+        static_cast<Uint32>(meadow_floor_vertices.size())
     );
     if (!plane_geometry) return std::unexpected(plane_geometry.error());
 
-    auto grass_geometry = create_vertex_geometry(
-        engine, vertical_quad_vertices.data(), static_cast<Uint32>(sizeof(vertical_quad_vertices)),
-        static_cast<Uint32>(vertical_quad_vertices.size())
-    );
-    if (!grass_geometry) return std::unexpected(grass_geometry.error());
-
     auto marble_material = create_material(
         engine, {.texture_paths = {std::string(ASSETS_PATH) + "textures/marble.jpg"}}
     );
@@ -90,34 +101,36 @@ std::expected<scene_t, std::string> create_scene(engine_t &engine) {
     );
     if (!metal_material) return std::unexpected(metal_material.error());
 
-    // CLAMP_TO_EDGE: prevents bilinear filtering from bleeding the opposite edge's
-    // colour into the transparent border of the grass texture (fringe artifact).
-    auto grass_material = create_material(
-        engine, {
-                    .texture_paths = {std::string(ASSETS_PATH) + "textures/grass.png"},
-                    .address_modes = {SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE},
-                }
-    );
-    if (!grass_material) return std::unexpected(grass_material.error());
+    // About half a million plants over 160 m x 160 m.
+    auto vegetation =
+        create_vegetation_field(engine, noise_density_map({256, 256}, 24), {}, format, samples);
+    if (!vegetation) return std::unexpected(vegetation.error());
+
+    camera_t camera{engine.window, {0.0f, 1.7f, 3.0f}};
+    camera.speed = 8.0f;
 
     return scene_t{
         .pipeline        = std::move(*pipeline),
         .cube_geometry   = std::move(*cube_geometry),
         .plane_geometry  = std::move(*plane_geometry),
-        .grass_geometry  = std::move(*grass_geometry),
         .marble_material = std::move(*marble_material),
         .metal_material  = std::move(*metal_material),
-        .grass_material  = std::move(*grass_material),
-        .camera          = camera_t{engine.window, {0.0f, 0.5f, 3.0f}},
+        .vegetation      = std::move(*vegetation),
+        .samples         = samples,
+        .camera          = camera,
     };
 }
 
 bool scene_t::update(input_t const &in) {
     m_aspect_ratio = in.aspect_ratio;
+    m_time += in.dt;
     if (in.keys[SDL_SCANCODE_ESCAPE]) return false;
 
     camera.update(in);
+    vegetation.cull(projection() * camera.view_matrix(), camera.position);
 
+    auto const &stats  = vegetation.stats();
+    auto       &config = vegetation.config;
     ImGui::SetNextWindowPos(ImVec2(6.0f, 6.0f), ImGuiCond_Once);
     ImGui::Begin("Scene", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
     ImGui::PushItemWidth(180.0f);
@@ -125,6 +138,19 @@ bool scene_t::update(input_t const &in) {
         "Camera", "(%.2f, %.2f, %.2f)", camera.position.x, camera.position.y, camera.position.z
     );
     ImGui::LabelText("Mode", "%s", camera.ui_mode() ? "UI (` to fly)" : "Fly (` for UI)");
+    ImGui::Separator();
+    ImGui::LabelText(
+        "MSAA", "%dx, %s", 1 << samples,
+        vegetation.alpha_to_coverage ? "alpha to coverage" : "discard"
+    );
+    ImGui::LabelText("Plants", "%zu of %u", stats.instances, vegetation.instance_count);
+    ImGui::LabelText("Draws", "%zu of %zu chunks", stats.chunks, vegetation.chunks.size());
+    ImGui::Checkbox("Frustum and distance culling", &vegetation.culling);
+    ImGui::Checkbox("Distance thinning", &vegetation.thinning);
+    ImGui::SliderFloat("Full density to", &config.full_distance, 2.0f, 60.0f, "%.0f m");
+    ImGui::SliderFloat(
+        "Culled past", &config.cull_distance, config.full_distance, FAR_PLANE, "%.0f m"
+    );
     ImGui::PopItemWidth();
     ImGui::End();
 
@@ -133,18 +159,15 @@ bool scene_t::update(input_t const &in) {
 
 void scene_t::render(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
     auto const view = camera.rotation_view();
-    auto const proj = glm::perspective(glm::radians(camera.fov), m_aspect_ratio, 0.1f, 100.0f);
+    auto const proj = projection();
 
     SDL_BindGPUGraphicsPipeline(pass, pipeline.get());
     push_vertex_uniform(cmd, 1, view);
     push_vertex_uniform(cmd, 2, proj);
 
     // Floor
-    {
-        auto model = glm::translate(glm::mat4{1.0f}, PLANE.position - camera.position);
-        push_vertex_uniform(cmd, 0, model);
-        draw(plane_geometry, metal_material, pass);
-    }
+    push_vertex_uniform(cmd, 0, glm::translate(glm::mat4{1.0f}, -camera.position));
+    draw(plane_geometry, metal_material, pass);
 
     // Cubes
     for (auto const &placement : CUBES) {
@@ -154,19 +177,53 @@ void scene_t::render(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
         draw(cube_geometry, marble_material, pass);
     }
 
-    // Grass -- alpha cutout: discard handles transparency, no back-to-front sorting needed.
-    for (auto const &placement : VEGETATION) {
-        auto model = glm::translate(glm::mat4{1.0f}, placement.position - camera.position);
-        model      = glm::scale(model, glm::vec3{placement.scale});
-        push_vertex_uniform(cmd, 0, model);
-        draw(grass_geometry, grass_material, pass);
-    }
+    // Grass -- alpha cutout, so no back-to-front sorting: one instanced draw per visible chunk.
+    vegetation.draw(cmd, pass, view, proj, camera.position, m_time);
 }
 
 int main(int argc, char *argv[]) {
-    auto result = run_app(
-        argc, argv, TITLE, WINDOW_WIDTH, WINDOW_HEIGHT, SDL_FColor{0.01f, 0.01f, 0.0f, 1.0f},
-        create_scene
+    auto engine =
+        create_engine(TITLE, WINDOW_WIDTH, WINDOW_HEIGHT, parse_engine_args(argc, argv));
+    if (!engine) {
+        std::println(stderr, "{}", engine.error());
+        return 1;
+    }
+
+    auto scene = create_scene(*engine);
+    if (!scene) {
+        std::println(stderr, "{}", scene.error());
+        return 1;
+    }
+
+    // Multisampled, the scene pass resolves into the swapchain as it ends and its samples are
+    // never stored; ImGui then draws single-sampled on top.
+    render_graph_t graph;
+    auto const     depth =
+        graph.create_texture({.name = "depth", .format = DEPTH_FORMAT, .samples = scene->samples});
+    rg_pass_t scene_pass{
+        .name  = "scene",
+        .color = {rg_swapchain},
+        .depth = depth,
+        .draw  = [&](auto cmd, auto pass) { scene->render(cmd, pass); },
+    };
+    if (scene->samples != SDL_GPU_SAMPLECOUNT_1) {
+        auto const color =
+            graph.create_texture({.name = "scene color", .samples = scene->samples});
+        scene_pass.color   = {color};
+        scene_pass.resolve = {rg_swapchain};
+    }
+    graph.add_pass(std::move(scene_pass));
+    graph.add_pass({
+        .name        = "imgui",
+        .color       = {rg_swapchain},
+        .clear_color = false,
+        .prepare     = [](auto cmd) { imgui_prepare(cmd); },
+        .draw        = [](auto cmd, auto pass) { imgui_render(cmd, pass); },
+    });
+
+    auto result = run_loop(
+        *engine, [] { return SDL_FColor{0.01f, 0.01f, 0.0f, 1.0f}; }, graph,
+        [&](input_t const &in) { return scene->update(in); }
     );
     if (!result) {
         std::println(stderr, "{}", result.error());
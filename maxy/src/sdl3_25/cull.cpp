@@ -13,6 +13,8 @@
 #include "engine.hpp"
 #include "geometry.hpp"
 #include "lights.hpp"
+#include "placement.hpp"
+#include "scene_graph.hpp"
 
 constexpr int WINDOW_WIDTH  = 1024;
 constexpr int WINDOW_HEIGHT = 768;
@@ -30,11 +32,6 @@ struct scene_params_t {
     glm::vec4 dir_specular;
 };
 
-struct model_placement_t {
-    glm::vec3 position;
-    float     scale;
-};
-
 // Far clip is 100 units; +-500 ensures the floor edge is never visible.
 // Texture tiles at the same density as floor_plane_vertices (5 units per tile).
 static constexpr std::array<pos_normal_uv_vertex_t, 6> large_floor_vertices = {{
@@ -333,6 +330,11 @@ struct scene_t {
     std::vector<pos_light_state_t>  pos_lights;
     std::vector<spot_light_state_t> spot_lights;
 
+    // Light indicators: a root holding the camera offset, then one child per positional light
+    // and one per spot light, in that order. Rebuilt when the lights change; otherwise only the
+    // root moves, with the camera.
+    scene_graph_t m_indicators;
+
     key_edge_t m_p_edge;
     key_edge_t m_c_edge;
     key_edge_t m_g_edge;
@@ -343,13 +345,31 @@ struct scene_t {
 
     bool update(input_t const &in);
     void render(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass);
+    void build_indicators();
 };
 
+void scene_t::build_indicators() {
+    glm::mat4 const scale = glm::scale(glm::mat4{1.0f}, glm::vec3(0.2f));
+
+    m_indicators.clear();
+    node_id_t const root = m_indicators.add(no_node);
+    for (auto const &light : pos_lights)
+        m_indicators.add(root, glm::translate(glm::mat4{1.0f}, light.position) * scale);
+    for (auto const &light : spot_lights) {
+        glm::vec3 dir = light.direction;
+        glm::vec3 up =
+            (std::abs(dir.y) > 0.99f) ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+        glm::mat4 rotation = glm::inverse(glm::lookAt(glm::vec3(0.0f), dir, up));
+        m_indicators.add(root, glm::translate(glm::mat4{1.0f}, light.position) * rotation * scale);
+    }
+}
+
 std::expected<scene_t, std::string> create_scene(engine_t &engine) {
     scene_t scene;
     scene.camera = camera_t(engine.window, {0.0f, 0.5f, 3.0f});
     scene.pos_lights.assign(PRESETS[0].pos_lights.begin(), PRESETS[0].pos_lights.end());
     scene.spot_lights.assign(PRESETS[0].spot_lights.begin(), PRESETS[0].spot_lights.end());
+    scene.build_indicators();
 
     if (auto r = init_imgui(engine); !r) return std::unexpected(r.error());
     ImGui::GetIO().IniFilename = nullptr;
@@ -511,7 +531,8 @@ bool scene_t::update(input_t const &in) {
 
     camera.update(in);
 
-    bool shift = in.keys[SDL_SCANCODE_LSHIFT] || in.keys[SDL_SCANCODE_RSHIFT];
+    bool shift          = in.keys[SDL_SCANCODE_LSHIFT] || in.keys[SDL_SCANCODE_RSHIFT];
+    bool lights_changed = false;
 
     if (m_p_edge(in.keys[SDL_SCANCODE_P]) && !camera.ui_mode()) {
         if (shift)
@@ -522,6 +543,7 @@ bool scene_t::update(input_t const &in) {
         m_clear_color      = preset.clear_color;
         pos_lights.assign(preset.pos_lights.begin(), preset.pos_lights.end());
         spot_lights.assign(preset.spot_lights.begin(), preset.spot_lights.end());
+        lights_changed = true;
     }
 
     if (m_c_edge(in.keys[SDL_SCANCODE_C]) && !camera.ui_mode())
@@ -535,13 +557,19 @@ bool scene_t::update(input_t const &in) {
         bool zero_key  = in.keys[SDL_SCANCODE_0];
         bool nine_key  = in.keys[SDL_SCANCODE_9];
 
+        // Counted per kind: adding one kind and removing the other in the same frame keeps the
+        // total but still moves the indicators.
+        size_t const pos_count  = pos_lights.size();
+        size_t const spot_count = spot_lights.size();
         if (m_plus_edge(plus_key) && static_cast<int>(pos_lights.size()) < MAX_POS_LIGHTS)
             pos_lights.push_back({.position = {0.0f, 1.0f, 0.0f}});
         if (m_minus_edge(minus_key) && !pos_lights.empty()) pos_lights.pop_back();
         if (m_zero_edge(zero_key) && static_cast<int>(spot_lights.size()) < MAX_SPOT_LIGHTS)
             spot_lights.push_back({.position = {0.0f, 2.0f, 0.0f}});
         if (m_nine_edge(nine_key) && !spot_lights.empty()) spot_lights.pop_back();
+        lights_changed |= pos_lights.size() != pos_count || spot_lights.size() != spot_count;
     }
+    if (lights_changed) build_indicators();
 
     ImGui::SetNextWindowPos(ImVec2(6.0f, 6.0f), ImGuiCond_Once);
     ImGui::Begin("Scene", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
@@ -587,34 +615,8 @@ void scene_t::render(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
     scene_params_t window_params = opaque_params;
     window_params.shininess      = 128.0f;
 
-    pos_lights_block_t<MAX_POS_LIGHTS> pos_block;
-    for (int i = 0; i < static_cast<int>(pos_lights.size()); ++i) {
-        pos_block.lights[i] = {
-            .position  = glm::vec4(pos_lights[i].position - camera.position, 0.0f),
-            .ambient   = glm::vec4(pos_lights[i].ambient, 0.0f),
-            .diffuse   = glm::vec4(pos_lights[i].diffuse, 0.0f),
-            .specular  = glm::vec4(pos_lights[i].specular, 0.0f),
-            .constant  = pos_lights[i].constant,
-            .linear    = pos_lights[i].linear,
-            .quadratic = pos_lights[i].quadratic,
-        };
-    }
-
-    spot_lights_block_t<MAX_SPOT_LIGHTS> spot_block;
-    for (int i = 0; i < static_cast<int>(spot_lights.size()); ++i) {
-        spot_block.lights[i] = {
-            .position     = glm::vec4(spot_lights[i].position - camera.position, 0.0f),
-            .direction    = glm::vec4(spot_lights[i].direction, 0.0f),
-            .ambient      = glm::vec4(spot_lights[i].ambient, 0.0f),
-            .diffuse      = glm::vec4(spot_lights[i].diffuse, 0.0f),
-            .specular     = glm::vec4(spot_lights[i].specular, 0.0f),
-            .cutoff       = glm::cos(glm::radians(spot_lights[i].inner_degrees)),
-            .outer_cutoff = glm::cos(glm::radians(spot_lights[i].outer_degrees)),
-            .constant     = spot_lights[i].constant,
-            .linear       = spot_lights[i].linear,
-            .quadratic    = spot_lights[i].quadratic,
-        };
-    }
+    auto const pos_block  = pack_pos_lights<MAX_POS_LIGHTS>(pos_lights, camera.position);
+    auto const spot_block = pack_spot_lights<MAX_SPOT_LIGHTS>(spot_lights, camera.position);
 
     auto const           &fl                 = preset.flashlight;
     flashlight_uniforms_t flashlight_uniform = {
@@ -664,15 +666,16 @@ void scene_t::render(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
     }
 
     // Light indicators.
+    m_indicators.set_local(0, glm::translate(glm::mat4{1.0f}, -camera.position));
+    m_indicators.update();
+    node_id_t node = 1;
+
     SDL_BindGPUGraphicsPipeline(pass, cube_indicator_pipeline.get());
     push_vertex_uniform(cmd, 1, view);
     push_vertex_uniform(cmd, 2, proj);
     for (auto const &light : pos_lights) {
         push_fragment_uniform(cmd, 0, glm::vec4(light.ambient + light.diffuse, 1.0f));
-        auto model = glm::scale(
-            glm::translate(glm::mat4{1.0f}, light.position - camera.position), glm::vec3(0.2f)
-        );
-        push_vertex_uniform(cmd, 0, model);
+        push_vertex_uniform(cmd, 0, m_indicators.world(node++));
         draw(cube_geometry, gpu_material_t{}, pass);
     }
 
@@ -681,23 +684,13 @@ void scene_t::render(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
     push_vertex_uniform(cmd, 2, proj);
     for (auto const &light : spot_lights) {
         push_fragment_uniform(cmd, 0, glm::vec4(light.ambient + light.diffuse, 1.0f));
-        glm::vec3 dir = light.direction;
-        glm::vec3 up =
-            (std::abs(dir.y) > 0.99f) ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
-        glm::mat4 rotation = glm::inverse(glm::lookAt(glm::vec3(0.0f), dir, up));
-        auto model = glm::translate(glm::mat4{1.0f}, light.position - camera.position) * rotation *
-                     glm::scale(glm::mat4{1.0f}, glm::vec3(0.2f));
-        push_vertex_uniform(cmd, 0, model);
+        push_vertex_uniform(cmd, 0, m_indicators.world(node++));
         draw(pyramid_geometry, gpu_material_t{}, pass);
     }
 
     // Transparent windows: sort farthest-first, then two-pass cull (back faces then front).
     // Window pipelines use fixed FRONT/BACK cull modes -- independent of the cube cull toggle.
-    std::vector<model_placement_t> sorted(preset.windows.begin(), preset.windows.end());
-    std::ranges::sort(sorted, [&](auto const &a, auto const &b) {
-        return glm::length(a.position - camera.position) >
-               glm::length(b.position - camera.position);
-    });
+    auto const sorted = sorted_back_to_front(preset.windows, camera.position);
 
     auto const draw_windows = [&](float normal_flip) {
         push_vertex_uniform(cmd, 3, normal_flip);
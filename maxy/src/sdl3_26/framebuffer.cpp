@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <cmath>
 #include <print>
 #include <span>
@@ -10,9 +11,12 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <imgui.h>
 
+#include "dynamic_resolution.hpp"
 #include "engine.hpp"
 #include "geometry.hpp"
 #include "lights.hpp"
+#include "post.hpp"
+#include "render_graph.hpp"
 
 constexpr int WINDOW_WIDTH  = 1024;
 constexpr int WINDOW_HEIGHT = 768;
@@ -292,6 +296,17 @@ const std::array<preset_t, 4>
     };
 
 constexpr std::array<const char *, 5> KERNEL_NAMES = {"None", "Blur", "Edge", "Sharpen", "Emboss"};
+constexpr std::array<std::array<float, 9>, 3> KERNELS = {
+    edge_kernel, sharpen_kernel, emboss_kernel
+};
+
+// Order of the post-processing stack; K, I and V switch the entries on and off.
+enum post_slot_t { POST_BLUR, POST_KERNEL, POST_INVERT, POST_GREY };
+
+// L starts a synthetic load spike: for SPIKE_SECONDS the floor is shaded m_load_draws extra
+// times, a cost that scales with the pixel count, like real fragment-bound load.
+constexpr float  SPIKE_SECONDS = 3.0f;
+constexpr size_t HISTORY_SIZE  = 240; // frames plotted in the dynamic resolution panel
 
 // Fullscreen quad for the screen pass. NDC y=-1 is top in Vulkan/SDL3 GPU, UV v=0 is top.
 struct screen_vertex_t {
@@ -332,6 +347,7 @@ struct scene_t {
     gpu_pipeline_t cube_indicator_pipeline;
     gpu_pipeline_t pyramid_indicator_pipeline;
     gpu_pipeline_t screen_pipeline;
+    gpu_pipeline_t load_pipeline; // depth_equal_desc of the floor: reshades, same image
 
     gpu_geometry_t cube_geometry;
     gpu_geometry_t floor_geometry;
@@ -344,7 +360,21 @@ struct scene_t {
     gpu_material_t window_material;
     gpu_sampler_t  screen_sampler;
 
-    tracked_color_target_t color_target;
+    post_stack_t    post;
+    SDL_GPUTexture *m_post_output = nullptr; // set by the screen pass's prepare
+
+    // The scene renders into the top-left m_viewport of an m_target_size target; the screen
+    // pass scales that part up to the window. Both are set after update (see main).
+    dynamic_resolution_t resolution;
+    glm::ivec2           m_target_size = {WINDOW_WIDTH, WINDOW_HEIGHT};
+    glm::ivec2           m_viewport    = {WINDOW_WIDTH, WINDOW_HEIGHT};
+    glm::vec2            m_uv_scale    = {1.0f, 1.0f};
+    int                  m_load_draws  = 16;
+    float                m_spike_left  = 0.0f; // seconds
+
+    std::array<float, HISTORY_SIZE> m_frame_ms_history = {};
+    std::array<float, HISTORY_SIZE> m_scale_history    = {};
+    size_t                          m_history_next     = 0;
 
     camera_t   camera;
     float      m_aspect_ratio  = static_cast<float>(WINDOW_WIDTH) / WINDOW_HEIGHT;
@@ -352,8 +382,6 @@ struct scene_t {
     size_t     m_preset_index  = 0;
     bool       m_flashlight_on = true;
     uint32_t   m_kernel_idx    = 0; // 0=none, 1=blur, 2=edge, 3=sharpen, 4=emboss
-    bool       m_invert_on     = false;
-    bool       m_grey_on       = false;
 
     std::vector<pos_light_state_t>  pos_lights;
     std::vector<spot_light_state_t> spot_lights;
@@ -367,6 +395,7 @@ struct scene_t {
     key_edge_t m_minus_edge;
     key_edge_t m_zero_edge;
     key_edge_t m_nine_edge;
+    key_edge_t m_l_edge;
 
     bool update(input_t const &in);
     void render_scene(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass);
@@ -398,21 +427,24 @@ std::expected<scene_t, std::string> create_scene(engine_t &engine) {
     if (!cube_pipeline) return std::unexpected(cube_pipeline.error());
     scene.cube_pipeline = std::move(*cube_pipeline);
 
-    auto floor_pipeline = create_pipeline(
-        engine, {
-                    .vertex_shader            = "shaders/sdl3_24/lit.vert.spv",
-                    .fragment_shader          = "shaders/sdl3_24/lit.frag.spv",
-                    .vertex_uniform_buffers   = 4,
-                    .fragment_uniform_buffers = 4,
-                    .fragment_samplers        = 2,
-                    .vertex_buffer_descs      = pos_normal_uv_buffer_descs,
-                    .vertex_attributes        = pos_normal_uv_vertex_attributes,
-                    .enable_depth_test        = true,
-                }
-    );
+    pipeline_desc_t const floor_desc = {
+        .vertex_shader            = "shaders/sdl3_24/lit.vert.spv",
+        .fragment_shader          = "shaders/sdl3_24/lit.frag.spv",
+        .vertex_uniform_buffers   = 4,
+        .fragment_uniform_buffers = 4,
+        .fragment_samplers        = 2,
+        .vertex_buffer_descs      = pos_normal_uv_buffer_descs,
+        .vertex_attributes        = pos_normal_uv_vertex_attributes,
+        .enable_depth_test        = true,
+    };
+    auto floor_pipeline = create_pipeline(engine, floor_desc);
     if (!floor_pipeline) return std::unexpected(floor_pipeline.error());
     scene.floor_pipeline = std::move(*floor_pipeline);
 
+    auto load_pipeline = create_pipeline(engine, depth_equal_desc(floor_desc));
+    if (!load_pipeline) return std::unexpected(load_pipeline.error());
+    scene.load_pipeline = std::move(*load_pipeline);
+
     auto window_back = create_pipeline(
         engine, {
                     .vertex_shader            = "shaders/sdl3_24/lit.vert.spv",
@@ -481,8 +513,9 @@ std::expected<scene_t, std::string> create_scene(engine_t &engine) {
     // No depth test: the quad covers everything and there is no depth attachment in pass 2.
     auto screen_pipe = create_pipeline(
         engine, {
-                    .vertex_shader            = "shaders/sdl3_26/screen.vert.spv",
+                    .vertex_shader            = "shaders/sdl3_26/screen_scaled.vert.spv",
                     .fragment_shader          = "shaders/sdl3_26/screen.frag.spv",
+                    .vertex_uniform_buffers   = 1,
                     .fragment_uniform_buffers = 1,
                     .fragment_samplers        = 1,
                     .vertex_buffer_descs      = std::span(&screen_buffer_desc, 1),
@@ -570,9 +603,15 @@ std::expected<scene_t, std::string> create_scene(engine_t &engine) {
     if (!screen_samp) return std::unexpected(screen_samp.error());
     scene.screen_sampler = std::move(*screen_samp);
 
-    auto color_target = create_tracked_color_target(engine);
-    if (!color_target) return std::unexpected(color_target.error());
-    scene.color_target = std::move(*color_target);
+    auto post = create_post_stack(engine);
+    if (!post) return std::unexpected(post.error());
+    scene.post         = std::move(*post);
+    scene.post.effects = {
+        {.kind = post_effect_kind_t::gaussian_blur, .enabled = false, .radius = 16.0f},
+        {.kind = post_effect_kind_t::kernel, .enabled = false},
+        {.kind = post_effect_kind_t::invert, .enabled = false},
+        {.kind = post_effect_kind_t::greyscale, .enabled = false},
+    };
 
     return scene;
 }
@@ -596,15 +635,32 @@ bool scene_t::update(input_t const &in) {
         spot_lights.assign(preset.spot_lights.begin(), preset.spot_lights.end());
     }
 
-    if (m_e_edge(in.keys[SDL_SCANCODE_K]) && !camera.ui_mode())
-        m_kernel_idx = (m_kernel_idx + 1) % static_cast<uint32_t>(KERNEL_NAMES.size());
+    auto &blur   = post.effects[POST_BLUR];
+    auto &kernel = post.effects[POST_KERNEL];
+    auto &invert = post.effects[POST_INVERT];
+    auto &grey   = post.effects[POST_GREY];
 
-    if (m_i_edge(in.keys[SDL_SCANCODE_I]) && !camera.ui_mode()) m_invert_on = !m_invert_on;
+    if (m_e_edge(in.keys[SDL_SCANCODE_K]) && !camera.ui_mode()) {
+        m_kernel_idx   = (m_kernel_idx + 1) % static_cast<uint32_t>(KERNEL_NAMES.size());
+        blur.enabled   = m_kernel_idx == 1;
+        kernel.enabled = m_kernel_idx >= 2;
+        if (kernel.enabled) kernel.kernel = KERNELS[m_kernel_idx - 2];
+    }
 
-    if (m_v_edge(in.keys[SDL_SCANCODE_V]) && !camera.ui_mode()) m_grey_on = !m_grey_on;
+    if (m_i_edge(in.keys[SDL_SCANCODE_I]) && !camera.ui_mode()) invert.enabled = !invert.enabled;
+
+    if (m_v_edge(in.keys[SDL_SCANCODE_V]) && !camera.ui_mode()) grey.enabled = !grey.enabled;
 
     if (m_g_edge(in.keys[SDL_SCANCODE_G]) && !camera.ui_mode()) m_flashlight_on = !m_flashlight_on;
 
+    m_spike_left = std::max(m_spike_left - in.dt, 0.0f);
+    if (m_l_edge(in.keys[SDL_SCANCODE_L]) && !camera.ui_mode()) m_spike_left = SPIKE_SECONDS;
+
+    resolution.update(in.dt * 1000.0f);
+    m_frame_ms_history[m_history_next] = in.dt * 1000.0f;
+    m_scale_history[m_history_next]    = resolution.scale;
+    m_history_next                     = (m_history_next + 1) % HISTORY_SIZE;
+
     if (!camera.ui_mode()) {
         bool plus_key  = shift && in.keys[SDL_SCANCODE_EQUALS];
         bool minus_key = in.keys[SDL_SCANCODE_MINUS];
@@ -632,8 +688,43 @@ bool scene_t::update(input_t const &in) {
     );
     ImGui::Separator();
     ImGui::LabelText("Kernel (K)", "%s", KERNEL_NAMES[m_kernel_idx]);
-    ImGui::LabelText("Invert (I)", "%s", m_invert_on ? "on" : "off");
-    ImGui::LabelText("Greyscale (V)", "%s", m_grey_on ? "on" : "off");
+    if (blur.enabled) {
+        ImGui::SliderFloat("Blur radius", &blur.radius, 1.0f, 4.0f * POST_MAX_BLUR_RADIUS);
+        int resolution = std::countr_zero(blur.downsample);
+        if (ImGui::Combo("Blur resolution", &resolution, "Full\0Half\0Quarter\0"))
+            blur.downsample = 1u << resolution;
+        ImGui::Checkbox("Compute blur", &blur.compute);
+    }
+    ImGui::LabelText("Invert (I)", "%s", invert.enabled ? "on" : "off");
+    ImGui::LabelText("Greyscale (V)", "%s", grey.enabled ? "on" : "off");
+    ImGui::LabelText("Post targets", "%zu", post.pool.texture_count());
+    ImGui::Separator();
+    ImGui::Checkbox("Dynamic resolution", &resolution.enabled);
+    ImGui::SliderFloat("Budget (ms)", &resolution.config.budget_ms, 4.0f, 33.3f);
+    ImGui::LabelText(
+        "Scale", "%.2f in %dx%d (%d reallocations)", resolution.scale, m_target_size.x,
+        m_target_size.y, resolution.allocations
+    );
+    ImGui::SliderInt("Spike draws", &m_load_draws, 1, 64);
+    if (m_spike_left > 0.0f) ImGui::LabelText("Load spike (L)", "%.1f s left", m_spike_left);
+    else ImGui::LabelText("Load spike (L)", "off");
+    {
+        auto sorted = m_frame_ms_history;
+        std::ranges::sort(sorted);
+        ImGui::LabelText(
+            "Frame p50 / p99", "%.2f / %.2f ms", sorted[HISTORY_SIZE / 2],
+            sorted[HISTORY_SIZE * 99 / 100]
+        );
+    }
+    int const offset = static_cast<int>(m_history_next);
+    ImGui::PlotLines(
+        "Frame ms", m_frame_ms_history.data(), static_cast<int>(HISTORY_SIZE), offset, nullptr,
+        0.0f, 2.0f * resolution.config.budget_ms, ImVec2(200.0f, 60.0f)
+    );
+    ImGui::PlotLines(
+        "Scale", m_scale_history.data(), static_cast<int>(HISTORY_SIZE), offset, nullptr, 0.0f,
+        1.0f, ImVec2(200.0f, 40.0f)
+    );
     ImGui::Separator();
     ImGui::LabelText("Flashlight (G)", "%s", m_flashlight_on ? "on" : "off");
     ImGui::LabelText(
@@ -649,6 +740,11 @@ bool scene_t::update(input_t const &in) {
 }
 
 void scene_t::render_scene(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
+    SDL_GPUViewport const viewport = {
+        0.0f, 0.0f, static_cast<float>(m_viewport.x), static_cast<float>(m_viewport.y), 0.0f, 1.0f
+    };
+    SDL_SetGPUViewport(pass, &viewport);
+
     glm::mat4 view = camera.rotation_view();
     glm::mat4 proj = glm::perspective(glm::radians(camera.fov), m_aspect_ratio, 0.1f, 100.0f);
 
@@ -721,6 +817,10 @@ void scene_t::render_scene(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
         auto model = glm::translate(glm::mat4{1.0f}, -camera.position);
         push_vertex_uniform(cmd, 0, model);
         draw(floor_geometry, floor_material, pass);
+        if (m_spike_left > 0.0f) {
+            SDL_BindGPUGraphicsPipeline(pass, load_pipeline.get());
+            for (int i = 0; i < m_load_draws; ++i) draw(floor_geometry, floor_material, pass);
+        }
     }
 
     SDL_BindGPUGraphicsPipeline(pass, cube_pipeline.get());
@@ -804,17 +904,20 @@ void scene_t::render_scene(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
     draw_windows(1.0f);
 }
 
+// The effects have run by now (see main): the screen pass only copies their result, scaling it up
+// when it ends in a reduced-resolution blur or the scene was drawn below window resolution.
 void scene_t::render_screen(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
-    uint32_t effect_flags = m_kernel_idx | (m_invert_on ? 0x8u : 0u) | (m_grey_on ? 0x10u : 0u);
+    uint32_t effect_flags = 0;
 
     SDL_BindGPUGraphicsPipeline(pass, screen_pipeline.get());
 
     SDL_GPUBufferBinding vb = {screen_geometry.vertex_buffer.get(), 0};
     SDL_BindGPUVertexBuffers(pass, 0, &vb, 1);
 
-    SDL_GPUTextureSamplerBinding binding = {color_target.texture.get(), screen_sampler.get()};
+    SDL_GPUTextureSamplerBinding binding = {m_post_output, screen_sampler.get()};
     SDL_BindGPUFragmentSamplers(pass, 0, &binding, 1);
 
+    push_vertex_uniform(cmd, 0, m_uv_scale);
     push_fragment_uniform(cmd, 0, effect_flags);
 
     SDL_DrawGPUPrimitives(pass, screen_geometry.vertex_count, 1, 0, 0);
@@ -835,29 +938,50 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    auto depth = create_tracked_depth(*engine);
-    if (!depth) {
-        std::println(stderr, "{}", depth.error());
-        return 1;
-    }
+    // The screen pass covers every pixel, so the swapchain is not cleared; scene depth is
+    // never read back, so it is not stored.
+    render_graph_t graph;
+    auto const     scene_color = graph.create_texture({.name = "scene color"});
+    auto const     depth       = graph.create_texture({.name = "depth", .format = DEPTH_FORMAT});
+    graph.add_pass({
+        .name  = "scene",
+        .color = {scene_color},
+        .depth = depth,
+        .draw  = [&](auto cmd, auto pass) { scene->render_scene(cmd, pass); },
+    });
+    graph.add_pass({
+        .name        = "screen",
+        .color       = {rg_swapchain},
+        .reads       = {scene_color},
+        .clear_color = false,
+        .prepare =
+            [&](auto cmd) {
+                scene->m_post_output = scene->post.apply(
+                    *engine, cmd, graph.texture(scene_color), scene->m_target_size
+                );
+                imgui_prepare(cmd);
+            },
+        .draw =
+            [&](auto cmd, auto pass) {
+                scene->render_screen(cmd, pass);
+                imgui_render(cmd, pass);
+            },
+    });
 
-    std::array<pass_desc_t, 2> passes = {{
-        {.color_target  = &scene->color_target.texture,
-         .depth_texture = &depth->texture,
-         .draw          = [&](auto cmd, auto pass) { scene->render_scene(cmd, pass); }},
-        {.load_op = SDL_GPU_LOADOP_DONT_CARE,
-         .prepare = [](auto cmd) { imgui_prepare(cmd); },
-         .draw =
-             [&](auto cmd, auto pass) {
-                 scene->render_screen(cmd, pass);
-                 imgui_render(cmd, pass);
-             }},
-    }};
-
-    auto result = run_loop(
-        *engine, [&]() { return scene->m_clear_color; }, *depth, scene->color_target,
-        [&](input_t const &in) { return scene->update(in); }, passes
-    );
+    // Sized after update and before the graph compiles, so a frame renders at the scale its own
+    // update picked.
+    auto const update = [&](input_t const &in) {
+        if (!scene->update(in)) return false;
+        auto const window    = window_pixel_size(*engine);
+        scene->m_target_size = scene->resolution.target_size(window);
+        scene->m_viewport    = scene->resolution.viewport_size(window);
+        scene->m_uv_scale    = scene->resolution.uv_scale(window);
+        graph.set_size(scene_color, scene->m_target_size);
+        graph.set_size(depth, scene->m_target_size);
+        return true;
+    };
+
+    auto result = run_loop(*engine, [&]() { return scene->m_clear_color; }, graph, update);
     if (!result) {
         std::println(stderr, "{}", result.error());
         return 1;
@@ -13,6 +13,7 @@
 #include "engine.hpp"
 #include "geometry.hpp"
 #include "lights.hpp"
+#include "render_graph.hpp"
 
 constexpr int WINDOW_WIDTH  = 1024;
 constexpr int WINDOW_HEIGHT = 768;
@@ -348,8 +349,6 @@ struct scene_t {
     gpu_material_t window_material;
     gpu_sampler_t  screen_sampler;
 
-    tracked_color_target_t color_target;
-
     camera_t   camera;
     float      m_aspect_ratio  = static_cast<float>(WINDOW_WIDTH) / WINDOW_HEIGHT;
     SDL_FColor m_clear_color   = PRESETS[0].clear_color;
@@ -374,7 +373,7 @@ struct scene_t {
     );
     void render_mirror(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass);
     void render_main(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass);
-    void render_overlay(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass);
+    void render_overlay(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass, SDL_GPUTexture *mirror);
 };
 
 std::expected<scene_t, std::string> create_scene(engine_t &engine) {
@@ -573,10 +572,6 @@ std::expected<scene_t, std::string> create_scene(engine_t &engine) {
     if (!screen_samp) return std::unexpected(screen_samp.error());
     scene.screen_sampler = std::move(*screen_samp);
 
-    auto color_target = create_tracked_color_target(engine);
-    if (!color_target) return std::unexpected(color_target.error());
-    scene.color_target = std::move(*color_target);
-
     return scene;
 }
 
@@ -821,7 +816,9 @@ void scene_t::render_main(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
     draw_world(cmd, pass, view, proj, camera.front());
 }
 
-void scene_t::render_overlay(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
+void scene_t::render_overlay(
+    SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass, SDL_GPUTexture *mirror
+) {
     constexpr uint32_t no_effects = 0u;
 
     SDL_BindGPUGraphicsPipeline(pass, overlay_pipeline.get());
@@ -829,7 +826,7 @@ void scene_t::render_overlay(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass)
     SDL_GPUBufferBinding vb = {screen_geometry.vertex_buffer.get(), 0};
     SDL_BindGPUVertexBuffers(pass, 0, &vb, 1);
 
-    SDL_GPUTextureSamplerBinding binding = {color_target.texture.get(), screen_sampler.get()};
+    SDL_GPUTextureSamplerBinding binding = {mirror, screen_sampler.get()};
     SDL_BindGPUFragmentSamplers(pass, 0, &binding, 1);
 
     push_vertex_uniform(cmd, 0, PIP_TRANSFORM);
@@ -853,28 +850,38 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    auto depth = create_tracked_depth(*engine);
-    if (!depth) {
-        std::println(stderr, "{}", depth.error());
-        return 1;
-    }
-
-    std::array<pass_desc_t, 3> passes = {{
-        {.color_target  = &scene->color_target.texture,
-         .depth_texture = &depth->texture,
-         .draw          = [&](auto cmd, auto pass) { scene->render_mirror(cmd, pass); }},
-        {.depth_texture = &depth->texture,
-         .prepare       = [](auto cmd) { imgui_prepare(cmd); },
-         .draw          = [&](auto cmd, auto pass) { scene->render_main(cmd, pass); }},
-        {.load_op = SDL_GPU_LOADOP_LOAD, .draw = [&](auto cmd, auto pass) {
-             scene->render_overlay(cmd, pass);
-             imgui_render(cmd, pass);
-         }},
-    }};
+    // Both views clear depth, so neither pass stores it.
+    render_graph_t graph;
+    auto const     mirror_color = graph.create_texture({.name = "mirror color"});
+    auto const     depth        = graph.create_texture({.name = "depth", .format = DEPTH_FORMAT});
+    graph.add_pass({
+        .name  = "mirror",
+        .color = {mirror_color},
+        .depth = depth,
+        .draw  = [&](auto cmd, auto pass) { scene->render_mirror(cmd, pass); },
+    });
+    graph.add_pass({
+        .name    = "main",
+        .color   = {rg_swapchain},
+        .depth   = depth,
+        .prepare = [](auto cmd) { imgui_prepare(cmd); },
+        .draw    = [&](auto cmd, auto pass) { scene->render_main(cmd, pass); },
+    });
+    graph.add_pass({
+        .name        = "overlay",
+        .color       = {rg_swapchain},
+        .reads       = {mirror_color},
+        .clear_color = false,
+        .draw =
+            [&](auto cmd, auto pass) {
+                scene->render_overlay(cmd, pass, graph.texture(mirror_color));
+                imgui_render(cmd, pass);
+            },
+    });
 
     auto result = run_loop(
-        *engine, [&]() { return scene->m_clear_color; }, *depth, scene->color_target,
-        [&](input_t const &in) { return scene->update(in); }, passes
+        *engine, [&]() { return scene->m_clear_color; }, graph,
+        [&](input_t const &in) { return scene->update(in); }
     );
     if (!result) {
         std::println(stderr, "{}", result.error());
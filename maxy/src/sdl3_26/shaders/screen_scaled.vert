@@ -0,0 +1,17 @@
+#version 460 core
+
+layout(location = 0) in vec2 a_position;
+layout(location = 1) in vec2 a_tex_coord;
+
+layout(location = 0) out vec2 frag_tex_coord;
+
+// Part of the texture the scene was drawn into, from its top-left corner: the dynamic
+// resolution viewport over the size of the target.
+layout(set = 1, binding = 0) uniform UvScale {
+    vec2 uv_scale;
+};
+
+void main() {
+    frag_tex_coord = a_tex_coord * uv_scale;
+    gl_Position = vec4(a_position, 0.0, 1.0);
+}
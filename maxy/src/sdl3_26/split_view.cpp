@@ -13,6 +13,7 @@
 #include "engine.hpp"
 #include "geometry.hpp"
 #include "lights.hpp"
+#include "render_graph.hpp"
 
 constexpr int WINDOW_WIDTH  = 1024;
 constexpr int WINDOW_HEIGHT = 768;
@@ -348,9 +349,6 @@ struct scene_t {
     gpu_material_t window_material;
     gpu_sampler_t  screen_sampler;
 
-    tracked_color_target_t mirror_color_target;
-    tracked_color_target_t scene_color_target;
-
     camera_t   camera;
     float      m_aspect_ratio  = static_cast<float>(WINDOW_WIDTH) / WINDOW_HEIGHT;
     SDL_FColor m_clear_color   = PRESETS[0].clear_color;
@@ -381,7 +379,10 @@ struct scene_t {
     );
     void render_mirror(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass);
     void render_main(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass);
-    void render_composite(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass);
+    void render_composite(
+        SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass, SDL_GPUTexture *scene_color,
+        SDL_GPUTexture *mirror_color
+    );
 };
 
 std::expected<scene_t, std::string> create_scene(engine_t &engine) {
@@ -580,14 +581,6 @@ std::expected<scene_t, std::string> create_scene(engine_t &engine) {
     if (!screen_samp) return std::unexpected(screen_samp.error());
     scene.screen_sampler = std::move(*screen_samp);
 
-    auto mirror_target = create_tracked_color_target(engine);
-    if (!mirror_target) return std::unexpected(mirror_target.error());
-    scene.mirror_color_target = std::move(*mirror_target);
-
-    auto scene_target = create_tracked_color_target(engine);
-    if (!scene_target) return std::unexpected(scene_target.error());
-    scene.scene_color_target = std::move(*scene_target);
-
     return scene;
 }
 
@@ -838,7 +831,10 @@ void scene_t::render_main(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
     draw_world(cmd, pass, view, proj);
 }
 
-void scene_t::render_composite(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
+void scene_t::render_composite(
+    SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass, SDL_GPUTexture *scene_color,
+    SDL_GPUTexture *mirror_color
+) {
     uint32_t scene_flags  = m_kernel_idx | (m_invert_on ? 0x8u : 0u) | (m_grey_on ? 0x10u : 0u);
     uint32_t mirror_flags = scene_flags;
 
@@ -847,17 +843,13 @@ void scene_t::render_composite(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pas
     SDL_GPUBufferBinding vb = {screen_geometry.vertex_buffer.get(), 0};
     SDL_BindGPUVertexBuffers(pass, 0, &vb, 1);
 
-    SDL_GPUTextureSamplerBinding scene_binding = {
-        scene_color_target.texture.get(), screen_sampler.get()
-    };
+    SDL_GPUTextureSamplerBinding scene_binding = {scene_color, screen_sampler.get()};
     SDL_BindGPUFragmentSamplers(pass, 0, &scene_binding, 1);
     push_vertex_uniform(cmd, 0, glm::mat4{1.0f});
     push_fragment_uniform(cmd, 0, scene_flags);
     SDL_DrawGPUPrimitives(pass, screen_geometry.vertex_count, 1, 0, 0);
 
-    SDL_GPUTextureSamplerBinding mirror_binding = {
-        mirror_color_target.texture.get(), screen_sampler.get()
-    };
+    SDL_GPUTextureSamplerBinding mirror_binding = {mirror_color, screen_sampler.get()};
     SDL_BindGPUFragmentSamplers(pass, 0, &mirror_binding, 1);
     push_vertex_uniform(cmd, 0, PIP_TRANSFORM);
     push_fragment_uniform(cmd, 0, mirror_flags);
@@ -879,33 +871,40 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    auto depth = create_tracked_depth(*engine);
-    if (!depth) {
-        std::println(stderr, "{}", depth.error());
-        return 1;
-    }
-
-    std::array<pass_desc_t, 3> passes = {{
-        {.color_target  = &scene->mirror_color_target.texture,
-         .depth_texture = &depth->texture,
-         .draw          = [&](auto cmd, auto pass) { scene->render_mirror(cmd, pass); }},
-        {.color_target  = &scene->scene_color_target.texture,
-         .depth_texture = &depth->texture,
-         .prepare =
-             [&](auto cmd) {
-                 scene->scene_color_target.update(*engine);
-                 imgui_prepare(cmd);
-             },
-         .draw = [&](auto cmd, auto pass) { scene->render_main(cmd, pass); }},
-        {.draw = [&](auto cmd, auto pass) {
-            scene->render_composite(cmd, pass);
-            imgui_render(cmd, pass);
-        }},
-    }};
+    // Both views clear depth, so neither pass stores it.
+    render_graph_t graph;
+    auto const     mirror_color = graph.create_texture({.name = "mirror color"});
+    auto const     scene_color  = graph.create_texture({.name = "scene color"});
+    auto const     depth        = graph.create_texture({.name = "depth", .format = DEPTH_FORMAT});
+    graph.add_pass({
+        .name  = "mirror",
+        .color = {mirror_color},
+        .depth = depth,
+        .draw  = [&](auto cmd, auto pass) { scene->render_mirror(cmd, pass); },
+    });
+    graph.add_pass({
+        .name    = "main",
+        .color   = {scene_color},
+        .depth   = depth,
+        .prepare = [](auto cmd) { imgui_prepare(cmd); },
+        .draw    = [&](auto cmd, auto pass) { scene->render_main(cmd, pass); },
+    });
+    graph.add_pass({
+        .name  = "composite",
+        .color = {rg_swapchain},
+        .reads = {scene_color, mirror_color},
+        .draw =
+            [&](auto cmd, auto pass) {
+                scene->render_composite(
+                    cmd, pass, graph.texture(scene_color), graph.texture(mirror_color)
+                );
+                imgui_render(cmd, pass);
+            },
+    });
 
     auto result = run_loop(
-        *engine, [&]() { return scene->m_clear_color; }, *depth, scene->mirror_color_target,
-        [&](input_t const &in) { return scene->update(in); }, passes
+        *engine, [&]() { return scene->m_clear_color; }, graph,
+        [&](input_t const &in) { return scene->update(in); }
     );
     if (!result) {
         std::println(stderr, "{}", result.error());
@@ -15,6 +15,7 @@
 #include "engine.hpp"
 #include "geometry.hpp"
 #include "lights.hpp"
+#include "render_graph.hpp"
 
 constexpr int WINDOW_WIDTH  = 1024;
 constexpr int WINDOW_HEIGHT = 768;
@@ -376,7 +377,10 @@ load_cubemap_texture(engine_t const &engine, std::span<std::string const, 6> fac
     tex_info.height                   = static_cast<Uint32>(face_h);
     tex_info.layer_count_or_depth     = 6;
     tex_info.num_levels               = 1;
-    gpu_texture_t texture{engine.gpu_device, SDL_CreateGPUTexture(engine.gpu_device, &tex_info)};
+    gpu_texture_t texture{
+        engine.gpu_device, SDL_CreateGPUTexture(engine.gpu_device, &tex_info),
+        gpu_texture_bytes(tex_info)
+    };
     if (!texture) {
         for (auto *s : surfaces)
             SDL_DestroySurface(s);
@@ -387,7 +391,8 @@ load_cubemap_texture(engine_t const &engine, std::span<std::string const, 6> fac
     transfer_info.usage                           = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
     transfer_info.size                            = total_size;
     transfer_t transfer{
-        engine.gpu_device, SDL_CreateGPUTransferBuffer(engine.gpu_device, &transfer_info)
+        engine.gpu_device, SDL_CreateGPUTransferBuffer(engine.gpu_device, &transfer_info),
+        transfer_info.size
     };
     if (!transfer) {
         for (auto *s : surfaces)
@@ -460,8 +465,6 @@ struct scene_t {
     gpu_sampler_t  cubemap_sampler;
     gpu_sampler_t  screen_sampler;
 
-    tracked_color_target_t color_target;
-
     camera_t   camera;
     float      m_aspect_ratio  = static_cast<float>(WINDOW_WIDTH) / WINDOW_HEIGHT;
     SDL_FColor m_clear_color   = PRESETS[0].clear_color;
@@ -487,7 +490,9 @@ struct scene_t {
     bool update(input_t const &in);
     void render_scene(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass);
     void render_skybox(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass);
-    void render_screen(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass);
+    void render_screen(
+        SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass, SDL_GPUTexture *scene_color
+    );
 };
 
 std::expected<scene_t, std::string> create_scene(engine_t &engine) {
@@ -724,10 +729,6 @@ std::expected<scene_t, std::string> create_scene(engine_t &engine) {
     if (!screen_samp) return std::unexpected(screen_samp.error());
     scene.screen_sampler = std::move(*screen_samp);
 
-    auto color_target = create_tracked_color_target(engine);
-    if (!color_target) return std::unexpected(color_target.error());
-    scene.color_target = std::move(*color_target);
-
     return scene;
 }
 
@@ -983,7 +984,9 @@ void scene_t::render_scene(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
     draw_windows(1.0f);
 }
 
-void scene_t::render_screen(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
+void scene_t::render_screen(
+    SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass, SDL_GPUTexture *scene_color
+) {
     uint32_t effect_flags = m_kernel_idx | (m_invert_on ? 0x8u : 0u) | (m_grey_on ? 0x10u : 0u);
 
     SDL_BindGPUGraphicsPipeline(pass, screen_pipeline.get());
@@ -991,7 +994,7 @@ void scene_t::render_screen(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass)
     SDL_GPUBufferBinding vb = {screen_geometry.vertex_buffer.get(), 0};
     SDL_BindGPUVertexBuffers(pass, 0, &vb, 1);
 
-    SDL_GPUTextureSamplerBinding binding = {color_target.texture.get(), screen_sampler.get()};
+    SDL_GPUTextureSamplerBinding binding = {scene_color, screen_sampler.get()};
     SDL_BindGPUFragmentSamplers(pass, 0, &binding, 1);
 
     push_fragment_uniform(cmd, 0, effect_flags);
@@ -1014,28 +1017,33 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    auto depth = create_tracked_depth(*engine);
-    if (!depth) {
-        std::println(stderr, "{}", depth.error());
-        return 1;
-    }
-
-    std::array<pass_desc_t, 2> passes = {{
-        {.color_target  = &scene->color_target.texture,
-         .depth_texture = &depth->texture,
-         .draw          = [&](auto cmd, auto pass) { scene->render_scene(cmd, pass); }},
-        {.load_op = SDL_GPU_LOADOP_DONT_CARE,
-         .prepare = [](auto cmd) { imgui_prepare(cmd); },
-         .draw =
-             [&](auto cmd, auto pass) {
-                 scene->render_screen(cmd, pass);
-                 imgui_render(cmd, pass);
-             }},
-    }};
+    // The screen pass covers every pixel, so the swapchain is not cleared; scene depth is
+    // never read back, so it is not stored.
+    render_graph_t graph;
+    auto const     scene_color = graph.create_texture({.name = "scene color"});
+    auto const     depth       = graph.create_texture({.name = "depth", .format = DEPTH_FORMAT});
+    graph.add_pass({
+        .name  = "scene",
+        .color = {scene_color},
+        .depth = depth,
+        .draw  = [&](auto cmd, auto pass) { scene->render_scene(cmd, pass); },
+    });
+    graph.add_pass({
+        .name        = "screen",
+        .color       = {rg_swapchain},
+        .reads       = {scene_color},
+        .clear_color = false,
+        .prepare     = [](auto cmd) { imgui_prepare(cmd); },
+        .draw =
+            [&](auto cmd, auto pass) {
+                scene->render_screen(cmd, pass, graph.texture(scene_color));
+                imgui_render(cmd, pass);
+            },
+    });
 
     auto result = run_loop(
-        *engine, [&]() { return scene->m_clear_color; }, *depth, scene->color_target,
-        [&](input_t const &in) { return scene->update(in); }, passes
+        *engine, [&]() { return scene->m_clear_color; }, graph,
+        [&](input_t const &in) { return scene->update(in); }
     );
     if (!result) {
         std::println(stderr, "{}", result.error());
@@ -23,6 +23,7 @@
 
 #include "engine.hpp"
 #include "geometry.hpp"
+#include "render_graph.hpp"
 
 constexpr int      WINDOW_WIDTH  = 1024;
 constexpr int      WINDOW_HEIGHT = 768;
@@ -73,7 +74,10 @@ std::expected<gpu_texture_t, std::string> create_dynamic_cubemap(engine_t const
     info.height               = CUBEMAP_SIZE;
     info.layer_count_or_depth = 6;
     info.num_levels           = 1;
-    gpu_texture_t tex{engine.gpu_device, SDL_CreateGPUTexture(engine.gpu_device, &info)};
+    gpu_texture_t tex{
+        engine.gpu_device, SDL_CreateGPUTexture(engine.gpu_device, &info),
+        gpu_texture_bytes(info)
+    };
     if (!tex) return sdl_error("SDL_CreateGPUTexture (dynamic cubemap) failed");
     return tex;
 }
@@ -107,9 +111,6 @@ struct scene_t {
     gpu_texture_t cubemap_depth; // shared by all face passes (cycled per pass)
     gpu_sampler_t cubemap_sampler;
 
-    tracked_depth_t        main_depth;
-    tracked_color_target_t unused_color_target; // required by the multi-pass run_loop API
-
     camera_t camera;
     float    m_aspect_ratio = static_cast<float>(WINDOW_WIDTH) / WINDOW_HEIGHT;
     float    m_box_angle    = 0.0f;
@@ -212,14 +213,6 @@ std::expected<scene_t, std::string> create_scene(engine_t &engine) {
     if (!sampler) return std::unexpected(sampler.error());
     scene.cubemap_sampler = std::move(*sampler);
 
-    auto main_depth = create_tracked_depth(engine);
-    if (!main_depth) return std::unexpected(main_depth.error());
-    scene.main_depth = std::move(*main_depth);
-
-    auto unused = create_tracked_color_target(engine);
-    if (!unused) return std::unexpected(unused.error());
-    scene.unused_color_target = std::move(*unused);
-
     return scene;
 }
 
@@ -340,24 +333,29 @@ int main(int argc, char *argv[]) {
     }
 
     // The mirror cubemaps are rebuilt in prepare (outside the swapchain pass);
-    // the main pass then samples them.
-    std::array<pass_desc_t, 1> passes = {{
-        {.depth_texture = &scene->main_depth.texture,
-         .prepare =
-             [&](SDL_GPUCommandBuffer *cmd) {
-                 scene->render_all_cubemap_faces(cmd);
-                 imgui_prepare(cmd);
-             },
-         .draw =
-             [&](SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
-                 scene->render_main(cmd, pass);
-                 imgui_render(cmd, pass);
-             }},
-    }};
+    // the main pass then samples them. They persist across frames, so they stay out of the
+    // graph, which only sees the swapchain and the main depth.
+    render_graph_t graph;
+    auto const     depth = graph.create_texture({.name = "depth", .format = DEPTH_FORMAT});
+    graph.add_pass({
+        .name  = "main",
+        .color = {rg_swapchain},
+        .depth = depth,
+        .prepare =
+            [&](SDL_GPUCommandBuffer *cmd) {
+                scene->render_all_cubemap_faces(cmd);
+                imgui_prepare(cmd);
+            },
+        .draw =
+            [&](SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
+                scene->render_main(cmd, pass);
+                imgui_render(cmd, pass);
+            },
+    });
 
     auto result = run_loop(
-        *engine, [&]() { return SDL_FColor{0.02f, 0.02f, 0.03f, 1.0f}; }, scene->main_depth,
-        scene->unused_color_target, [&](input_t const &in) { return scene->update(in); }, passes
+        *engine, [&]() { return SDL_FColor{0.02f, 0.02f, 0.03f, 1.0f}; }, graph,
+        [&](input_t const &in) { return scene->update(in); }
     );
     if (!result) {
         std::println(stderr, "{}", result.error());
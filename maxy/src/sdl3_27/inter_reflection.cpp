@@ -34,6 +34,7 @@
 #include "engine.hpp"
 #include "geometry.hpp"
 #include "lights.hpp"
+#include "render_graph.hpp"
 
 constexpr int      WINDOW_WIDTH  = 1024;
 constexpr int      WINDOW_HEIGHT = 768;
@@ -133,7 +134,10 @@ load_cubemap_texture(engine_t const &engine, std::span<std::string const, 6> fac
     tex_info.height                   = static_cast<Uint32>(face_h);
     tex_info.layer_count_or_depth     = 6;
     tex_info.num_levels               = 1;
-    gpu_texture_t texture{engine.gpu_device, SDL_CreateGPUTexture(engine.gpu_device, &tex_info)};
+    gpu_texture_t texture{
+        engine.gpu_device, SDL_CreateGPUTexture(engine.gpu_device, &tex_info),
+        gpu_texture_bytes(tex_info)
+    };
     if (!texture) {
         for (auto *s : surfaces)
             SDL_DestroySurface(s);
@@ -144,7 +148,8 @@ load_cubemap_texture(engine_t const &engine, std::span<std::string const, 6> fac
     tbuf_info.usage                           = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
     tbuf_info.size                            = total_size;
     transfer_t transfer{
-        engine.gpu_device, SDL_CreateGPUTransferBuffer(engine.gpu_device, &tbuf_info)
+        engine.gpu_device, SDL_CreateGPUTransferBuffer(engine.gpu_device, &tbuf_info),
+        tbuf_info.size
     };
     if (!transfer) {
         for (auto *s : surfaces)
@@ -201,7 +206,10 @@ std::expected<gpu_texture_t, std::string> create_dynamic_cubemap(engine_t const
     info.height               = CUBEMAP_SIZE;
     info.layer_count_or_depth = 6;
     info.num_levels           = 1;
-    gpu_texture_t tex{engine.gpu_device, SDL_CreateGPUTexture(engine.gpu_device, &info)};
+    gpu_texture_t tex{
+        engine.gpu_device, SDL_CreateGPUTexture(engine.gpu_device, &info),
+        gpu_texture_bytes(info)
+    };
     if (!tex) return sdl_error("SDL_CreateGPUTexture (dynamic cubemap) failed");
     return tex;
 }
@@ -236,10 +244,6 @@ struct scene_t {
 
     reflective_t objects[NUM_OBJECTS];
 
-    // Dummy color target: required by the multi-pass run_loop API even when all
-    // passes render to the swapchain. Never referenced by any pass_desc_t.
-    tracked_color_target_t color_target;
-
     camera_t camera;
     float    m_aspect_ratio = static_cast<float>(WINDOW_WIDTH) / WINDOW_HEIGHT;
     int      m_frame_count  = 0; // counts frames; used to seed the cubemaps
@@ -414,10 +418,6 @@ std::expected<scene_t, std::string> create_scene(engine_t &engine) {
         scene.objects[i].sampler = std::move(*samp);
     }
 
-    auto dummy_ct = create_tracked_color_target(engine);
-    if (!dummy_ct) return std::unexpected(dummy_ct.error());
-    scene.color_target = std::move(*dummy_ct);
-
     return scene;
 }
 
@@ -629,31 +629,29 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    auto depth = create_tracked_depth(*engine);
-    if (!depth) {
-        std::println(stderr, "{}", depth.error());
-        return 1;
-    }
-
     // Cubemap rendering happens in prepare (outside the swapchain render pass),
     // so that render_scene can immediately sample the freshly-built cubemaps.
-    std::array<pass_desc_t, 1> passes = {{
-        {.depth_texture = &depth->texture,
-         .prepare =
-             [&](SDL_GPUCommandBuffer *cmd) {
-                 scene->render_all_cubemap_faces(cmd);
-                 imgui_prepare(cmd);
-             },
-         .draw =
-             [&](SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
-                 scene->render_scene(cmd, pass);
-                 imgui_render(cmd, pass);
-             }},
-    }};
+    render_graph_t graph;
+    auto const     depth = graph.create_texture({.name = "depth", .format = DEPTH_FORMAT});
+    graph.add_pass({
+        .name  = "main",
+        .color = {rg_swapchain},
+        .depth = depth,
+        .prepare =
+            [&](SDL_GPUCommandBuffer *cmd) {
+                scene->render_all_cubemap_faces(cmd);
+                imgui_prepare(cmd);
+            },
+        .draw =
+            [&](SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
+                scene->render_scene(cmd, pass);
+                imgui_render(cmd, pass);
+            },
+    });
 
     auto result = run_loop(
-        *engine, [&]() { return SDL_FColor{0.1f, 0.1f, 0.1f, 1.0f}; }, *depth, scene->color_target,
-        [&](input_t const &in) { return scene->update(in); }, passes
+        *engine, [&]() { return SDL_FColor{0.1f, 0.1f, 0.1f, 1.0f}; }, graph,
+        [&](input_t const &in) { return scene->update(in); }
     );
     if (!result) {
         std::println(stderr, "{}", result.error());
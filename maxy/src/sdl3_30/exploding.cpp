@@ -0,0 +1,103 @@
+#include <print>
+
+#include <SDL3/SDL.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <imgui.h>
+
+#include "engine.hpp"
+#include "model.hpp"
+#include "visualizers.hpp"
+
+constexpr int        WINDOW_WIDTH     = 1024;
+constexpr int        WINDOW_HEIGHT    = 768;
+constexpr SDL_FColor BACKGROUND_COLOR = {0.1f, 0.1f, 0.1f, 1.0f};
+
+// The nanosuit blown apart along its face normals. The OpenGL version works the normals out in
+// a geometry shader every frame; here explode_model gives each triangle its own vertices with the
+// face normal once, at load time, and the vertex shader only moves them.
+struct scene_t {
+    gpu_pipeline_t pipeline;
+    gpu_model_t    model;
+    camera_t       camera;
+    float          m_aspect_ratio = static_cast<float>(WINDOW_WIDTH) / WINDOW_HEIGHT;
+
+    bool update(input_t const &in);
+    void render(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass);
+};
+
+bool scene_t::update(input_t const &in) {
+    m_aspect_ratio = in.aspect_ratio;
+    if (in.keys[SDL_SCANCODE_ESCAPE]) return false;
+    camera.update(in);
+
+    size_t triangles = 0;
+    for (auto const &mesh : model.meshes)
+        triangles += mesh.geometry.vertex_count / 3;
+
+    ImGui::SetNextWindowPos(ImVec2(6.0f, 6.0f), ImGuiCond_Once);
+    ImGui::Begin("Scene", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+    ImGui::LabelText("Mode", "%s", camera.ui_mode() ? "UI (` to fly)" : "Fly (` for UI)");
+    ImGui::LabelText("Triangles", "%zu", triangles);
+    ImGui::End();
+
+    return true;
+}
+
+void scene_t::render(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
+    glm::mat4 model_mat  = glm::translate(glm::mat4(1.0f), -camera.position);
+    glm::mat4 view       = camera.rotation_view();
+    glm::mat4 projection = glm::perspective(glm::radians(camera.fov), m_aspect_ratio, 0.1f, 100.0f);
+
+    SDL_BindGPUGraphicsPipeline(pass, pipeline.get());
+    push_vertex_uniform(cmd, 1, view);
+    push_vertex_uniform(cmd, 2, projection);
+    push_vertex_uniform(cmd, 3, static_cast<float>(SDL_GetTicks()) / 1000.0f);
+    draw_model(cmd, model, model_mat, 0, {texture_slot_t::diffuse}, pass);
+}
+
+std::expected<scene_t, std::string> create_scene(engine_t &engine) {
+    scene_t scene;
+    scene.camera = camera_t(engine.window);
+
+    if (auto r = init_imgui(engine); !r) return std::unexpected(r.error());
+    ImGuiIO &io    = ImGui::GetIO();
+    io.IniFilename = nullptr;
+    io.Fonts->AddFontFromFileTTF(
+        (std::string(ASSETS_PATH) + "fonts/NotoSans-Regular.ttf").c_str(), 20.0f
+    );
+
+    auto pipe = create_pipeline(
+        engine, {
+                    .vertex_shader          = "shaders/sdl3_30/exploding.vert.spv",
+                    .fragment_shader        = "shaders/sdl3_30/model.frag.spv",
+                    .vertex_uniform_buffers = 4,
+                    .fragment_samplers      = 1,
+                    .vertex_buffer_descs    = pos_normal_uv_buffer_descs,
+                    .vertex_attributes      = pos_normal_uv_vertex_attributes,
+                    .enable_depth_test      = true,
+                }
+    );
+    if (!pipe) return std::unexpected(pipe.error());
+    scene.pipeline = std::move(*pipe);
+
+    auto model =
+        load_model(engine, std::string(ASSETS_PATH) + "objects/nanosuit/nanosuit.obj", true);
+    if (!model) return std::unexpected(model.error());
+    if (auto r = explode_model(engine, *model); !r) return std::unexpected(r.error());
+    scene.model = std::move(*model);
+
+    return scene;
+}
+
+int main(int argc, char *argv[]) {
+    auto result = run_app(
+        argc, argv, "SDL3 30 - Exploding models", WINDOW_WIDTH, WINDOW_HEIGHT, BACKGROUND_COLOR,
+        [](engine_t &engine) { return create_scene(engine); }
+    );
+    if (!result) {
+        std::println(stderr, "{}", result.error());
+        return 1;
+    }
+    return 0;
+}
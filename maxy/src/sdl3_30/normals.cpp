@@ -0,0 +1,123 @@
+#include <print>
+
+#include <SDL3/SDL.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <imgui.h>
+
+#include "engine.hpp"
+#include "model.hpp"
+#include "visualizers.hpp"
+
+constexpr int        WINDOW_WIDTH     = 1024;
+constexpr int        WINDOW_HEIGHT    = 768;
+constexpr SDL_FColor BACKGROUND_COLOR = {0.1f, 0.1f, 0.1f, 1.0f};
+
+// The backpack with a line along the normal of every vertex. The OpenGL version expands each
+// triangle into three lines in a geometry shader; here the mesh's vertex buffer is read once per
+// instance and each instance is one line.
+struct scene_t {
+    gpu_pipeline_t model_pipeline;
+    gpu_pipeline_t lines_pipeline;
+    gpu_model_t    model;
+    camera_t       camera;
+    bool           show_normals   = true;
+    float          m_aspect_ratio = static_cast<float>(WINDOW_WIDTH) / WINDOW_HEIGHT;
+
+    bool update(input_t const &in);
+    void render(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass);
+};
+
+bool scene_t::update(input_t const &in) {
+    m_aspect_ratio = in.aspect_ratio;
+    if (in.keys[SDL_SCANCODE_ESCAPE]) return false;
+    camera.update(in);
+
+    size_t lines = 0;
+    for (auto const &mesh : model.meshes)
+        lines += mesh.geometry.vertex_bytes / sizeof(pos_normal_uv_vertex_t);
+
+    ImGui::SetNextWindowPos(ImVec2(6.0f, 6.0f), ImGuiCond_Once);
+    ImGui::Begin("Scene", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+    ImGui::LabelText("Mode", "%s", camera.ui_mode() ? "UI (` to fly)" : "Fly (` for UI)");
+    ImGui::Checkbox("Normals", &show_normals);
+    ImGui::LabelText("Lines", "%zu", lines);
+    ImGui::End();
+
+    return true;
+}
+
+void scene_t::render(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
+    glm::mat4 model_mat  = glm::translate(glm::mat4(1.0f), -camera.position);
+    glm::mat4 view       = camera.rotation_view();
+    glm::mat4 projection = glm::perspective(glm::radians(camera.fov), m_aspect_ratio, 0.1f, 100.0f);
+
+    SDL_BindGPUGraphicsPipeline(pass, model_pipeline.get());
+    push_vertex_uniform(cmd, 1, view);
+    push_vertex_uniform(cmd, 2, projection);
+    draw_model(cmd, model, model_mat, 0, {texture_slot_t::diffuse}, pass);
+
+    if (!show_normals) return;
+    SDL_BindGPUGraphicsPipeline(pass, lines_pipeline.get());
+    push_vertex_uniform(cmd, 1, view);
+    push_vertex_uniform(cmd, 2, projection);
+    draw_normal_lines(cmd, model, model_mat, 0, pass);
+}
+
+std::expected<scene_t, std::string> create_scene(engine_t &engine) {
+    scene_t scene;
+    scene.camera = camera_t(engine.window);
+
+    if (auto r = init_imgui(engine); !r) return std::unexpected(r.error());
+    ImGuiIO &io    = ImGui::GetIO();
+    io.IniFilename = nullptr;
+    io.Fonts->AddFontFromFileTTF(
+        (std::string(ASSETS_PATH) + "fonts/NotoSans-Regular.ttf").c_str(), 20.0f
+    );
+
+    auto model_pipe = create_pipeline(
+        engine, {
+                    .vertex_shader          = "shaders/sdl3_30/model.vert.spv",
+                    .fragment_shader        = "shaders/sdl3_30/model.frag.spv",
+                    .vertex_uniform_buffers = 3,
+                    .fragment_samplers      = 1,
+                    .vertex_buffer_descs    = pos_normal_uv_buffer_descs,
+                    .vertex_attributes      = pos_normal_uv_vertex_attributes,
+                    .enable_depth_test      = true,
+                }
+    );
+    if (!model_pipe) return std::unexpected(model_pipe.error());
+    scene.model_pipeline = std::move(*model_pipe);
+
+    auto lines_pipe = create_pipeline(
+        engine, {
+                    .vertex_shader          = "shaders/sdl3_30/normal_lines.vert.spv",
+                    .fragment_shader        = "shaders/sdl3_30/normal_lines.frag.spv",
+                    .vertex_uniform_buffers = 3,
+                    .vertex_buffer_descs    = normal_line_buffer_descs,
+                    .vertex_attributes      = normal_line_vertex_attributes,
+                    .enable_depth_test      = true,
+                    .primitive_type         = SDL_GPU_PRIMITIVETYPE_LINELIST,
+                }
+    );
+    if (!lines_pipe) return std::unexpected(lines_pipe.error());
+    scene.lines_pipeline = std::move(*lines_pipe);
+
+    auto model = load_model(engine, std::string(ASSETS_PATH) + "objects/backpack/backpack.obj");
+    if (!model) return std::unexpected(model.error());
+    scene.model = std::move(*model);
+
+    return scene;
+}
+
+int main(int argc, char *argv[]) {
+    auto result = run_app(
+        argc, argv, "SDL3 30 - Normals as needles", WINDOW_WIDTH, WINDOW_HEIGHT, BACKGROUND_COLOR,
+        [](engine_t &engine) { return create_scene(engine); }
+    );
+    if (!result) {
+        std::println(stderr, "{}", result.error());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,28 @@
+#version 460 core
+
+// For explode_model(): a_normal is the face normal, the same for the three corners.
+layout(location = 0) in vec3 a_pos;
+layout(location = 1) in vec3 a_normal;
+layout(location = 2) in vec2 a_tex_coords;
+
+layout(set = 1, binding = 0) uniform ModelBlock {
+    mat4 model;
+};
+layout(set = 1, binding = 1) uniform ViewBlock {
+    mat4 view;
+};
+layout(set = 1, binding = 2) uniform ProjectionBlock {
+    mat4 projection;
+};
+layout(set = 1, binding = 3) uniform TimeBlock {
+    float time;
+};
+
+layout(location = 0) out vec2 tex_coords;
+
+void main() {
+    float magnitude = 2.0;
+    vec3  direction = a_normal * ((sin(time) + 1.0) / 2.0) * magnitude;
+    tex_coords      = a_tex_coords;
+    gl_Position     = projection * view * model * vec4(a_pos + direction, 1.0);
+}
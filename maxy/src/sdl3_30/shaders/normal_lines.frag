@@ -0,0 +1,7 @@
+#version 460 core
+
+layout(location = 0) out vec4 frag_color;
+
+void main() {
+    frag_color = vec4(1.0, 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,25 @@
+#version 460 core
+
+// Instanced over the vertices of a mesh (normal_line_buffer_descs): the attributes step once
+// per instance and the two vertices of each instance are the two ends of its normal line.
+layout(location = 0) in vec3 a_pos;
+layout(location = 1) in vec3 a_normal;
+
+layout(set = 1, binding = 0) uniform ModelBlock {
+    mat4 model;
+};
+layout(set = 1, binding = 1) uniform ViewBlock {
+    mat4 view;
+};
+layout(set = 1, binding = 2) uniform ProjectionBlock {
+    mat4 projection;
+};
+
+const float MAGNITUDE = 0.2;
+
+void main() {
+    mat3 normal_matrix = mat3(transpose(inverse(view * model)));
+    vec4 position      = view * model * vec4(a_pos, 1.0);
+    position.xyz += normal_matrix * a_normal * MAGNITUDE * float(gl_VertexIndex);
+    gl_Position = projection * position;
+}
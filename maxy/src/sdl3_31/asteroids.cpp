@@ -0,0 +1,334 @@
+#include <array>
+#include <cmath>
+#include <print>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <imgui.h>
+
+#include "engine.hpp"
+#include "hiz.hpp"
+#include "model.hpp"
+
+constexpr int        WINDOW_WIDTH     = 1024;
+constexpr int        WINDOW_HEIGHT    = 768;
+constexpr SDL_FColor BACKGROUND_COLOR = {0.01f, 0.01f, 0.02f, 1.0f};
+
+// Asteroid belt around a planet large enough to hide a good part of the far side of the ring
+// from a camera inside it.
+constexpr int   ASTEROID_COUNT = 100000;
+constexpr float RING_RADIUS    = 150.0f;
+constexpr float RING_OFFSET    = 10.0f;
+constexpr float PLANET_SCALE   = 12.0f;
+// Farthest vertex of rock.obj from its origin; scaled per instance for the bounding sphere.
+constexpr float ROCK_RADIUS = 2.9f;
+
+enum class cull_mode_t { none, frustum, hiz };
+constexpr std::array<const char *, 3> MODE_NAMES = {
+    "None (draw all)", "Frustum", "Frustum + Hi-Z occlusion"
+};
+
+struct scene_t {
+    gpu_pipeline_t pipeline;
+    gpu_model_t    rock;
+    gpu_model_t    planet;
+    gpu_buffer_t   planet_instance; // one hiz_instance_t: the planet's model matrix
+    hiz_culler_t   culler;
+
+    camera_t    camera;
+    float       m_aspect_ratio = static_cast<float>(WINDOW_WIDTH) / WINDOW_HEIGHT;
+    cull_mode_t m_mode         = cull_mode_t::hiz;
+
+    // Frame time averaged over half-second windows so the readout is stable.
+    float m_frame_ms      = 0.0f;
+    float m_sample_time   = 0.0f;
+    int   m_sample_frames = 0;
+
+    // Instances drawn by each phase, read back on demand.
+    bool                  m_counts_requested = false;
+    std::array<Uint32, 2> m_counts           = {};
+    std::string           m_counts_error;
+
+    glm::mat4 view_proj() const {
+        glm::mat4 proj = glm::perspective(glm::radians(camera.fov), m_aspect_ratio, 0.1f, 1000.0f);
+        return proj * camera.view_matrix();
+    }
+
+    bool update(input_t const &in);
+    void read_counts(engine_t const &engine);
+    void cull_phase1(SDL_GPUCommandBuffer *cmd);
+    void cull_phase2(
+        engine_t const &engine, SDL_GPUCommandBuffer *cmd, tracked_depth_t const &depth
+    );
+    void render_phase1(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass);
+    void render_phase2(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass);
+
+private:
+    SDL_GPUTextureSamplerBinding rock_sampler() const;
+};
+
+// Same distribution as the OpenGL asteroid field (chapter 31), plus a bounding sphere per rock.
+std::vector<hiz_instance_t> asteroid_instances() {
+    std::mt19937                          rng{31};
+    std::uniform_real_distribution<float> displacement(-RING_OFFSET, RING_OFFSET);
+    std::uniform_real_distribution<float> scale(0.05f, 0.25f);
+    std::uniform_real_distribution<float> rotation(0.0f, 360.0f);
+
+    std::vector<hiz_instance_t> instances(ASTEROID_COUNT);
+    for (int i = 0; i < ASTEROID_COUNT; ++i) {
+        float const     angle = static_cast<float>(i) / ASTEROID_COUNT * glm::radians(360.0f);
+        glm::vec3 const position = {
+            std::sin(angle) * RING_RADIUS + displacement(rng), displacement(rng) * 0.4f,
+            std::cos(angle) * RING_RADIUS + displacement(rng)
+        };
+        float const s = scale(rng);
+
+        glm::mat4 model = glm::translate(glm::mat4{1.0f}, position);
+        model           = glm::scale(model, glm::vec3(s));
+        model = glm::rotate(model, glm::radians(rotation(rng)), glm::vec3(0.4f, 0.6f, 0.8f));
+        instances[i] = {model, glm::vec4(position, ROCK_RADIUS * s)};
+    }
+    return instances;
+}
+
+std::expected<scene_t, std::string> create_scene(engine_t &engine) {
+    scene_t scene;
+    scene.camera       = camera_t(engine.window, {0.0f, 2.0f, RING_RADIUS});
+    scene.camera.speed = 20.0f;
+
+    if (auto r = init_imgui(engine); !r) return std::unexpected(r.error());
+    ImGui::GetIO().IniFilename = nullptr;
+
+    auto pipeline = create_pipeline(
+        engine, {
+                    .vertex_shader          = "shaders/sdl3_31/asteroid.vert.spv",
+                    .fragment_shader        = "shaders/sdl3_31/asteroid.frag.spv",
+                    .vertex_uniform_buffers = 1,
+                    .fragment_samplers      = 1,
+                    .vertex_buffer_descs    = hiz_instance_buffer_descs,
+                    .vertex_attributes      = hiz_instance_vertex_attributes,
+                    .enable_depth_test      = true,
+                    .cull_mode              = SDL_GPU_CULLMODE_BACK,
+                }
+    );
+    if (!pipeline) return std::unexpected(pipeline.error());
+    scene.pipeline = std::move(*pipeline);
+
+    auto rock = load_model(engine, std::string(ASSETS_PATH) + "objects/rock/rock.obj");
+    if (!rock) return std::unexpected(rock.error());
+    scene.rock = std::move(*rock);
+    // rock.obj is a single textured mesh; the culler's indirect commands draw exactly that.
+    if (scene.rock.meshes.empty() || scene.rock.meshes[0].textures.diffuse < 0)
+        return std::unexpected("rock.obj: expected a mesh with a diffuse texture");
+
+    auto planet = load_model(engine, std::string(ASSETS_PATH) + "objects/planet/planet.obj");
+    if (!planet) return std::unexpected(planet.error());
+    scene.planet = std::move(*planet);
+
+    hiz_instance_t const planet_instance = {
+        glm::scale(glm::translate(glm::mat4{1.0f}, {0.0f, -3.0f, 0.0f}), glm::vec3(PLANET_SCALE)),
+        glm::vec4(0.0f),
+    };
+    auto planet_buffer = create_gpu_buffer(
+        engine, SDL_GPU_BUFFERUSAGE_VERTEX, sizeof(planet_instance), &planet_instance
+    );
+    if (!planet_buffer) return std::unexpected(planet_buffer.error());
+    scene.planet_instance = std::move(*planet_buffer);
+
+    auto const instances = asteroid_instances();
+    auto culler = create_hiz_culler(engine, instances, scene.rock.meshes[0].geometry.index_count);
+    if (!culler) return std::unexpected(culler.error());
+    scene.culler = std::move(*culler);
+
+    return scene;
+}
+
+bool scene_t::update(input_t const &in) {
+    m_aspect_ratio = in.aspect_ratio;
+    if (in.keys[SDL_SCANCODE_ESCAPE]) return false;
+
+    camera.update(in);
+
+    m_sample_time += in.dt;
+    ++m_sample_frames;
+    if (m_sample_time >= 0.5f) {
+        m_frame_ms      = 1000.0f * m_sample_time / static_cast<float>(m_sample_frames);
+        m_sample_time   = 0.0f;
+        m_sample_frames = 0;
+    }
+
+    ImGui::SetNextWindowPos(ImVec2(6.0f, 6.0f), ImGuiCond_Once);
+    ImGui::Begin("Scene", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+    ImGui::PushItemWidth(200.0f);
+    ImGui::LabelText(
+        "Camera", "(%.2f, %.2f, %.2f)", camera.position.x, camera.position.y, camera.position.z
+    );
+    ImGui::LabelText("Mode", "%s", camera.ui_mode() ? "UI (` to fly)" : "Fly (` for UI)");
+    int mode = static_cast<int>(m_mode);
+    if (ImGui::Combo("Culling", &mode, MODE_NAMES.data(), static_cast<int>(MODE_NAMES.size()))) {
+        m_mode      = static_cast<cull_mode_t>(mode);
+        culler.mode = m_mode == cull_mode_t::hiz ? hiz_mode_t::occlusion : hiz_mode_t::frustum;
+        m_counts    = {};
+    }
+    ImGui::LabelText("Asteroids", "%d", ASTEROID_COUNT);
+    if (ImGui::Button("Print memory report"))
+        std::print("{}{}", memory_report("rock", rock), memory_report("planet", planet));
+    float const fps = m_frame_ms > 0.0f ? 1000.0f / m_frame_ms : 0.0f;
+    ImGui::LabelText("Frame time", "%.2f ms (%.0f fps)", m_frame_ms, fps);
+
+    if (m_mode != cull_mode_t::none) {
+        if (ImGui::Button("Count drawn asteroids")) m_counts_requested = true;
+        if (!m_counts_error.empty()) {
+            ImGui::TextDisabled("%s", m_counts_error.c_str());
+        } else if (m_counts[0] + m_counts[1] > 0) {
+            Uint32 const total = m_counts[0] + m_counts[1];
+            ImGui::LabelText("Phase 1", "%u", m_counts[0]);
+            ImGui::LabelText("Phase 2", "%u", m_counts[1]);
+            ImGui::LabelText("Culled", "%.1f%%", 100.0 * (1.0 - double(total) / ASTEROID_COUNT));
+        }
+    }
+    ImGui::PopItemWidth();
+    ImGui::End();
+
+    return true;
+}
+
+void scene_t::read_counts(engine_t const &engine) {
+    m_counts_requested = false;
+    auto counts        = culler.read_counts(engine);
+    if (!counts) {
+        m_counts_error = counts.error();
+        return;
+    }
+    m_counts_error.clear();
+    m_counts = *counts;
+}
+
+SDL_GPUTextureSamplerBinding scene_t::rock_sampler() const {
+    int const texture = rock.meshes[0].textures.diffuse;
+    return {rock.textures[texture].get(), rock.samplers[texture].get()};
+}
+
+void scene_t::cull_phase1(SDL_GPUCommandBuffer *cmd) {
+    if (m_mode != cull_mode_t::none) culler.cull_phase1(cmd, view_proj());
+}
+
+void scene_t::cull_phase2(
+    engine_t const &engine, SDL_GPUCommandBuffer *cmd, tracked_depth_t const &depth
+) {
+    if (m_mode != cull_mode_t::none) culler.cull_phase2(engine, cmd, depth, view_proj());
+}
+
+// Planet plus the rocks that survived phase 1 (or every rock without culling).
+void scene_t::render_phase1(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
+    SDL_BindGPUGraphicsPipeline(pass, pipeline.get());
+    push_vertex_uniform(cmd, 0, view_proj());
+
+    for (auto const &mesh : planet.meshes) {
+        if (mesh.textures.diffuse < 0) continue;
+        std::array<SDL_GPUBufferBinding, 2> const vertex_bindings = {{
+            {mesh.geometry.vertex_buffer.get(), 0},
+            {planet_instance.get(), 0},
+        }};
+        SDL_BindGPUVertexBuffers(pass, 0, vertex_bindings.data(), 2);
+        SDL_GPUBufferBinding index_binding = {mesh.geometry.index_buffer.get(), 0};
+        SDL_BindGPUIndexBuffer(pass, &index_binding, mesh.geometry.index_element_size);
+        SDL_GPUTextureSamplerBinding sampler = {
+            planet.textures[mesh.textures.diffuse].get(),
+            planet.samplers[mesh.textures.diffuse].get()
+        };
+        SDL_BindGPUFragmentSamplers(pass, 0, &sampler, 1);
+        SDL_DrawGPUIndexedPrimitives(pass, mesh.geometry.index_count, 1, 0, 0, 0);
+    }
+
+    SDL_GPUTextureSamplerBinding const sampler = rock_sampler();
+    if (m_mode != cull_mode_t::none) {
+        culler.draw(0, rock.meshes[0].geometry, std::span{&sampler, 1}, pass);
+        return;
+    }
+
+    auto const &geometry = rock.meshes[0].geometry;
+    std::array<SDL_GPUBufferBinding, 2> const vertex_bindings = {{
+        {geometry.vertex_buffer.get(), 0},
+        {culler.instances.get(), 0},
+    }};
+    SDL_BindGPUVertexBuffers(pass, 0, vertex_bindings.data(), 2);
+    SDL_GPUBufferBinding index_binding = {geometry.index_buffer.get(), 0};
+    SDL_BindGPUIndexBuffer(pass, &index_binding, geometry.index_element_size);
+    SDL_BindGPUFragmentSamplers(pass, 0, &sampler, 1);
+    SDL_DrawGPUIndexedPrimitives(pass, geometry.index_count, ASTEROID_COUNT, 0, 0, 0);
+}
+
+// Rocks disoccluded since the previous frame.
+void scene_t::render_phase2(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
+    if (m_mode != cull_mode_t::hiz) return;
+
+    SDL_BindGPUGraphicsPipeline(pass, pipeline.get());
+    push_vertex_uniform(cmd, 0, view_proj());
+    SDL_GPUTextureSamplerBinding const sampler = rock_sampler();
+    culler.draw(1, rock.meshes[0].geometry, std::span{&sampler, 1}, pass);
+}
+
+int main(int argc, char *argv[]) {
+    auto engine = create_engine(
+        "SDL3 31 - Asteroids (Hi-Z culling)", WINDOW_WIDTH, WINDOW_HEIGHT,
+        parse_engine_args(argc, argv)
+    );
+    if (!engine) {
+        std::println(stderr, "{}", engine.error());
+        return 1;
+    }
+
+    auto scene = create_scene(*engine);
+    if (!scene) {
+        std::println(stderr, "{}", scene.error());
+        return 1;
+    }
+
+    // Sampleable, and stored by the first pass: the Hi-Z pyramid is built from it in between.
+    auto depth = create_tracked_depth(*engine, true);
+    if (!depth) {
+        std::println(stderr, "{}", depth.error());
+        return 1;
+    }
+
+    std::array<pass_desc_t, 2> passes = {{
+        {.depth_texture = &depth->texture,
+         .prepare =
+             [&](auto cmd) {
+                 imgui_prepare(cmd);
+                 scene->cull_phase1(cmd);
+             },
+         .draw           = [&](auto cmd, auto pass) { scene->render_phase1(cmd, pass); },
+         .depth_store_op = SDL_GPU_STOREOP_STORE},
+        {.depth_texture = &depth->texture,
+         .load_op       = SDL_GPU_LOADOP_LOAD,
+         .prepare       = [&](auto cmd) { scene->cull_phase2(*engine, cmd, *depth); },
+         .draw =
+             [&](auto cmd, auto pass) {
+                 scene->render_phase2(cmd, pass);
+                 imgui_render(cmd, pass);
+             },
+         .depth_load_op = SDL_GPU_LOADOP_LOAD},
+    }};
+
+    auto result = run_loop(
+        *engine, [&]() { return BACKGROUND_COLOR; }, *depth, std::span<tracked_color_target_t>{},
+        [&](input_t const &in) {
+            bool const keep_running = scene->update(in);
+            if (scene->m_counts_requested) scene->read_counts(*engine);
+            return keep_running;
+        },
+        passes
+    );
+    if (!result) {
+        std::println(stderr, "{}", result.error());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,16 @@
+#version 460 core
+
+layout(location = 0) in vec2 frag_tex_coord;
+layout(location = 1) in vec3 frag_normal;
+
+layout(set = 2, binding = 0) uniform sampler2D diffuse_tex;
+
+layout(location = 0) out vec4 frag_color;
+
+const vec3 SUN_DIRECTION = normalize(vec3(-0.4, -0.3, -1.0));
+
+void main() {
+    vec3  albedo  = texture(diffuse_tex, frag_tex_coord).rgb;
+    float diffuse = max(dot(normalize(frag_normal), -SUN_DIRECTION), 0.0);
+    frag_color    = vec4(albedo * (0.15 + 0.85 * diffuse), 1.0);
+}
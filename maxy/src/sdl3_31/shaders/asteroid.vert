@@ -0,0 +1,22 @@
+#version 460 core
+
+// Instanced mesh: the model matrix arrives per instance from vertex buffer slot 1 (the Hi-Z
+// culler's compacted visible list, or the full instance list when culling is off).
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 normal;
+layout(location = 2) in vec2 tex_coord;
+layout(location = 3) in mat4 model;
+
+layout(set = 1, binding = 0) uniform ViewProjection {
+    mat4 view_proj;
+};
+
+layout(location = 0) out vec2 frag_tex_coord;
+layout(location = 1) out vec3 frag_normal;
+
+void main() {
+    gl_Position    = view_proj * model * vec4(position, 1.0);
+    frag_tex_coord = tex_coord;
+    frag_normal    = mat3(model) * normal;
+}
@@ -0,0 +1,764 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <print>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <SDL3/SDL.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <imgui.h>
+
+#include "deferred.hpp"
+#include "engine.hpp"
+#include "geometry.hpp"
+#include "lights.hpp"
+
+constexpr int WINDOW_WIDTH  = 1024;
+constexpr int WINDOW_HEIGHT = 768;
+
+// Light volumes issue one draw per light, so they are not bound by the uniform array size.
+constexpr int MAX_VOLUME_LIGHTS = 256;
+constexpr int MAX_LAYERS        = 16;
+
+// Same packing as sdl3_24's SceneParamsBlock, for the forward lit.frag.
+struct scene_params_t {
+    float     shininess;
+    int       pos_count;
+    int       spot_count;
+    int       pad;
+    glm::vec4 dir_direction;
+    glm::vec4 dir_ambient;
+    glm::vec4 dir_diffuse;
+    glm::vec4 dir_specular;
+};
+
+// DeferredParamsBlock: shininess moves into the G-buffer, the pass needs the inverse
+// view-projection to rebuild positions from depth.
+struct deferred_params_t {
+    glm::mat4 inv_view_proj;
+    glm::vec4 screen_size;
+    int       pos_count;
+    int       spot_count;
+    int       pad[2];
+    glm::vec4 dir_direction;
+    glm::vec4 dir_ambient;
+    glm::vec4 dir_diffuse;
+    glm::vec4 dir_specular;
+};
+
+struct model_placement_t {
+    glm::vec3 position;
+    float     scale;
+};
+
+static constexpr std::array<pos_normal_uv_vertex_t, 6> large_floor_vertices = {{
+    {{500.0f, 0.0f, 500.0f}, {0.0f, 1.0f, 0.0f}, {200.0f, 0.0f}},
+    {{-500.0f, 0.0f, -500.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 200.0f}},
+    {{-500.0f, 0.0f, 500.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f}},
+    {{500.0f, 0.0f, 500.0f}, {0.0f, 1.0f, 0.0f}, {200.0f, 0.0f}},
+    {{500.0f, 0.0f, -500.0f}, {0.0f, 1.0f, 0.0f}, {200.0f, 200.0f}},
+    {{-500.0f, 0.0f, -500.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 200.0f}},
+}};
+
+// Two triangles covering NDC; fullscreen.vert pins z to the far plane.
+static constexpr std::array<vertex_t, 6> FULLSCREEN_QUAD = {{
+    {-1.0f, 1.0f, 0.0f},
+    {1.0f, 1.0f, 0.0f},
+    {1.0f, -1.0f, 0.0f},
+    {-1.0f, 1.0f, 0.0f},
+    {1.0f, -1.0f, 0.0f},
+    {-1.0f, -1.0f, 0.0f},
+}};
+
+static constexpr model_placement_t WINDOWS[] = {
+    {{-2.5f, 0.5f, 1.0f}, 1.0f},
+    {{0.0f, 0.6f, 1.5f}, 1.2f},
+    {{2.5f, 0.5f, 1.0f}, 1.0f},
+};
+
+// Each overdraw layer is a wall of cubes across the view, one unit further away than the last.
+constexpr int   WALL_CUBES    = 9;
+constexpr float LAYER_DEPTH   = 1.5f;
+constexpr float FIRST_LAYER_Z = -2.0f;
+
+enum class lighting_mode_t { forward, forward_prepass, deferred_fullscreen, deferred_volumes };
+constexpr std::array<const char *, 4> MODE_NAMES = {
+    "Forward", "Forward + depth pre-pass", "Deferred (fullscreen)", "Deferred (light volumes)"
+};
+
+constexpr bool is_forward(lighting_mode_t mode) {
+    return mode == lighting_mode_t::forward || mode == lighting_mode_t::forward_prepass;
+}
+
+constexpr std::array<spot_light_state_t, 2> SPOT_LIGHTS = {{
+    {.position = {-3.0f, 3.0f, 0.0f}, .direction = {0.3f, -1.0f, -0.3f}},
+    {.position = {3.0f, 3.0f, 0.0f}, .direction = {-0.3f, -1.0f, -0.3f}},
+}};
+
+constexpr flashlight_state_t FLASHLIGHT = {
+    .ambient       = {0.0f, 0.0f, 0.0f},
+    .diffuse       = {0.6f, 0.6f, 0.6f},
+    .specular      = {1.0f, 1.0f, 1.0f},
+    .inner_degrees = 12.5f,
+    .outer_degrees = 17.5f,
+    .constant      = 1.0f,
+    .linear        = 0.09f,
+    .quadratic     = 0.032f,
+};
+
+struct scene_t {
+    // Geometry pass (MRT into the G-buffer).
+    gpu_pipeline_t      gbuffer_pipeline;
+    // Lighting pass (swapchain, depth loaded from the geometry pass).
+    gpu_pipeline_t      light_pipeline;
+    gpu_pipeline_t      volume_pipeline;
+    // Forward path: opaque objects in forward mode, transparents and indicators in every mode.
+    gpu_pipeline_t      forward_pipeline;
+    prepass_pipelines_t forward_prepass;
+    gpu_pipeline_t      window_pipeline;
+    gpu_pipeline_t      indicator_pipeline;
+    // Fragment counting variants of the forward pipeline (see count_fragments).
+    gpu_pipeline_t      count_pipeline;
+    prepass_pipelines_t count_prepass;
+
+    gpu_geometry_t cube_geometry;
+    gpu_geometry_t floor_geometry;
+    gpu_geometry_t quad_geometry;
+    gpu_geometry_t fullscreen_geometry;
+
+    gpu_material_t cube_material;
+    gpu_material_t floor_material;
+    gpu_material_t window_material;
+    gpu_sampler_t  gbuffer_sampler;
+
+    gbuffer_t gbuffer;
+
+    camera_t        camera;
+    float           m_aspect_ratio  = static_cast<float>(WINDOW_WIDTH) / WINDOW_HEIGHT;
+    SDL_FColor      m_clear_color   = {0.02f, 0.02f, 0.03f, 1.0f};
+    lighting_mode_t m_mode          = lighting_mode_t::deferred_fullscreen;
+    int             m_light_count   = MAX_POS_LIGHTS;
+    int             m_layers        = 4;
+    bool            m_flashlight_on = true;
+    bool            m_animate       = true;
+    float           m_time          = 0.0f;
+
+    // Frame time averaged over half-second windows so the readout is stable.
+    float m_frame_ms      = 0.0f;
+    float m_sample_time   = 0.0f;
+    int   m_sample_frames = 0;
+
+    // Forward fragment shader invocations with and without the depth pre-pass, measured on demand.
+    bool        m_measure_requested = false;
+    Uint64      m_fragments_plain   = 0;
+    Uint64      m_fragments_prepass = 0;
+    std::string m_measure_error;
+
+    std::vector<pos_light_state_t> pos_lights;
+
+    key_edge_t m_m_edge;
+    key_edge_t m_g_edge;
+
+    // Lights actually used this frame: the forward and fullscreen paths are bound by the
+    // MAX_POS_LIGHTS uniform array.
+    int active_lights() const {
+        if (m_mode == lighting_mode_t::deferred_volumes) return m_light_count;
+        return std::min(m_light_count, MAX_POS_LIGHTS);
+    }
+
+    bool update(input_t const &in);
+    void measure_fragments(engine_t const &engine);
+    void render_gbuffer(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass);
+    void render(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass);
+
+private:
+    void draw_opaque(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass);
+};
+
+std::expected<scene_t, std::string> create_scene(engine_t &engine) {
+    scene_t scene;
+    scene.camera = camera_t(engine.window, {0.0f, 1.5f, 5.0f});
+
+    if (auto r = init_imgui(engine); !r) return std::unexpected(r.error());
+    ImGui::GetIO().IniFilename = nullptr;
+
+    auto gbuffer_pipeline = create_pipeline(
+        engine, {
+                    .vertex_shader            = "shaders/sdl3_24/lit.vert.spv",
+                    .fragment_shader          = "shaders/sdl3_41/gbuffer.frag.spv",
+                    .vertex_uniform_buffers   = 4,
+                    .fragment_uniform_buffers = 1,
+                    .fragment_samplers        = 2,
+                    .vertex_buffer_descs      = pos_normal_uv_buffer_descs,
+                    .vertex_attributes        = pos_normal_uv_vertex_attributes,
+                    .enable_depth_test        = true,
+                    .color_target_formats     = gbuffer_formats,
+                }
+    );
+    if (!gbuffer_pipeline) return std::unexpected(gbuffer_pipeline.error());
+    scene.gbuffer_pipeline = std::move(*gbuffer_pipeline);
+
+    // The quad sits on the far plane: GREATER passes only where geometry was written.
+    auto light_pipeline = create_pipeline(
+        engine, {
+                    .vertex_shader            = "shaders/sdl3_41/fullscreen.vert.spv",
+                    .fragment_shader          = "shaders/sdl3_41/deferred_light.frag.spv",
+                    .fragment_uniform_buffers = 4,
+                    .fragment_samplers        = GBUFFER_SLOT_COUNT,
+                    .enable_depth_test        = true,
+                    .depth_compare_op         = SDL_GPU_COMPAREOP_GREATER,
+                    .enable_depth_write       = false,
+                }
+    );
+    if (!light_pipeline) return std::unexpected(light_pipeline.error());
+    scene.light_pipeline = std::move(*light_pipeline);
+
+    // Back faces of the volume with GREATER_OR_EQUAL: shade only surfaces in front of the far
+    // side of the volume. Works with the camera inside the volume, unlike front faces.
+    auto volume_pipeline = create_pipeline(
+        engine, {
+                    .vertex_shader            = "shaders/sdl3_17/light.vert.spv",
+                    .fragment_shader          = "shaders/sdl3_41/deferred_volume.frag.spv",
+                    .vertex_uniform_buffers   = 3,
+                    .fragment_uniform_buffers = 2,
+                    .fragment_samplers        = GBUFFER_SLOT_COUNT,
+                    .vertex_buffer_descs      = pos_normal_uv_buffer_descs,
+                    .vertex_attributes        = light_vertex_attributes,
+                    .enable_depth_test        = true,
+                    .depth_compare_op         = SDL_GPU_COMPAREOP_GREATER_OR_EQUAL,
+                    .enable_depth_write       = false,
+                    .cull_mode                = SDL_GPU_CULLMODE_FRONT,
+                    .enable_blend             = true,
+                    .additive_blend           = true,
+                }
+    );
+    if (!volume_pipeline) return std::unexpected(volume_pipeline.error());
+    scene.volume_pipeline = std::move(*volume_pipeline);
+
+    pipeline_desc_t const forward_desc = {
+        .vertex_shader            = "shaders/sdl3_24/lit.vert.spv",
+        .fragment_shader          = "shaders/sdl3_24/lit.frag.spv",
+        .vertex_uniform_buffers   = 4,
+        .fragment_uniform_buffers = 4,
+        .fragment_samplers        = 2,
+        .vertex_buffer_descs      = pos_normal_uv_buffer_descs,
+        .vertex_attributes        = pos_normal_uv_vertex_attributes,
+        .enable_depth_test        = true,
+    };
+
+    auto forward_pipeline = create_pipeline(engine, forward_desc);
+    if (!forward_pipeline) return std::unexpected(forward_pipeline.error());
+    scene.forward_pipeline = std::move(*forward_pipeline);
+
+    auto forward_prepass = create_prepass_pipelines(engine, forward_desc);
+    if (!forward_prepass) return std::unexpected(forward_prepass.error());
+    scene.forward_prepass = std::move(*forward_prepass);
+
+    auto count_pipeline = create_pipeline(engine, fragment_count_desc(forward_desc));
+    if (!count_pipeline) return std::unexpected(count_pipeline.error());
+    scene.count_pipeline = std::move(*count_pipeline);
+
+    auto count_prepass = create_prepass_pipelines(engine, fragment_count_desc(forward_desc));
+    if (!count_prepass) return std::unexpected(count_prepass.error());
+    scene.count_prepass = std::move(*count_prepass);
+
+    auto window_pipeline = create_pipeline(
+        engine, {
+                    .vertex_shader            = "shaders/sdl3_24/lit.vert.spv",
+                    .fragment_shader          = "shaders/sdl3_24/lit.frag.spv",
+                    .vertex_uniform_buffers   = 4,
+                    .fragment_uniform_buffers = 4,
+                    .fragment_samplers        = 2,
+                    .vertex_buffer_descs      = pos_normal_uv_buffer_descs,
+                    .vertex_attributes        = pos_normal_uv_vertex_attributes,
+                    .enable_depth_test        = true,
+                    .enable_depth_write       = false,
+                    .enable_blend             = true,
+                }
+    );
+    if (!window_pipeline) return std::unexpected(window_pipeline.error());
+    scene.window_pipeline = std::move(*window_pipeline);
+
+    auto indicator_pipeline = create_pipeline(
+        engine, {
+                    .vertex_shader            = "shaders/sdl3_17/light.vert.spv",
+                    .fragment_shader          = "shaders/sdl3_17/indicator.frag.spv",
+                    .vertex_uniform_buffers   = 3,
+                    .fragment_uniform_buffers = 1,
+                    .vertex_buffer_descs      = pos_normal_uv_buffer_descs,
+                    .vertex_attributes        = light_vertex_attributes,
+                    .enable_depth_test        = true,
+                }
+    );
+    if (!indicator_pipeline) return std::unexpected(indicator_pipeline.error());
+    scene.indicator_pipeline = std::move(*indicator_pipeline);
+
+    auto cube_geom = create_vertex_geometry(
+        engine, unit_cube_with_normals.data(),
+        static_cast<Uint32>(unit_cube_with_normals.size() * sizeof(pos_normal_uv_vertex_t)),
+        static_cast<Uint32>(unit_cube_with_normals.size())
+    );
+    if (!cube_geom) return std::unexpected(cube_geom.error());
+    scene.cube_geometry = std::move(*cube_geom);
+
+    auto floor_geom = create_vertex_geometry(
+        engine, large_floor_vertices.data(),
+        static_cast<Uint32>(large_floor_vertices.size() * sizeof(pos_normal_uv_vertex_t)),
+        static_cast<Uint32>(large_floor_vertices.size())
+    );
+    if (!floor_geom) return std::unexpected(floor_geom.error());
+    scene.floor_geometry = std::move(*floor_geom);
+
+    auto quad_geom = create_vertex_geometry(
+        engine, vertical_quad_vertices.data(),
+        static_cast<Uint32>(vertical_quad_vertices.size() * sizeof(pos_normal_uv_vertex_t)),
+        static_cast<Uint32>(vertical_quad_vertices.size())
+    );
+    if (!quad_geom) return std::unexpected(quad_geom.error());
+    scene.quad_geometry = std::move(*quad_geom);
+
+    auto fullscreen_geom = create_vertex_geometry(
+        engine, FULLSCREEN_QUAD.data(),
+        static_cast<Uint32>(FULLSCREEN_QUAD.size() * sizeof(vertex_t)),
+        static_cast<Uint32>(FULLSCREEN_QUAD.size())
+    );
+    if (!fullscreen_geom) return std::unexpected(fullscreen_geom.error());
+    scene.fullscreen_geometry = std::move(*fullscreen_geom);
+
+    auto cube_mat = create_material(
+        engine, {.texture_paths = {
+                     std::string(ASSETS_PATH) + "textures/container2.png",
+                     std::string(ASSETS_PATH) + "textures/container2_specular.png",
+                 }}
+    );
+    if (!cube_mat) return std::unexpected(cube_mat.error());
+    scene.cube_material = std::move(*cube_mat);
+
+    auto floor_mat = create_material(
+        engine, {.texture_paths = {
+                     std::string(ASSETS_PATH) + "textures/metal.png",
+                     std::string(ASSETS_PATH) + "textures/metal.png",
+                 }}
+    );
+    if (!floor_mat) return std::unexpected(floor_mat.error());
+    scene.floor_material = std::move(*floor_mat);
+
+    auto win_diffuse = load_texture(engine, std::string(ASSETS_PATH) + "textures/window.png");
+    if (!win_diffuse) return std::unexpected(win_diffuse.error());
+
+    auto win_specular = create_solid_texture(engine, glm::u8vec4{255, 255, 255, 255});
+    if (!win_specular) return std::unexpected(win_specular.error());
+
+    auto sampler_clamp = create_sampler(engine, SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE);
+    if (!sampler_clamp) return std::unexpected(sampler_clamp.error());
+
+    auto sampler_repeat = create_sampler(engine);
+    if (!sampler_repeat) return std::unexpected(sampler_repeat.error());
+
+    scene.window_material.textures.push_back(std::move(*win_diffuse));
+    scene.window_material.textures.push_back(std::move(*win_specular));
+    scene.window_material.samplers.push_back(std::move(*sampler_clamp));
+    scene.window_material.samplers.push_back(std::move(*sampler_repeat));
+
+    auto gbuffer_sampler = create_sampler(
+        engine, SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE, SDL_GPU_FILTER_NEAREST
+    );
+    if (!gbuffer_sampler) return std::unexpected(gbuffer_sampler.error());
+    scene.gbuffer_sampler = std::move(*gbuffer_sampler);
+
+    auto gbuffer = create_gbuffer(engine);
+    if (!gbuffer) return std::unexpected(gbuffer.error());
+    scene.gbuffer = std::move(*gbuffer);
+
+    // Short-range coloured lights (radius ~5 units) spread over the floor in front of the walls.
+    scene.pos_lights.resize(MAX_VOLUME_LIGHTS);
+    for (int i = 0; i < MAX_VOLUME_LIGHTS; ++i) {
+        float const     hue   = static_cast<float>(i) * 0.618034f;
+        glm::vec3 const color = glm::clamp(
+            glm::abs(glm::mod(hue * 6.0f + glm::vec3(0.0f, 4.0f, 2.0f), 6.0f) - 3.0f) - 1.0f,
+            0.0f, 1.0f
+        );
+        scene.pos_lights[i] = {
+            .position  = {0.0f, 0.5f, 0.0f},
+            .ambient   = color * 0.02f,
+            .diffuse   = color,
+            .specular  = color,
+            .linear    = 0.7f,
+            .quadratic = 1.8f,
+        };
+    }
+
+    return scene;
+}
+
+bool scene_t::update(input_t const &in) {
+    m_aspect_ratio = in.aspect_ratio;
+    if (in.keys[SDL_SCANCODE_ESCAPE]) return false;
+
+    camera.update(in);
+
+    if (m_m_edge(in.keys[SDL_SCANCODE_M]) && !camera.ui_mode())
+        m_mode = static_cast<lighting_mode_t>((static_cast<int>(m_mode) + 1) % MODE_NAMES.size());
+    if (m_g_edge(in.keys[SDL_SCANCODE_G]) && !camera.ui_mode()) m_flashlight_on = !m_flashlight_on;
+
+    // Lights orbit the origin on concentric rings, each ring at its own speed.
+    if (m_animate) m_time += in.dt;
+    for (int i = 0; i < MAX_VOLUME_LIGHTS; ++i) {
+        float const ring       = static_cast<float>(1 + i % 8);
+        float const angle      = static_cast<float>(i) * 2.399963f + m_time * (0.6f / ring);
+        pos_lights[i].position = {
+            std::cos(angle) * ring * 1.2f, 0.3f + 0.2f * static_cast<float>(i % 5),
+            std::sin(angle) * ring * 1.2f - 2.0f
+        };
+    }
+
+    m_sample_time += in.dt;
+    ++m_sample_frames;
+    if (m_sample_time >= 0.5f) {
+        m_frame_ms      = 1000.0f * m_sample_time / static_cast<float>(m_sample_frames);
+        m_sample_time   = 0.0f;
+        m_sample_frames = 0;
+    }
+
+    ImGui::SetNextWindowPos(ImVec2(6.0f, 6.0f), ImGuiCond_Once);
+    ImGui::Begin("Scene", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+    ImGui::PushItemWidth(200.0f);
+    ImGui::LabelText(
+        "Camera", "(%.2f, %.2f, %.2f)", camera.position.x, camera.position.y, camera.position.z
+    );
+    ImGui::LabelText("Mode", "%s", camera.ui_mode() ? "UI (` to fly)" : "Fly (` for UI)");
+    int mode = static_cast<int>(m_mode);
+    if (ImGui::Combo("Lighting (M)", &mode, MODE_NAMES.data(), static_cast<int>(MODE_NAMES.size())))
+        m_mode = static_cast<lighting_mode_t>(mode);
+    ImGui::SliderInt("Pos lights", &m_light_count, 0, MAX_VOLUME_LIGHTS);
+    if (active_lights() < m_light_count)
+        ImGui::TextDisabled("capped at %d outside light-volume mode", MAX_POS_LIGHTS);
+    ImGui::SliderInt("Overdraw layers", &m_layers, 1, MAX_LAYERS);
+    ImGui::Checkbox("Animate lights", &m_animate);
+    ImGui::LabelText("Flashlight (G)", "%s", m_flashlight_on ? "on" : "off");
+    float const fps = m_frame_ms > 0.0f ? 1000.0f / m_frame_ms : 0.0f;
+    ImGui::LabelText("Frame time", "%.2f ms (%.0f fps)", m_frame_ms, fps);
+
+    // Counts assume early depth testing: lit.frag's discard may disable it in the plain
+    // forward pass, so the real saving there can be larger.
+    if (ImGui::Button("Count forward fragments")) m_measure_requested = true;
+    if (!m_measure_error.empty()) {
+        ImGui::TextDisabled("%s", m_measure_error.c_str());
+    } else if (m_fragments_plain > 0) {
+        double const plain   = static_cast<double>(m_fragments_plain);
+        double const prepass = static_cast<double>(m_fragments_prepass);
+        ImGui::LabelText("Without pre-pass", "%.3f M fragments", plain / 1e6);
+        ImGui::LabelText("With pre-pass", "%.3f M fragments", prepass / 1e6);
+        ImGui::LabelText("Saved", "%.1f%%", 100.0 * (1.0 - prepass / plain));
+    }
+    ImGui::PopItemWidth();
+    ImGui::End();
+
+    return true;
+}
+
+// Floor plus m_layers walls of cubes, drawn farthest-first so every layer overdraws the last.
+// The caller binds the pipeline and pushes view/projection/fragment uniforms.
+void scene_t::draw_opaque(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
+    push_vertex_uniform(cmd, 3, 1.0f);
+    push_vertex_uniform(cmd, 0, glm::translate(glm::mat4{1.0f}, -camera.position));
+    draw(floor_geometry, floor_material, pass);
+
+    for (int layer = m_layers - 1; layer >= 0; --layer) {
+        float const z = FIRST_LAYER_Z - LAYER_DEPTH * static_cast<float>(layer);
+        for (int i = 0; i < WALL_CUBES; ++i) {
+            glm::vec3 const position = {static_cast<float>(i - WALL_CUBES / 2), 0.5f, z};
+            push_vertex_uniform(
+                cmd, 0, glm::translate(glm::mat4{1.0f}, position - camera.position)
+            );
+            draw(cube_geometry, cube_material, pass);
+        }
+    }
+}
+
+void scene_t::measure_fragments(engine_t const &engine) {
+    m_measure_requested = false;
+
+    glm::mat4 view = camera.rotation_view();
+    glm::mat4 proj = glm::perspective(glm::radians(camera.fov), m_aspect_ratio, 0.1f, 100.0f);
+
+    auto const count = [&](gpu_pipeline_t const *depth, gpu_pipeline_t const &shade) {
+        return count_fragments(engine, [&](SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
+            if (depth) {
+                SDL_BindGPUGraphicsPipeline(pass, depth->get());
+                push_vertex_uniform(cmd, 1, view);
+                push_vertex_uniform(cmd, 2, proj);
+                draw_opaque(cmd, pass);
+            }
+            SDL_BindGPUGraphicsPipeline(pass, shade.get());
+            push_vertex_uniform(cmd, 1, view);
+            push_vertex_uniform(cmd, 2, proj);
+            draw_opaque(cmd, pass);
+        });
+    };
+
+    auto plain   = count(nullptr, count_pipeline);
+    auto prepass = count(&count_prepass.depth, count_prepass.shade);
+    if (!plain || !prepass) {
+        m_measure_error = !plain ? plain.error() : prepass.error();
+        return;
+    }
+    m_measure_error.clear();
+    m_fragments_plain   = *plain;
+    m_fragments_prepass = *prepass;
+}
+
+void scene_t::render_gbuffer(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
+    glm::mat4 view = camera.rotation_view();
+    glm::mat4 proj = glm::perspective(glm::radians(camera.fov), m_aspect_ratio, 0.1f, 100.0f);
+
+    SDL_BindGPUGraphicsPipeline(pass, gbuffer_pipeline.get());
+    push_vertex_uniform(cmd, 1, view);
+    push_vertex_uniform(cmd, 2, proj);
+    push_fragment_uniform(cmd, 0, 32.0f);
+    draw_opaque(cmd, pass);
+}
+
+void scene_t::render(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
+    glm::mat4 view = camera.rotation_view();
+    glm::mat4 proj = glm::perspective(glm::radians(camera.fov), m_aspect_ratio, 0.1f, 100.0f);
+
+    int const uniform_lights = std::min(active_lights(), MAX_POS_LIGHTS);
+    int const spot_count     = static_cast<int>(SPOT_LIGHTS.size());
+
+    scene_params_t params = {
+        .shininess     = 32.0f,
+        .pos_count     = uniform_lights,
+        .spot_count    = spot_count,
+        .dir_direction = glm::vec4(-0.2f, -1.0f, -0.3f, 0.0f),
+        .dir_ambient   = glm::vec4(0.03f, 0.03f, 0.04f, 0.0f),
+        .dir_diffuse   = glm::vec4(0.1f, 0.1f, 0.12f, 0.0f),
+        .dir_specular  = glm::vec4(0.2f, 0.2f, 0.2f, 0.0f),
+    };
+
+    pos_lights_block_t<MAX_POS_LIGHTS> pos_block;
+    for (int i = 0; i < uniform_lights; ++i) {
+        pos_block.lights[i] = {
+            .position  = glm::vec4(pos_lights[i].position - camera.position, 0.0f),
+            .ambient   = glm::vec4(pos_lights[i].ambient, 0.0f),
+            .diffuse   = glm::vec4(pos_lights[i].diffuse, 0.0f),
+            .specular  = glm::vec4(pos_lights[i].specular, 0.0f),
+            .constant  = pos_lights[i].constant,
+            .linear    = pos_lights[i].linear,
+            .quadratic = pos_lights[i].quadratic,
+        };
+    }
+
+    spot_lights_block_t<MAX_SPOT_LIGHTS> spot_block;
+    for (int i = 0; i < spot_count; ++i) {
+        spot_block.lights[i] = {
+            .position     = glm::vec4(SPOT_LIGHTS[i].position - camera.position, 0.0f),
+            .direction    = glm::vec4(SPOT_LIGHTS[i].direction, 0.0f),
+            .ambient      = glm::vec4(SPOT_LIGHTS[i].ambient, 0.0f),
+            .diffuse      = glm::vec4(SPOT_LIGHTS[i].diffuse, 0.0f),
+            .specular     = glm::vec4(SPOT_LIGHTS[i].specular, 0.0f),
+            .cutoff       = glm::cos(glm::radians(SPOT_LIGHTS[i].inner_degrees)),
+            .outer_cutoff = glm::cos(glm::radians(SPOT_LIGHTS[i].outer_degrees)),
+            .constant     = SPOT_LIGHTS[i].constant,
+            .linear       = SPOT_LIGHTS[i].linear,
+            .quadratic    = SPOT_LIGHTS[i].quadratic,
+        };
+    }
+
+    auto const           &fl                 = FLASHLIGHT;
+    flashlight_uniforms_t flashlight_uniform = {
+        .direction    = glm::vec4(camera.front(), 0.0f),
+        .ambient      = m_flashlight_on ? glm::vec4(fl.ambient, 0.0f) : glm::vec4(0.0f),
+        .diffuse      = m_flashlight_on ? glm::vec4(fl.diffuse, 0.0f) : glm::vec4(0.0f),
+        .specular     = m_flashlight_on ? glm::vec4(fl.specular, 0.0f) : glm::vec4(0.0f),
+        .cutoff       = glm::cos(glm::radians(fl.inner_degrees)),
+        .outer_cutoff = glm::cos(glm::radians(fl.outer_degrees)),
+        .constant     = fl.constant,
+        .linear       = fl.linear,
+        .quadratic    = fl.quadratic,
+    };
+
+    if (m_mode == lighting_mode_t::forward_prepass) {
+        // Lay down depth with the fragment stage stripped, then shade only the visible surface.
+        SDL_BindGPUGraphicsPipeline(pass, forward_prepass.depth.get());
+        push_vertex_uniform(cmd, 1, view);
+        push_vertex_uniform(cmd, 2, proj);
+        draw_opaque(cmd, pass);
+
+        SDL_BindGPUGraphicsPipeline(pass, forward_prepass.shade.get());
+        push_vertex_uniform(cmd, 1, view);
+        push_vertex_uniform(cmd, 2, proj);
+        push_fragment_uniform(cmd, 0, params);
+        push_fragment_uniform(cmd, 1, pos_block);
+        push_fragment_uniform(cmd, 2, spot_block);
+        push_fragment_uniform(cmd, 3, flashlight_uniform);
+        draw_opaque(cmd, pass);
+    } else if (m_mode == lighting_mode_t::forward) {
+        SDL_BindGPUGraphicsPipeline(pass, forward_pipeline.get());
+        push_vertex_uniform(cmd, 1, view);
+        push_vertex_uniform(cmd, 2, proj);
+        push_fragment_uniform(cmd, 0, params);
+        push_fragment_uniform(cmd, 1, pos_block);
+        push_fragment_uniform(cmd, 2, spot_block);
+        push_fragment_uniform(cmd, 3, flashlight_uniform);
+        draw_opaque(cmd, pass);
+    } else {
+        bool const volumes = m_mode == lighting_mode_t::deferred_volumes;
+        auto const size    = gbuffer.targets[GBUFFER_DEPTH].size;
+
+        deferred_params_t deferred_params = {
+            .inv_view_proj = glm::inverse(proj * view),
+            .screen_size   = glm::vec4(glm::vec2(size), 0.0f, 0.0f),
+            .pos_count     = volumes ? 0 : uniform_lights,
+            .spot_count    = spot_count,
+            .dir_direction = params.dir_direction,
+            .dir_ambient   = params.dir_ambient,
+            .dir_diffuse   = params.dir_diffuse,
+            .dir_specular  = params.dir_specular,
+        };
+
+        // Directional, spot and flashlight (plus positional lights when not using volumes).
+        SDL_BindGPUGraphicsPipeline(pass, light_pipeline.get());
+        bind_gbuffer(gbuffer, gbuffer_sampler, pass);
+        push_fragment_uniform(cmd, 0, deferred_params);
+        push_fragment_uniform(cmd, 1, pos_block);
+        push_fragment_uniform(cmd, 2, spot_block);
+        push_fragment_uniform(cmd, 3, flashlight_uniform);
+        draw(fullscreen_geometry, gpu_material_t{}, pass);
+
+        if (volumes) {
+            SDL_BindGPUGraphicsPipeline(pass, volume_pipeline.get());
+            bind_gbuffer(gbuffer, gbuffer_sampler, pass);
+            push_vertex_uniform(cmd, 1, view);
+            push_vertex_uniform(cmd, 2, proj);
+            push_fragment_uniform(cmd, 0, deferred_params);
+            for (int i = 0; i < m_light_count; ++i) {
+                auto const &light = pos_lights[i];
+                // The unit cube spans [-0.5, 0.5]; scale by the diameter to enclose the radius.
+                auto model = glm::scale(
+                    glm::translate(glm::mat4{1.0f}, light.position - camera.position),
+                    glm::vec3(2.0f * light_volume_radius(light))
+                );
+                push_vertex_uniform(cmd, 0, model);
+                push_fragment_uniform(
+                    cmd, 1,
+                    positional_light_uniforms_t{
+                        .position  = glm::vec4(light.position - camera.position, 0.0f),
+                        .ambient   = glm::vec4(light.ambient, 0.0f),
+                        .diffuse   = glm::vec4(light.diffuse, 0.0f),
+                        .specular  = glm::vec4(light.specular, 0.0f),
+                        .constant  = light.constant,
+                        .linear    = light.linear,
+                        .quadratic = light.quadratic,
+                    }
+                );
+                draw(cube_geometry, gpu_material_t{}, pass);
+            }
+        }
+    }
+
+    // Light indicators.
+    SDL_BindGPUGraphicsPipeline(pass, indicator_pipeline.get());
+    push_vertex_uniform(cmd, 1, view);
+    push_vertex_uniform(cmd, 2, proj);
+    for (int i = 0; i < active_lights(); ++i) {
+        auto const &light = pos_lights[i];
+        push_fragment_uniform(cmd, 0, glm::vec4(light.ambient + light.diffuse, 1.0f));
+        auto model = glm::scale(
+            glm::translate(glm::mat4{1.0f}, light.position - camera.position), glm::vec3(0.1f)
+        );
+        push_vertex_uniform(cmd, 0, model);
+        draw(cube_geometry, gpu_material_t{}, pass);
+    }
+
+    // Transparents stay forward: the G-buffer holds one surface per pixel. They see at most
+    // MAX_POS_LIGHTS positional lights, whichever mode is active.
+    std::vector<model_placement_t> sorted(std::begin(WINDOWS), std::end(WINDOWS));
+    std::ranges::sort(sorted, [&](auto const &a, auto const &b) {
+        return glm::length(a.position - camera.position) >
+               glm::length(b.position - camera.position);
+    });
+
+    scene_params_t window_params = params;
+    window_params.shininess      = 128.0f;
+
+    SDL_BindGPUGraphicsPipeline(pass, window_pipeline.get());
+    push_vertex_uniform(cmd, 1, view);
+    push_vertex_uniform(cmd, 2, proj);
+    push_vertex_uniform(cmd, 3, 1.0f);
+    push_fragment_uniform(cmd, 0, window_params);
+    push_fragment_uniform(cmd, 1, pos_block);
+    push_fragment_uniform(cmd, 2, spot_block);
+    push_fragment_uniform(cmd, 3, flashlight_uniform);
+    for (auto const &placement : sorted) {
+        auto model = glm::scale(
+            glm::translate(glm::mat4{1.0f}, placement.position - camera.position),
+            glm::vec3{placement.scale}
+        );
+        push_vertex_uniform(cmd, 0, model);
+        draw(quad_geometry, window_material, pass);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    auto engine = create_engine(
+        "SDL3 41 - Deferred shading", WINDOW_WIDTH, WINDOW_HEIGHT, parse_engine_args(argc, argv)
+    );
+    if (!engine) {
+        std::println(stderr, "{}", engine.error());
+        return 1;
+    }
+
+    auto scene = create_scene(*engine);
+    if (!scene) {
+        std::println(stderr, "{}", scene.error());
+        return 1;
+    }
+
+    auto depth = create_tracked_depth(*engine);
+    if (!depth) {
+        std::println(stderr, "{}", depth.error());
+        return 1;
+    }
+
+    // Geometry pass: the lighting quad only touches pixels with geometry, so the G-buffer never
+    // needs clearing. Depth is stored for the lighting and forward passes that follow.
+    auto const gbuffer_targets = scene->gbuffer.attachments();
+
+    std::array<pass_desc_t, 2> passes = {{
+        {.depth_texture  = &depth->texture,
+         .load_op        = SDL_GPU_LOADOP_DONT_CARE,
+         .draw           = [&](auto cmd, auto pass) { scene->render_gbuffer(cmd, pass); },
+         .color_targets  = gbuffer_targets,
+         .depth_store_op = SDL_GPU_STOREOP_STORE},
+        {.depth_texture = &depth->texture,
+         .prepare       = [](auto cmd) { imgui_prepare(cmd); },
+         .draw =
+             [&](auto cmd, auto pass) {
+                 scene->render(cmd, pass);
+                 imgui_render(cmd, pass);
+             }},
+    }};
+
+    auto result = run_loop(
+        *engine, [&]() { return scene->m_clear_color; }, *depth, scene->gbuffer.targets,
+        [&](input_t const &in) {
+            bool const keep_running = scene->update(in);
+            if (scene->m_measure_requested) scene->measure_fragments(*engine);
+            // Forward modes skip the G-buffer pass and clear depth in the main pass instead.
+            bool const forward      = is_forward(scene->m_mode);
+            passes[0].enabled       = !forward;
+            passes[1].depth_load_op = forward ? SDL_GPU_LOADOP_CLEAR : SDL_GPU_LOADOP_LOAD;
+            return keep_running;
+        },
+        passes
+    );
+    if (!result) {
+        std::println(stderr, "{}", result.error());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,163 @@
+#version 460 core
+
+#define MAX_POS_LIGHTS  16
+#define MAX_SPOT_LIGHTS 8
+
+// Fullscreen lighting pass: same light model as sdl3_24/lit.frag, but surface attributes come
+// from the G-buffer instead of interpolated vertex outputs, so each covered pixel is lit once
+// regardless of how many opaque layers were rasterised into it.
+
+layout(set = 2, binding = 0) uniform sampler2D albedo_spec_tex;
+layout(set = 2, binding = 1) uniform sampler2D normal_tex;
+layout(set = 2, binding = 2) uniform sampler2D depth_tex;
+
+layout(set = 3, binding = 0) uniform DeferredParamsBlock {
+    mat4 inv_view_proj; // inverse(projection * rotation_view): NDC -> camera-relative world
+    vec4 screen_size;   // xy = framebuffer size in pixels
+    int pos_count;
+    int spot_count;
+    int pad0;
+    int pad1;
+    vec4 dir_direction;
+    vec4 dir_ambient;
+    vec4 dir_diffuse;
+    vec4 dir_specular;
+} scene;
+
+struct pos_light_t {
+    vec4 position;
+    vec4 ambient;
+    vec4 diffuse;
+    vec4 specular;
+    float constant;
+    float linear;
+    float quadratic;
+    float pad;
+};
+
+layout(set = 3, binding = 1) uniform PosLightsBlock {
+    pos_light_t lights[MAX_POS_LIGHTS];
+} pos_lights;
+
+struct spot_light_t {
+    vec4 position;
+    vec4 direction;
+    vec4 ambient;
+    vec4 diffuse;
+    vec4 specular;
+    float cutoff;
+    float outer_cutoff;
+    float constant;
+    float linear;
+    float quadratic;
+};
+
+layout(set = 3, binding = 2) uniform SpotLightsBlock {
+    spot_light_t lights[MAX_SPOT_LIGHTS];
+} spot_lights;
+
+layout(set = 3, binding = 3) uniform FlashlightBlock {
+    vec4 direction;
+    vec4 ambient;
+    vec4 diffuse;
+    vec4 specular;
+    float cutoff;
+    float outer_cutoff;
+    float constant;
+    float linear;
+    float quadratic;
+} flashlight;
+
+layout(location = 0) out vec4 frag_color;
+
+vec3 frag_pos;
+float shininess;
+
+vec3 directional_contribution(vec3 norm, vec3 view_dir, vec3 diffuse_color, vec3 specular_color) {
+    vec3 light_dir = normalize(-scene.dir_direction.xyz);
+    vec3 ambient = scene.dir_ambient.rgb * diffuse_color;
+    float diff = max(dot(norm, light_dir), 0.0);
+    vec3 diffuse = scene.dir_diffuse.rgb * diff * diffuse_color;
+    vec3 reflect_dir = reflect(-light_dir, norm);
+    float spec = pow(max(dot(view_dir, reflect_dir), 0.0), shininess);
+    vec3 specular = scene.dir_specular.rgb * spec * specular_color;
+    return ambient + diffuse + specular;
+}
+
+vec3 positional_contribution(
+    pos_light_t light, vec3 norm, vec3 view_dir, vec3 diffuse_color, vec3 specular_color
+) {
+    vec3 to_light = light.position.xyz - frag_pos;
+    float dist = length(to_light);
+    float attenuation = 1.0 / (light.constant + light.linear * dist + light.quadratic * dist * dist);
+    vec3 light_dir = normalize(to_light);
+    vec3 ambient = light.ambient.rgb * diffuse_color;
+    float diff = max(dot(norm, light_dir), 0.0);
+    vec3 diffuse = light.diffuse.rgb * diff * diffuse_color;
+    vec3 reflect_dir = reflect(-light_dir, norm);
+    float spec = pow(max(dot(view_dir, reflect_dir), 0.0), shininess);
+    vec3 specular = light.specular.rgb * spec * specular_color;
+    return attenuation * (ambient + diffuse + specular);
+}
+
+vec3 spot_contribution(
+    spot_light_t light, vec3 norm, vec3 view_dir, vec3 diffuse_color, vec3 specular_color
+) {
+    vec3 to_light = light.position.xyz - frag_pos;
+    float dist = length(to_light);
+    float attenuation = 1.0 / (light.constant + light.linear * dist + light.quadratic * dist * dist);
+    vec3 light_dir = normalize(to_light);
+    float theta = dot(light_dir, normalize(-light.direction.xyz));
+    float epsilon = light.cutoff - light.outer_cutoff;
+    float intensity = clamp((theta - light.outer_cutoff) / epsilon, 0.0, 1.0);
+    vec3 ambient = light.ambient.rgb * diffuse_color;
+    float diff = max(dot(norm, light_dir), 0.0);
+    vec3 diffuse = light.diffuse.rgb * diff * diffuse_color;
+    vec3 reflect_dir = reflect(-light_dir, norm);
+    float spec = pow(max(dot(view_dir, reflect_dir), 0.0), shininess);
+    vec3 specular = light.specular.rgb * spec * specular_color;
+    return attenuation * (ambient + intensity * (diffuse + specular));
+}
+
+vec3 flashlight_contribution(vec3 norm, vec3 view_dir, vec3 diffuse_color, vec3 specular_color) {
+    vec3 to_light = -frag_pos;
+    float dist = length(to_light);
+    float attenuation = 1.0 / (flashlight.constant + flashlight.linear * dist + flashlight.quadratic * dist * dist);
+    vec3 light_dir = normalize(to_light);
+    float theta = dot(light_dir, normalize(-flashlight.direction.xyz));
+    float epsilon = flashlight.cutoff - flashlight.outer_cutoff;
+    float intensity = clamp((theta - flashlight.outer_cutoff) / epsilon, 0.0, 1.0);
+    vec3 ambient = flashlight.ambient.rgb * diffuse_color;
+    float diff = max(dot(norm, light_dir), 0.0);
+    vec3 diffuse = flashlight.diffuse.rgb * diff * diffuse_color;
+    vec3 reflect_dir = reflect(-light_dir, norm);
+    float spec = pow(max(dot(view_dir, reflect_dir), 0.0), shininess);
+    vec3 specular = flashlight.specular.rgb * spec * specular_color;
+    return attenuation * (ambient + intensity * (diffuse + specular));
+}
+
+void main() {
+    vec2 uv = gl_FragCoord.xy / scene.screen_size.xy;
+    vec4 albedo_spec = texture(albedo_spec_tex, uv);
+    vec4 normal_shininess = texture(normal_tex, uv);
+    float depth = texture(depth_tex, uv).r;
+
+    // Texture rows run top-to-bottom while NDC y points up.
+    vec4 world = scene.inv_view_proj * vec4(uv.x * 2.0 - 1.0, 1.0 - uv.y * 2.0, depth, 1.0);
+    frag_pos = world.xyz / world.w;
+    shininess = normal_shininess.w;
+
+    vec3 diffuse_color = albedo_spec.rgb;
+    vec3 specular_color = vec3(albedo_spec.a);
+    vec3 norm = normalize(normal_shininess.xyz);
+    vec3 view_dir = normalize(-frag_pos);
+
+    vec3 result = directional_contribution(norm, view_dir, diffuse_color, specular_color);
+    for (int i = 0; i < scene.pos_count; ++i)
+        result += positional_contribution(pos_lights.lights[i], norm, view_dir, diffuse_color, specular_color);
+    for (int i = 0; i < scene.spot_count; ++i)
+        result += spot_contribution(spot_lights.lights[i], norm, view_dir, diffuse_color, specular_color);
+    result += flashlight_contribution(norm, view_dir, diffuse_color, specular_color);
+
+    frag_color = vec4(result, 1.0);
+}
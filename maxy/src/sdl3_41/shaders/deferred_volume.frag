@@ -0,0 +1,63 @@
+#version 460 core
+
+// Light-volume pass: one positional light per draw, rasterised as a cube bounding the light's
+// visible radius and accumulated with additive blending. Only pixels whose G-buffer surface
+// lies in front of the volume's back faces are shaded.
+
+layout(set = 2, binding = 0) uniform sampler2D albedo_spec_tex;
+layout(set = 2, binding = 1) uniform sampler2D normal_tex;
+layout(set = 2, binding = 2) uniform sampler2D depth_tex;
+
+layout(set = 3, binding = 0) uniform DeferredParamsBlock {
+    mat4 inv_view_proj;
+    vec4 screen_size;
+    int pos_count;
+    int spot_count;
+    int pad0;
+    int pad1;
+    vec4 dir_direction;
+    vec4 dir_ambient;
+    vec4 dir_diffuse;
+    vec4 dir_specular;
+} scene;
+
+layout(set = 3, binding = 1) uniform PosLightBlock {
+    vec4 position;
+    vec4 ambient;
+    vec4 diffuse;
+    vec4 specular;
+    float constant;
+    float linear;
+    float quadratic;
+    float pad;
+} light;
+
+layout(location = 0) out vec4 frag_color;
+
+void main() {
+    vec2 uv = gl_FragCoord.xy / scene.screen_size.xy;
+    vec4 albedo_spec = texture(albedo_spec_tex, uv);
+    vec4 normal_shininess = texture(normal_tex, uv);
+    float depth = texture(depth_tex, uv).r;
+
+    vec4 world = scene.inv_view_proj * vec4(uv.x * 2.0 - 1.0, 1.0 - uv.y * 2.0, depth, 1.0);
+    vec3 frag_pos = world.xyz / world.w;
+
+    vec3 diffuse_color = albedo_spec.rgb;
+    vec3 specular_color = vec3(albedo_spec.a);
+    vec3 norm = normalize(normal_shininess.xyz);
+    vec3 view_dir = normalize(-frag_pos);
+
+    vec3 to_light = light.position.xyz - frag_pos;
+    float dist = length(to_light);
+    float attenuation = 1.0 / (light.constant + light.linear * dist + light.quadratic * dist * dist);
+    vec3 light_dir = normalize(to_light);
+    vec3 ambient = light.ambient.rgb * diffuse_color;
+    float diff = max(dot(norm, light_dir), 0.0);
+    vec3 diffuse = light.diffuse.rgb * diff * diffuse_color;
+    vec3 reflect_dir = reflect(-light_dir, norm);
+    float spec = pow(max(dot(view_dir, reflect_dir), 0.0), normal_shininess.w);
+    vec3 specular = light.specular.rgb * spec * specular_color;
+
+    frag_color = vec4(attenuation * (ambient + diffuse + specular), 1.0);
+}
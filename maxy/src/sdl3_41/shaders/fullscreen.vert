@@ -0,0 +1,10 @@
+#version 460 core
+
+// Fullscreen lighting quad placed on the far plane. With depth compare GREATER against the
+// geometry pass depth, only pixels covered by geometry run the lighting shader.
+
+layout(location = 0) in vec3 position;
+
+void main() {
+    gl_Position = vec4(position.xy, 1.0, 1.0);
+}
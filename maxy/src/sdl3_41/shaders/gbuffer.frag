@@ -0,0 +1,27 @@
+#version 460 core
+
+// Geometry pass: writes surface attributes only. Pairs with sdl3_24/lit.vert, whose outputs
+// are camera-relative world-space position and normal.
+
+layout(location = 0) in vec2 frag_tex_coord;
+layout(location = 1) in vec3 frag_pos;
+layout(location = 2) in vec3 frag_normal;
+
+layout(set = 2, binding = 0) uniform sampler2D diffuse_tex;
+layout(set = 2, binding = 1) uniform sampler2D specular_tex;
+
+layout(set = 3, binding = 0) uniform MaterialBlock {
+    float shininess;
+} material;
+
+layout(location = 0) out vec4 albedo_spec;
+layout(location = 1) out vec4 normal_shininess;
+layout(location = 2) out float depth;
+
+void main() {
+    vec4 diffuse_texel = texture(diffuse_tex, frag_tex_coord);
+    if (diffuse_texel.a < 0.1) discard;
+    albedo_spec = vec4(diffuse_texel.rgb, texture(specular_tex, frag_tex_coord).r);
+    normal_shininess = vec4(normalize(frag_normal), material.shininess);
+    depth = gl_FragCoord.z;
+}
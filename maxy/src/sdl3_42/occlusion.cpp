@@ -0,0 +1,319 @@
+#include "engine.hpp"
+#include "occlusion.hpp"
+#include <SDL3/SDL_main.h>
+#include <algorithm>
+#include <array>
+#include <glm/gtc/matrix_transform.hpp>
+#include <imgui.h>
+#include <print>
+#include <random>
+#include <vector>
+
+constexpr std::string_view TITLE         = "CPU occlusion culling";
+constexpr int              WINDOW_WIDTH  = 1024;
+constexpr int              WINDOW_HEIGHT = 768;
+
+// Dense city: one building per block, crates scattered along the pavements. Streets run along
+// multiples of BLOCK_PITCH, so the camera starts at an intersection.
+constexpr int   CITY_BLOCKS     = 24;
+constexpr float BLOCK_PITCH     = 14.0f;
+constexpr int   PROPS_PER_BLOCK = 8;
+constexpr float FAR_PLANE       = 400.0f;
+
+// Low resolution is enough: occluders are large and a test only needs a conservative answer.
+constexpr int OCCLUSION_WIDTH  = 320;
+constexpr int OCCLUSION_HEIGHT = 180;
+
+static constexpr std::array<pos_normal_uv_vertex_t, 6> ground_vertices = {{
+    {{250.0f, 0.0f, 250.0f}, {0.0f, 1.0f, 0.0f}, {100.0f, 0.0f}},
+    {{-250.0f, 0.0f, -250.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 100.0f}},
+    {{-250.0f, 0.0f, 250.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f}},
+    {{250.0f, 0.0f, 250.0f}, {0.0f, 1.0f, 0.0f}, {100.0f, 0.0f}},
+    {{250.0f, 0.0f, -250.0f}, {0.0f, 1.0f, 0.0f}, {100.0f, 100.0f}},
+    {{-250.0f, 0.0f, -250.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 100.0f}},
+}};
+
+struct city_object_t {
+    aabb_t box;
+    bool   building; // buildings are occluder candidates and use the marble material
+};
+
+struct scene_t {
+    gpu_pipeline_t pipeline;
+    gpu_geometry_t cube_geometry;
+    gpu_geometry_t ground_geometry;
+    gpu_material_t building_material;
+    gpu_material_t prop_material;
+    gpu_material_t ground_material;
+
+    camera_t camera;
+    float    m_aspect_ratio = static_cast<float>(WINDOW_WIDTH) / WINDOW_HEIGHT;
+
+    std::vector<city_object_t> objects;
+    std::vector<visibility_t>  visibility;
+    occlusion_buffer_t         occlusion{OCCLUSION_WIDTH, OCCLUSION_HEIGHT};
+
+    bool  m_cull           = true;
+    bool  m_freeze         = false;
+    int   m_max_occluders  = 32;
+    float m_occluder_range = 80.0f;
+
+    // Timings and counts averaged over the frames cull() ran in each half-second window, so the
+    // readout is stable. Disabling culling zeroes them.
+    float  m_sample_time   = 0.0f;
+    int    m_sample_frames = 0;
+    double m_raster_sum    = 0.0;
+    double m_test_sum      = 0.0;
+    size_t m_occluded_sum  = 0;
+    size_t m_offscreen_sum = 0;
+    float  m_raster_us     = 0.0f;
+    float  m_test_us       = 0.0f;
+    float  m_occluded_pct  = 0.0f;
+    float  m_offscreen_pct = 0.0f;
+    int    m_occluders     = 0;
+
+    bool update(input_t const &in);
+    void render(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass);
+
+private:
+    glm::mat4 projection() const {
+        return glm::perspective(glm::radians(camera.fov), m_aspect_ratio, 0.1f, FAR_PLANE);
+    }
+    void cull();
+    void reset_stats();
+};
+
+std::expected<scene_t, std::string> create_scene(engine_t &engine) {
+    if (auto r = init_imgui(engine); !r) return std::unexpected(r.error());
+    ImGui::GetIO().IniFilename = nullptr;
+
+    auto pipeline = create_pipeline(
+        engine, {
+                    .vertex_shader          = "shaders/sdl3_24/grass.vert.spv",
+                    .fragment_shader        = "shaders/sdl3_24/grass.frag.spv",
+                    .vertex_uniform_buffers = 3,
+                    .fragment_samplers      = 1,
+                    .vertex_buffer_descs    = pos_normal_uv_buffer_descs,
+                    .vertex_attributes      = pos_normal_uv_vertex_attributes,
+                    .enable_depth_test      = true,
+                }
+    );
+    if (!pipeline) return std::unexpected(pipeline.error());
+
+    auto cube_geometry = create_vertex_geometry(
+        engine, unit_cube_with_normals.data(), static_cast<Uint32>(sizeof(unit_cube_with_normals)),
+        static_cast<Uint32>(unit_cube_with_normals.size())
+    );
+    if (!cube_geometry) return std::unexpected(cube_geometry.error());
+
+    auto ground_geometry = create_vertex_geometry(
+        engine, ground_vertices.data(), static_cast<Uint32>(sizeof(ground_vertices)),
+        static_cast<Uint32>(ground_vertices.size())
+    );
+    if (!ground_geometry) return std::unexpected(ground_geometry.error());
+
+    auto building_material = create_material(
+        engine, {.texture_paths = {std::string(ASSETS_PATH) + "textures/marble.jpg"}}
+    );
+    if (!building_material) return std::unexpected(building_material.error());
+
+    auto prop_material = create_material(
+        engine, {.texture_paths = {std::string(ASSETS_PATH) + "textures/container2.png"}}
+    );
+    if (!prop_material) return std::unexpected(prop_material.error());
+
+    auto ground_material = create_material(
+        engine, {.texture_paths = {std::string(ASSETS_PATH) + "textures/metal.png"}}
+    );
+    if (!ground_material) return std::unexpected(ground_material.error());
+
+    scene_t scene{
+        .pipeline          = std::move(*pipeline),
+        .cube_geometry     = std::move(*cube_geometry),
+        .ground_geometry   = std::move(*ground_geometry),
+        .building_material = std::move(*building_material),
+        .prop_material     = std::move(*prop_material),
+        .ground_material   = std::move(*ground_material),
+        .camera            = camera_t{engine.window, {0.0f, 1.7f, 0.0f}},
+    };
+    scene.camera.speed = 10.0f;
+
+    // Fixed seed: the same city every run, so numbers are comparable between builds.
+    std::mt19937                          rng(42);
+    std::uniform_real_distribution<float> footprint(8.0f, 10.0f);
+    std::uniform_real_distribution<float> height(6.0f, 30.0f);
+    std::uniform_real_distribution<float> crate(0.6f, 1.2f);
+    std::uniform_real_distribution<float> along(-6.0f, 6.0f);
+    std::uniform_int_distribution<int>    side(0, 3);
+
+    for (int bz = 0; bz < CITY_BLOCKS; ++bz) {
+        for (int bx = 0; bx < CITY_BLOCKS; ++bx) {
+            glm::vec3 const center = {
+                (static_cast<float>(bx - CITY_BLOCKS / 2) + 0.5f) * BLOCK_PITCH, 0.0f,
+                (static_cast<float>(bz - CITY_BLOCKS / 2) + 0.5f) * BLOCK_PITCH
+            };
+            glm::vec3 const half   = {footprint(rng) * 0.5f, height(rng), footprint(rng) * 0.5f};
+            glm::vec3 const base   = center - glm::vec3(half.x, 0.0f, half.z);
+            scene.objects.push_back({{base, center + half}, true});
+
+            // Crates on the pavement ring between the building and the street.
+            for (int i = 0; i < PROPS_PER_BLOCK; ++i) {
+                float const                    offset   = along(rng);
+                float const                    size     = crate(rng);
+                std::array<glm::vec3, 4> const pavement = {{
+                    {offset, 0.0f, 6.0f},
+                    {offset, 0.0f, -6.0f},
+                    {6.0f, 0.0f, offset},
+                    {-6.0f, 0.0f, offset},
+                }};
+                glm::vec3 const at = center + pavement[side(rng)];
+                glm::vec3 const lo = at - glm::vec3(size * 0.5f, 0.0f, size * 0.5f);
+                glm::vec3 const hi = at + glm::vec3(size * 0.5f, size, size * 0.5f);
+                scene.objects.push_back({{lo, hi}, false});
+            }
+        }
+    }
+    scene.visibility.assign(scene.objects.size(), visibility_t::visible);
+
+    return scene;
+}
+
+// Rasterizes the nearest buildings as occluders and classifies every object. Both phases are
+// timed separately so the panel shows where the CPU cost goes.
+void scene_t::cull() {
+    if (!m_cull) {
+        std::ranges::fill(visibility, visibility_t::visible);
+        m_occluders = 0;
+        reset_stats();
+        return;
+    }
+
+    Uint64 const start = SDL_GetPerformanceCounter();
+
+    std::vector<std::pair<float, size_t>> candidates;
+    for (size_t i = 0; i < objects.size(); ++i) {
+        if (!objects[i].building) continue;
+        glm::vec3 const center   = (objects[i].box.min + objects[i].box.max) * 0.5f;
+        float const     distance = glm::length(center - camera.position);
+        if (distance < m_occluder_range) candidates.emplace_back(distance, i);
+    }
+    size_t const count = std::min(candidates.size(), static_cast<size_t>(m_max_occluders));
+    std::ranges::partial_sort(candidates, candidates.begin() + static_cast<ptrdiff_t>(count));
+
+    occlusion.begin(projection() * camera.view_matrix());
+    for (size_t i = 0; i < count; ++i) occlusion.rasterize_box(objects[candidates[i].second].box);
+    occlusion.finalize();
+    m_occluders = static_cast<int>(count);
+
+    Uint64 const rasterized = SDL_GetPerformanceCounter();
+
+    for (size_t i = 0; i < objects.size(); ++i) {
+        visibility[i] = occlusion.test(objects[i].box);
+        if (visibility[i] == visibility_t::occluded) ++m_occluded_sum;
+        if (visibility[i] == visibility_t::off_screen) ++m_offscreen_sum;
+    }
+
+    Uint64 const tested      = SDL_GetPerformanceCounter();
+    double const us_per_tick = 1e6 / static_cast<double>(SDL_GetPerformanceFrequency());
+    m_raster_sum += static_cast<double>(rasterized - start) * us_per_tick;
+    m_test_sum += static_cast<double>(tested - rasterized) * us_per_tick;
+    ++m_sample_frames;
+}
+
+// Culling off: nothing is rasterized or tested, so the readout shows zeros rather than the last
+// window, and a new window starts once it is back on.
+void scene_t::reset_stats() {
+    m_sample_time   = 0.0f;
+    m_sample_frames = 0;
+    m_raster_sum    = 0.0;
+    m_test_sum      = 0.0;
+    m_occluded_sum  = 0;
+    m_offscreen_sum = 0;
+    m_raster_us     = 0.0f;
+    m_test_us       = 0.0f;
+    m_occluded_pct  = 0.0f;
+    m_offscreen_pct = 0.0f;
+}
+
+bool scene_t::update(input_t const &in) {
+    m_aspect_ratio = in.aspect_ratio;
+    if (in.keys[SDL_SCANCODE_ESCAPE]) return false;
+
+    camera.update(in);
+
+    // Frozen: keep the last classification so the culled set can be inspected from outside.
+    if (!m_freeze) cull();
+
+    // Only frames that ran cull() are averaged; frozen frames keep the window open.
+    m_sample_time += in.dt;
+    if (m_sample_time >= 0.5f && m_sample_frames > 0) {
+        double const frames = static_cast<double>(m_sample_frames);
+        double const tested = frames * static_cast<double>(objects.size());
+        m_raster_us         = static_cast<float>(m_raster_sum / frames);
+        m_test_us           = static_cast<float>(m_test_sum / frames);
+        m_occluded_pct  = static_cast<float>(100.0 * static_cast<double>(m_occluded_sum) / tested);
+        m_offscreen_pct = static_cast<float>(100.0 * static_cast<double>(m_offscreen_sum) / tested);
+        m_sample_time   = 0.0f;
+        m_sample_frames = 0;
+        m_raster_sum    = 0.0;
+        m_test_sum      = 0.0;
+        m_occluded_sum  = 0;
+        m_offscreen_sum = 0;
+    }
+
+    ImGui::SetNextWindowPos(ImVec2(6.0f, 6.0f), ImGuiCond_Once);
+    ImGui::Begin("Scene", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+    ImGui::PushItemWidth(180.0f);
+    ImGui::LabelText(
+        "Camera", "(%.2f, %.2f, %.2f)", camera.position.x, camera.position.y, camera.position.z
+    );
+    ImGui::LabelText("Mode", "%s", camera.ui_mode() ? "UI (` to fly)" : "Fly (` for UI)");
+    ImGui::Checkbox("Occlusion culling", &m_cull);
+    ImGui::Checkbox("Freeze culling", &m_freeze);
+    ImGui::SliderInt("Max occluders", &m_max_occluders, 0, 128);
+    ImGui::SliderFloat("Occluder range", &m_occluder_range, 10.0f, 200.0f, "%.0f");
+    ImGui::LabelText("Depth buffer", "%d x %d", occlusion.width(), occlusion.height());
+    ImGui::LabelText("Occluders", "%d", m_occluders);
+    ImGui::LabelText("Rasterize", "%.1f us/frame", m_raster_us);
+    ImGui::LabelText("Test", "%.1f us/frame", m_test_us);
+    ImGui::LabelText("Objects", "%zu", objects.size());
+    ImGui::LabelText("Occluded", "%.1f%%", m_occluded_pct);
+    ImGui::LabelText("Off screen", "%.1f%%", m_offscreen_pct);
+    ImGui::PopItemWidth();
+    ImGui::End();
+
+    return true;
+}
+
+void scene_t::render(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
+    SDL_BindGPUGraphicsPipeline(pass, pipeline.get());
+    push_vertex_uniform(cmd, 1, camera.rotation_view());
+    push_vertex_uniform(cmd, 2, projection());
+
+    push_vertex_uniform(cmd, 0, glm::translate(glm::mat4{1.0f}, -camera.position));
+    draw(ground_geometry, ground_material, pass);
+
+    // The unit cube spans [-0.5, 0.5]: scale to the box size around its centre.
+    for (size_t i = 0; i < objects.size(); ++i) {
+        if (visibility[i] != visibility_t::visible) continue;
+        auto const &box    = objects[i].box;
+        auto const  center = (box.min + box.max) * 0.5f;
+        auto model = glm::scale(
+            glm::translate(glm::mat4{1.0f}, center - camera.position), box.max - box.min
+        );
+        push_vertex_uniform(cmd, 0, model);
+        draw(cube_geometry, objects[i].building ? building_material : prop_material, pass);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    auto result = run_app(
+        argc, argv, TITLE, WINDOW_WIDTH, WINDOW_HEIGHT, SDL_FColor{0.55f, 0.65f, 0.75f, 1.0f},
+        create_scene
+    );
+    if (!result) {
+        std::println(stderr, "{}", result.error());
+        return 1;
+    }
+    return 0;
+}
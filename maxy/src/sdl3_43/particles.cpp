@@ -0,0 +1,283 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <print>
+#include <span>
+
+#include <SDL3/SDL.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <imgui.h>
+
+#include "engine.hpp"
+
+constexpr int        WINDOW_WIDTH     = 1280;
+constexpr int        WINDOW_HEIGHT    = 720;
+constexpr SDL_FColor BACKGROUND_COLOR = {0.0f, 0.0f, 0.01f, 1.0f};
+
+// The whole simulation lives in one GPU buffer: seeded by particle_init.comp, integrated in place
+// by particle_update.comp and bound as the vertex buffer of a point-list draw. The CPU only
+// pushes a few uniforms per frame.
+constexpr Uint32 PARTICLE_COUNT = 1u << 20;
+constexpr Uint32 GROUP_SIZE     = 256; // local_size_x of both compute shaders
+constexpr int    MAX_ATTRACTORS = 4;   // MAX_ATTRACTORS in particle_update.comp
+
+// Matches struct particle_t in the compute shaders (std430) and the vertex layout below.
+struct particle_t {
+    glm::vec4 position;
+    glm::vec4 velocity;
+};
+
+// Matches the InitParams uniform block in particle_init.comp (std140).
+struct init_params_t {
+    Uint32 particle_count;
+    Uint32 seed;
+    float  orbit_strength;
+    float  pad;
+};
+
+// Matches the UpdateParams uniform block in particle_update.comp (std140).
+struct update_params_t {
+    glm::vec4 attractors[MAX_ATTRACTORS];
+    float     dt;
+    float     damping;
+    Uint32    particle_count;
+    Uint32    attractor_count;
+};
+
+constexpr SDL_GPUVertexBufferDescription particle_buffer_descs[] = {{
+    .slot       = 0,
+    .pitch      = sizeof(particle_t),
+    .input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX,
+}};
+
+constexpr SDL_GPUVertexAttribute particle_vertex_attributes[] = {
+    {.location    = 0,
+     .buffer_slot = 0,
+     .format      = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
+     .offset      = static_cast<Uint32>(offsetof(particle_t, position))},
+    {.location    = 1,
+     .buffer_slot = 0,
+     .format      = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
+     .offset      = static_cast<Uint32>(offsetof(particle_t, velocity))},
+};
+
+struct scene_t {
+    gpu_compute_pipeline_t init_pipeline;
+    gpu_compute_pipeline_t update_pipeline;
+    gpu_pipeline_t         render_pipeline;
+    gpu_buffer_t           particles; // particle_t[PARTICLE_COUNT]
+
+    camera_t camera;
+    float    m_aspect_ratio = static_cast<float>(WINDOW_WIDTH) / WINDOW_HEIGHT;
+
+    // Simulation controls.
+    bool   m_reset           = true; // reseed on the next frame (and on the first)
+    Uint32 m_seed            = 1;
+    bool   m_paused          = false;
+    float  m_time_scale      = 1.0f;
+    float  m_strength        = 60.0f; // central attractor; the satellites pull a third as hard
+    float  m_drag            = 0.02f; // fraction of velocity lost per second
+    int    m_attractor_count = 3;
+    float  m_time            = 0.0f; // simulation time, drives the orbiting attractors
+
+    update_params_t m_params = {};
+
+    // Frame time averaged over half-second windows so the readout is stable.
+    float m_frame_ms      = 0.0f;
+    float m_sample_time   = 0.0f;
+    int   m_sample_frames = 0;
+
+    bool update(input_t const &in);
+    void dispatch(SDL_GPUCommandBuffer *cmd, SDL_GPUComputePass *pass);
+    void render(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass);
+};
+
+std::expected<scene_t, std::string> create_scene(engine_t &engine) {
+    scene_t scene;
+    scene.camera       = camera_t(engine.window, {0.0f, 12.0f, 45.0f}, -90.0f, -15.0f);
+    scene.camera.speed = 15.0f;
+
+    if (auto r = init_imgui(engine); !r) return std::unexpected(r.error());
+    ImGui::GetIO().IniFilename = nullptr;
+
+    // Resource counts and local_size are reflected from the SPIR-V.
+    auto init_pipeline = create_compute_pipeline(engine, "shaders/sdl3_43/particle_init.comp.spv");
+    if (!init_pipeline) return std::unexpected(init_pipeline.error());
+    scene.init_pipeline = std::move(*init_pipeline);
+
+    auto update_pipeline =
+        create_compute_pipeline(engine, "shaders/sdl3_43/particle_update.comp.spv");
+    if (!update_pipeline) return std::unexpected(update_pipeline.error());
+    scene.update_pipeline = std::move(*update_pipeline);
+
+    auto render_pipeline = create_pipeline(
+        engine, {
+                    .vertex_shader          = "shaders/sdl3_43/particle.vert.spv",
+                    .fragment_shader        = "shaders/sdl3_43/particle.frag.spv",
+                    .vertex_uniform_buffers = 1,
+                    .vertex_buffer_descs    = particle_buffer_descs,
+                    .vertex_attributes      = particle_vertex_attributes,
+                    .enable_blend           = true,
+                    .additive_blend         = true,
+                    .primitive_type         = SDL_GPU_PRIMITIVETYPE_POINTLIST,
+                }
+    );
+    if (!render_pipeline) return std::unexpected(render_pipeline.error());
+    scene.render_pipeline = std::move(*render_pipeline);
+
+    // No initial data: particle_init.comp seeds the buffer on the first frame.
+    auto particles = create_storage_buffer(
+        engine, PARTICLE_COUNT * sizeof(particle_t), nullptr, SDL_GPU_BUFFERUSAGE_VERTEX
+    );
+    if (!particles) return std::unexpected(particles.error());
+    scene.particles = std::move(*particles);
+
+    return scene;
+}
+
+bool scene_t::update(input_t const &in) {
+    m_aspect_ratio = in.aspect_ratio;
+    if (in.keys[SDL_SCANCODE_ESCAPE]) return false;
+
+    camera.update(in);
+
+    m_sample_time += in.dt;
+    ++m_sample_frames;
+    if (m_sample_time >= 0.5f) {
+        m_frame_ms      = 1000.0f * m_sample_time / static_cast<float>(m_sample_frames);
+        m_sample_time   = 0.0f;
+        m_sample_frames = 0;
+    }
+
+    ImGui::SetNextWindowPos(ImVec2(6.0f, 6.0f), ImGuiCond_Once);
+    ImGui::Begin("Scene", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+    ImGui::PushItemWidth(200.0f);
+    ImGui::LabelText(
+        "Camera", "(%.2f, %.2f, %.2f)", camera.position.x, camera.position.y, camera.position.z
+    );
+    ImGui::LabelText("Mode", "%s", camera.ui_mode() ? "UI (` to fly)" : "Fly (` for UI)");
+    ImGui::LabelText("Particles", "%u", PARTICLE_COUNT);
+    float const fps = m_frame_ms > 0.0f ? 1000.0f / m_frame_ms : 0.0f;
+    ImGui::LabelText("Frame time", "%.2f ms (%.0f fps)", m_frame_ms, fps);
+    ImGui::Separator();
+    ImGui::Checkbox("Pause", &m_paused);
+    ImGui::SliderFloat("Time scale", &m_time_scale, 0.0f, 4.0f, "%.2f");
+    ImGui::SliderFloat("Attractor strength", &m_strength, 0.0f, 200.0f, "%.0f");
+    ImGui::SliderFloat("Drag", &m_drag, 0.0f, 0.5f, "%.2f");
+    ImGui::SliderInt("Attractors", &m_attractor_count, 1, 3);
+    if (ImGui::Button("Reset")) {
+        m_reset = true;
+        ++m_seed;
+    }
+    ImGui::PopItemWidth();
+    ImGui::End();
+
+    // Clamped so a hitch (window drag, shader compile) cannot blow the orbits apart.
+    float const dt = m_paused ? 0.0f : std::min(in.dt, 1.0f / 30.0f) * m_time_scale;
+    m_time += dt;
+
+    // A fixed central mass plus two satellites orbiting it on tilted circles.
+    float const inner = 0.4f * m_time;
+    float const outer = 0.28f * m_time;
+    float const pull  = m_strength / 3.0f;
+
+    m_params.attractors[0] = {0.0f, 0.0f, 0.0f, m_strength};
+    m_params.attractors[1] = {
+        12.0f * std::cos(inner), 2.0f * std::sin(inner), 12.0f * std::sin(inner), pull
+    };
+    m_params.attractors[2] = {
+        -16.0f * std::cos(outer), -3.0f * std::sin(outer), -16.0f * std::sin(outer), pull
+    };
+    m_params.dt              = dt;
+    m_params.damping         = std::pow(1.0f - m_drag, dt);
+    m_params.particle_count  = PARTICLE_COUNT;
+    m_params.attractor_count = static_cast<Uint32>(m_attractor_count);
+
+    return true;
+}
+
+void scene_t::dispatch(SDL_GPUCommandBuffer *cmd, SDL_GPUComputePass *pass) {
+    Uint32 const groups = (PARTICLE_COUNT + GROUP_SIZE - 1) / GROUP_SIZE;
+
+    if (m_reset) {
+        init_params_t const params = {
+            .particle_count = PARTICLE_COUNT, .seed = m_seed, .orbit_strength = m_strength
+        };
+        SDL_BindGPUComputePipeline(pass, init_pipeline.get());
+        SDL_PushGPUComputeUniformData(cmd, 0, &params, sizeof(params));
+        SDL_DispatchGPUCompute(pass, groups, 1, 1);
+        m_reset = false;
+        return;
+    }
+    if (m_params.dt == 0.0f) return;
+
+    SDL_BindGPUComputePipeline(pass, update_pipeline.get());
+    SDL_PushGPUComputeUniformData(cmd, 0, &m_params, sizeof(m_params));
+    SDL_DispatchGPUCompute(pass, groups, 1, 1);
+}
+
+void scene_t::render(SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
+    glm::mat4 const proj = glm::perspective(glm::radians(camera.fov), m_aspect_ratio, 0.1f, 500.0f);
+
+    SDL_BindGPUGraphicsPipeline(pass, render_pipeline.get());
+    push_vertex_uniform(cmd, 0, proj * camera.view_matrix());
+
+    SDL_GPUBufferBinding binding = {particles.get(), 0};
+    SDL_BindGPUVertexBuffers(pass, 0, &binding, 1);
+    SDL_DrawGPUPrimitives(pass, PARTICLE_COUNT, 1, 0, 0);
+}
+
+int main(int argc, char *argv[]) {
+    auto engine = create_engine(
+        "SDL3 43 - GPU particles", WINDOW_WIDTH, WINDOW_HEIGHT, parse_engine_args(argc, argv)
+    );
+    if (!engine) {
+        std::println(stderr, "{}", engine.error());
+        return 1;
+    }
+
+    auto scene = create_scene(*engine);
+    if (!scene) {
+        std::println(stderr, "{}", scene.error());
+        return 1;
+    }
+
+    // Unused by the passes (points are additive, no depth test) but required by run_loop.
+    auto depth = create_tracked_depth(*engine);
+    if (!depth) {
+        std::println(stderr, "{}", depth.error());
+        return 1;
+    }
+
+    // Not cycled: each step reads the previous frame's particles.
+    std::array<SDL_GPUStorageBufferReadWriteBinding, 1> const storage = {{
+        {.buffer = scene->particles.get(), .cycle = false},
+    }};
+
+    std::array<frame_pass_t, 2> passes = {
+        compute_pass_desc_t{
+            .storage_buffers = storage,
+            .dispatch        = [&](auto cmd, auto pass) { scene->dispatch(cmd, pass); },
+        },
+        pass_desc_t{
+            .prepare = [](auto cmd) { imgui_prepare(cmd); },
+            .draw =
+                [&](auto cmd, auto pass) {
+                    scene->render(cmd, pass);
+                    imgui_render(cmd, pass);
+                },
+        },
+    };
+
+    auto result = run_loop(
+        *engine, [&]() { return BACKGROUND_COLOR; }, *depth, std::span<tracked_color_target_t>{},
+        [&](input_t const &in) { return scene->update(in); }, passes
+    );
+    if (!result) {
+        std::println(stderr, "{}", result.error());
+        return 1;
+    }
+    return 0;
+}
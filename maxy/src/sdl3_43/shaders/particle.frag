@@ -0,0 +1,9 @@
+#version 460 core
+
+layout(location = 0) in vec3 frag_color;
+
+layout(location = 0) out vec4 frag_out;
+
+void main() {
+    frag_out = vec4(frag_color, 1.0);
+}
@@ -0,0 +1,26 @@
+#version 460 core
+
+// One point per particle, read straight from the compute shader's storage buffer.
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec4 velocity;
+
+layout(set = 1, binding = 0) uniform ViewProjection {
+    mat4 view_proj;
+};
+
+layout(location = 0) out vec3 frag_color;
+
+const vec3  SLOW_COLOR = vec3(0.10, 0.25, 1.00);
+const vec3  FAST_COLOR = vec3(1.00, 0.75, 0.45);
+const float MAX_SPEED  = 6.0;
+// Points are blended additively; a million full-intensity points would saturate immediately.
+const float INTENSITY = 0.12;
+
+void main() {
+    gl_Position  = view_proj * vec4(position.xyz, 1.0);
+    gl_PointSize = 1.0; // required for point lists on Vulkan
+
+    float speed = clamp(length(velocity.xyz) / MAX_SPEED, 0.0, 1.0);
+    frag_color  = mix(SLOW_COLOR, FAST_COLOR, speed) * INTENSITY;
+}
@@ -0,0 +1,38 @@
+#include "deferred.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+std::array<gpu_texture_t const *, GBUFFER_SLOT_COUNT> gbuffer_t::attachments() const {
+    std::array<gpu_texture_t const *, GBUFFER_SLOT_COUNT> result;
+    for (size_t i = 0; i < targets.size(); ++i) result[i] = &targets[i].texture;
+    return result;
+}
+
+std::expected<gbuffer_t, std::string> create_gbuffer(engine_t const &engine) {
+    gbuffer_t gbuffer;
+    for (size_t i = 0; i < gbuffer_formats.size(); ++i) {
+        auto target = create_tracked_color_target(engine, gbuffer_formats[i]);
+        if (!target) return std::unexpected(target.error());
+        gbuffer.targets[i] = std::move(*target);
+    }
+    return gbuffer;
+}
+
+void bind_gbuffer(gbuffer_t const &gbuffer, gpu_sampler_t const &sampler, SDL_GPURenderPass *pass) {
+    std::array<SDL_GPUTextureSamplerBinding, GBUFFER_SLOT_COUNT> bindings;
+    for (size_t i = 0; i < bindings.size(); ++i)
+        bindings[i] = {gbuffer.targets[i].texture.get(), sampler.get()};
+    SDL_BindGPUFragmentSamplers(pass, 0, bindings.data(), static_cast<Uint32>(bindings.size()));
+}
+
+float light_volume_radius(pos_light_state_t const &light) {
+    float const brightest = std::max({light.diffuse.r, light.diffuse.g, light.diffuse.b});
+    float const c         = light.constant - brightest * (256.0f / 5.0f);
+    if (light.quadratic <= 0.0f) {
+        // Linear-only falloff (or none): fall back to the linear root, or "infinite".
+        return light.linear > 0.0f ? std::max(-c / light.linear, 0.0f) : 1e6f;
+    }
+    float const disc = light.linear * light.linear - 4.0f * light.quadratic * c;
+    return (-light.linear + std::sqrt(std::max(disc, 0.0f))) / (2.0f * light.quadratic);
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <array>
+#include <expected>
+#include <string>
+
+#include "engine.hpp"
+#include "lights.hpp"
+
+// G-buffer slots written by the geometry pass and sampled by the lighting pass.
+// Slot order is also the fragment sampler binding order (see bind_gbuffer).
+enum gbuffer_slot_t {
+    GBUFFER_ALBEDO_SPEC, // rgb = diffuse albedo, a = specular intensity
+    GBUFFER_NORMAL,      // xyz = world-space normal, w = shininess
+    GBUFFER_DEPTH,       // r = window-space depth (gl_FragCoord.z)
+    GBUFFER_SLOT_COUNT,
+};
+
+// Formats per slot. Normals need more than 8 bits per channel to keep specular highlights
+// smooth; depth is stored as a colour target because the depth-stencil attachment is not
+// sampleable.
+inline constexpr std::array<SDL_GPUTextureFormat, GBUFFER_SLOT_COUNT> gbuffer_formats = {
+    SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
+    SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT,
+    SDL_GPU_TEXTUREFORMAT_R32_FLOAT,
+};
+
+// Window-sized G-buffer. Pass targets to the multi-target run_loop so it follows resizes,
+// and attachments() to pass_desc_t::color_targets for the geometry pass.
+struct gbuffer_t {
+    std::array<tracked_color_target_t, GBUFFER_SLOT_COUNT> targets;
+
+    // Pointers into targets; stable as long as the gbuffer_t itself is not moved.
+    std::array<gpu_texture_t const *, GBUFFER_SLOT_COUNT> attachments() const;
+};
+
+std::expected<gbuffer_t, std::string> create_gbuffer(engine_t const &engine);
+
+// Bind every G-buffer slot to fragment samplers 0..GBUFFER_SLOT_COUNT-1 with one sampler
+// (nearest filtering is appropriate: the lighting pass reads texel-for-pixel).
+void bind_gbuffer(gbuffer_t const &gbuffer, gpu_sampler_t const &sampler, SDL_GPURenderPass *pass);
+
+// Distance at which a positional light's brightest channel drops below 5/256, i.e. the radius
+// of the light volume outside which its contribution is invisible in an 8-bit target.
+// Solves quadratic*d^2 + linear*d + constant = max_channel * 256 / 5 for d.
+float light_volume_radius(pos_light_state_t const &light);
@@ -0,0 +1,87 @@
+#include "dynamic_resolution.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+glm::ivec2 scaled(glm::ivec2 window, float scale) {
+    return glm::max(glm::ivec2(glm::round(glm::vec2(window) * scale)), glm::ivec2(1));
+}
+
+} // namespace
+
+void dynamic_resolution_t::update(float frame_ms) {
+    if (!enabled) {
+        scale = allocation = config.max_scale;
+        m_below            = 0;
+        m_held             = 0;
+        m_probe_wait       = 0;
+        m_probe_from       = 0.0f;
+        return;
+    }
+    if (frame_ms <= 0.0f) return;
+
+    average_ms = average_ms > 0.0f ? std::lerp(average_ms, frame_ms, config.smoothing) : frame_ms;
+    float const load = average_ms / config.budget_ms;
+    if (m_probe_from > 0.0f && load > 1.0f + config.dead_band) {
+        // The last probe cost more than the headroom there was: undo it, and the frame time it
+        // caused with it, and back off.
+        int const wait = m_probe_wait > 0 ? m_probe_wait : config.probe_interval;
+        scale          = m_probe_from;
+        average_ms     = m_probe_average;
+        m_probe_from   = 0.0f;
+        m_probe_wait   = std::min(wait * 2, config.probe_interval * 16);
+        m_held         = 0;
+    } else if (std::abs(load - 1.0f) <= config.dead_band) {
+        ++m_held;
+        // A probe that has stayed in the band for probe_interval frames has held: later overloads
+        // are load changes, not its cost, and the next probe waits the normal interval.
+        if (m_probe_from > 0.0f && m_held >= config.probe_interval) {
+            m_probe_from = 0.0f;
+            m_probe_wait = 0;
+        }
+        int const wait = m_probe_wait > 0 ? m_probe_wait : config.probe_interval;
+        if (m_held >= wait && scale < config.max_scale) {
+            m_probe_from    = scale;
+            m_probe_average = average_ms;
+            scale           = std::min(scale + config.probe_step, config.max_scale);
+            m_held          = 0;
+        }
+    } else {
+        float const wanted = scale * std::sqrt(1.0f / load);
+        scale        = std::clamp(
+            std::lerp(scale, wanted, config.gain), config.min_scale, config.max_scale
+        );
+        m_held       = 0;
+        m_probe_from = 0.0f;
+    }
+
+    float const needed =
+        std::min(std::ceil(scale / config.step - 1e-4f) * config.step, config.max_scale);
+    if (needed > allocation) {
+        allocation = needed;
+        m_below    = 0;
+        ++allocations;
+    } else if (needed < allocation) {
+        if (++m_below >= config.shrink_delay) {
+            allocation = needed;
+            m_below    = 0;
+            ++allocations;
+        }
+    } else {
+        m_below = 0;
+    }
+}
+
+glm::ivec2 dynamic_resolution_t::target_size(glm::ivec2 window) const {
+    return scaled(window, allocation);
+}
+
+glm::ivec2 dynamic_resolution_t::viewport_size(glm::ivec2 window) const {
+    return glm::min(scaled(window, scale), target_size(window));
+}
+
+glm::vec2 dynamic_resolution_t::uv_scale(glm::ivec2 window) const {
+    return glm::vec2(viewport_size(window)) / glm::vec2(target_size(window));
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <glm/glm.hpp>
+
+// Dynamic resolution: picks, frame by frame, the fraction of the window the 3D scene is rendered
+// at so that the frame time holds a budget, for a final pass to scale back up to the window.
+//
+// Fragment cost goes with the pixel count, the square of the scale, so each frame moves the scale
+// part of the way towards scale * sqrt(budget / frame time). Render targets are only reallocated
+// in whole steps of the scale: between steps the scene is drawn into the top-left viewport of the
+// current target and the final pass samples that sub-rectangle. A target grows as soon as the
+// scale outgrows it and shrinks only after the scale has stayed a step below it for a while, so a
+// scale hovering at a step boundary does not reallocate every frame.
+//
+// The frame time is measured on the CPU, between frames. That is the GPU time only while the GPU
+// is the bottleneck and nothing else paces the loop: with vsync the interval is quantised to the
+// refresh period, so a frame that fits shows up as exactly the budget and says nothing about the
+// headroom left. Within dead_band of the budget the scale is therefore held rather than corrected,
+// and every probe_interval frames it is nudged up by probe_step. A probe that pushes the average
+// out of the band (under vsync, a missed refresh) within probe_interval frames is undone and the
+// next one waits twice as long, so the scale climbs back after a spike without oscillating around
+// a refresh boundary; once a probe has held that long, an overload is corrected as usual. SDL_GPU
+// has no timestamp queries.
+
+struct dynamic_resolution_config_t {
+    float budget_ms      = 16.6f;
+    float min_scale      = 0.5f;
+    float max_scale      = 1.0f;
+    float step           = 0.125f; // allocation granularity
+    float gain           = 0.15f;  // fraction of the correction applied per frame
+    float smoothing      = 0.2f;   // weight of the newest frame time in the average
+    int   shrink_delay   = 60;     // frames a target is kept after the scale drops a step below
+    float dead_band      = 0.1f;   // no correction while the average is this close to the budget
+    int   probe_interval = 30;     // frames held in the dead band before probing upwards
+    float probe_step     = 0.05f;  // scale added by a probe
+};
+
+struct dynamic_resolution_t {
+    dynamic_resolution_config_t config;
+    bool                        enabled = true; // off: scale and allocation stay at max_scale
+
+    float scale       = 1.0f; // of the window, per side; sizes the viewport
+    float allocation  = 1.0f; // a whole number of steps, >= scale; sizes the targets
+    float average_ms  = 0.0f; // smoothed frame time the controller acts on
+    int   allocations = 0;    // times the allocation changed
+
+    // Feeds one frame time, in milliseconds, and updates scale and allocation.
+    void update(float frame_ms);
+
+    glm::ivec2 target_size(glm::ivec2 window) const;   // allocation * window
+    glm::ivec2 viewport_size(glm::ivec2 window) const; // scale * window, within target_size
+    // viewport_size / target_size: the part of the target the final pass samples.
+    glm::vec2 uv_scale(glm::ivec2 window) const;
+
+private:
+    int   m_below         = 0;    // consecutive frames the scale has needed a smaller allocation
+    int   m_held          = 0;    // consecutive frames in the dead band since the last probe
+    int   m_probe_wait    = 0;    // frames before the next probe; 0: config.probe_interval
+    float m_probe_from    = 0.0f; // scale before the last probe, until it has held (settled)
+    float m_probe_average = 0.0f; // and average_ms
+};
@@ -1,10 +1,20 @@
 #include "engine.hpp"
 #include "geometry.hpp"
+#include "render_graph.hpp"
+
+#include "common/frame_pacing.hpp"
 
 #include <algorithm>
+#include <array>
+#include <charconv>
 #include <cmath>
+#include <condition_variable>
 #include <format>
 #include <fstream>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -12,6 +22,7 @@
 #include <backends/imgui_impl_sdlgpu3.h>
 
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/packing.hpp>
 
 #include <SDL3_image/SDL_image.h>
 
@@ -21,22 +32,27 @@ std::unexpected<std::string> sdl_error(std::string prefix) {
 
 namespace {
 
+using transfer_t = gpu_resource_t<SDL_GPUTransferBuffer, SDL_ReleaseGPUTransferBuffer>;
+
 std::expected<gpu_buffer_t, std::string> create_buffer(
-    engine_t const &engine, SDL_GPUBufferUsageFlags usage, void const *data, Uint32 size
+    engine_t const &engine, SDL_GPUBufferUsageFlags usage, void const *data, Uint32 size,
+    std::source_location const &site
 ) {
-    using transfer_t = gpu_resource_t<SDL_GPUTransferBuffer, SDL_ReleaseGPUTransferBuffer>;
-
     SDL_GPUBufferCreateInfo buffer_info = {};
     buffer_info.usage                   = usage;
     buffer_info.size                    = size;
-    gpu_buffer_t buffer{engine.gpu_device, SDL_CreateGPUBuffer(engine.gpu_device, &buffer_info)};
+    gpu_buffer_t buffer{
+        engine.gpu_device, SDL_CreateGPUBuffer(engine.gpu_device, &buffer_info), size, site
+    };
     if (!buffer) return sdl_error("SDL_CreateGPUBuffer failed");
+    if (!data) return buffer;
 
     SDL_GPUTransferBufferCreateInfo transfer_info = {};
     transfer_info.usage                           = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
     transfer_info.size                            = size;
     transfer_t transfer{
-        engine.gpu_device, SDL_CreateGPUTransferBuffer(engine.gpu_device, &transfer_info)
+        engine.gpu_device, SDL_CreateGPUTransferBuffer(engine.gpu_device, &transfer_info),
+        transfer_info.size, site
     };
     if (!transfer) return sdl_error("SDL_CreateGPUTransferBuffer failed");
 
@@ -74,6 +90,14 @@ void imgui_new_frame() {
     ImGui::NewFrame();
 }
 
+char const *present_mode_name(SDL_GPUPresentMode mode) {
+    switch (mode) {
+    case SDL_GPU_PRESENTMODE_MAILBOX: return "mailbox";
+    case SDL_GPU_PRESENTMODE_IMMEDIATE: return "immediate";
+    default: return "vsync";
+    }
+}
+
 } // namespace
 
 void imgui_prepare(SDL_GPUCommandBuffer *cmd) {
@@ -90,6 +114,7 @@ engine_t::engine_t(engine_t &&other) noexcept
     : window(std::exchange(other.window, nullptr)),
       gpu_device(std::exchange(other.gpu_device, nullptr)),
       sdl_initialized(std::exchange(other.sdl_initialized, false)), verbose(other.verbose),
+      pipelined(other.pipelined), pacing(other.pacing), present(other.present),
       last_tick(other.last_tick) {}
 
 engine_t &engine_t::operator=(engine_t &&other) noexcept {
@@ -99,6 +124,9 @@ engine_t &engine_t::operator=(engine_t &&other) noexcept {
         gpu_device      = std::exchange(other.gpu_device, nullptr);
         sdl_initialized = std::exchange(other.sdl_initialized, false);
         verbose         = other.verbose;
+        pipelined       = other.pipelined;
+        pacing          = other.pacing;
+        present         = other.present;
         last_tick       = other.last_tick;
     }
     return *this;
@@ -112,6 +140,11 @@ engine_t::~engine_t() {
         ImGui::DestroyContext();
     }
     if (gpu_device && window) SDL_ReleaseWindowFromGPUDevice(gpu_device, window);
+    // Scenes are declared after the engine, so anything still live here outlives the device.
+    if (gpu_device && gpu_resource_tracking()) {
+        if (auto const leaks = gpu_resource_leaks(); !leaks.empty())
+            SDL_Log("GPU resources leaked past the device:\n%s", leaks.c_str());
+    }
     if (gpu_device) SDL_DestroyGPUDevice(gpu_device);
     if (window) SDL_DestroyWindow(window);
     if (sdl_initialized) SDL_Quit();
@@ -119,8 +152,31 @@ engine_t::~engine_t() {
 
 engine_config_t parse_engine_args(int argc, char *argv[]) {
     engine_config_t config;
+    auto const value = [](std::string_view arg, std::string_view prefix, double &out) {
+        if (!arg.starts_with(prefix)) return false;
+        arg.remove_prefix(prefix.size());
+        std::from_chars(arg.data(), arg.data() + arg.size(), out);
+        return true;
+    };
     for (int i = 1; i < argc; ++i) {
-        if (std::string_view(argv[i]) == "--verbose") config.verbose = true;
+        std::string_view const arg(argv[i]);
+        double frames = 0.0;
+        if (arg == "--verbose") config.verbose = true;
+        else if (arg == "--headless") config.headless = true;
+        else if (arg == "--frame-report") config.pacing.report = true;
+        else if (arg == "--track-resources") config.track_resources = true;
+        else if (arg == "--no-pipeline") config.pipelined = false;
+        else if (arg == "--late-latch") config.present.late_latch = true;
+        else if (arg == "--latency-probe") config.present.latency_probe = true;
+        else if (arg == "--present=vsync") config.present.present_mode = SDL_GPU_PRESENTMODE_VSYNC;
+        else if (arg == "--present=mailbox")
+            config.present.present_mode = SDL_GPU_PRESENTMODE_MAILBOX;
+        else if (arg == "--present=immediate")
+            config.present.present_mode = SDL_GPU_PRESENTMODE_IMMEDIATE;
+        else if (value(arg, "--frames-in-flight=", frames))
+            config.present.frames_in_flight = static_cast<Uint32>(frames);
+        else if (!value(arg, "--sim-hz=", config.pacing.simulation_hz))
+            value(arg, "--fps=", config.pacing.target_fps);
     }
     return config;
 }
@@ -128,21 +184,43 @@ engine_config_t parse_engine_args(int argc, char *argv[]) {
 std::expected<engine_t, std::string>
 create_engine(std::string_view title, int width, int height, engine_config_t const &config) {
     engine_t engine;
-    engine.verbose = config.verbose;
+    engine.verbose   = config.verbose;
+    engine.pipelined = config.pipelined;
+    engine.pacing    = config.pacing;
+    enable_gpu_resource_tracking(config.track_resources);
 
+    // The offscreen video driver still loads Vulkan, without needing a display server.
+    if (config.headless) SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
     if (!SDL_Init(SDL_INIT_VIDEO)) return sdl_error("SDL_Init failed");
     engine.sdl_initialized = true;
 
-    engine.window = SDL_CreateWindow(title.data(), width, height, SDL_WINDOW_RESIZABLE);
-    if (!engine.window) return sdl_error("SDL_CreateWindow failed");
-
     engine.gpu_device = SDL_CreateGPUDevice(SDL_GPU_SHADERFORMAT_SPIRV, true, nullptr);
     if (!engine.gpu_device) return sdl_error("SDL_CreateGPUDevice failed");
+    if (engine.verbose) SDL_Log("GPU driver: %s", SDL_GetGPUDeviceDriver(engine.gpu_device));
+    if (config.headless) return engine;
+
+    engine.window = SDL_CreateWindow(title.data(), width, height, SDL_WINDOW_RESIZABLE);
+    if (!engine.window) return sdl_error("SDL_CreateWindow failed");
 
     if (!SDL_ClaimWindowForGPUDevice(engine.gpu_device, engine.window))
         return sdl_error("SDL_ClaimWindowForGPUDevice failed");
 
-    if (engine.verbose) SDL_Log("GPU driver: %s", SDL_GetGPUDeviceDriver(engine.gpu_device));
+    engine.present = config.present;
+    if (!SDL_WindowSupportsGPUPresentMode(
+            engine.gpu_device, engine.window, engine.present.present_mode
+        )) {
+        auto const *mode = present_mode_name(engine.present.present_mode);
+        SDL_Log("Present mode %s unsupported, using vsync", mode);
+        engine.present.present_mode = SDL_GPU_PRESENTMODE_VSYNC;
+    }
+    if (!SDL_SetGPUSwapchainParameters(
+            engine.gpu_device, engine.window, SDL_GPU_SWAPCHAINCOMPOSITION_SDR,
+            engine.present.present_mode
+        ))
+        return sdl_error("SDL_SetGPUSwapchainParameters failed");
+    engine.present.frames_in_flight = std::clamp(engine.present.frames_in_flight, 1u, 3u);
+    if (!SDL_SetGPUAllowedFramesInFlight(engine.gpu_device, engine.present.frames_in_flight))
+        return sdl_error("SDL_SetGPUAllowedFramesInFlight failed");
     return engine;
 }
 
@@ -178,11 +256,24 @@ bool poll_events() {
 
 namespace {
 
-bool pump_events(engine_t &engine, bool &focused, float &scroll_delta) {
+// input_time is lowered to the timestamp of the oldest input event seen, for the latency probe.
+bool pump_events(engine_t &engine, bool &focused, float &scroll_delta, Uint64 &input_time) {
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
         if (ImGui::GetCurrentContext()) imgui_process_event(event);
         if (event.type == SDL_EVENT_QUIT) return false;
+        switch (event.type) {
+        case SDL_EVENT_KEY_DOWN:
+        case SDL_EVENT_KEY_UP:
+        case SDL_EVENT_MOUSE_MOTION:
+        case SDL_EVENT_MOUSE_BUTTON_DOWN:
+        case SDL_EVENT_MOUSE_BUTTON_UP:
+        case SDL_EVENT_MOUSE_WHEEL:
+            if (input_time == 0 || event.common.timestamp < input_time)
+                input_time = event.common.timestamp;
+            break;
+        default: break;
+        }
         if (event.type == SDL_EVENT_MOUSE_WHEEL) scroll_delta += event.wheel.y;
         if (event.type == SDL_EVENT_WINDOW_FOCUS_LOST) {
             focused = false;
@@ -208,26 +299,155 @@ input_t collect_input(engine_t &engine, bool focused, float scroll_delta, float
         .scroll       = scroll_delta,
         .dt           = dt,
         .aspect_ratio = aspect_ratio(engine),
+        .steps        = 1,
+        .step         = dt,
+        .alpha        = 1.0f,
     };
 }
 
-} // namespace
+double seconds_now() { return static_cast<double>(SDL_GetTicksNS()) / 1e9; }
 
-std::expected<void, std::string>
-render_frame(engine_t const &engine, SDL_FColor clear_color, draw_fn draw) {
-    pass_desc_t pass{.clear_color = clear_color, .draw = std::move(draw)};
-    return render_frame(engine, std::span{&pass, 1});
-}
+// Loop-side state behind frame_pacing_t and the latency probe. The fixed step, the limiter and
+// the percentiles are the GL event_loop's (common/frame_pacing.hpp), driven by SDL's clock.
+class frame_scheduler_t {
+public:
+    frame_scheduler_t(frame_pacing_t pacing, present_config_t present)
+        : m_pacing(pacing), m_present(present) {
+        if (pacing.simulation_hz > 0.0) m_timestep.step = 1.0 / pacing.simulation_hz;
+        m_limiter.target_fps = pacing.target_fps;
+    }
 
-std::expected<void, std::string> render_frame(
-    engine_t const &engine, SDL_FColor clear_color, gpu_texture_t const &depth, draw_fn draw
+    // Records the frame time and, at a fixed rate, turns it into whole steps and an alpha.
+    void schedule(input_t &in) {
+        if (in.dt > 0.0f) m_frame_ms.add(in.dt);
+        if (m_pacing.simulation_hz <= 0.0) return;
+
+        in.steps = m_timestep.advance(in.dt);
+        in.step  = static_cast<float>(m_timestep.step);
+        in.alpha = m_timestep.alpha();
+    }
+
+    // Call once the frame is submitted, with the timestamp of the oldest input event it consumed
+    // (0 for none): records the latency, waits out the limiter and reports when due.
+    void finish_frame(Uint64 input_time) {
+        end_gpu_resource_frame();
+        Uint64 const now = SDL_GetTicksNS();
+        if (m_present.latency_probe && input_time != 0 && input_time <= now)
+            m_input_to_submit_ms.add(static_cast<double>(now - input_time) / 1e9);
+        m_limiter.wait(seconds_now);
+        if (!m_pacing.report) return;
+        double const seconds = seconds_now();
+        if (m_next_report == 0.0) m_next_report = seconds + REPORT_PERIOD;
+        if (seconds < m_next_report) return;
+        report();
+        m_next_report += REPORT_PERIOD;
+    }
+
+    void report() const {
+        if (gpu_resource_tracking()) SDL_Log("%s", gpu_resource_report().c_str());
+        if (!m_pacing.report || m_frame_ms.samples.empty()) return;
+        SDL_Log(
+            "%s",
+            frame_report(m_frame_ms, m_pacing.simulation_hz, m_pacing.target_fps).c_str()
+        );
+        if (m_input_to_submit_ms.samples.empty()) return;
+        // Presentation follows submit by up to frames_in_flight frames plus scanout, which the
+        // CPU cannot observe; this is the part of input-to-photon the engine controls.
+        SDL_Log(
+            "input to submit p50 %.2f ms, p99 %.2f ms over %zu frames (%u in flight, %s, %s)",
+            m_input_to_submit_ms.percentile(50.0f), m_input_to_submit_ms.percentile(99.0f),
+            m_input_to_submit_ms.samples.size(), m_present.frames_in_flight,
+            present_mode_name(m_present.present_mode),
+            m_present.late_latch ? "late latched" : "input before swapchain wait"
+        );
+    }
+
+private:
+    static constexpr double REPORT_PERIOD = 5.0; // seconds
+
+    frame_pacing_t   m_pacing;
+    present_config_t m_present;
+    fixed_timestep_t m_timestep{};
+    frame_limiter_t  m_limiter{};
+    double           m_next_report = 0.0;
+    frame_stats_t    m_frame_ms{};
+    frame_stats_t    m_input_to_submit_ms{};
+};
+
+// Shared body of every run_loop overload; Pass is pass_desc_t or frame_pass_t.
+template <typename Pass>
+std::expected<void, std::string> run_pass_loop(
+    engine_t &engine, std::function<SDL_FColor()> const &get_clear_color, tracked_depth_t &depth,
+    std::span<tracked_color_target_t> color_targets,
+    std::function<bool(input_t const &)> const &update, std::span<Pass> passes
+);
+
+void encode_render_pass(
+    SDL_GPUCommandBuffer *cmd, SDL_GPUTexture *swapchain, pass_desc_t const &pass
 ) {
-    pass_desc_t pass{.depth_texture = &depth, .clear_color = clear_color, .draw = std::move(draw)};
-    return render_frame(engine, std::span{&pass, 1});
+    if (!pass.enabled) return;
+
+    std::array<SDL_GPUColorTargetInfo, MAX_COLOR_TARGETS> color_infos = {};
+    Uint32                                                num_colors  = 0;
+
+    auto const add_color = [&](SDL_GPUTexture *texture) {
+        if (num_colors == MAX_COLOR_TARGETS) return;
+        auto &info       = color_infos[num_colors++];
+        info.texture     = texture;
+        info.clear_color = pass.clear_color;
+        info.load_op     = pass.load_op;
+        info.store_op    = SDL_GPU_STOREOP_STORE;
+    };
+    if (pass.color_targets.empty())
+        add_color(pass.color_target ? pass.color_target->get() : swapchain);
+    else
+        for (auto const *target : pass.color_targets) add_color(target->get());
+
+    SDL_GPUDepthStencilTargetInfo  depth_info = {};
+    SDL_GPUDepthStencilTargetInfo *depth_ptr  = nullptr;
+    if (pass.depth_texture) {
+        // Cycling discards the previous contents, so only cycle when they are not loaded.
+        bool const load             = pass.depth_load_op == SDL_GPU_LOADOP_LOAD;
+        depth_info.texture          = pass.depth_texture->get();
+        depth_info.clear_depth      = 1.0f;
+        depth_info.load_op          = pass.depth_load_op;
+        depth_info.store_op         = pass.depth_store_op;
+        depth_info.clear_stencil    = 0;
+        depth_info.stencil_load_op  = pass.depth_load_op;
+        depth_info.stencil_store_op = pass.depth_store_op;
+        depth_info.cycle            = !load;
+        depth_ptr                   = &depth_info;
+    }
+
+    if (pass.prepare) pass.prepare(cmd);
+
+    SDL_GPURenderPass *render_pass =
+        SDL_BeginGPURenderPass(cmd, color_infos.data(), num_colors, depth_ptr);
+    if (pass.draw) pass.draw(cmd, render_pass);
+    SDL_EndGPURenderPass(render_pass);
 }
 
-std::expected<void, std::string>
-render_frame(engine_t const &engine, std::span<pass_desc_t const> passes) {
+void encode_compute_pass(SDL_GPUCommandBuffer *cmd, compute_pass_desc_t const &pass) {
+    if (pass.prepare) pass.prepare(cmd);
+
+    SDL_GPUComputePass *compute_pass = SDL_BeginGPUComputePass(
+        cmd, pass.storage_textures.data(), static_cast<Uint32>(pass.storage_textures.size()),
+        pass.storage_buffers.data(), static_cast<Uint32>(pass.storage_buffers.size())
+    );
+    if (pass.dispatch) pass.dispatch(cmd, compute_pass);
+    SDL_EndGPUComputePass(compute_pass);
+}
+
+// A command buffer with the swapchain texture it will present; swapchain is null while the
+// window is minimised.
+struct frame_target_t {
+    SDL_GPUCommandBuffer *cmd;
+    SDL_GPUTexture       *swapchain;
+};
+
+// Acquires a command buffer and waits for the swapchain. This is where the CPU blocks once the
+// GPU is frames_in_flight frames behind.
+std::expected<frame_target_t, std::string> acquire_frame(engine_t const &engine) {
     SDL_GPUCommandBuffer *cmd = SDL_AcquireGPUCommandBuffer(engine.gpu_device);
     if (!cmd) return sdl_error("SDL_AcquireGPUCommandBuffer failed");
 
@@ -236,39 +456,72 @@ render_frame(engine_t const &engine, std::span<pass_desc_t const> passes) {
         SDL_CancelGPUCommandBuffer(cmd);
         return sdl_error("SDL_WaitAndAcquireGPUSwapchainTexture failed");
     }
+    return frame_target_t{cmd, swapchain};
+}
 
-    if (swapchain) {
-        for (auto const &pass : passes) {
-            SDL_GPUColorTargetInfo color_info = {};
-            color_info.texture     = pass.color_target ? pass.color_target->get() : swapchain;
-            color_info.clear_color = pass.clear_color;
-            color_info.load_op     = pass.load_op;
-            color_info.store_op    = SDL_GPU_STOREOP_STORE;
-
-            SDL_GPUDepthStencilTargetInfo  depth_info = {};
-            SDL_GPUDepthStencilTargetInfo *depth_ptr  = nullptr;
-            if (pass.depth_texture) {
-                depth_info.texture          = pass.depth_texture->get();
-                depth_info.clear_depth      = 1.0f;
-                depth_info.load_op          = SDL_GPU_LOADOP_CLEAR;
-                depth_info.store_op         = SDL_GPU_STOREOP_DONT_CARE;
-                depth_info.clear_stencil    = 0;
-                depth_info.stencil_load_op  = SDL_GPU_LOADOP_CLEAR;
-                depth_info.stencil_store_op = SDL_GPU_STOREOP_DONT_CARE;
-                depth_info.cycle            = true;
-                depth_ptr                   = &depth_info;
-            }
+// Lets encode record the frame and submits; encode is skipped while minimised.
+std::expected<void, std::string> submit_frame(
+    frame_target_t frame, std::function<void(SDL_GPUCommandBuffer *, SDL_GPUTexture *)> encode
+) {
+    if (frame.swapchain && encode) encode(frame.cmd, frame.swapchain);
 
-            if (pass.prepare) pass.prepare(cmd);
+    if (!SDL_SubmitGPUCommandBuffer(frame.cmd))
+        return sdl_error("SDL_SubmitGPUCommandBuffer failed");
+    return {};
+}
 
-            SDL_GPURenderPass *render_pass = SDL_BeginGPURenderPass(cmd, &color_info, 1, depth_ptr);
-            if (pass.draw) pass.draw(cmd, render_pass);
-            SDL_EndGPURenderPass(render_pass);
-        }
+std::expected<void, std::string> submit_frame(
+    engine_t const &engine, std::function<void(SDL_GPUCommandBuffer *, SDL_GPUTexture *)> encode
+) {
+    auto frame = acquire_frame(engine);
+    if (!frame) return std::unexpected(frame.error());
+    return submit_frame(*frame, std::move(encode));
+}
+
+void encode_passes(
+    SDL_GPUCommandBuffer *cmd, SDL_GPUTexture *swapchain, std::span<pass_desc_t const> passes
+) {
+    for (auto const &pass : passes) encode_render_pass(cmd, swapchain, pass);
+}
+
+void encode_passes(
+    SDL_GPUCommandBuffer *cmd, SDL_GPUTexture *swapchain, std::span<frame_pass_t const> passes
+) {
+    for (auto const &step : passes) {
+        if (auto const *pass = std::get_if<pass_desc_t>(&step))
+            encode_render_pass(cmd, swapchain, *pass);
+        else
+            encode_compute_pass(cmd, std::get<compute_pass_desc_t>(step));
     }
+}
 
-    if (!SDL_SubmitGPUCommandBuffer(cmd)) return sdl_error("SDL_SubmitGPUCommandBuffer failed");
-    return {};
+} // namespace
+
+std::expected<void, std::string>
+render_frame(engine_t const &engine, SDL_FColor clear_color, draw_fn draw) {
+    pass_desc_t pass{.clear_color = clear_color, .draw = std::move(draw)};
+    return render_frame(engine, std::span{&pass, 1});
+}
+
+std::expected<void, std::string> render_frame(
+    engine_t const &engine, SDL_FColor clear_color, gpu_texture_t const &depth, draw_fn draw
+) {
+    pass_desc_t pass{.depth_texture = &depth, .clear_color = clear_color, .draw = std::move(draw)};
+    return render_frame(engine, std::span{&pass, 1});
+}
+
+std::expected<void, std::string>
+render_frame(engine_t const &engine, std::span<pass_desc_t const> passes) {
+    return submit_frame(engine, [&](SDL_GPUCommandBuffer *cmd, SDL_GPUTexture *swapchain) {
+        encode_passes(cmd, swapchain, passes);
+    });
+}
+
+std::expected<void, std::string>
+render_frame(engine_t const &engine, std::span<frame_pass_t const> passes) {
+    return submit_frame(engine, [&](SDL_GPUCommandBuffer *cmd, SDL_GPUTexture *swapchain) {
+        encode_passes(cmd, swapchain, passes);
+    });
 }
 
 std::expected<void, std::string> run_loop(engine_t &engine, SDL_FColor clear_color, draw_fn draw) {
@@ -299,31 +552,14 @@ std::expected<void, std::string> run_loop(
         },
     };
 
-    SDL_SetWindowRelativeMouseMode(engine.window, true);
-    bool focused = true;
-
-    while (true) {
-        float scroll_delta = 0.0f;
-        if (!pump_events(engine, focused, scroll_delta)) break;
-
-        float dt = tick(engine);
-        depth.update(engine);
-
-        if (ImGui::GetCurrentContext()) imgui_new_frame();
-        bool const should_continue = update(collect_input(engine, focused, scroll_delta, dt));
-        if (ImGui::GetCurrentContext()) ImGui::Render();
-        if (!should_continue) break;
-
-        frame_pass.clear_color = get_clear_color();
-        if (auto f = render_frame(engine, std::span{&frame_pass, 1}); !f)
-            return std::unexpected(f.error());
-    }
-    return {};
+    return run_pass_loop(
+        engine, get_clear_color, depth, {}, update, std::span<pass_desc_t>(&frame_pass, 1)
+    );
 }
 
 float tick(engine_t &engine) {
-    Uint64 now       = SDL_GetTicks();
-    float  dt        = engine.last_tick == 0 ? 0.0f : (now - engine.last_tick) / 1000.0f;
+    Uint64 now = SDL_GetTicksNS();
+    float  dt  = engine.last_tick == 0 ? 0.0f : static_cast<float>(now - engine.last_tick) / 1e9f;
     engine.last_tick = now;
     return dt;
 }
@@ -339,10 +575,9 @@ float aspect_ratio(engine_t const &engine) {
     return float(size.x) / float(size.y);
 }
 
-std::expected<gpu_shader_t, std::string> load_shader(
-    engine_t const &engine, std::string_view spv_path, SDL_GPUShaderStage stage,
-    Uint32 num_uniform_buffers, Uint32 num_samplers
-) {
+namespace {
+
+std::expected<std::vector<Uint8>, std::string> read_spirv(std::string_view spv_path) {
     std::ifstream file(spv_path.data(), std::ios::binary | std::ios::ate);
     if (!file) return std::unexpected(std::format("Cannot open shader: {}", spv_path));
 
@@ -351,10 +586,153 @@ std::expected<gpu_shader_t, std::string> load_shader(
     std::vector<Uint8> code(size);
     file.read(reinterpret_cast<char *>(code.data()), size);
     if (!file) return std::unexpected(std::format("Failed to read shader: {}", spv_path));
+    return code;
+}
+
+// Derives the resource counts of a compute shader from its SPIR-V, following SDL's compute set
+// layout (see compute_pipeline_desc_t), and the thread counts from its LocalSize mode. Only the
+// handful of instructions that declare resources are decoded; everything else is skipped. An
+// array of resources counts as one binding per element, as SDL expects.
+std::expected<compute_pipeline_desc_t, std::string>
+reflect_compute_shader(std::span<Uint8 const> code, std::string_view spv_path) {
+    constexpr Uint32 SPIRV_MAGIC               = 0x07230203;
+    constexpr Uint32 OP_EXECUTION_MODE         = 16;
+    constexpr Uint32 OP_TYPE_IMAGE             = 25;
+    constexpr Uint32 OP_TYPE_SAMPLER           = 26;
+    constexpr Uint32 OP_TYPE_SAMPLED_IMAGE     = 27;
+    constexpr Uint32 OP_TYPE_ARRAY             = 28;
+    constexpr Uint32 OP_TYPE_RUNTIME_ARRAY     = 29;
+    constexpr Uint32 OP_TYPE_POINTER           = 32;
+    constexpr Uint32 OP_CONSTANT               = 43;
+    constexpr Uint32 OP_VARIABLE               = 59;
+    constexpr Uint32 OP_DECORATE               = 71;
+    constexpr Uint32 MODE_LOCAL_SIZE           = 17;
+    constexpr Uint32 DECORATION_DESCRIPTOR_SET = 34;
+
+    if (code.size() < 20 || code.size() % 4 != 0)
+        return std::unexpected(std::format("Not a SPIR-V module: {}", spv_path));
+    std::vector<Uint32> words(code.size() / 4);
+    SDL_memcpy(words.data(), code.data(), code.size());
+    if (words[0] != SPIRV_MAGIC)
+        return std::unexpected(std::format("Not a SPIR-V module: {}", spv_path));
+
+    enum class kind_t { buffer, sampler, storage_image };
+    std::unordered_map<Uint32, kind_t>     kinds;     // type id -> kind (buffer if absent)
+    std::unordered_map<Uint32, Uint32>     pointees;  // pointer type id -> pointee type id
+    std::unordered_map<Uint32, Uint32>     constants; // constant id -> low 32 bits of its value
+    std::unordered_map<Uint32, Uint32>     lengths;   // array type id -> elements, 0 if runtime
+    std::unordered_map<Uint32, Uint32>     sets;      // variable id -> descriptor set
+    std::vector<std::pair<Uint32, Uint32>> variables; // (variable id, pointer type id)
+
+    compute_pipeline_desc_t desc       = {.shader = spv_path};
+    bool                    local_size = false;
+
+    for (size_t i = 5; i < words.size();) {
+        Uint32 const count  = words[i] >> 16;
+        Uint32 const opcode = words[i] & 0xFFFF;
+        if (count == 0 || i + count > words.size())
+            return std::unexpected(std::format("Malformed SPIR-V: {}", spv_path));
+        auto const op = std::span{words}.subspan(i, count);
+
+        switch (opcode) {
+        case OP_EXECUTION_MODE:
+            if (count >= 6 && op[2] == MODE_LOCAL_SIZE) {
+                desc.threadcount_x = op[3];
+                desc.threadcount_y = op[4];
+                desc.threadcount_z = op[5];
+                local_size         = true;
+            }
+            break;
+        case OP_TYPE_IMAGE:
+            // Sampled operand 2 = storage image; 1 = used with a sampler.
+            if (count >= 9) kinds[op[1]] = op[7] == 2 ? kind_t::storage_image : kind_t::sampler;
+            break;
+        case OP_TYPE_SAMPLER:
+        case OP_TYPE_SAMPLED_IMAGE:
+            kinds[op[1]] = kind_t::sampler;
+            break;
+        case OP_TYPE_ARRAY:
+        case OP_TYPE_RUNTIME_ARRAY: {
+            if (auto it = kinds.find(op[2]); it != kinds.end()) kinds[op[1]] = it->second;
+            // Arrays of arrays multiply out; the length operand is an OpConstant declared first.
+            auto const   inner   = lengths.find(op[2]);
+            Uint32 const element = inner == lengths.end() ? 1 : inner->second;
+            lengths[op[1]] = opcode == OP_TYPE_ARRAY && count >= 4 ? element * constants[op[3]] : 0;
+            break;
+        }
+        case OP_CONSTANT:
+            if (count >= 4) constants[op[2]] = op[3];
+            break;
+        case OP_TYPE_POINTER:
+            pointees[op[1]] = op[3];
+            break;
+        case OP_VARIABLE:
+            variables.emplace_back(op[2], op[1]);
+            break;
+        case OP_DECORATE:
+            if (count >= 4 && op[2] == DECORATION_DESCRIPTOR_SET) sets[op[1]] = op[3];
+            break;
+        }
+        i += count;
+    }
+
+    if (!local_size)
+        return std::unexpected(std::format("{}: local_size must be a literal", spv_path));
+
+    for (auto const &[id, pointer] : variables) {
+        auto const set = sets.find(id);
+        if (set == sets.end()) continue; // not a resource (e.g. gl_GlobalInvocationID)
+
+        Uint32 const type    = pointees[pointer];
+        auto const   kind_it = kinds.find(type);
+        kind_t const kind    = kind_it == kinds.end() ? kind_t::buffer : kind_it->second;
+        Uint32       n       = 1;
+        if (auto const length = lengths.find(type); length != lengths.end()) {
+            if (length->second == 0)
+                return std::unexpected(
+                    std::format("{}: resource arrays need a constant size", spv_path)
+                );
+            n = length->second;
+        }
+        switch (set->second) {
+        case 0:
+            if (kind == kind_t::sampler)
+                desc.samplers += n;
+            else if (kind == kind_t::storage_image)
+                desc.readonly_storage_textures += n;
+            else
+                desc.readonly_storage_buffers += n;
+            break;
+        case 1:
+            if (kind == kind_t::storage_image)
+                desc.readwrite_storage_textures += n;
+            else
+                desc.readwrite_storage_buffers += n;
+            break;
+        case 2:
+            desc.uniform_buffers += n;
+            break;
+        default:
+            return std::unexpected(
+                std::format("{}: descriptor set {} is not used by SDL GPU", spv_path, set->second)
+            );
+        }
+    }
+    return desc;
+}
+
+} // namespace
+
+std::expected<gpu_shader_t, std::string> load_shader(
+    engine_t const &engine, std::string_view spv_path, SDL_GPUShaderStage stage,
+    Uint32 num_uniform_buffers, Uint32 num_samplers, std::source_location const &site
+) {
+    auto code = read_spirv(spv_path);
+    if (!code) return std::unexpected(code.error());
 
     SDL_GPUShaderCreateInfo info = {};
-    info.code_size               = code.size();
-    info.code                    = code.data();
+    info.code_size               = code->size();
+    info.code                    = code->data();
     info.entrypoint              = "main";
     info.format                  = SDL_GPU_SHADERFORMAT_SPIRV;
     info.stage                   = stage;
@@ -363,29 +741,153 @@ std::expected<gpu_shader_t, std::string> load_shader(
 
     SDL_GPUShader *shader = SDL_CreateGPUShader(engine.gpu_device, &info);
     if (!shader) return sdl_error("SDL_CreateGPUShader failed");
-    return gpu_shader_t{engine.gpu_device, shader};
+    return gpu_shader_t{engine.gpu_device, shader, 0, site};
+}
+
+std::expected<gpu_buffer_t, std::string> create_vertex_buffer(
+    engine_t const &engine, void const *data, Uint32 size, std::source_location const &site
+) {
+    return create_buffer(engine, SDL_GPU_BUFFERUSAGE_VERTEX, data, size, site);
 }
 
-std::expected<gpu_buffer_t, std::string>
-create_vertex_buffer(engine_t const &engine, void const *data, Uint32 size) {
-    return create_buffer(engine, SDL_GPU_BUFFERUSAGE_VERTEX, data, size);
+std::expected<gpu_buffer_t, std::string> create_index_buffer(
+    engine_t const &engine, void const *data, Uint32 size, std::source_location const &site
+) {
+    return create_buffer(engine, SDL_GPU_BUFFERUSAGE_INDEX, data, size, site);
+}
+
+std::expected<gpu_buffer_t, std::string> create_gpu_buffer(
+    engine_t const &engine, SDL_GPUBufferUsageFlags usage, Uint32 size, void const *data,
+    std::source_location const &site
+) {
+    return create_buffer(engine, usage, data, size, site);
 }
 
-std::expected<gpu_buffer_t, std::string>
-create_index_buffer(engine_t const &engine, void const *data, Uint32 size) {
-    return create_buffer(engine, SDL_GPU_BUFFERUSAGE_INDEX, data, size);
+std::expected<gpu_buffer_t, std::string> create_storage_buffer(
+    engine_t const &engine, Uint32 size, void const *data, SDL_GPUBufferUsageFlags extra_usage,
+    std::source_location const &site
+) {
+    SDL_GPUBufferUsageFlags const usage = SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ |
+                                          SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE | extra_usage;
+    return create_buffer(engine, usage, data, size, site);
 }
 
-std::expected<gpu_pipeline_t, std::string>
-create_pipeline(engine_t const &engine, pipeline_desc_t const &desc) {
+std::expected<gpu_texture_t, std::string> create_storage_texture(
+    engine_t const &engine, int width, int height, SDL_GPUTextureFormat format, Uint32 levels,
+    std::source_location const &site
+) {
+    SDL_GPUTextureCreateInfo info = {};
+    info.type                     = SDL_GPU_TEXTURETYPE_2D;
+    info.format                   = format;
+    info.usage = SDL_GPU_TEXTUREUSAGE_SAMPLER | SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_READ |
+                 SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_WRITE;
+    info.width                = static_cast<Uint32>(width);
+    info.height               = static_cast<Uint32>(height);
+    info.layer_count_or_depth = 1;
+    info.num_levels           = levels;
+
+    SDL_GPUTexture *tex = SDL_CreateGPUTexture(engine.gpu_device, &info);
+    if (!tex) return sdl_error("SDL_CreateGPUTexture (storage) failed");
+    return gpu_texture_t{engine.gpu_device, tex, gpu_texture_bytes(info), site};
+}
+
+std::expected<std::vector<Uint8>, std::string>
+download_buffer(engine_t const &engine, gpu_buffer_t const &buffer, Uint32 size) {
+    SDL_GPUTransferBufferCreateInfo transfer_info = {};
+    transfer_info.usage                           = SDL_GPU_TRANSFERBUFFERUSAGE_DOWNLOAD;
+    transfer_info.size                            = size;
+    transfer_t transfer{
+        engine.gpu_device, SDL_CreateGPUTransferBuffer(engine.gpu_device, &transfer_info),
+        transfer_info.size
+    };
+    if (!transfer) return sdl_error("SDL_CreateGPUTransferBuffer failed");
+
+    SDL_GPUCommandBuffer *cmd = SDL_AcquireGPUCommandBuffer(engine.gpu_device);
+    if (!cmd) return sdl_error("SDL_AcquireGPUCommandBuffer failed");
+
+    SDL_GPUBufferRegion source = {};
+    source.buffer              = buffer.get();
+    source.size                = size;
+
+    SDL_GPUTransferBufferLocation destination = {};
+    destination.transfer_buffer               = transfer.get();
+
+    SDL_GPUCopyPass *copy_pass = SDL_BeginGPUCopyPass(cmd);
+    SDL_DownloadFromGPUBuffer(copy_pass, &source, &destination);
+    SDL_EndGPUCopyPass(copy_pass);
+
+    SDL_GPUFence *fence = SDL_SubmitGPUCommandBufferAndAcquireFence(cmd);
+    if (!fence) return sdl_error("SDL_SubmitGPUCommandBufferAndAcquireFence failed");
+    bool const waited = SDL_WaitForGPUFences(engine.gpu_device, true, &fence, 1);
+    SDL_ReleaseGPUFence(engine.gpu_device, fence);
+    if (!waited) return sdl_error("SDL_WaitForGPUFences failed");
+
+    void *mapped = SDL_MapGPUTransferBuffer(engine.gpu_device, transfer.get(), false);
+    if (!mapped) return sdl_error("SDL_MapGPUTransferBuffer failed");
+    auto const        *bytes = static_cast<Uint8 const *>(mapped);
+    std::vector<Uint8> result(bytes, bytes + size);
+    SDL_UnmapGPUTransferBuffer(engine.gpu_device, transfer.get());
+    return result;
+}
+
+namespace {
+
+std::expected<gpu_compute_pipeline_t, std::string> create_compute_pipeline_from_code(
+    engine_t const &engine, std::span<Uint8 const> code, compute_pipeline_desc_t const &desc,
+    std::source_location const &site
+) {
+    SDL_GPUComputePipelineCreateInfo info = {};
+    info.code_size                        = code.size();
+    info.code                             = code.data();
+    info.entrypoint                       = "main";
+    info.format                           = SDL_GPU_SHADERFORMAT_SPIRV;
+    info.num_samplers                     = desc.samplers;
+    info.num_readonly_storage_textures    = desc.readonly_storage_textures;
+    info.num_readonly_storage_buffers     = desc.readonly_storage_buffers;
+    info.num_readwrite_storage_textures   = desc.readwrite_storage_textures;
+    info.num_readwrite_storage_buffers    = desc.readwrite_storage_buffers;
+    info.num_uniform_buffers              = desc.uniform_buffers;
+    info.threadcount_x                    = desc.threadcount_x;
+    info.threadcount_y                    = desc.threadcount_y;
+    info.threadcount_z                    = desc.threadcount_z;
+
+    SDL_GPUComputePipeline *pipeline = SDL_CreateGPUComputePipeline(engine.gpu_device, &info);
+    if (!pipeline) return sdl_error("SDL_CreateGPUComputePipeline failed");
+    return gpu_compute_pipeline_t{engine.gpu_device, pipeline, 0, site};
+}
+
+} // namespace
+
+std::expected<gpu_compute_pipeline_t, std::string> create_compute_pipeline(
+    engine_t const &engine, compute_pipeline_desc_t const &desc, std::source_location const &site
+) {
+    auto code = read_spirv(desc.shader);
+    if (!code) return std::unexpected(code.error());
+    return create_compute_pipeline_from_code(engine, *code, desc, site);
+}
+
+std::expected<gpu_compute_pipeline_t, std::string> create_compute_pipeline(
+    engine_t const &engine, std::string_view spv_path, std::source_location const &site
+) {
+    auto code = read_spirv(spv_path);
+    if (!code) return std::unexpected(code.error());
+    auto desc = reflect_compute_shader(*code, spv_path);
+    if (!desc) return std::unexpected(desc.error());
+    return create_compute_pipeline_from_code(engine, *code, *desc, site);
+}
+
+std::expected<gpu_pipeline_t, std::string> create_pipeline(
+    engine_t const &engine, pipeline_desc_t const &desc, std::source_location const &site
+) {
     auto vert = load_shader(
-        engine, desc.vertex_shader, SDL_GPU_SHADERSTAGE_VERTEX, desc.vertex_uniform_buffers
+        engine, desc.vertex_shader, SDL_GPU_SHADERSTAGE_VERTEX, desc.vertex_uniform_buffers, 0,
+        site
     );
     if (!vert) return std::unexpected(vert.error());
 
     auto frag = load_shader(
         engine, desc.fragment_shader, SDL_GPU_SHADERSTAGE_FRAGMENT, desc.fragment_uniform_buffers,
-        desc.fragment_samplers
+        desc.fragment_samplers, site
     );
     if (!frag) return std::unexpected(frag.error());
 
@@ -401,10 +903,9 @@ create_pipeline(engine_t const &engine, pipeline_desc_t const &desc) {
     auto attrs =
         desc.vertex_attributes.empty() ? std::span{&default_attribute, 1} : desc.vertex_attributes;
 
-    SDL_GPUColorTargetDescription color_target = {};
-    color_target.format = SDL_GetGPUSwapchainTextureFormat(engine.gpu_device, engine.window);
+    SDL_GPUColorTargetBlendState blend_state = {};
     if (desc.enable_blend) {
-        color_target.blend_state = {
+        blend_state = {
             .src_color_blendfactor = SDL_GPU_BLENDFACTOR_SRC_ALPHA,
             .dst_color_blendfactor = SDL_GPU_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,
             .color_blend_op        = SDL_GPU_BLENDOP_ADD,
@@ -413,7 +914,28 @@ create_pipeline(engine_t const &engine, pipeline_desc_t const &desc) {
             .alpha_blend_op        = SDL_GPU_BLENDOP_ADD,
             .enable_blend          = true,
         };
+        if (desc.additive_blend) {
+            blend_state.src_color_blendfactor = SDL_GPU_BLENDFACTOR_ONE;
+            blend_state.dst_color_blendfactor = SDL_GPU_BLENDFACTOR_ONE;
+            blend_state.dst_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ONE;
+        }
     }
+    if (!desc.enable_color_write) {
+        blend_state.enable_color_write_mask = true;
+        blend_state.color_write_mask        = 0;
+    }
+
+    // Default: one colour target in the swapchain format.
+    SDL_GPUTextureFormat const swapchain_format =
+        SDL_GetGPUSwapchainTextureFormat(engine.gpu_device, engine.window);
+    auto formats = desc.color_target_formats.empty() ? std::span{&swapchain_format, 1}
+                                                     : desc.color_target_formats;
+    if (formats.size() > MAX_COLOR_TARGETS)
+        return std::unexpected(std::format("Too many colour targets: {}", formats.size()));
+
+    std::array<SDL_GPUColorTargetDescription, MAX_COLOR_TARGETS> color_targets = {};
+    for (size_t i = 0; i < formats.size(); ++i)
+        color_targets[i] = {.format = formats[i], .blend_state = blend_state};
 
     SDL_GPUGraphicsPipelineCreateInfo info             = {};
     info.vertex_shader                                 = vert->get();
@@ -422,9 +944,9 @@ create_pipeline(engine_t const &engine, pipeline_desc_t const &desc) {
     info.vertex_input_state.num_vertex_buffers         = static_cast<Uint32>(buffer_descs.size());
     info.vertex_input_state.vertex_attributes          = attrs.data();
     info.vertex_input_state.num_vertex_attributes      = static_cast<Uint32>(attrs.size());
-    info.primitive_type                                = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST;
-    info.target_info.color_target_descriptions         = &color_target;
-    info.target_info.num_color_targets                 = 1;
+    info.primitive_type                                = desc.primitive_type;
+    info.target_info.color_target_descriptions         = color_targets.data();
+    info.target_info.num_color_targets                 = static_cast<Uint32>(formats.size());
     if (desc.enable_depth_test || desc.enable_stencil_test) {
         auto &ds                              = info.depth_stencil_state;
         ds.enable_depth_test                  = desc.enable_depth_test;
@@ -438,73 +960,195 @@ create_pipeline(engine_t const &engine, pipeline_desc_t const &desc) {
         ds.back_stencil_state                 = ds.front_stencil_state;
         ds.compare_mask                       = desc.stencil_compare_mask;
         ds.write_mask                         = desc.stencil_write_mask;
-        info.target_info.depth_stencil_format = SDL_GPU_TEXTUREFORMAT_D32_FLOAT_S8_UINT;
+        info.target_info.depth_stencil_format = DEPTH_FORMAT;
         info.target_info.has_depth_stencil_target = true;
     }
 
-    info.rasterizer_state.cull_mode = desc.cull_mode;
+    info.rasterizer_state.cull_mode     = desc.cull_mode;
+    info.multisample_state.sample_count = desc.sample_count;
+#if SDL_VERSION_ATLEAST(3, 4, 0)
+    info.multisample_state.enable_alpha_to_coverage =
+        desc.alpha_to_coverage && desc.sample_count != SDL_GPU_SAMPLECOUNT_1;
+#endif
 
     gpu_pipeline_t pipeline{
-        engine.gpu_device, SDL_CreateGPUGraphicsPipeline(engine.gpu_device, &info)
+        engine.gpu_device, SDL_CreateGPUGraphicsPipeline(engine.gpu_device, &info), 0, site
     };
     if (!pipeline) return sdl_error("SDL_CreateGPUGraphicsPipeline failed");
     return pipeline;
 }
 
-std::expected<gpu_texture_t, std::string>
-load_texture(engine_t const &engine, std::string_view path) {
-    using transfer_t = gpu_resource_t<SDL_GPUTransferBuffer, SDL_ReleaseGPUTransferBuffer>;
+SDL_GPUSampleCount supported_sample_count(
+    engine_t const &engine, SDL_GPUTextureFormat format, SDL_GPUSampleCount wanted
+) {
+    for (auto count = wanted; count != SDL_GPU_SAMPLECOUNT_1;
+         count      = static_cast<SDL_GPUSampleCount>(count - 1)) {
+        if (SDL_GPUTextureSupportsSampleCount(engine.gpu_device, format, count) &&
+            SDL_GPUTextureSupportsSampleCount(engine.gpu_device, DEPTH_FORMAT, count))
+            return count;
+    }
+    return SDL_GPU_SAMPLECOUNT_1;
+}
+
+pipeline_desc_t depth_prepass_desc(pipeline_desc_t desc) {
+    desc.fragment_shader    = "shaders/sdl3_engine/depth_only.frag.spv";
+    desc.enable_depth_test  = true;
+    desc.enable_depth_write = true;
+    desc.enable_blend       = false;
+    desc.enable_color_write = false;
+    return desc;
+}
+
+pipeline_desc_t depth_equal_desc(pipeline_desc_t desc) {
+    desc.enable_depth_test  = true;
+    desc.enable_depth_write = false;
+    desc.depth_compare_op   = SDL_GPU_COMPAREOP_EQUAL;
+    return desc;
+}
+
+std::expected<prepass_pipelines_t, std::string> create_prepass_pipelines(
+    engine_t const &engine, pipeline_desc_t const &desc, std::source_location const &site
+) {
+    auto depth = create_pipeline(engine, depth_prepass_desc(desc), site);
+    if (!depth) return std::unexpected(depth.error());
+    auto shade = create_pipeline(engine, depth_equal_desc(desc), site);
+    if (!shade) return std::unexpected(shade.error());
+    return prepass_pipelines_t{std::move(*depth), std::move(*shade)};
+}
+
+namespace {
+
+constexpr SDL_GPUTextureFormat fragment_count_format[] = {SDL_GPU_TEXTUREFORMAT_R16_FLOAT};
+
+} // namespace
+
+pipeline_desc_t fragment_count_desc(pipeline_desc_t desc) {
+    desc.fragment_shader      = "shaders/sdl3_engine/fragment_count.frag.spv";
+    desc.color_target_formats = fragment_count_format;
+    desc.enable_blend         = true;
+    desc.additive_blend       = true;
+    return desc;
+}
+
+std::expected<Uint64, std::string> count_fragments(engine_t const &engine, draw_fn const &draw) {
+    auto const size = window_pixel_size(engine);
+    auto target = create_color_target_texture(engine, size.x, size.y, fragment_count_format[0]);
+    if (!target) return std::unexpected(target.error());
+    auto depth = create_depth_texture(engine, size.x, size.y);
+    if (!depth) return std::unexpected(depth.error());
+
+    Uint32 const pixel_count = static_cast<Uint32>(size.x) * static_cast<Uint32>(size.y);
+
+    SDL_GPUTransferBufferCreateInfo transfer_info = {};
+    transfer_info.usage                           = SDL_GPU_TRANSFERBUFFERUSAGE_DOWNLOAD;
+    transfer_info.size                            = pixel_count * sizeof(Uint16);
+    transfer_t transfer{
+        engine.gpu_device, SDL_CreateGPUTransferBuffer(engine.gpu_device, &transfer_info),
+        transfer_info.size
+    };
+    if (!transfer) return sdl_error("SDL_CreateGPUTransferBuffer failed");
+
+    SDL_GPUCommandBuffer *cmd = SDL_AcquireGPUCommandBuffer(engine.gpu_device);
+    if (!cmd) return sdl_error("SDL_AcquireGPUCommandBuffer failed");
+
+    SDL_GPUColorTargetInfo color_info = {};
+    color_info.texture                = target->get();
+    color_info.clear_color            = {0.0f, 0.0f, 0.0f, 0.0f};
+    color_info.load_op                = SDL_GPU_LOADOP_CLEAR;
+    color_info.store_op               = SDL_GPU_STOREOP_STORE;
+
+    SDL_GPUDepthStencilTargetInfo depth_info = {};
+    depth_info.texture                       = depth->get();
+    depth_info.clear_depth                   = 1.0f;
+    depth_info.load_op                       = SDL_GPU_LOADOP_CLEAR;
+    depth_info.store_op                      = SDL_GPU_STOREOP_DONT_CARE;
+    depth_info.stencil_load_op               = SDL_GPU_LOADOP_CLEAR;
+    depth_info.stencil_store_op              = SDL_GPU_STOREOP_DONT_CARE;
+
+    SDL_GPURenderPass *render_pass = SDL_BeginGPURenderPass(cmd, &color_info, 1, &depth_info);
+    draw(cmd, render_pass);
+    SDL_EndGPURenderPass(render_pass);
+
+    SDL_GPUTextureRegion source = {};
+    source.texture              = target->get();
+    source.w                    = static_cast<Uint32>(size.x);
+    source.h                    = static_cast<Uint32>(size.y);
+    source.d                    = 1;
+
+    SDL_GPUTextureTransferInfo destination = {};
+    destination.transfer_buffer            = transfer.get();
+    destination.pixels_per_row             = source.w;
+    destination.rows_per_layer             = source.h;
 
-    SDL_Surface *raw = IMG_Load(path.data());
+    SDL_GPUCopyPass *copy_pass = SDL_BeginGPUCopyPass(cmd);
+    SDL_DownloadFromGPUTexture(copy_pass, &source, &destination);
+    SDL_EndGPUCopyPass(copy_pass);
+
+    SDL_GPUFence *fence = SDL_SubmitGPUCommandBufferAndAcquireFence(cmd);
+    if (!fence) return sdl_error("SDL_SubmitGPUCommandBufferAndAcquireFence failed");
+    bool const waited = SDL_WaitForGPUFences(engine.gpu_device, true, &fence, 1);
+    SDL_ReleaseGPUFence(engine.gpu_device, fence);
+    if (!waited) return sdl_error("SDL_WaitForGPUFences failed");
+
+    void *mapped = SDL_MapGPUTransferBuffer(engine.gpu_device, transfer.get(), false);
+    if (!mapped) return sdl_error("SDL_MapGPUTransferBuffer failed");
+    auto const *texels = static_cast<Uint16 const *>(mapped);
+    Uint64 total = 0;
+    for (Uint32 i = 0; i < pixel_count; ++i)
+        total += static_cast<Uint64>(glm::unpackHalf1x16(texels[i]) + 0.5f);
+    SDL_UnmapGPUTransferBuffer(engine.gpu_device, transfer.get());
+    return total;
+}
+
+std::expected<surface_t, std::string> decode_texture(std::string_view path) {
+    surface_t raw{IMG_Load(path.data())};
     if (!raw) return std::unexpected(std::format("IMG_Load failed: {}", SDL_GetError()));
 
-    SDL_Surface *rgba = SDL_ConvertSurface(raw, SDL_PIXELFORMAT_RGBA32);
-    SDL_DestroySurface(raw);
+    surface_t rgba{SDL_ConvertSurface(raw.get(), SDL_PIXELFORMAT_RGBA32)};
     if (!rgba) return sdl_error("SDL_ConvertSurface failed");
 
     // SDL3_GPU uses top-left UV origin; flip vertically so images appear
     // the same way as in OpenGL (which loaded images bottom-row-first).
-    if (!SDL_FlipSurface(rgba, SDL_FLIP_VERTICAL)) {
-        SDL_DestroySurface(rgba);
-        return sdl_error("SDL_FlipSurface failed");
-    }
+    if (!SDL_FlipSurface(rgba.get(), SDL_FLIP_VERTICAL)) return sdl_error("SDL_FlipSurface failed");
 
-    Uint32 const data_size = rgba->w * rgba->h * 4;
+    return rgba;
+}
+
+std::expected<gpu_texture_t, std::string> upload_texture(
+    engine_t const &engine, SDL_Surface const &rgba, std::source_location const &site
+) {
+    using transfer_t = gpu_resource_t<SDL_GPUTransferBuffer, SDL_ReleaseGPUTransferBuffer>;
+
+    Uint32 const data_size = rgba.w * rgba.h * 4;
 
     SDL_GPUTextureCreateInfo tex_info = {};
     tex_info.type                     = SDL_GPU_TEXTURETYPE_2D;
     tex_info.format                   = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM;
     tex_info.usage                    = SDL_GPU_TEXTUREUSAGE_SAMPLER;
-    tex_info.width                    = rgba->w;
-    tex_info.height                   = rgba->h;
+    tex_info.width                    = rgba.w;
+    tex_info.height                   = rgba.h;
     tex_info.layer_count_or_depth     = 1;
     tex_info.num_levels               = 1;
 
-    gpu_texture_t texture{engine.gpu_device, SDL_CreateGPUTexture(engine.gpu_device, &tex_info)};
-    if (!texture) {
-        SDL_DestroySurface(rgba);
-        return sdl_error("SDL_CreateGPUTexture failed");
-    }
+    gpu_texture_t texture{
+        engine.gpu_device, SDL_CreateGPUTexture(engine.gpu_device, &tex_info),
+        gpu_texture_bytes(tex_info), site
+    };
+    if (!texture) return sdl_error("SDL_CreateGPUTexture failed");
 
     SDL_GPUTransferBufferCreateInfo transfer_info = {};
     transfer_info.usage                           = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
     transfer_info.size                            = data_size;
     transfer_t transfer{
-        engine.gpu_device, SDL_CreateGPUTransferBuffer(engine.gpu_device, &transfer_info)
+        engine.gpu_device, SDL_CreateGPUTransferBuffer(engine.gpu_device, &transfer_info),
+        transfer_info.size, site
     };
-    if (!transfer) {
-        SDL_DestroySurface(rgba);
-        return sdl_error("SDL_CreateGPUTransferBuffer failed");
-    }
+    if (!transfer) return sdl_error("SDL_CreateGPUTransferBuffer failed");
 
     void *mapped = SDL_MapGPUTransferBuffer(engine.gpu_device, transfer.get(), false);
-    if (!mapped) {
-        SDL_DestroySurface(rgba);
-        return sdl_error("SDL_MapGPUTransferBuffer failed");
-    }
-    SDL_memcpy(mapped, rgba->pixels, data_size);
+    if (!mapped) return sdl_error("SDL_MapGPUTransferBuffer failed");
+    SDL_memcpy(mapped, rgba.pixels, data_size);
     SDL_UnmapGPUTransferBuffer(engine.gpu_device, transfer.get());
-    SDL_DestroySurface(rgba);
 
     SDL_GPUCommandBuffer *cmd = SDL_AcquireGPUCommandBuffer(engine.gpu_device);
     if (!cmd) return sdl_error("SDL_AcquireGPUCommandBuffer failed");
@@ -529,8 +1173,20 @@ load_texture(engine_t const &engine, std::string_view path) {
     return texture;
 }
 
-std::expected<gpu_texture_t, std::string>
-create_solid_texture(engine_t const &engine, glm::u8vec4 const &color) {
+std::expected<gpu_texture_t, std::string> load_texture(
+    engine_t const &engine, std::string_view path, glm::ivec2 *size,
+    std::source_location const &site
+) {
+    gpu_resource_scope_t const scope{std::string(path.substr(path.find_last_of("/\\") + 1))};
+    auto rgba = decode_texture(path);
+    if (!rgba) return std::unexpected(rgba.error());
+    if (size) *size = {(*rgba)->w, (*rgba)->h};
+    return upload_texture(engine, **rgba, site);
+}
+
+std::expected<gpu_texture_t, std::string> create_solid_texture(
+    engine_t const &engine, glm::u8vec4 const &color, std::source_location const &site
+) {
     using transfer_t = gpu_resource_t<SDL_GPUTransferBuffer, SDL_ReleaseGPUTransferBuffer>;
 
     Uint8 const pixels[4] = {color.r, color.g, color.b, color.a};
@@ -544,14 +1200,18 @@ create_solid_texture(engine_t const &engine, glm::u8vec4 const &color) {
     tex_info.layer_count_or_depth     = 1;
     tex_info.num_levels               = 1;
 
-    gpu_texture_t texture{engine.gpu_device, SDL_CreateGPUTexture(engine.gpu_device, &tex_info)};
+    gpu_texture_t texture{
+        engine.gpu_device, SDL_CreateGPUTexture(engine.gpu_device, &tex_info),
+        gpu_texture_bytes(tex_info), site
+    };
     if (!texture) return sdl_error("SDL_CreateGPUTexture failed");
 
     SDL_GPUTransferBufferCreateInfo transfer_info = {};
     transfer_info.usage                           = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
     transfer_info.size                            = 4;
     transfer_t transfer{
-        engine.gpu_device, SDL_CreateGPUTransferBuffer(engine.gpu_device, &transfer_info)
+        engine.gpu_device, SDL_CreateGPUTransferBuffer(engine.gpu_device, &transfer_info),
+        transfer_info.size, site
     };
     if (!transfer) return sdl_error("SDL_CreateGPUTransferBuffer failed");
 
@@ -584,7 +1244,8 @@ create_solid_texture(engine_t const &engine, glm::u8vec4 const &color) {
 }
 
 std::expected<gpu_sampler_t, std::string> create_sampler(
-    engine_t const &engine, SDL_GPUSamplerAddressMode address_mode, SDL_GPUFilter filter
+    engine_t const &engine, SDL_GPUSamplerAddressMode address_mode, SDL_GPUFilter filter,
+    std::source_location const &site
 ) {
     SDL_GPUSamplerCreateInfo info = {};
     info.min_filter               = filter;
@@ -596,61 +1257,75 @@ std::expected<gpu_sampler_t, std::string> create_sampler(
 
     SDL_GPUSampler *sampler = SDL_CreateGPUSampler(engine.gpu_device, &info);
     if (!sampler) return sdl_error("SDL_CreateGPUSampler failed");
-    return gpu_sampler_t{engine.gpu_device, sampler};
+    return gpu_sampler_t{engine.gpu_device, sampler, 0, site};
 }
 
 std::expected<gpu_geometry_t, std::string> create_geometry(
     engine_t const &engine, void const *vertices, Uint32 vertex_size,
-    std::span<uint16_t const> indices
+    std::span<uint16_t const> indices, std::source_location const &site
 ) {
-    auto vertex_buffer = create_buffer(engine, SDL_GPU_BUFFERUSAGE_VERTEX, vertices, vertex_size);
+    auto vertex_buffer =
+        create_buffer(engine, SDL_GPU_BUFFERUSAGE_VERTEX, vertices, vertex_size, site);
     if (!vertex_buffer) return std::unexpected(vertex_buffer.error());
 
     Uint32 index_size = static_cast<Uint32>(indices.size() * sizeof(uint16_t));
     auto   index_buffer =
-        create_buffer(engine, SDL_GPU_BUFFERUSAGE_INDEX, indices.data(), index_size);
+        create_buffer(engine, SDL_GPU_BUFFERUSAGE_INDEX, indices.data(), index_size, site);
     if (!index_buffer) return std::unexpected(index_buffer.error());
 
     return gpu_geometry_t{
-        std::move(*vertex_buffer), std::move(*index_buffer), static_cast<Uint32>(indices.size())
+        std::move(*vertex_buffer), std::move(*index_buffer), static_cast<Uint32>(indices.size()), 0,
+        SDL_GPU_INDEXELEMENTSIZE_16BIT, vertex_size
     };
 }
 
 std::expected<gpu_geometry_t, std::string> create_geometry(
     engine_t const &engine, void const *vertices, Uint32 vertex_size,
-    std::span<uint32_t const> indices
+    std::span<uint32_t const> indices, std::source_location const &site
 ) {
-    auto vertex_buffer = create_buffer(engine, SDL_GPU_BUFFERUSAGE_VERTEX, vertices, vertex_size);
+    auto vertex_buffer =
+        create_buffer(engine, SDL_GPU_BUFFERUSAGE_VERTEX, vertices, vertex_size, site);
     if (!vertex_buffer) return std::unexpected(vertex_buffer.error());
 
     Uint32 index_size = static_cast<Uint32>(indices.size() * sizeof(uint32_t));
     auto   index_buffer =
-        create_buffer(engine, SDL_GPU_BUFFERUSAGE_INDEX, indices.data(), index_size);
+        create_buffer(engine, SDL_GPU_BUFFERUSAGE_INDEX, indices.data(), index_size, site);
     if (!index_buffer) return std::unexpected(index_buffer.error());
 
     return gpu_geometry_t{
         std::move(*vertex_buffer), std::move(*index_buffer), static_cast<Uint32>(indices.size()), 0,
-        SDL_GPU_INDEXELEMENTSIZE_32BIT
+        SDL_GPU_INDEXELEMENTSIZE_32BIT, vertex_size
     };
 }
 
 std::expected<gpu_geometry_t, std::string> create_vertex_geometry(
-    engine_t const &engine, void const *vertices, Uint32 vertex_size, Uint32 vertex_count
+    engine_t const &engine, void const *vertices, Uint32 vertex_size, Uint32 vertex_count,
+    std::source_location const &site
 ) {
-    auto vertex_buffer = create_buffer(engine, SDL_GPU_BUFFERUSAGE_VERTEX, vertices, vertex_size);
+    auto vertex_buffer =
+        create_buffer(engine, SDL_GPU_BUFFERUSAGE_VERTEX, vertices, vertex_size, site);
     if (!vertex_buffer) return std::unexpected(vertex_buffer.error());
     gpu_geometry_t g;
     g.vertex_buffer = std::move(*vertex_buffer);
     g.vertex_count  = vertex_count;
+    g.vertex_bytes  = vertex_size;
     return g;
 }
 
-std::expected<gpu_material_t, std::string>
-create_material(engine_t const &engine, material_desc_t desc) {
+memory_usage_t memory_usage(gpu_geometry_t const &geometry) {
+    Uint64 const index_size = geometry.index_element_size == SDL_GPU_INDEXELEMENTSIZE_32BIT
+                                  ? sizeof(uint32_t)
+                                  : sizeof(uint16_t);
+    return {.cpu = 0, .gpu = geometry.vertex_bytes + geometry.index_count * index_size};
+}
+
+std::expected<gpu_material_t, std::string> create_material(
+    engine_t const &engine, material_desc_t desc, std::source_location const &site
+) {
     std::vector<gpu_texture_t> textures;
     textures.reserve(desc.texture_paths.size());
     for (auto const &path : desc.texture_paths) {
-        auto tex = load_texture(engine, path);
+        auto tex = load_texture(engine, path, nullptr, site);
         if (!tex) return std::unexpected(tex.error());
         textures.push_back(std::move(*tex));
     }
@@ -661,7 +1336,7 @@ create_material(engine_t const &engine, material_desc_t desc) {
         auto mode   = i < desc.address_modes.size() ? desc.address_modes[i]
                                                     : SDL_GPU_SAMPLERADDRESSMODE_REPEAT;
         auto filter = i < desc.filter_modes.size() ? desc.filter_modes[i] : SDL_GPU_FILTER_LINEAR;
-        auto s      = create_sampler(engine, mode, filter);
+        auto s      = create_sampler(engine, mode, filter, site);
         if (!s) return std::unexpected(s.error());
         samplers.push_back(std::move(*s));
     }
@@ -698,12 +1373,15 @@ void draw(
     draw(geometry, material, pass);
 }
 
-std::expected<gpu_texture_t, std::string>
-create_depth_texture(engine_t const &engine, int width, int height) {
+std::expected<gpu_texture_t, std::string> create_depth_texture(
+    engine_t const &engine, int width, int height, bool sampleable,
+    std::source_location const &site
+) {
     SDL_GPUTextureCreateInfo info = {};
     info.type                     = SDL_GPU_TEXTURETYPE_2D;
-    info.format                   = SDL_GPU_TEXTUREFORMAT_D32_FLOAT_S8_UINT;
+    info.format                   = DEPTH_FORMAT;
     info.usage                    = SDL_GPU_TEXTUREUSAGE_DEPTH_STENCIL_TARGET;
+    if (sampleable) info.usage |= SDL_GPU_TEXTUREUSAGE_SAMPLER;
     info.width                    = static_cast<Uint32>(width);
     info.height                   = static_cast<Uint32>(height);
     info.layer_count_or_depth     = 1;
@@ -711,31 +1389,38 @@ create_depth_texture(engine_t const &engine, int width, int height) {
 
     SDL_GPUTexture *tex = SDL_CreateGPUTexture(engine.gpu_device, &info);
     if (!tex) return sdl_error("SDL_CreateGPUTexture (depth) failed");
-    return gpu_texture_t{engine.gpu_device, tex};
+    return gpu_texture_t{engine.gpu_device, tex, gpu_texture_bytes(info), site};
 }
 
 bool tracked_depth_t::update(engine_t const &engine) {
     auto current = window_pixel_size(engine);
     if (current == size) return true;
-    auto result = create_depth_texture(engine, current.x, current.y);
+    auto result = create_depth_texture(engine, current.x, current.y, sampleable);
     if (!result) return false;
     texture = std::move(*result);
     size    = current;
     return true;
 }
 
-std::expected<tracked_depth_t, std::string> create_tracked_depth(engine_t const &engine) {
+std::expected<tracked_depth_t, std::string> create_tracked_depth(
+    engine_t const &engine, bool sampleable, std::source_location const &site
+) {
     auto size   = window_pixel_size(engine);
-    auto result = create_depth_texture(engine, size.x, size.y);
+    auto result = create_depth_texture(engine, size.x, size.y, sampleable, site);
     if (!result) return std::unexpected(result.error());
-    return tracked_depth_t{std::move(*result), size};
+    return tracked_depth_t{std::move(*result), size, sampleable};
 }
 
-std::expected<gpu_texture_t, std::string>
-create_color_target_texture(engine_t const &engine, int width, int height) {
+std::expected<gpu_texture_t, std::string> create_color_target_texture(
+    engine_t const &engine, int width, int height, SDL_GPUTextureFormat format,
+    std::source_location const &site
+) {
+    if (format == SDL_GPU_TEXTUREFORMAT_INVALID)
+        format = SDL_GetGPUSwapchainTextureFormat(engine.gpu_device, engine.window);
+
     SDL_GPUTextureCreateInfo info = {};
     info.type                     = SDL_GPU_TEXTURETYPE_2D;
-    info.format               = SDL_GetGPUSwapchainTextureFormat(engine.gpu_device, engine.window);
+    info.format                   = format;
     info.usage                = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER;
     info.width                = static_cast<Uint32>(width);
     info.height               = static_cast<Uint32>(height);
@@ -744,25 +1429,26 @@ create_color_target_texture(engine_t const &engine, int width, int height) {
 
     SDL_GPUTexture *tex = SDL_CreateGPUTexture(engine.gpu_device, &info);
     if (!tex) return sdl_error("SDL_CreateGPUTexture (color_target) failed");
-    return gpu_texture_t{engine.gpu_device, tex};
+    return gpu_texture_t{engine.gpu_device, tex, gpu_texture_bytes(info), site};
 }
 
 bool tracked_color_target_t::update(engine_t const &engine) {
     auto current = window_pixel_size(engine);
     if (current == size) return true;
-    auto result = create_color_target_texture(engine, current.x, current.y);
+    auto result = create_color_target_texture(engine, current.x, current.y, format);
     if (!result) return false;
     texture = std::move(*result);
     size    = current;
     return true;
 }
 
-std::expected<tracked_color_target_t, std::string>
-create_tracked_color_target(engine_t const &engine) {
+std::expected<tracked_color_target_t, std::string> create_tracked_color_target(
+    engine_t const &engine, SDL_GPUTextureFormat format, std::source_location const &site
+) {
     auto size   = window_pixel_size(engine);
-    auto result = create_color_target_texture(engine, size.x, size.y);
+    auto result = create_color_target_texture(engine, size.x, size.y, format, site);
     if (!result) return std::unexpected(result.error());
-    return tracked_color_target_t{std::move(*result), size};
+    return tracked_color_target_t{std::move(*result), size, format};
 }
 
 std::expected<void, std::string> run_loop(
@@ -770,28 +1456,278 @@ std::expected<void, std::string> run_loop(
     tracked_color_target_t &color_target, std::function<bool(input_t const &)> update,
     std::span<pass_desc_t> passes
 ) {
+    return run_loop(
+        engine, std::move(get_clear_color), depth, std::span{&color_target, 1}, std::move(update),
+        passes
+    );
+}
+
+namespace {
+
+// Runs one job at a time on its own thread: run() hands a job over, wait() blocks until it is
+// done. Only one job may be outstanding.
+class update_worker_t {
+public:
+    update_worker_t() : m_thread([this](std::stop_token stop) { work(stop); }) {}
+
+    void run(std::function<void()> job) {
+        {
+            std::lock_guard lock(m_mutex);
+            m_job = std::move(job);
+        }
+        m_changed.notify_all();
+    }
+
+    void wait() {
+        std::unique_lock lock(m_mutex);
+        m_changed.wait(lock, [this] { return !m_job; });
+    }
+
+private:
+    std::mutex                  m_mutex;
+    std::condition_variable_any m_changed;
+    std::function<void()>       m_job;    // guarded by m_mutex, cleared once the job has run
+    std::jthread                m_thread; // last: joined before the members above go away
+
+    void work(std::stop_token stop) {
+        std::unique_lock lock(m_mutex);
+        while (m_changed.wait(lock, stop, [this] { return static_cast<bool>(m_job); })) {
+            // run() is not called again until wait() has seen the job cleared.
+            lock.unlock();
+            m_job();
+            lock.lock();
+            m_job = nullptr;
+            m_changed.notify_all();
+        }
+    }
+};
+
+void set_clear_color(pass_desc_t &pass, SDL_FColor clear) {
+    if (pass.load_op == SDL_GPU_LOADOP_CLEAR) pass.clear_color = clear;
+}
+
+void set_clear_color(frame_pass_t &step, SDL_FColor clear) {
+    if (auto *pass = std::get_if<pass_desc_t>(&step)) set_clear_color(*pass, clear);
+}
+
+using frame_hook_t = std::function<std::expected<void, std::string>()>;
+
+// Shared body of every multi-pass run_loop. Each frame runs before_update (e.g. recreating
+// window-sized targets), update, then after_update (e.g. compiling targets update resized), and
+// encode records the frame. Either hook may be empty; a failing one ends the loop.
+std::expected<void, std::string> run_frame_loop(
+    engine_t &engine, std::function<bool(input_t const &)> const &update,
+    frame_hook_t const &before_update, frame_hook_t const &after_update,
+    std::function<void(SDL_GPUCommandBuffer *, SDL_GPUTexture *)> const &encode
+) {
+    SDL_SetWindowRelativeMouseMode(engine.window, true);
+    bool              focused = true;
+    frame_scheduler_t scheduler{engine.pacing, engine.present};
+
+    while (true) {
+        // Late latching waits for the swapchain before sampling input, so the frame is encoded
+        // from input that is fresh rather than a whole swapchain wait old.
+        std::optional<frame_target_t> frame;
+        if (engine.present.late_latch) {
+            auto acquired = acquire_frame(engine);
+            if (!acquired) return std::unexpected(acquired.error());
+            frame = *acquired;
+        }
+        // An acquired swapchain texture must be submitted, not cancelled, even when quitting.
+        auto const quit = [&frame]() {
+            if (frame) submit_frame(*frame, nullptr);
+        };
+
+        float  scroll_delta = 0.0f;
+        Uint64 input_time   = 0;
+        if (!pump_events(engine, focused, scroll_delta, input_time)) {
+            quit();
+            break;
+        }
+
+        float dt = tick(engine);
+        if (before_update) {
+            if (auto r = before_update(); !r) {
+                quit();
+                return r;
+            }
+        }
+
+        input_t in = collect_input(engine, focused, scroll_delta, dt);
+        scheduler.schedule(in);
+        if (ImGui::GetCurrentContext()) imgui_new_frame();
+        bool const should_continue = update(in);
+        if (ImGui::GetCurrentContext()) {
+            draw_gpu_resource_panel();
+            ImGui::Render();
+        }
+        if (!should_continue) {
+            quit();
+            break;
+        }
+        if (after_update) {
+            if (auto r = after_update(); !r) {
+                quit();
+                return r;
+            }
+        }
+
+        if (!frame) {
+            auto acquired = acquire_frame(engine);
+            if (!acquired) return std::unexpected(acquired.error());
+            frame = *acquired;
+        }
+        if (auto f = submit_frame(*frame, encode); !f) return std::unexpected(f.error());
+        scheduler.finish_frame(input_time);
+    }
+    scheduler.report();
+    return {};
+}
+
+template <typename Pass>
+std::expected<void, std::string> run_pass_loop(
+    engine_t &engine, std::function<SDL_FColor()> const &get_clear_color, tracked_depth_t &depth,
+    std::span<tracked_color_target_t> color_targets,
+    std::function<bool(input_t const &)> const &update, std::span<Pass> passes
+) {
+    auto const resize = [&]() -> std::expected<void, std::string> {
+        depth.update(engine);
+        for (auto &target : color_targets) target.update(engine);
+        return {};
+    };
+    auto const encode = [&](SDL_GPUCommandBuffer *cmd, SDL_GPUTexture *swapchain) {
+        auto clear = get_clear_color();
+        for (auto &pass : passes) set_clear_color(pass, clear);
+        encode_passes(cmd, swapchain, std::span<Pass const>(passes));
+    };
+    return run_frame_loop(engine, update, resize, nullptr, encode);
+}
+
+} // namespace
+
+std::expected<void, std::string> run_loop(
+    engine_t &engine, std::function<SDL_FColor()> get_clear_color, tracked_depth_t &depth,
+    std::span<tracked_color_target_t> color_targets, std::function<bool(input_t const &)> update,
+    std::span<pass_desc_t> passes
+) {
+    return run_pass_loop(engine, get_clear_color, depth, color_targets, update, passes);
+}
+
+std::expected<void, std::string> run_loop(
+    engine_t &engine, std::function<SDL_FColor()> get_clear_color, tracked_depth_t &depth,
+    std::span<tracked_color_target_t> color_targets, std::function<bool(input_t const &)> update,
+    std::span<frame_pass_t> passes
+) {
+    return run_pass_loop(engine, get_clear_color, depth, color_targets, update, passes);
+}
+
+std::expected<void, std::string> run_loop(
+    engine_t &engine, std::function<SDL_FColor()> get_clear_color, render_graph_t &graph,
+    std::function<bool(input_t const &)> update
+) {
+    bool       reported = false;
+    auto const compile  = [&]() -> std::expected<void, std::string> {
+        if (auto r = graph.compile(engine); !r) return r;
+        if (engine.verbose && !std::exchange(reported, true))
+            SDL_Log("%s", graph.report().c_str());
+        return {};
+    };
+    auto const encode = [&](SDL_GPUCommandBuffer *cmd, SDL_GPUTexture *swapchain) {
+        graph.clear_color = get_clear_color();
+        graph.execute(cmd, swapchain);
+    };
+    return run_frame_loop(engine, update, nullptr, compile, encode);
+}
+
+std::expected<void, std::string>
+run_pipeline_loop(engine_t &engine, SDL_FColor clear_color, pipeline_stages_t stages) {
+    auto depth_result = create_tracked_depth(engine);
+    if (!depth_result) return std::unexpected(depth_result.error());
+    tracked_depth_t depth = std::move(*depth_result);
+
+    // The worker reads input.keys while the next pump_events updates SDL's array: copy per slot.
+    std::array<std::array<bool, SDL_SCANCODE_COUNT>, 2> keys{};
+    int slot      = 0;  // snapshot the next update fills
+    int draw_slot = -1; // snapshot recorded this frame; none before the first update
+
+    pass_desc_t frame_pass{
+        .depth_texture = &depth.texture,
+        .clear_color   = clear_color,
+        .prepare       = imgui_prepare,
+        .draw =
+            [&](SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
+                stages.render(draw_slot, cmd, pass);
+                imgui_render(cmd, pass);
+            },
+    };
+
     SDL_SetWindowRelativeMouseMode(engine.window, true);
-    bool focused = true;
+    bool              focused = true;
+    frame_scheduler_t scheduler{engine.pacing, engine.present};
+    update_worker_t   worker;
+
+    Uint64 const start     = SDL_GetTicksNS();
+    Uint64       frames    = 0;
+    Uint64       update_ns = 0; // written by the worker, read after wait()
+    Uint64       render_ns = 0;
 
     while (true) {
-        float scroll_delta = 0.0f;
-        if (!pump_events(engine, focused, scroll_delta)) break;
+        float  scroll_delta = 0.0f;
+        Uint64 input_time   = 0;
+        if (!pump_events(engine, focused, scroll_delta, input_time)) break;
 
         float dt = tick(engine);
         depth.update(engine);
-        color_target.update(engine);
+
+        input_t in = collect_input(engine, focused, scroll_delta, dt);
+        scheduler.schedule(in);
+        std::copy_n(in.keys, SDL_SCANCODE_COUNT, keys[slot].begin());
+        in.keys = keys[slot].data();
 
         if (ImGui::GetCurrentContext()) imgui_new_frame();
-        bool const should_continue = update(collect_input(engine, focused, scroll_delta, dt));
-        if (ImGui::GetCurrentContext()) ImGui::Render();
+        bool const should_continue = stages.ui(in);
+        if (ImGui::GetCurrentContext()) {
+            draw_gpu_resource_panel();
+            ImGui::Render();
+        }
         if (!should_continue) break;
 
-        auto clear = get_clear_color();
-        for (auto &pass : passes)
-            if (pass.load_op == SDL_GPU_LOADOP_CLEAR) pass.clear_color = clear;
+        auto const update = [&stages, &update_ns, in, slot] {
+            Uint64 const begin = SDL_GetTicksNS();
+            stages.update(in, slot);
+            update_ns += SDL_GetTicksNS() - begin;
+        };
+        if (engine.pipelined) {
+            worker.run(update);
+        } else {
+            update();
+            draw_slot = slot;
+        }
 
-        if (auto f = render_frame(engine, std::span<pass_desc_t const>(passes)); !f)
-            return std::unexpected(f.error());
+        Uint64 const render_begin = SDL_GetTicksNS();
+        auto const   frame        = draw_slot < 0 ? std::expected<void, std::string>{}
+                                                  : render_frame(engine, std::span{&frame_pass, 1});
+        render_ns += SDL_GetTicksNS() - render_begin;
+        worker.wait();
+        if (!frame) return std::unexpected(frame.error());
+
+        if (engine.pipelined) draw_slot = slot;
+        slot = 1 - slot;
+        ++frames;
+        scheduler.finish_frame(input_time);
+    }
+    scheduler.report();
+
+    if (engine.pacing.report && frames > 0) {
+        double const seconds = static_cast<double>(SDL_GetTicksNS() - start) / 1e9;
+        double const per     = 1e6 * static_cast<double>(frames);
+        SDL_Log(
+            "%s: %" SDL_PRIu64 " frames in %.1f s (%.1f fps), update %.2f ms/frame, "
+            "render_frame %.2f ms/frame",
+            engine.pipelined ? "pipelined" : "serial", frames, seconds,
+            static_cast<double>(frames) / seconds, static_cast<double>(update_ns) / per,
+            static_cast<double>(render_ns) / per
+        );
     }
     return {};
 }
@@ -1,26 +1,41 @@
 #pragma once
+#include <array>
+#include <concepts>
 #include <expected>
 #include <functional>
+#include <memory>
+#include <source_location>
 #include <span>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include <SDL3/SDL.h>
 #include <glm/glm.hpp>
 #include <imgui.h>
 
+#include "common/memory_usage.hpp"
 #include "geometry.hpp"
+#include "resource_tracking.hpp"
 
 // Generic RAII owner for any SDL GPU object released via Release(device,
-// handle). Move-only; destructor fires the release call.
+// handle). Move-only; destructor fires the release call. With resource tracking on, taking a
+// handle records it under the constructing call site (see resource_tracking.hpp); pass bytes
+// when the size is known.
 template <typename T, void (*Release)(SDL_GPUDevice *, T *)> struct gpu_resource_t {
     SDL_GPUDevice *device = nullptr;
     T             *handle = nullptr;
 
     gpu_resource_t() = default;
-    gpu_resource_t(SDL_GPUDevice *dev, T *h) : device(dev), handle(h) {}
+    gpu_resource_t(
+        SDL_GPUDevice *dev, T *h, Uint64 bytes = 0,
+        std::source_location const &site = std::source_location::current()
+    )
+        : device(dev), handle(h) {
+        if (handle) track_gpu_resource(gpu_resource_type<T>(), handle, bytes, site);
+    }
 
     gpu_resource_t(gpu_resource_t const &)            = delete;
     gpu_resource_t &operator=(gpu_resource_t const &) = delete;
@@ -31,19 +46,24 @@ template <typename T, void (*Release)(SDL_GPUDevice *, T *)> struct gpu_resource
 
     gpu_resource_t &operator=(gpu_resource_t &&other) noexcept {
         if (this != &other) {
-            if (device && handle) Release(device, handle);
+            release();
             device = std::exchange(other.device, nullptr);
             handle = std::exchange(other.handle, nullptr);
         }
         return *this;
     }
 
-    ~gpu_resource_t() {
-        if (device && handle) Release(device, handle);
-    }
+    ~gpu_resource_t() { release(); }
 
     T       *get() const { return handle; }
     explicit operator bool() const { return handle != nullptr; }
+
+private:
+    void release() {
+        if (!device || !handle) return;
+        untrack_gpu_resource(handle);
+        Release(device, handle);
+    }
 };
 
 using gpu_pipeline_t = gpu_resource_t<SDL_GPUGraphicsPipeline, SDL_ReleaseGPUGraphicsPipeline>;
@@ -51,9 +71,36 @@ using gpu_buffer_t   = gpu_resource_t<SDL_GPUBuffer, SDL_ReleaseGPUBuffer>;
 using gpu_shader_t   = gpu_resource_t<SDL_GPUShader, SDL_ReleaseGPUShader>;
 using gpu_texture_t  = gpu_resource_t<SDL_GPUTexture, SDL_ReleaseGPUTexture>;
 using gpu_sampler_t  = gpu_resource_t<SDL_GPUSampler, SDL_ReleaseGPUSampler>;
+using gpu_compute_pipeline_t =
+    gpu_resource_t<SDL_GPUComputePipeline, SDL_ReleaseGPUComputePipeline>;
+
+// How the run_loop overloads schedule frames. Everything defaults to off, which keeps the old
+// behaviour of one update per rendered frame as fast as the swapchain allows, and a quiet log.
+struct frame_pacing_t {
+    double simulation_hz = 0.0;   // > 0: update gets whole fixed steps and an interpolation alpha
+    double target_fps    = 0.0;   // > 0: sleep, then spin, until the next frame is due
+    bool   report        = false; // frame time p50/p99 every few seconds and at exit
+};
+
+// Swapchain and queueing options, applied by create_engine. Fewer frames in flight and late
+// latching both trade some throughput for fresher input in the presented frame.
+struct present_config_t {
+    Uint32             frames_in_flight = 2; // 1-3, SDL_SetGPUAllowedFramesInFlight
+    SDL_GPUPresentMode present_mode     = SDL_GPU_PRESENTMODE_VSYNC; // vsync if unsupported
+    bool               late_latch       = false; // sample input after the swapchain wait
+    bool               latency_probe    = false; // report input event to submit times
+};
 
 struct engine_config_t {
-    bool verbose = false;
+    bool             verbose         = false;
+    bool             pipelined       = true; // run_pipeline_loop overlaps update with recording
+    // No window and no swapchain: only off-screen work (benchmarks). engine_t::window stays
+    // null, so nothing that takes the window size or the swapchain format can be used.
+    bool             headless        = false;
+    // Count and label every gpu_resource_t: see resource_tracking.hpp.
+    bool             track_resources = false;
+    frame_pacing_t   pacing{};
+    present_config_t present{};
 };
 
 engine_config_t parse_engine_args(int argc, char *argv[]);
@@ -61,11 +108,14 @@ engine_config_t parse_engine_args(int argc, char *argv[]);
 std::unexpected<std::string> sdl_error(std::string prefix);
 
 struct engine_t {
-    SDL_Window    *window          = nullptr;
-    SDL_GPUDevice *gpu_device      = nullptr;
-    bool           sdl_initialized = false;
-    bool           verbose         = false;
-    Uint64         last_tick       = 0;
+    SDL_Window      *window          = nullptr;
+    SDL_GPUDevice   *gpu_device      = nullptr;
+    bool             sdl_initialized = false;
+    bool             verbose         = false;
+    bool             pipelined       = true;
+    frame_pacing_t   pacing{};
+    present_config_t present{};
+    Uint64           last_tick = 0; // SDL_GetTicksNS
 
     engine_t()                            = default;
     engine_t(engine_t const &)            = delete;
@@ -86,7 +136,7 @@ std::expected<void, std::string> init_imgui(engine_t const &engine);
 // Games handle their own exit conditions (escape, menus, etc.) separately.
 bool poll_events();
 
-// Returns seconds elapsed since the last call. Call once per frame.
+// Returns seconds elapsed since the last call, at nanosecond resolution. Call once per frame.
 // Returns 0 on the first call.
 float tick(engine_t &engine);
 
@@ -99,8 +149,12 @@ glm::ivec2 window_pixel_size(engine_t const &engine);
 float aspect_ratio(engine_t const &engine);
 
 // Type aliases for pass callbacks.
-using cmd_fn  = std::function<void(SDL_GPUCommandBuffer *)>;
-using draw_fn = std::function<void(SDL_GPUCommandBuffer *, SDL_GPURenderPass *)>;
+using cmd_fn     = std::function<void(SDL_GPUCommandBuffer *)>;
+using draw_fn    = std::function<void(SDL_GPUCommandBuffer *, SDL_GPURenderPass *)>;
+using compute_fn = std::function<void(SDL_GPUCommandBuffer *, SDL_GPUComputePass *)>;
+
+// Upper bound on colour attachments per pass (SDL3 GPU guarantees at least 4).
+constexpr size_t MAX_COLOR_TARGETS = 4;
 
 // Describes one render pass in a frame.
 // color_target == null means the swapchain. depth_texture == null means no depth attachment.
@@ -113,8 +167,30 @@ struct pass_desc_t {
     SDL_GPULoadOp        load_op       = SDL_GPU_LOADOP_CLEAR;
     cmd_fn               prepare;
     draw_fn              draw;
+    // Multiple render targets (e.g. a G-buffer): when non-empty, replaces color_target and binds
+    // each texture to colour slot 0..N-1. All slots share clear_color and load_op.
+    std::span<gpu_texture_t const *const> color_targets = {};
+    // LOAD reuses depth written by an earlier pass; STORE keeps this pass's depth for later ones.
+    SDL_GPULoadOp  depth_load_op  = SDL_GPU_LOADOP_CLEAR;
+    SDL_GPUStoreOp depth_store_op = SDL_GPU_STOREOP_DONT_CARE;
+    // False skips the pass outright, prepare included, for modes that do not need it this frame.
+    bool enabled = true;
 };
 
+// Describes one compute pass in a frame. The read-write storage resources are bound for the
+// whole pass (SDL_BeginGPUComputePass); pipelines, samplers, read-only storage and uniforms are
+// bound by dispatch. prepare is called outside any pass, like pass_desc_t::prepare.
+struct compute_pass_desc_t {
+    std::span<SDL_GPUStorageTextureReadWriteBinding const> storage_textures = {};
+    std::span<SDL_GPUStorageBufferReadWriteBinding const>  storage_buffers  = {};
+    cmd_fn                                                 prepare;
+    compute_fn                                             dispatch;
+};
+
+// One step of a frame: a render pass or a compute pass. Steps run in order in one command
+// buffer, so a compute pass sees everything earlier passes wrote and vice versa.
+using frame_pass_t = std::variant<pass_desc_t, compute_pass_desc_t>;
+
 // Upload ImGui vertex/index data to the GPU (must be called outside any render pass).
 // No-op when no ImGui context exists. Use as a pass_desc_t::prepare callback.
 void imgui_prepare(SDL_GPUCommandBuffer *cmd);
@@ -136,69 +212,178 @@ std::expected<void, std::string> render_frame(
 std::expected<void, std::string>
 render_frame(engine_t const &engine, std::span<pass_desc_t const> passes);
 
+// Same, with compute passes interleaved between the render passes.
+std::expected<void, std::string>
+render_frame(engine_t const &engine, std::span<frame_pass_t const> passes);
+
+// The helpers below that create resources take the call site as a last, defaulted argument and
+// hand it to gpu_resource_t, so resource tracking names their caller rather than engine.cpp.
+
 // Reads a SPIR-V file and creates a GPU shader stage.
 // num_uniform_buffers and num_samplers must match the shader's declared bindings.
 std::expected<gpu_shader_t, std::string> load_shader(
     engine_t const &engine, std::string_view spv_path, SDL_GPUShaderStage stage,
-    Uint32 num_uniform_buffers = 0, Uint32 num_samplers = 0
+    Uint32 num_uniform_buffers = 0, Uint32 num_samplers = 0,
+    std::source_location const &site = std::source_location::current()
 );
 
 // Allocates a GPU vertex buffer and uploads data via a one-shot copy pass.
-std::expected<gpu_buffer_t, std::string>
-create_vertex_buffer(engine_t const &engine, void const *data, Uint32 size);
+std::expected<gpu_buffer_t, std::string> create_vertex_buffer(
+    engine_t const &engine, void const *data, Uint32 size,
+    std::source_location const &site = std::source_location::current()
+);
 
 // Allocates a GPU index buffer and uploads data via a one-shot copy pass.
-std::expected<gpu_buffer_t, std::string>
-create_index_buffer(engine_t const &engine, void const *data, Uint32 size);
+std::expected<gpu_buffer_t, std::string> create_index_buffer(
+    engine_t const &engine, void const *data, Uint32 size,
+    std::source_location const &site = std::source_location::current()
+);
+
+// Allocates a GPU buffer with arbitrary usage flags (e.g. INDIRECT | COMPUTE_STORAGE_WRITE).
+// With data, uploads size bytes via a one-shot copy pass; without, contents are undefined.
+std::expected<gpu_buffer_t, std::string> create_gpu_buffer(
+    engine_t const &engine, SDL_GPUBufferUsageFlags usage, Uint32 size, void const *data = nullptr,
+    std::source_location const &site = std::source_location::current()
+);
+
+// Buffer that compute shaders can read and write. extra_usage adds e.g. VERTEX or INDIRECT so
+// render passes can consume compute output directly, without a copy.
+std::expected<gpu_buffer_t, std::string> create_storage_buffer(
+    engine_t const &engine, Uint32 size, void const *data = nullptr,
+    SDL_GPUBufferUsageFlags extra_usage = 0,
+    std::source_location const &site = std::source_location::current()
+);
+
+// 2D texture that compute shaders can read and write and render passes can sample.
+std::expected<gpu_texture_t, std::string> create_storage_texture(
+    engine_t const &engine, int width, int height, SDL_GPUTextureFormat format, Uint32 levels = 1,
+    std::source_location const &site = std::source_location::current()
+);
+
+// Copies the first size bytes of buffer back to the CPU. Waits for the GPU, so everything
+// submitted before the call (e.g. last frame's compute output) is visible. Synchronous; call
+// outside render_frame.
+std::expected<std::vector<Uint8>, std::string>
+download_buffer(engine_t const &engine, gpu_buffer_t const &buffer, Uint32 size);
+
+// Resource counts for a compute pipeline; they must match the shader's declarations.
+// create_compute_pipeline(engine, path) derives them from the SPIR-V instead.
+// SPIR-V set layout: set 0 = samplers, then read-only storage textures, then read-only storage
+// buffers; set 1 = read-write storage textures, then read-write storage buffers; set 2 =
+// uniform buffers.
+struct compute_pipeline_desc_t {
+    std::string_view shader;
+    Uint32           samplers                   = 0;
+    Uint32           readonly_storage_textures  = 0;
+    Uint32           readonly_storage_buffers   = 0;
+    Uint32           readwrite_storage_textures = 0;
+    Uint32           readwrite_storage_buffers  = 0;
+    Uint32           uniform_buffers            = 0;
+    // Must match the shader's local_size_{x,y,z}.
+    Uint32 threadcount_x = 1;
+    Uint32 threadcount_y = 1;
+    Uint32 threadcount_z = 1;
+};
+
+std::expected<gpu_compute_pipeline_t, std::string> create_compute_pipeline(
+    engine_t const &engine, compute_pipeline_desc_t const &desc,
+    std::source_location const &site = std::source_location::current()
+);
+
+// Reflects the resource counts and local_size of a compute shader from its SPIR-V and creates
+// the pipeline. Fails if a binding is outside the three sets above or local_size is given by
+// specialization constants.
+std::expected<gpu_compute_pipeline_t, std::string> create_compute_pipeline(
+    engine_t const &engine, std::string_view spv_path,
+    std::source_location const &site = std::source_location::current()
+);
+
+// Format of every depth texture and of the depth attachment create_pipeline expects.
+constexpr SDL_GPUTextureFormat DEPTH_FORMAT = SDL_GPU_TEXTUREFORMAT_D32_FLOAT_S8_UINT;
 
 // Creates a depth texture for 3D rendering. Recreate on window resize.
-std::expected<gpu_texture_t, std::string>
-create_depth_texture(engine_t const &engine, int width, int height);
+// sampleable adds SAMPLER usage so later passes (e.g. a Hi-Z build) can read the depth; the
+// pass that writes it must then use depth_store_op = STORE.
+std::expected<gpu_texture_t, std::string> create_depth_texture(
+    engine_t const &engine, int width, int height, bool sampleable = false,
+    std::source_location const &site = std::source_location::current()
+);
 
 // Depth texture that automatically recreates itself when the window is resized.
 // Call update() once per frame before rendering; pass texture to render_frame.
 struct tracked_depth_t {
     gpu_texture_t texture;
     glm::ivec2    size;
+    bool          sampleable = false;
 
     // Recreates the texture if the window pixel size has changed.
     // Returns false if recreation failed (old texture remains valid).
     bool update(engine_t const &engine);
 };
 
-std::expected<tracked_depth_t, std::string> create_tracked_depth(engine_t const &engine);
+std::expected<tracked_depth_t, std::string> create_tracked_depth(
+    engine_t const &engine, bool sampleable = false,
+    std::source_location const &site = std::source_location::current()
+);
 
-// Off-screen color texture for render-to-texture (RTT). Format matches the swapchain
-// so existing scene pipelines can render to it without recompilation.
-std::expected<gpu_texture_t, std::string>
-create_color_target_texture(engine_t const &engine, int width, int height);
+// Off-screen color texture for render-to-texture (RTT). By default the format matches the
+// swapchain so existing scene pipelines can render to it without recompilation; pass an explicit
+// format for G-buffer style targets (e.g. R16G16B16A16_FLOAT normals).
+std::expected<gpu_texture_t, std::string> create_color_target_texture(
+    engine_t const &engine, int width, int height,
+    SDL_GPUTextureFormat format = SDL_GPU_TEXTUREFORMAT_INVALID,
+    std::source_location const &site = std::source_location::current()
+);
 
 // Color target texture that automatically recreates itself on window resize.
 // Call update() once per frame (alongside tracked_depth_t) before the RTT render pass.
 struct tracked_color_target_t {
-    gpu_texture_t texture;
-    glm::ivec2    size;
+    gpu_texture_t        texture;
+    glm::ivec2           size;
+    SDL_GPUTextureFormat format = SDL_GPU_TEXTUREFORMAT_INVALID; // INVALID: swapchain format
 
     bool update(engine_t const &engine);
 };
 
-std::expected<tracked_color_target_t, std::string>
-create_tracked_color_target(engine_t const &engine);
+std::expected<tracked_color_target_t, std::string> create_tracked_color_target(
+    engine_t const &engine, SDL_GPUTextureFormat format = SDL_GPU_TEXTUREFORMAT_INVALID,
+    std::source_location const &site = std::source_location::current()
+);
 
 // Loads an image file via SDL3_image and uploads it to a GPU texture.
-std::expected<gpu_texture_t, std::string>
-load_texture(engine_t const &engine, std::string_view path);
+// When given, `size` receives the image dimensions (SDL has no query for them afterwards).
+std::expected<gpu_texture_t, std::string> load_texture(
+    engine_t const &engine, std::string_view path, glm::ivec2 *size = nullptr,
+    std::source_location const &site = std::source_location::current()
+);
+
+struct surface_deleter_t {
+    void operator()(SDL_Surface *surface) const { SDL_DestroySurface(surface); }
+};
+using surface_t = std::unique_ptr<SDL_Surface, surface_deleter_t>;
+
+// The two halves of load_texture. decode_texture reads the file into an RGBA32 surface in the
+// row order upload_texture expects and touches no GPU state, so it can run on a job thread;
+// upload_texture has to run on the thread that owns the device.
+std::expected<surface_t, std::string> decode_texture(std::string_view path);
+std::expected<gpu_texture_t, std::string> upload_texture(
+    engine_t const &engine, SDL_Surface const &rgba,
+    std::source_location const &site = std::source_location::current()
+);
 
 // Creates a 1x1 GPU texture filled with solid RGBA colour (components in [0, 255]).
 // Useful for placeholder textures (e.g. a pure-white specular map for glass materials).
-std::expected<gpu_texture_t, std::string>
-create_solid_texture(engine_t const &engine, glm::u8vec4 const &color);
+std::expected<gpu_texture_t, std::string> create_solid_texture(
+    engine_t const &engine, glm::u8vec4 const &color,
+    std::source_location const &site = std::source_location::current()
+);
 
 // Creates a sampler with linear filtering and the given address mode (default: repeat).
 std::expected<gpu_sampler_t, std::string> create_sampler(
-    engine_t const           &engine,
-    SDL_GPUSamplerAddressMode address_mode = SDL_GPU_SAMPLERADDRESSMODE_REPEAT,
-    SDL_GPUFilter             filter       = SDL_GPU_FILTER_LINEAR
+    engine_t const             &engine,
+    SDL_GPUSamplerAddressMode   address_mode = SDL_GPU_SAMPLERADDRESSMODE_REPEAT,
+    SDL_GPUFilter               filter       = SDL_GPU_FILTER_LINEAR,
+    std::source_location const &site         = std::source_location::current()
 );
 
 // Describes the shaders and resource bindings for a graphics pipeline.
@@ -225,10 +410,68 @@ struct pipeline_desc_t {
     SDL_GPUStencilOp stencil_fail_op       = SDL_GPU_STENCILOP_KEEP;
     SDL_GPUStencilOp stencil_depth_fail_op = SDL_GPU_STENCILOP_KEEP;
     SDL_GPUStencilOp stencil_pass_op       = SDL_GPU_STENCILOP_KEEP;
+    // One format per colour attachment for MRT passes. Empty means one swapchain-format target.
+    std::span<SDL_GPUTextureFormat const> color_target_formats = {};
+    // With enable_blend: ONE / ONE accumulation (light volumes) instead of alpha blending.
+    bool additive_blend = false;
+    // false masks every colour channel; only depth/stencil are written (depth pre-pass).
+    bool enable_color_write = true;
+    // POINTLIST needs gl_PointSize written by the vertex shader on Vulkan.
+    SDL_GPUPrimitiveType primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST;
+    // Samples per pixel of the attachments the pipeline renders to, colour and depth alike.
+    SDL_GPUSampleCount sample_count = SDL_GPU_SAMPLECOUNT_1;
+    // With sample_count > 1, the fragment's alpha decides how many of the pixel's samples it
+    // covers: alpha-tested edges come out antialiased without discard. Ignored without
+    // ALPHA_TO_COVERAGE.
+    bool alpha_to_coverage = false;
 };
 
-std::expected<gpu_pipeline_t, std::string>
-create_pipeline(engine_t const &engine, pipeline_desc_t const &desc);
+// SDL_GPUMultisampleState::enable_alpha_to_coverage is new in SDL 3.4.
+constexpr bool ALPHA_TO_COVERAGE = SDL_VERSION_ATLEAST(3, 4, 0);
+
+// The highest sample count up to `wanted` that both format and DEPTH_FORMAT support as render
+// targets; SDL_GPU_SAMPLECOUNT_1 where multisampling is not available at all.
+SDL_GPUSampleCount supported_sample_count(
+    engine_t const &engine, SDL_GPUTextureFormat format, SDL_GPUSampleCount wanted
+);
+
+std::expected<gpu_pipeline_t, std::string> create_pipeline(
+    engine_t const &engine, pipeline_desc_t const &desc,
+    std::source_location const &site = std::source_location::current()
+);
+
+// Depth pre-pass variants of a pipeline description. Both keep the vertex stage, vertex layout
+// and resource counts of desc, so the same draw code (uniform pushes, material bindings) works
+// unchanged and produces bit-identical depth.
+//   depth_prepass_desc: empty fragment shader, colour writes masked, depth written.
+//   depth_equal_desc:   original fragment shader, depth compare EQUAL, depth writes off; after
+//                       the pre-pass each visible pixel runs the fragment shader exactly once.
+// Alpha-tested geometry (discard) must not go through the pre-pass: its depth would be written
+// for discarded texels. Draw it with the original pipeline after the EQUAL pass instead.
+pipeline_desc_t depth_prepass_desc(pipeline_desc_t desc);
+pipeline_desc_t depth_equal_desc(pipeline_desc_t desc);
+
+struct prepass_pipelines_t {
+    gpu_pipeline_t depth; // from depth_prepass_desc
+    gpu_pipeline_t shade; // from depth_equal_desc
+};
+
+std::expected<prepass_pipelines_t, std::string> create_prepass_pipelines(
+    engine_t const &engine, pipeline_desc_t const &desc,
+    std::source_location const &site = std::source_location::current()
+);
+
+// Overdraw measurement variant: the fragment shader writes 1.0 into a single R16_FLOAT target
+// with additive blending, so after a pass every pixel holds the number of fragments that passed
+// the depth test there. Compose with depth_prepass_desc / depth_equal_desc to measure a
+// pre-pass. Use with count_fragments.
+pipeline_desc_t fragment_count_desc(pipeline_desc_t desc);
+
+// Renders draw into an offscreen window-sized R16_FLOAT target (with its own depth buffer),
+// waits for the GPU and returns the sum over all pixels: the number of fragment shader
+// invocations the pass would cost with early depth testing. Synchronous; call outside
+// render_frame (e.g. from update when the user asks for a measurement).
+std::expected<Uint64, std::string> count_fragments(engine_t const &engine, draw_fn const &draw);
 
 // Push a uniform value into the command buffer for the next draw call.
 // Works for float, glm::vec4, glm::mat4, SDL_FColor, and any other type
@@ -255,30 +498,38 @@ inline void push_fragment_uniform(SDL_GPUCommandBuffer *cmd, Uint32 slot, glm::v
 }
 
 // Vertex and index buffers for a single drawable piece of geometry.
+// The vertex and index data are not kept on the CPU once uploaded.
 struct gpu_geometry_t {
     gpu_buffer_t            vertex_buffer;
     gpu_buffer_t            index_buffer;           // empty when drawing without indices
     Uint32                  index_count        = 0; // > 0: SDL_DrawGPUIndexedPrimitives
     Uint32                  vertex_count       = 0; // > 0: SDL_DrawGPUPrimitives (non-indexed)
     SDL_GPUIndexElementSize index_element_size = SDL_GPU_INDEXELEMENTSIZE_16BIT;
+    Uint32                  vertex_bytes       = 0; // size of vertex_buffer
 };
 
+// GPU bytes of the vertex and index buffers.
+memory_usage_t memory_usage(gpu_geometry_t const &geometry);
+
 // Uploads vertices and 16-bit indices to the GPU in one shot.
 std::expected<gpu_geometry_t, std::string> create_geometry(
     engine_t const &engine, void const *vertices, Uint32 vertex_size,
-    std::span<uint16_t const> indices
+    std::span<uint16_t const> indices,
+    std::source_location const &site = std::source_location::current()
 );
 
 // Uploads vertices and 32-bit indices to the GPU in one shot.
 // Use when index values exceed 65535 (e.g. large loaded models).
 std::expected<gpu_geometry_t, std::string> create_geometry(
     engine_t const &engine, void const *vertices, Uint32 vertex_size,
-    std::span<uint32_t const> indices
+    std::span<uint32_t const> indices,
+    std::source_location const &site = std::source_location::current()
 );
 
 // Uploads vertices only (no index buffer) for glDrawArrays-style drawing.
 std::expected<gpu_geometry_t, std::string> create_vertex_geometry(
-    engine_t const &engine, void const *vertices, Uint32 vertex_size, Uint32 vertex_count
+    engine_t const &engine, void const *vertices, Uint32 vertex_size, Uint32 vertex_count,
+    std::source_location const &site = std::source_location::current()
 );
 
 // Textures and their paired samplers for a draw call.
@@ -294,8 +545,10 @@ struct material_desc_t {
     std::vector<SDL_GPUFilter>             filter_modes;
 };
 
-std::expected<gpu_material_t, std::string>
-create_material(engine_t const &engine, material_desc_t desc);
+std::expected<gpu_material_t, std::string> create_material(
+    engine_t const &engine, material_desc_t desc,
+    std::source_location const &site = std::source_location::current()
+);
 
 // A pipeline, geometry, and material assembled into one drawable unit.
 struct textured_mesh_t {
@@ -335,6 +588,9 @@ private:
 
 // Per-frame input snapshot delivered by run_loop to the update callback.
 // dy is already negated for screen-Y-down convention.
+// With a fixed simulation rate (frame_pacing_t::simulation_hz) update still runs once per
+// frame: it advances the simulation `steps` times by `step` and keeps `alpha` to draw between
+// the last two states. Without one, steps is 1, step is dt and alpha is 1.
 struct input_t {
     bool const *keys;
     float       dx;
@@ -342,8 +598,14 @@ struct input_t {
     float       scroll;
     float       dt;
     float       aspect_ratio;
+    int         steps;
+    float       step;
+    float       alpha;
 };
 
+// Every run_loop overload polls events, runs update, then acquires the swapchain and submits;
+// with present_config_t::late_latch the swapchain wait moves before polling instead.
+
 // Single-pass event loop: manages depth internally; draws to the swapchain each frame.
 // Quits on SDL_EVENT_QUIT only (no update callback).
 std::expected<void, std::string> run_loop(engine_t &engine, SDL_FColor clear_color, draw_fn draw);
@@ -370,6 +632,37 @@ std::expected<void, std::string> run_loop(
     std::span<pass_desc_t> passes
 );
 
+// Variant for passes that render into several tracked targets (e.g. a G-buffer): every entry
+// of color_targets is updated each frame alongside depth.
+std::expected<void, std::string> run_loop(
+    engine_t &engine, std::function<SDL_FColor()> get_clear_color, tracked_depth_t &depth,
+    std::span<tracked_color_target_t> color_targets, std::function<bool(input_t const &)> update,
+    std::span<pass_desc_t> passes
+);
+
+// Variant whose frame interleaves compute passes with the render passes.
+std::expected<void, std::string> run_loop(
+    engine_t &engine, std::function<SDL_FColor()> get_clear_color, tracked_depth_t &depth,
+    std::span<tracked_color_target_t> color_targets, std::function<bool(input_t const &)> update,
+    std::span<frame_pass_t> passes
+);
+
+// Stages of run_pipeline_loop. slot (0 or 1) names the snapshot buffer a stage works on: update
+// fills one while render reads the other, so the two never share one.
+struct pipeline_stages_t {
+    std::function<bool(input_t const &)>           ui;     // main thread, ImGui; false quits
+    std::function<void(input_t const &, int slot)> update; // worker thread, no ImGui or GPU
+    std::function<void(int slot, SDL_GPUCommandBuffer *, SDL_GPURenderPass *)> render; // main
+};
+
+// Two-stage loop: while the main thread records and submits frame N from its snapshot, a worker
+// thread runs update for frame N+1, so a CPU-heavy update overlaps command recording instead of
+// leaving the GPU idle behind it. Each snapshot is drawn a frame after its input was sampled,
+// which late latching cannot help with, so present_config_t::late_latch is ignored here. With
+// engine_t::pipelined off (--no-pipeline) the same stages run serially, for comparison.
+std::expected<void, std::string>
+run_pipeline_loop(engine_t &engine, SDL_FColor clear_color, pipeline_stages_t stages);
+
 // FPS camera with Euler angles. Derives front/right/up axes on every update.
 // process_mouse expects dy already negated for screen-Y-down convention.
 struct camera_t {
@@ -485,3 +778,32 @@ std::expected<void, std::string> run_app(
         [&](SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) { scene->render(cmd, pass); }
     );
 }
+
+// Scene for run_pipelined: update builds an immutable snapshot from input on the worker thread
+// and must not touch anything render reads; render records a frame from a snapshot; ui runs on
+// the main thread (ImGui, quitting) before update is handed its input.
+template <typename SceneT>
+concept pipelined_scene_t = requires(
+    SceneT &scene, input_t const &in, SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass
+) {
+    { scene.ui(in) } -> std::convertible_to<bool>;
+    scene.render(scene.update(in), cmd, pass);
+};
+
+template <pipelined_scene_t SceneT>
+std::expected<void, std::string>
+run_pipelined(engine_t &engine, SDL_FColor clear_color, SceneT &scene) {
+    using snapshot_t = decltype(scene.update(std::declval<input_t const &>()));
+    std::array<snapshot_t, 2> snapshots{};
+    return run_pipeline_loop(
+        engine, clear_color,
+        {
+            .ui     = [&](input_t const &in) { return scene.ui(in); },
+            .update = [&](input_t const &in, int slot) { snapshots[slot] = scene.update(in); },
+            .render =
+                [&](int slot, SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
+                    scene.render(std::as_const(snapshots[slot]), cmd, pass);
+                },
+        }
+    );
+}
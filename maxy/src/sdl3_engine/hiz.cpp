@@ -0,0 +1,309 @@
+#include "hiz.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace {
+
+constexpr Uint32 CULL_GROUP_SIZE   = 64; // hiz_cull.comp local_size_x
+constexpr Uint32 REDUCE_GROUP_SIZE = 8;  // hiz_reduce.comp local_size_x and local_size_y
+
+// Matches the CullParams uniform block in hiz_cull.comp (std140).
+struct cull_params_t {
+    glm::mat4 view_proj;
+    glm::mat4 pyramid_view_proj;
+    glm::vec4 planes[6];
+    Uint32    instance_count;
+    Uint32    phase;
+    Uint32    occlusion;
+    Uint32    pad;
+};
+
+glm::ivec2 level_size(glm::ivec2 size, Uint32 level) {
+    return glm::max(glm::ivec2(size.x >> level, size.y >> level), glm::ivec2(1));
+}
+
+// Sampled-only mip chain; levels are filled by copies from the scratch storage textures.
+std::expected<gpu_texture_t, std::string>
+create_pyramid_texture(engine_t const &engine, glm::ivec2 size, Uint32 levels) {
+    SDL_GPUTextureCreateInfo info = {};
+    info.type                     = SDL_GPU_TEXTURETYPE_2D;
+    info.format                   = SDL_GPU_TEXTUREFORMAT_R32_FLOAT;
+    info.usage                    = SDL_GPU_TEXTUREUSAGE_SAMPLER;
+    info.width                    = static_cast<Uint32>(size.x);
+    info.height                   = static_cast<Uint32>(size.y);
+    info.layer_count_or_depth     = 1;
+    info.num_levels               = levels;
+
+    SDL_GPUTexture *tex = SDL_CreateGPUTexture(engine.gpu_device, &info);
+    if (!tex) return sdl_error("SDL_CreateGPUTexture (hi-z) failed");
+    return gpu_texture_t{engine.gpu_device, tex, gpu_texture_bytes(info)};
+}
+
+std::expected<hiz_pyramid_t, std::string>
+create_pyramid(engine_t const &engine, glm::ivec2 size) {
+    size = glm::max(size, glm::ivec2(1));
+
+    // Full chain down to 1x1: floor(log2(largest side)) + 1 levels.
+    Uint32 const largest = static_cast<Uint32>(std::max(size.x, size.y));
+
+    hiz_pyramid_t pyramid;
+    pyramid.size   = size;
+    pyramid.levels = static_cast<Uint32>(std::bit_width(largest));
+
+    auto texture = create_pyramid_texture(engine, size, pyramid.levels);
+    if (!texture) return std::unexpected(texture.error());
+    pyramid.texture = std::move(*texture);
+
+    for (Uint32 level = 0; level < pyramid.levels; ++level) {
+        glm::ivec2 const extent  = level_size(size, level);
+        auto             scratch = create_storage_texture(
+            engine, extent.x, extent.y, SDL_GPU_TEXTUREFORMAT_R32_FLOAT
+        );
+        if (!scratch) return std::unexpected(scratch.error());
+        pyramid.scratch.push_back(std::move(*scratch));
+    }
+    return pyramid;
+}
+
+void dispatch_cull(
+    hiz_culler_t const &culler, SDL_GPUCommandBuffer *cmd, Uint32 phase,
+    glm::mat4 const &view_proj, bool occlusion
+) {
+    cull_params_t params = {
+        .view_proj         = view_proj,
+        .pyramid_view_proj = culler.pyramid_view_proj,
+        .instance_count    = culler.instance_count,
+        .phase             = phase,
+        .occlusion         = occlusion ? 1u : 0u,
+    };
+    std::ranges::copy(frustum_planes(view_proj), params.planes);
+
+    std::array<SDL_GPUStorageBufferReadWriteBinding, 3> const outputs = {{
+        {.buffer = culler.drawn.get()},
+        {.buffer = culler.visible.get()},
+        {.buffer = culler.commands.get()},
+    }};
+    SDL_GPUComputePass *pass = SDL_BeginGPUComputePass(
+        cmd, nullptr, 0, outputs.data(), static_cast<Uint32>(outputs.size())
+    );
+    SDL_BindGPUComputePipeline(pass, culler.cull_pipeline.get());
+
+    // Always bound (the layout requires it); only sampled when occlusion is set.
+    SDL_GPUTextureSamplerBinding pyramid = {
+        culler.pyramid.texture.get(), culler.point_sampler.get()
+    };
+    SDL_BindGPUComputeSamplers(pass, 0, &pyramid, 1);
+    SDL_GPUBuffer *instances = culler.instances.get();
+    SDL_BindGPUComputeStorageBuffers(pass, 0, &instances, 1);
+    SDL_PushGPUComputeUniformData(cmd, 0, &params, sizeof(params));
+
+    Uint32 const groups = (culler.instance_count + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE;
+    SDL_DispatchGPUCompute(pass, groups, 1, 1);
+    SDL_EndGPUComputePass(pass);
+}
+
+} // namespace
+
+std::array<glm::vec4, 6> frustum_planes(glm::mat4 const &view_proj) {
+    auto const row = [&](int i) {
+        return glm::vec4(view_proj[0][i], view_proj[1][i], view_proj[2][i], view_proj[3][i]);
+    };
+    std::array<glm::vec4, 6> planes = {
+        row(3) + row(0), // left
+        row(3) - row(0), // right
+        row(3) + row(1), // bottom
+        row(3) - row(1), // top
+        row(2),          // near: SDL GPU keeps 0 <= z, not -w <= z
+        row(3) - row(2), // far
+    };
+    for (auto &plane : planes) plane /= glm::length(glm::vec3(plane));
+    return planes;
+}
+
+std::expected<hiz_culler_t, std::string> create_hiz_culler(
+    engine_t const &engine, std::span<hiz_instance_t const> instances, Uint32 index_count
+) {
+    hiz_culler_t culler;
+    culler.instance_count = static_cast<Uint32>(instances.size());
+
+    auto reduce_pipeline =
+        create_compute_pipeline(engine, "shaders/sdl3_engine/hiz_reduce.comp.spv");
+    if (!reduce_pipeline) return std::unexpected(reduce_pipeline.error());
+    culler.reduce_pipeline = std::move(*reduce_pipeline);
+
+    auto cull_pipeline = create_compute_pipeline(engine, "shaders/sdl3_engine/hiz_cull.comp.spv");
+    if (!cull_pipeline) return std::unexpected(cull_pipeline.error());
+    culler.cull_pipeline = std::move(*cull_pipeline);
+
+    auto sampler = create_sampler(
+        engine, SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE, SDL_GPU_FILTER_NEAREST
+    );
+    if (!sampler) return std::unexpected(sampler.error());
+    culler.point_sampler = std::move(*sampler);
+
+    auto pyramid = create_pyramid(engine, window_pixel_size(engine));
+    if (!pyramid) return std::unexpected(pyramid.error());
+    culler.pyramid = std::move(*pyramid);
+
+    Uint32 const instance_bytes = culler.instance_count * sizeof(hiz_instance_t);
+
+    auto instance_buffer = create_gpu_buffer(
+        engine, SDL_GPU_BUFFERUSAGE_VERTEX | SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ,
+        instance_bytes, instances.data()
+    );
+    if (!instance_buffer) return std::unexpected(instance_buffer.error());
+    culler.instances = std::move(*instance_buffer);
+
+    auto drawn = create_gpu_buffer(
+        engine,
+        SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ | SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE,
+        culler.instance_count * sizeof(Uint32)
+    );
+    if (!drawn) return std::unexpected(drawn.error());
+    culler.drawn = std::move(*drawn);
+
+    auto visible = create_gpu_buffer(
+        engine, SDL_GPU_BUFFERUSAGE_VERTEX | SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE,
+        2 * instance_bytes
+    );
+    if (!visible) return std::unexpected(visible.error());
+    culler.visible = std::move(*visible);
+
+    // Instance counts start at zero every frame; the shaders only ever increment them.
+    std::array<SDL_GPUIndexedIndirectDrawCommand, 2> const initial = {{
+        {.num_indices = index_count},
+        {.num_indices = index_count},
+    }};
+    auto commands = create_gpu_buffer(
+        engine,
+        SDL_GPU_BUFFERUSAGE_INDIRECT | SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ |
+            SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE,
+        sizeof(initial), initial.data()
+    );
+    if (!commands) return std::unexpected(commands.error());
+    culler.commands = std::move(*commands);
+
+    SDL_GPUTransferBufferCreateInfo transfer_info = {};
+    transfer_info.usage                           = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
+    transfer_info.size                            = sizeof(initial);
+    culler.commands_reset                         = {
+        engine.gpu_device, SDL_CreateGPUTransferBuffer(engine.gpu_device, &transfer_info),
+        transfer_info.size
+    };
+    if (!culler.commands_reset) return sdl_error("SDL_CreateGPUTransferBuffer failed");
+
+    void *mapped = SDL_MapGPUTransferBuffer(engine.gpu_device, culler.commands_reset.get(), false);
+    if (!mapped) return sdl_error("SDL_MapGPUTransferBuffer failed");
+    std::memcpy(mapped, initial.data(), sizeof(initial));
+    SDL_UnmapGPUTransferBuffer(engine.gpu_device, culler.commands_reset.get());
+
+    return culler;
+}
+
+void hiz_culler_t::cull_phase1(SDL_GPUCommandBuffer *cmd, glm::mat4 const &view_proj) {
+    SDL_GPUTransferBufferLocation source = {};
+    source.transfer_buffer               = commands_reset.get();
+
+    SDL_GPUBufferRegion destination = {};
+    destination.buffer              = commands.get();
+    destination.size                = 2 * sizeof(SDL_GPUIndexedIndirectDrawCommand);
+
+    SDL_GPUCopyPass *copy_pass = SDL_BeginGPUCopyPass(cmd);
+    SDL_UploadToGPUBuffer(copy_pass, &source, &destination, false);
+    SDL_EndGPUCopyPass(copy_pass);
+
+    bool const occlusion = mode == hiz_mode_t::occlusion && pyramid.valid;
+    dispatch_cull(*this, cmd, 0, view_proj, occlusion);
+}
+
+void hiz_culler_t::cull_phase2(
+    engine_t const &engine, SDL_GPUCommandBuffer *cmd, tracked_depth_t const &depth,
+    glm::mat4 const &view_proj
+) {
+    // Frustum-only mode draws everything in phase 1, and the pyramid goes stale.
+    if (mode != hiz_mode_t::occlusion) {
+        pyramid.valid = false;
+        return;
+    }
+
+    if (pyramid.size != depth.size) {
+        auto resized = create_pyramid(engine, depth.size);
+        if (!resized) {
+            pyramid.valid = false;
+            return;
+        }
+        pyramid = std::move(*resized);
+    }
+
+    // Level 0 copies depth (same size); each later level takes the max of the 2x2 (3x3 at odd
+    // edges) texels beneath it.
+    for (Uint32 level = 0; level < pyramid.levels; ++level) {
+        SDL_GPUStorageTextureReadWriteBinding target = {};
+        target.texture                               = pyramid.scratch[level].get();
+
+        SDL_GPUComputePass *pass = SDL_BeginGPUComputePass(cmd, &target, 1, nullptr, 0);
+        SDL_BindGPUComputePipeline(pass, reduce_pipeline.get());
+        SDL_GPUTextureSamplerBinding source = {
+            level == 0 ? depth.texture.get() : pyramid.scratch[level - 1].get(),
+            point_sampler.get()
+        };
+        SDL_BindGPUComputeSamplers(pass, 0, &source, 1);
+        glm::ivec2 const size = level_size(pyramid.size, level);
+        SDL_DispatchGPUCompute(
+            pass, (static_cast<Uint32>(size.x) + REDUCE_GROUP_SIZE - 1) / REDUCE_GROUP_SIZE,
+            (static_cast<Uint32>(size.y) + REDUCE_GROUP_SIZE - 1) / REDUCE_GROUP_SIZE, 1
+        );
+        SDL_EndGPUComputePass(pass);
+    }
+
+    SDL_GPUCopyPass *copy_pass = SDL_BeginGPUCopyPass(cmd);
+    for (Uint32 level = 0; level < pyramid.levels; ++level) {
+        SDL_GPUTextureLocation source = {};
+        source.texture                = pyramid.scratch[level].get();
+
+        SDL_GPUTextureLocation destination = {};
+        destination.texture                = pyramid.texture.get();
+        destination.mip_level              = level;
+
+        glm::ivec2 const size = level_size(pyramid.size, level);
+        SDL_CopyGPUTextureToTexture(
+            copy_pass, &source, &destination, static_cast<Uint32>(size.x),
+            static_cast<Uint32>(size.y), 1, false
+        );
+    }
+    SDL_EndGPUCopyPass(copy_pass);
+
+    pyramid.valid     = true;
+    pyramid_view_proj = view_proj;
+    dispatch_cull(*this, cmd, 1, view_proj, true);
+}
+
+void hiz_culler_t::draw(
+    Uint32 phase, gpu_geometry_t const &geometry,
+    std::span<SDL_GPUTextureSamplerBinding const> samplers, SDL_GPURenderPass *pass
+) const {
+    std::array<SDL_GPUBufferBinding, 2> const vertex_bindings = {{
+        {geometry.vertex_buffer.get(), 0},
+        {visible.get(), phase * instance_count * static_cast<Uint32>(sizeof(hiz_instance_t))},
+    }};
+    SDL_BindGPUVertexBuffers(
+        pass, 0, vertex_bindings.data(), static_cast<Uint32>(vertex_bindings.size())
+    );
+    SDL_GPUBufferBinding index_binding = {geometry.index_buffer.get(), 0};
+    SDL_BindGPUIndexBuffer(pass, &index_binding, geometry.index_element_size);
+    SDL_BindGPUFragmentSamplers(pass, 0, samplers.data(), static_cast<Uint32>(samplers.size()));
+
+    Uint32 const command_offset = phase * sizeof(SDL_GPUIndexedIndirectDrawCommand);
+    SDL_DrawGPUIndexedPrimitivesIndirect(pass, commands.get(), command_offset, 1);
+}
+
+std::expected<std::array<Uint32, 2>, std::string>
+hiz_culler_t::read_counts(engine_t const &engine) const {
+    std::array<SDL_GPUIndexedIndirectDrawCommand, 2> drawn_commands;
+    auto bytes = download_buffer(engine, commands, sizeof(drawn_commands));
+    if (!bytes) return std::unexpected(bytes.error());
+    std::memcpy(drawn_commands.data(), bytes->data(), sizeof(drawn_commands));
+    return std::array<Uint32, 2>{drawn_commands[0].num_instances, drawn_commands[1].num_instances};
+}
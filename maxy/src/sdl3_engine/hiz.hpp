@@ -0,0 +1,125 @@
+#pragma once
+#include <array>
+#include <expected>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "engine.hpp"
+
+// Hierarchical-Z occlusion culling of instanced geometry, entirely on the GPU.
+//
+// Each frame runs in two phases around a render pass split:
+//   phase 1 (before the first pass): every instance is frustum tested and then tested against
+//            the Hi-Z pyramid left by the previous frame, projected with that frame's camera.
+//            Survivors are appended to the phase-1 visible list and drawn in the first pass.
+//   pyramid: after the first pass, its depth (planet plus phase-1 instances) is reduced into a
+//            max-depth mip chain.
+//   phase 2: instances rejected in phase 1 are retested against the fresh pyramid with the
+//            current camera and drawn in a second pass that loads colour and depth.
+// Phase 2 catches disocclusions (objects hidden last frame but visible now), so the previous
+// frame's depth never causes popping; the pyramid it builds is next frame's phase-1 input.
+//
+// Visible lists are compacted copies of hiz_instance_t, bound as an instance-rate vertex buffer
+// (see hiz_instance_buffer_descs) and drawn with SDL_DrawGPUIndexedPrimitivesIndirect; the CPU
+// never reads the results back.
+
+// Matches struct instance_t in hiz_cull.comp (std430).
+struct hiz_instance_t {
+    glm::mat4 model;
+    glm::vec4 sphere; // world-space bounding sphere: centre (xyz), radius (w)
+};
+
+// Instance-rate vertex buffer in slot 1: model matrix columns at locations 3..6.
+// Use together with a per-vertex layout in slot 0 (e.g. pos_normal_uv_vertex_t).
+inline constexpr SDL_GPUVertexBufferDescription hiz_instance_buffer_descs[] = {
+    {.slot       = 0,
+     .pitch      = sizeof(pos_normal_uv_vertex_t),
+     .input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX},
+    {.slot       = 1,
+     .pitch      = sizeof(hiz_instance_t),
+     .input_rate = SDL_GPU_VERTEXINPUTRATE_INSTANCE},
+};
+
+inline constexpr SDL_GPUVertexAttribute hiz_instance_vertex_attributes[] = {
+    {.location    = 0,
+     .buffer_slot = 0,
+     .format      = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
+     .offset      = static_cast<Uint32>(offsetof(pos_normal_uv_vertex_t, position))},
+    {.location    = 1,
+     .buffer_slot = 0,
+     .format      = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
+     .offset      = static_cast<Uint32>(offsetof(pos_normal_uv_vertex_t, normal))},
+    {.location    = 2,
+     .buffer_slot = 0,
+     .format      = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT2,
+     .offset      = static_cast<Uint32>(offsetof(pos_normal_uv_vertex_t, uv))},
+    {.location = 3, .buffer_slot = 1, .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4, .offset = 0},
+    {.location = 4, .buffer_slot = 1, .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4, .offset = 16},
+    {.location = 5, .buffer_slot = 1, .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4, .offset = 32},
+    {.location = 6, .buffer_slot = 1, .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4, .offset = 48},
+};
+
+// Max-depth mip chain of a depth buffer (R32_FLOAT, level 0 = depth size). Levels are built in
+// per-level scratch textures and copied into texture, because a compute pass cannot sample one
+// mip of a texture while writing another.
+struct hiz_pyramid_t {
+    gpu_texture_t              texture;
+    std::vector<gpu_texture_t> scratch;
+    glm::ivec2                 size   = {0, 0};
+    Uint32                     levels = 0;
+    bool                       valid  = false; // false until built once at the current size
+};
+
+enum class hiz_mode_t {
+    frustum,   // frustum culling only: everything is drawn in phase 1
+    occlusion, // frustum plus two-phase Hi-Z occlusion
+};
+
+struct hiz_culler_t {
+    gpu_compute_pipeline_t reduce_pipeline;
+    gpu_compute_pipeline_t cull_pipeline;
+    gpu_sampler_t          point_sampler;
+    hiz_pyramid_t          pyramid;
+
+    gpu_buffer_t instances; // hiz_instance_t[instance_count], also usable as a vertex buffer
+    gpu_buffer_t drawn;     // uint per instance: drawn in phase 1
+    gpu_buffer_t visible;   // hiz_instance_t[2 * instance_count]: phase 1, then phase 2
+    gpu_buffer_t commands;  // two SDL_GPUIndexedIndirectDrawCommand, one per phase
+    gpu_resource_t<SDL_GPUTransferBuffer, SDL_ReleaseGPUTransferBuffer> commands_reset;
+
+    Uint32     instance_count = 0;
+    hiz_mode_t mode           = hiz_mode_t::occlusion;
+    glm::mat4  pyramid_view_proj{1.0f}; // camera that rendered the pyramid's depth
+
+    // Resets the indirect commands and runs phase 1. Call from the first pass's prepare.
+    void cull_phase1(SDL_GPUCommandBuffer *cmd, glm::mat4 const &view_proj);
+
+    // Builds the pyramid from the first pass's depth and runs phase 2. Call from the second
+    // pass's prepare. depth must be sampleable and stored by the first pass.
+    void cull_phase2(
+        engine_t const &engine, SDL_GPUCommandBuffer *cmd, tracked_depth_t const &depth,
+        glm::mat4 const &view_proj
+    );
+
+    // Binds geometry (indexed) plus one phase's visible list (0 = phase 1, 1 = phase 2), binds
+    // samplers to fragment slots 0..N-1 and issues the indirect draw. The pipeline must use
+    // hiz_instance_buffer_descs.
+    void draw(
+        Uint32 phase, gpu_geometry_t const &geometry,
+        std::span<SDL_GPUTextureSamplerBinding const> samplers, SDL_GPURenderPass *pass
+    ) const;
+
+    // Instances drawn by phase 1 and phase 2 in the last submitted frame. Synchronous readback.
+    std::expected<std::array<Uint32, 2>, std::string> read_counts(engine_t const &engine) const;
+};
+
+// index_count is the index count of the geometry the instances will be drawn with; it is baked
+// into the indirect commands.
+std::expected<hiz_culler_t, std::string> create_hiz_culler(
+    engine_t const &engine, std::span<hiz_instance_t const> instances, Uint32 index_count
+);
+
+// Clip planes (xyz = inward normal, w = distance) of a GL-style view-projection, with the near
+// plane at clip z = 0 where SDL GPU clips depth.
+std::array<glm::vec4, 6> frustum_planes(glm::mat4 const &view_proj);
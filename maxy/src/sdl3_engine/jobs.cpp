@@ -0,0 +1,203 @@
+#include "jobs.hpp"
+
+#include <algorithm>
+
+namespace {
+
+constexpr size_t no_queue = static_cast<size_t>(-1);
+
+// Which system the current thread works for, and its queue there.
+thread_local job_system_t const *t_system = nullptr;
+thread_local size_t              t_queue  = no_queue;
+
+} // namespace
+
+unsigned job_system_t::default_worker_count() {
+    unsigned const cores = std::thread::hardware_concurrency();
+    return cores > 1 ? cores - 1 : 1;
+}
+
+job_system_t::job_system_t(unsigned worker_count) : m_main_thread(std::this_thread::get_id()) {
+    for (unsigned i = 0; i <= worker_count; ++i)
+        m_queues.push_back(std::make_unique<queue_t>());
+    m_workers.reserve(worker_count);
+    for (unsigned i = 0; i < worker_count; ++i)
+        m_workers.emplace_back([this, i](std::stop_token stop) { work(stop, i); });
+}
+
+job_system_t::~job_system_t() {
+    for (auto &worker : m_workers)
+        worker.request_stop();
+    m_idle.notify_all();
+}
+
+size_t job_system_t::own_queue() const {
+    return t_system == this ? t_queue : m_queues.size() - 1;
+}
+
+void job_system_t::run(job_fn fn, job_counter_t *counter, job_thread_t thread) {
+    if (counter) counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    push({std::move(fn), counter}, thread);
+}
+
+void job_system_t::run_after(
+    job_counter_t &dependency, job_fn fn, job_counter_t *counter, job_thread_t thread
+) {
+    if (counter) counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard lock(dependency.m_mutex);
+        if (!dependency.done()) {
+            dependency.m_continuations.push_back({std::move(fn), counter, thread});
+            return;
+        }
+    }
+    push({std::move(fn), counter}, thread);
+}
+
+void job_system_t::push(job_t job, job_thread_t thread) {
+    if (thread == job_thread_t::main) {
+        std::lock_guard lock(m_main_jobs.mutex);
+        m_main_jobs.jobs.push_back(std::move(job));
+        return;
+    }
+
+    auto &queue = *m_queues[own_queue()];
+    {
+        std::lock_guard lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+    m_queued.fetch_add(1, std::memory_order_release);
+    // Taking the mutex orders this with a worker that has checked m_queued and is about to sleep.
+    { std::lock_guard lock(m_idle_mutex); }
+    m_idle.notify_one();
+}
+
+// Own queue from the back, then the main jobs when on the main thread, then everyone else's
+// from the front, starting after our own so thieves spread out.
+bool job_system_t::run_one() {
+    job_t        job{};
+    bool         found = false;
+    size_t const self  = own_queue();
+
+    {
+        auto           &queue = *m_queues[self];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+            found = true;
+        }
+    }
+    bool main_job = false;
+    if (!found && on_main_thread()) {
+        std::lock_guard lock(m_main_jobs.mutex);
+        if (!m_main_jobs.jobs.empty()) {
+            job = std::move(m_main_jobs.jobs.front());
+            m_main_jobs.jobs.pop_front();
+            found = main_job = true;
+        }
+    }
+    for (size_t i = 1; !found && i < m_queues.size(); ++i) {
+        auto           &queue = *m_queues[(self + i) % m_queues.size()];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+            found = true;
+        }
+    }
+    if (!found) return false;
+
+    if (!main_job) m_queued.fetch_sub(1, std::memory_order_relaxed);
+    job.fn();
+    finish(job.counter);
+    return true;
+}
+
+void job_system_t::finish(job_counter_t *counter) {
+    if (!counter) return;
+
+    std::vector<job_counter_t::continuation_t> ready;
+    {
+        // Decrementing under the lock lets wait() make sure we are done with the counter before
+        // its owner destroys it.
+        std::lock_guard lock(counter->m_mutex);
+        if (counter->m_pending.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+        ready.swap(counter->m_continuations);
+    }
+    for (auto &next : ready)
+        push({std::move(next.fn), next.counter}, next.thread);
+}
+
+void job_system_t::wait(job_counter_t &counter) {
+    while (!counter.done()) {
+        if (!run_one()) std::this_thread::yield();
+    }
+    std::lock_guard lock(counter.m_mutex);
+}
+
+size_t job_system_t::run_main_jobs() {
+    size_t ran = 0;
+    while (true) {
+        job_t job{};
+        {
+            std::lock_guard lock(m_main_jobs.mutex);
+            if (m_main_jobs.jobs.empty()) return ran;
+            job = std::move(m_main_jobs.jobs.front());
+            m_main_jobs.jobs.pop_front();
+        }
+        job.fn();
+        finish(job.counter);
+        ++ran;
+    }
+}
+
+void job_system_t::work(std::stop_token stop, size_t index) {
+    t_system = this;
+    t_queue  = index;
+    while (!stop.stop_requested()) {
+        if (run_one()) continue;
+        std::unique_lock lock(m_idle_mutex);
+        m_idle.wait(lock, stop, [this] { return m_queued.load(std::memory_order_acquire) > 0; });
+    }
+}
+
+void job_system_t::parallel_for(
+    size_t begin, size_t end, std::function<void(size_t, size_t)> const &fn, size_t grain
+) {
+    if (begin >= end) return;
+    if (grain == 0) {
+        // Enough pieces for every thread to steal several times, few enough to stay cheap.
+        size_t const threads = m_workers.size() + 1;
+        grain                = std::max<size_t>(1, (end - begin) / (threads * 16));
+    }
+
+    job_counter_t counter;
+    run_range(fn, counter, grain, begin, end);
+    wait(counter);
+}
+
+void job_system_t::run_range(
+    std::function<void(size_t, size_t)> const &fn, job_counter_t &counter, size_t grain,
+    size_t begin, size_t end
+) {
+    while (end - begin > grain) {
+        // Nothing queued anywhere means any idle worker would find nothing to steal.
+        if (end - begin >= 2 * grain && m_queued.load(std::memory_order_relaxed) == 0) {
+            size_t const middle = begin + (end - begin) / 2;
+            run([this, &fn, &counter, grain, middle, end] {
+                run_range(fn, counter, grain, middle, end);
+            }, &counter);
+            end = middle;
+            continue;
+        }
+        fn(begin, begin + grain);
+        begin += grain;
+    }
+    fn(begin, end);
+}
+
+job_system_t &default_job_system() {
+    static job_system_t system;
+    return system;
+}
@@ -0,0 +1,122 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing job system. Only needs the standard library, so the GL samples link it too
+// (the JOBS target in src/CMakeLists.txt).
+//
+// Every worker owns a deque: jobs queued from a worker go to the back of its own deque and it
+// pops from the back (most recent, still in cache); idle workers steal from the front of the
+// others. Jobs queued from other threads land in a shared injection queue. Jobs marked
+// job_thread_t::main are kept apart and only run on the thread that created the system, from
+// wait() or run_main_jobs(): that is where SDL_GPU and GL calls have to happen.
+
+enum class job_thread_t { any, main };
+
+using job_fn = std::function<void()>;
+
+class job_system_t;
+
+// Outstanding jobs of a group. run() increments it when the job is queued and the job decrements
+// it when done; wait() and run_after() key off it reaching zero. Reusable once zero, and must
+// outlive the jobs it counts: wait() on it before it goes out of scope.
+class job_counter_t {
+public:
+    job_counter_t()                                 = default;
+    job_counter_t(job_counter_t const &)            = delete;
+    job_counter_t &operator=(job_counter_t const &) = delete;
+
+    bool done() const { return m_pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class job_system_t;
+
+    struct continuation_t {
+        job_fn         fn;
+        job_counter_t *counter;
+        job_thread_t   thread;
+    };
+
+    std::atomic<int>            m_pending{0};
+    std::mutex                  m_mutex; // guards m_continuations and the last decrement
+    std::vector<continuation_t> m_continuations;
+};
+
+class job_system_t {
+public:
+    // hardware_concurrency() - 1: the main thread is the remaining core, helping from wait().
+    static unsigned default_worker_count();
+
+    // Zero workers is valid: every job then runs on the thread that waits for it.
+    explicit job_system_t(unsigned worker_count = default_worker_count());
+    // Joins the workers. Jobs still queued are dropped, so wait for them first.
+    ~job_system_t();
+
+    job_system_t(job_system_t const &)            = delete;
+    job_system_t &operator=(job_system_t const &) = delete;
+
+    void run(job_fn fn, job_counter_t *counter = nullptr, job_thread_t thread = job_thread_t::any);
+    // Queues fn once `dependency` reaches zero; straight away when it already has. `counter`
+    // counts it from now, so waiting on it also waits for the dependency.
+    void run_after(
+        job_counter_t &dependency, job_fn fn, job_counter_t *counter = nullptr,
+        job_thread_t thread = job_thread_t::any
+    );
+
+    // Runs other jobs until `counter` reaches zero. On the main thread that includes main jobs.
+    void wait(job_counter_t &counter);
+    // Main thread only: runs the main jobs queued so far; returns how many ran.
+    size_t run_main_jobs();
+
+    // Calls fn(first, last) over disjoint subranges covering [begin, end) and returns once all
+    // have run, the calling thread taking part. The range is split lazily: a piece hands the
+    // upper half of what it has left to the pool only while nothing else is queued for idle
+    // workers to steal, so a balanced loop costs a handful of jobs rather than one per grain.
+    // grain 0 picks one from the range and the worker count.
+    void parallel_for(
+        size_t begin, size_t end, std::function<void(size_t, size_t)> const &fn, size_t grain = 0
+    );
+
+    unsigned worker_count() const { return static_cast<unsigned>(m_workers.size()); }
+    bool     on_main_thread() const { return std::this_thread::get_id() == m_main_thread; }
+
+private:
+    struct job_t {
+        job_fn         fn;
+        job_counter_t *counter;
+    };
+    struct queue_t {
+        std::mutex        mutex;
+        std::deque<job_t> jobs;
+    };
+
+    std::thread::id m_main_thread;
+    // One per worker, then the injection queue for jobs queued from other threads.
+    std::vector<std::unique_ptr<queue_t>> m_queues;
+    queue_t                               m_main_jobs;
+    std::atomic<size_t>                   m_queued{0}; // jobs in m_queues, for idle workers
+    std::mutex                            m_idle_mutex;
+    std::condition_variable_any           m_idle;
+    std::vector<std::jthread>             m_workers; // last: joined before the queues go
+
+    size_t own_queue() const;
+    void   push(job_t job, job_thread_t thread);
+    bool   run_one();
+    void   finish(job_counter_t *counter);
+    void   work(std::stop_token stop, size_t index);
+    void   run_range(
+        std::function<void(size_t, size_t)> const &fn, job_counter_t &counter, size_t grain,
+        size_t begin, size_t end
+    );
+};
+
+// Process-wide instance with default_worker_count() workers. The first call decides which thread
+// is the main thread, so make it from there.
+job_system_t &default_job_system();
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <span>
 
 #include <SDL3/SDL.h>
 #include <glm/glm.hpp>
@@ -131,3 +133,46 @@ template <int N> struct pos_lights_block_t {
 template <int N> struct spot_lights_block_t {
     std::array<spot_light_uniforms_t, N> lights;
 };
+
+// The first N lights as a uniform block, positions made relative to camera for the
+// camera-relative samples; entries past the lights are left as they are. Called every frame.
+template <int N>
+pos_lights_block_t<N>
+pack_pos_lights(std::span<pos_light_state_t const> lights, glm::vec3 const &camera) {
+    pos_lights_block_t<N> block;
+    size_t const          count = std::min(lights.size(), static_cast<size_t>(N));
+    for (size_t i = 0; i < count; ++i) {
+        block.lights[i] = {
+            .position  = glm::vec4(lights[i].position - camera, 0.0f),
+            .ambient   = glm::vec4(lights[i].ambient, 0.0f),
+            .diffuse   = glm::vec4(lights[i].diffuse, 0.0f),
+            .specular  = glm::vec4(lights[i].specular, 0.0f),
+            .constant  = lights[i].constant,
+            .linear    = lights[i].linear,
+            .quadratic = lights[i].quadratic,
+        };
+    }
+    return block;
+}
+
+template <int N>
+spot_lights_block_t<N>
+pack_spot_lights(std::span<spot_light_state_t const> lights, glm::vec3 const &camera) {
+    spot_lights_block_t<N> block;
+    size_t const           count = std::min(lights.size(), static_cast<size_t>(N));
+    for (size_t i = 0; i < count; ++i) {
+        block.lights[i] = {
+            .position     = glm::vec4(lights[i].position - camera, 0.0f),
+            .direction    = glm::vec4(lights[i].direction, 0.0f),
+            .ambient      = glm::vec4(lights[i].ambient, 0.0f),
+            .diffuse      = glm::vec4(lights[i].diffuse, 0.0f),
+            .specular     = glm::vec4(lights[i].specular, 0.0f),
+            .cutoff       = glm::cos(glm::radians(lights[i].inner_degrees)),
+            .outer_cutoff = glm::cos(glm::radians(lights[i].outer_degrees)),
+            .constant     = lights[i].constant,
+            .linear       = lights[i].linear,
+            .quadratic    = lights[i].quadratic,
+        };
+    }
+    return block;
+}
@@ -7,83 +7,144 @@
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
+#include <glm/gtc/type_ptr.hpp>
 
 #include "geometry.hpp"
+#include "jobs.hpp"
 
-namespace {
-
-std::expected<gpu_geometry_t, std::string>
-load_mesh_geometry(engine_t &engine, aiMesh const *mesh) {
-    std::vector<pos_normal_uv_vertex_t> vertices;
-    vertices.reserve(mesh->mNumVertices);
+mesh_data_t convert_mesh(aiMesh const *mesh) {
+    mesh_data_t data;
+    data.vertices.reserve(mesh->mNumVertices);
     for (unsigned i = 0; i < mesh->mNumVertices; ++i) {
         pos_normal_uv_vertex_t v;
         v.position = {mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z};
         v.normal   = {mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z};
         if (mesh->mTextureCoords[0])
             v.uv = {mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y};
-        vertices.push_back(v);
+        data.vertices.push_back(v);
     }
 
-    std::vector<uint32_t> indices;
-    indices.reserve(mesh->mNumFaces * 3);
+    data.indices.reserve(mesh->mNumFaces * 3);
     for (unsigned i = 0; i < mesh->mNumFaces; ++i) {
         aiFace const &face = mesh->mFaces[i];
         for (unsigned j = 0; j < face.mNumIndices; ++j)
-            indices.push_back(face.mIndices[j]);
+            data.indices.push_back(face.mIndices[j]);
     }
+    return data;
+}
+
+namespace {
+
+// aiMatrix4x4 is row-major, glm column-major.
+glm::mat4 to_glm(aiMatrix4x4 const &m) { return glm::transpose(glm::make_mat4(&m.a1)); }
 
-    Uint32 vertex_size = static_cast<Uint32>(vertices.size() * sizeof(pos_normal_uv_vertex_t));
+std::expected<gpu_geometry_t, std::string> upload_mesh(
+    engine_t &engine, mesh_data_t const &data, std::source_location const &site
+) {
+    Uint32 vertex_size =
+        static_cast<Uint32>(data.vertices.size() * sizeof(pos_normal_uv_vertex_t));
     return create_geometry(
-        engine, vertices.data(), vertex_size, std::span<uint32_t const>{indices}
+        engine, data.vertices.data(), vertex_size, std::span<uint32_t const>{data.indices}, site
     );
 }
 
-std::expected<int, std::string> cached_texture(
-    engine_t &engine, gpu_model_t &model, std::unordered_map<std::string, int> &cache,
+// Index of `full_path` among the model's textures, adding it the first time it is seen.
+int texture_index(
+    std::unordered_map<std::string, int> &cache, std::vector<std::string> &paths,
     std::string const &full_path
 ) {
-    auto it = cache.find(full_path);
-    if (it != cache.end()) return it->second;
-
-    auto tex = load_texture(engine, full_path);
-    if (!tex) return std::unexpected(tex.error());
-    auto sampler = create_sampler(engine);
-    if (!sampler) return std::unexpected(sampler.error());
-
-    int index        = static_cast<int>(model.textures.size());
-    cache[full_path] = index;
-    model.textures.push_back(std::move(*tex));
-    model.samplers.push_back(std::move(*sampler));
-    return index;
+    auto [it, inserted] = cache.try_emplace(full_path, static_cast<int>(paths.size()));
+    if (inserted) paths.push_back(full_path);
+    return it->second;
 }
 
-std::expected<mesh_textures_t, std::string> load_mesh_textures(
-    engine_t &engine, gpu_model_t &model, std::unordered_map<std::string, int> &cache,
+mesh_textures_t mesh_texture_indices(
+    std::unordered_map<std::string, int> &cache, std::vector<std::string> &paths,
     aiMaterial const *mat, std::string const &model_dir
 ) {
-    mesh_textures_t result;
-
-    auto load_slot = [&](aiTextureType type) -> std::expected<int, std::string> {
+    auto slot = [&](aiTextureType type) {
         aiString path;
         if (mat->GetTexture(type, 0, &path) != AI_SUCCESS) return -1;
-        return cached_texture(engine, model, cache, model_dir + "/" + path.C_Str());
+        return texture_index(cache, paths, model_dir + "/" + path.C_Str());
     };
+    return {.diffuse = slot(aiTextureType_DIFFUSE), .specular = slot(aiTextureType_SPECULAR)};
+}
 
-    auto diffuse = load_slot(aiTextureType_DIFFUSE);
-    if (!diffuse) return std::unexpected(diffuse.error());
-    result.diffuse = *diffuse;
-
-    auto specular = load_slot(aiTextureType_SPECULAR);
-    if (!specular) return std::unexpected(specular.error());
-    result.specular = *specular;
+void draw_mesh(
+    gpu_model_t const &model, model_mesh_t const &mesh,
+    std::initializer_list<texture_slot_t> sampler_slots, SDL_GPURenderPass *pass
+) {
+    std::vector<SDL_GPUTextureSamplerBinding> bindings;
+    bindings.reserve(sampler_slots.size());
+    for (texture_slot_t slot : sampler_slots) {
+        int idx = -1;
+        switch (slot) {
+        case texture_slot_t::diffuse:
+            idx = mesh.textures.diffuse;
+            break;
+        case texture_slot_t::specular:
+            idx = mesh.textures.specular;
+            break;
+        }
+        if (idx < 0) return;
+        bindings.push_back({model.textures[idx].get(), model.samplers[idx].get()});
+    }
 
-    return result;
+    SDL_GPUBufferBinding vbinding{mesh.geometry.vertex_buffer.get(), 0};
+    SDL_BindGPUVertexBuffers(pass, 0, &vbinding, 1);
+    SDL_BindGPUFragmentSamplers(pass, 0, bindings.data(), static_cast<Uint32>(bindings.size()));
+    if (mesh.geometry.index_count == 0) { // explode_model
+        SDL_DrawGPUPrimitives(pass, mesh.geometry.vertex_count, 1, 0, 0);
+        return;
+    }
+    SDL_GPUBufferBinding ibinding{mesh.geometry.index_buffer.get(), 0};
+    SDL_BindGPUIndexBuffer(pass, &ibinding, mesh.geometry.index_element_size);
+    SDL_DrawGPUIndexedPrimitives(pass, mesh.geometry.index_count, 1, 0, 0, 0);
 }
 
 } // namespace
 
-std::expected<gpu_model_t, std::string> load_model(engine_t &engine, std::string_view path) {
+memory_usage_t memory_usage(gpu_model_t const &model) {
+    memory_usage_t usage{
+        .cpu = model.textures.capacity() * sizeof(gpu_texture_t) +
+               model.samplers.capacity() * sizeof(gpu_sampler_t) +
+               model.meshes.capacity() * sizeof(model_mesh_t) +
+               model.texture_bytes.capacity() * sizeof(Uint64),
+        .gpu = 0,
+    };
+    for (auto const &mesh : model.meshes) {
+        usage += memory_usage(mesh.geometry);
+        usage.cpu += mesh.vertices.capacity() * sizeof(pos_normal_uv_vertex_t) +
+                     mesh.indices.capacity() * sizeof(uint32_t);
+    }
+    for (Uint64 bytes : model.texture_bytes)
+        usage.gpu += bytes;
+    return usage;
+}
+
+std::string memory_report(std::string_view name, gpu_model_t const &model) {
+    std::string out;
+    append_memory_line(out, 0, std::format("model {}", name), memory_usage(model));
+    for (size_t i = 0; i < model.meshes.size(); ++i) {
+        auto const &geometry = model.meshes[i].geometry;
+        auto const  label    = std::format(
+            "mesh {} ({} vertices, {} indices)", i,
+            geometry.vertex_bytes / sizeof(pos_normal_uv_vertex_t), geometry.index_count
+        );
+        append_memory_line(out, 2, label, memory_usage(geometry));
+    }
+    for (size_t i = 0; i < model.texture_bytes.size(); ++i)
+        append_memory_line(
+            out, 2, std::format("texture {}", i), {.cpu = 0, .gpu = model.texture_bytes[i]}
+        );
+    return out;
+}
+
+std::expected<gpu_model_t, std::string> load_model(
+    engine_t &engine, std::string_view path, bool retain_cpu_copy,
+    std::source_location const &site
+) {
+    gpu_resource_scope_t const scope{std::string(path.substr(path.find_last_of("/\\") + 1))};
     Assimp::Importer importer;
     aiScene const   *ai_scene = importer.ReadFile(
         path.data(), static_cast<unsigned>(aiProcess_Triangulate | aiProcess_FlipUVs)
@@ -93,31 +154,116 @@ std::expected<gpu_model_t, std::string> load_model(engine_t &engine, std::string
 
     std::string model_dir{path.substr(0, path.find_last_of("/\\"))};
 
-    gpu_model_t                          model;
+    // Walk the node tree first: that fixes the mesh order, the texture indices and the node
+    // hierarchy, and leaves a flat list of independent work.
+    std::vector<aiMesh const *>          meshes;
+    std::vector<mesh_textures_t>         mesh_textures;
+    std::vector<node_id_t>               mesh_nodes;
+    std::vector<std::string>             texture_paths;
     std::unordered_map<std::string, int> cache;
+    scene_graph_t                        nodes;
 
-    std::function<std::expected<void, std::string>(aiNode const *)> process_node;
-    process_node = [&](aiNode const *node) -> std::expected<void, std::string> {
+    std::function<void(aiNode const *, node_id_t)> collect;
+    collect = [&](aiNode const *node, node_id_t parent) {
+        node_id_t const id = nodes.add(parent, to_glm(node->mTransformation));
         for (unsigned i = 0; i < node->mNumMeshes; ++i) {
-            aiMesh const     *mesh = ai_scene->mMeshes[node->mMeshes[i]];
-            aiMaterial const *mat  = ai_scene->mMaterials[mesh->mMaterialIndex];
-
-            auto geom = load_mesh_geometry(engine, mesh);
-            if (!geom) return std::unexpected(geom.error());
-
-            auto tex = load_mesh_textures(engine, model, cache, mat, model_dir);
-            if (!tex) return std::unexpected(tex.error());
-
-            model.meshes.push_back({std::move(*geom), *tex});
-        }
-        for (unsigned i = 0; i < node->mNumChildren; ++i) {
-            if (auto r = process_node(node->mChildren[i]); !r) return std::unexpected(r.error());
+            aiMesh const *mesh = ai_scene->mMeshes[node->mMeshes[i]];
+            meshes.push_back(mesh);
+            mesh_nodes.push_back(id);
+            mesh_textures.push_back(mesh_texture_indices(
+                cache, texture_paths, ai_scene->mMaterials[mesh->mMaterialIndex], model_dir
+            ));
         }
-        return {};
+        for (unsigned i = 0; i < node->mNumChildren; ++i)
+            collect(node->mChildren[i], id);
+    };
+    collect(ai_scene->mRootNode, no_node);
+    nodes.update();
+
+    // Image decoding and vertex conversion run on the job system. Each result is uploaded by a
+    // main-thread continuation of its own job, so uploads overlap the decoding still going on.
+    struct texture_load_t {
+        job_counter_t decoded;
+        surface_t     rgba;
+        gpu_texture_t texture;
+        Uint64        bytes = 0;
+        std::string   error;
+    };
+    struct mesh_load_t {
+        job_counter_t  converted;
+        mesh_data_t    data;
+        gpu_geometry_t geometry;
+        std::string    error;
     };
+    std::vector<texture_load_t> texture_loads(texture_paths.size());
+    std::vector<mesh_load_t>    mesh_loads(meshes.size());
+
+    job_system_t &jobs = default_job_system();
+    job_counter_t uploaded;
 
-    if (auto r = process_node(ai_scene->mRootNode); !r) return std::unexpected(r.error());
+    for (size_t i = 0; i < texture_loads.size(); ++i) {
+        auto &load = texture_loads[i];
+        jobs.run(
+            [&load, &path = texture_paths[i]] {
+                auto rgba = decode_texture(path);
+                if (rgba) load.rgba = std::move(*rgba);
+                else load.error = rgba.error();
+            },
+            &load.decoded
+        );
+        jobs.run_after(
+            load.decoded,
+            [&load, &engine, &site, &path = texture_paths[i]] {
+                if (!load.rgba) return;
+                gpu_resource_scope_t const scope{path.substr(path.find_last_of("/\\") + 1)};
+                auto texture = upload_texture(engine, *load.rgba, site);
+                if (texture) {
+                    load.texture = std::move(*texture);
+                    // upload_texture creates RGBA8 with a single level.
+                    load.bytes = static_cast<Uint64>(load.rgba->w) * load.rgba->h * 4;
+                } else {
+                    load.error = texture.error();
+                }
+                load.rgba.reset();
+            },
+            &uploaded, job_thread_t::main
+        );
+    }
+    for (size_t i = 0; i < mesh_loads.size(); ++i) {
+        auto &load = mesh_loads[i];
+        jobs.run([&load, mesh = meshes[i]] { load.data = convert_mesh(mesh); }, &load.converted);
+        jobs.run_after(
+            load.converted,
+            [&load, &engine, &site, retain_cpu_copy] {
+                auto geometry = upload_mesh(engine, load.data, site);
+                if (geometry) load.geometry = std::move(*geometry);
+                else load.error = geometry.error();
+                if (!retain_cpu_copy) load.data = {};
+            },
+            &uploaded, job_thread_t::main
+        );
+    }
+    jobs.wait(uploaded);
 
+    gpu_model_t model;
+    model.nodes = std::move(nodes);
+    for (auto &load : texture_loads) {
+        if (!load.error.empty()) return std::unexpected(load.error);
+        auto sampler = create_sampler(
+            engine, SDL_GPU_SAMPLERADDRESSMODE_REPEAT, SDL_GPU_FILTER_LINEAR, site
+        );
+        if (!sampler) return std::unexpected(sampler.error());
+        model.textures.push_back(std::move(load.texture));
+        model.samplers.push_back(std::move(*sampler));
+        model.texture_bytes.push_back(load.bytes);
+    }
+    for (size_t i = 0; i < mesh_loads.size(); ++i) {
+        if (!mesh_loads[i].error.empty()) return std::unexpected(mesh_loads[i].error);
+        model.meshes.push_back({
+            std::move(mesh_loads[i].geometry), mesh_textures[i], mesh_nodes[i],
+            std::move(mesh_loads[i].data.vertices), std::move(mesh_loads[i].data.indices)
+        });
+    }
     return model;
 }
 
@@ -125,35 +271,8 @@ void draw_model(
     gpu_model_t const &model, std::initializer_list<texture_slot_t> sampler_slots,
     SDL_GPURenderPass *pass
 ) {
-    for (auto const &mesh : model.meshes) {
-        std::vector<SDL_GPUTextureSamplerBinding> bindings;
-        bindings.reserve(sampler_slots.size());
-        bool complete = true;
-        for (texture_slot_t slot : sampler_slots) {
-            int idx = -1;
-            switch (slot) {
-            case texture_slot_t::diffuse:
-                idx = mesh.textures.diffuse;
-                break;
-            case texture_slot_t::specular:
-                idx = mesh.textures.specular;
-                break;
-            }
-            if (idx < 0) {
-                complete = false;
-                break;
-            }
-            bindings.push_back({model.textures[idx].get(), model.samplers[idx].get()});
-        }
-        if (!complete) continue;
-
-        SDL_GPUBufferBinding vbinding{mesh.geometry.vertex_buffer.get(), 0};
-        SDL_BindGPUVertexBuffers(pass, 0, &vbinding, 1);
-        SDL_GPUBufferBinding ibinding{mesh.geometry.index_buffer.get(), 0};
-        SDL_BindGPUIndexBuffer(pass, &ibinding, mesh.geometry.index_element_size);
-        SDL_BindGPUFragmentSamplers(pass, 0, bindings.data(), static_cast<Uint32>(bindings.size()));
-        SDL_DrawGPUIndexedPrimitives(pass, mesh.geometry.index_count, 1, 0, 0, 0);
-    }
+    for (auto const &mesh : model.meshes)
+        draw_mesh(model, mesh, sampler_slots, pass);
 }
 
 void draw_model(
@@ -163,3 +282,14 @@ void draw_model(
     SDL_BindGPUGraphicsPipeline(pass, pipeline.get());
     draw_model(model, sampler_slots, pass);
 }
+
+void draw_model(
+    SDL_GPUCommandBuffer *cmd, gpu_model_t const &model, glm::mat4 const &transform,
+    Uint32 model_slot, std::initializer_list<texture_slot_t> sampler_slots,
+    SDL_GPURenderPass *pass
+) {
+    for (auto const &mesh : model.meshes) {
+        push_vertex_uniform(cmd, model_slot, transform * model.nodes.world(mesh.node));
+        draw_mesh(model, mesh, sampler_slots, pass);
+    }
+}
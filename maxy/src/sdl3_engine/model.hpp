@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "engine.hpp"
+#include "scene_graph.hpp"
 
 // Which texture type to bind at a given fragment sampler slot.
 // Pass as an ordered list to draw_model(); the list length must match
@@ -22,6 +23,10 @@ struct mesh_textures_t {
 struct model_mesh_t {
     gpu_geometry_t  geometry;
     mesh_textures_t textures;
+    node_id_t       node = 0; // in gpu_model_t::nodes
+    // What geometry was uploaded from; empty unless load_model was asked to keep it.
+    std::vector<pos_normal_uv_vertex_t> vertices;
+    std::vector<uint32_t>               indices;
 };
 
 // Owns all unique textures for a loaded model. Meshes reference textures by
@@ -30,15 +35,42 @@ struct gpu_model_t {
     std::vector<gpu_texture_t> textures;
     std::vector<gpu_sampler_t> samplers;
     std::vector<model_mesh_t>  meshes;
+    std::vector<Uint64>        texture_bytes; // GPU size of each of textures
+    // One node per aiNode of the file, mTransformation as the local matrix, world matrices up
+    // to date after loading. After set_local(), call nodes.update() before drawing.
+    scene_graph_t nodes;
 };
 
+struct aiMesh;
+
+// One Assimp mesh in the vertex layout load_model uploads. Runs on the job system during
+// load_model; exposed for bench_engine.
+struct mesh_data_t {
+    std::vector<pos_normal_uv_vertex_t> vertices;
+    std::vector<uint32_t>               indices;
+};
+mesh_data_t convert_mesh(aiMesh const *mesh);
+
 // Loads a model from disk via Assimp (triangulates and flips UVs).
 // Textures are deduplicated: the same file is uploaded at most once.
 // Diffuse and specular texture types are populated when present.
-std::expected<gpu_model_t, std::string> load_model(engine_t &engine, std::string_view path);
+// Images are decoded and vertices converted on default_job_system(); the GPU uploads run on the
+// calling thread, which has to be the one that made the job system. The vertices and indices are
+// freed after the upload unless retain_cpu_copy is set (for explode_model and the like).
+std::expected<gpu_model_t, std::string> load_model(
+    engine_t &engine, std::string_view path, bool retain_cpu_copy = false,
+    std::source_location const &site = std::source_location::current()
+);
+
+// CPU bytes of the bookkeeping above and GPU bytes of every buffer and texture.
+memory_usage_t memory_usage(gpu_model_t const &model);
+
+// One line per mesh and texture of `model`, then the total.
+std::string memory_report(std::string_view name, gpu_model_t const &model);
 
 // Draw all meshes that have every requested texture slot.
-// Caller must have already bound the pipeline and pushed uniforms.
+// Caller must have already bound the pipeline and pushed uniforms; every mesh gets the same
+// model matrix, so node transforms are ignored.
 void draw_model(
     gpu_model_t const &model, std::initializer_list<texture_slot_t> sampler_slots,
     SDL_GPURenderPass *pass
@@ -49,3 +81,11 @@ void draw_model(
     gpu_pipeline_t const &pipeline, gpu_model_t const &model,
     std::initializer_list<texture_slot_t> sampler_slots, SDL_GPURenderPass *pass
 );
+
+// Like the first overload, but honours the node hierarchy: pushes transform * the world matrix
+// of each mesh's node to vertex uniform slot `model_slot` before drawing the mesh.
+void draw_model(
+    SDL_GPUCommandBuffer *cmd, gpu_model_t const &model, glm::mat4 const &transform,
+    Uint32 model_slot, std::initializer_list<texture_slot_t> sampler_slots,
+    SDL_GPURenderPass *pass
+);
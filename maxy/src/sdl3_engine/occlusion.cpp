@@ -0,0 +1,246 @@
+#include "occlusion.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define OCCLUSION_SSE2 1
+#endif
+
+namespace {
+
+// Occludee depths are pulled towards the camera by this much before comparing, so a box is
+// never hidden by its own rasterized faces through interpolation round-off.
+constexpr float DEPTH_BIAS = 1e-5f;
+
+// Edge function E(p) = a*x + b*y + c: positive on the inner side of va -> vb for a triangle with
+// positive signed area in screen space.
+struct edge_t {
+    float a, b, c;
+
+    float at(float x, float y) const { return a * x + b * y + c; }
+};
+
+edge_t make_edge(glm::vec3 const &va, glm::vec3 const &vb) {
+    float const a = va.y - vb.y;
+    float const b = vb.x - va.x;
+    return {a, b, -(a * va.x + b * va.y)};
+}
+
+bool behind_near_plane(glm::vec4 const &clip) {
+    return clip.w <= 0.0f || clip.z < -clip.w;
+}
+
+} // namespace
+
+occlusion_buffer_t::occlusion_buffer_t(int width, int height)
+    : m_width((width + TILE_W - 1) / TILE_W * TILE_W),
+      m_height((height + TILE_H - 1) / TILE_H * TILE_H), m_tiles_x(m_width / TILE_W),
+      m_tiles_y(m_height / TILE_H), m_depth(static_cast<size_t>(m_width) * m_height, 1.0f),
+      m_tile_max(static_cast<size_t>(m_tiles_x) * m_tiles_y, 1.0f) {}
+
+void occlusion_buffer_t::begin(glm::mat4 const &view_proj) {
+    m_view_proj = view_proj;
+    std::ranges::fill(m_depth, 1.0f);
+    std::ranges::fill(m_tile_max, 1.0f);
+}
+
+void occlusion_buffer_t::rasterize(
+    std::span<glm::vec3 const> positions, std::span<uint16_t const> indices,
+    glm::mat4 const &model
+) {
+    glm::mat4 const         mvp = m_view_proj * model;
+    std::vector<glm::vec4>  clip(positions.size());
+    for (size_t i = 0; i < positions.size(); ++i) clip[i] = mvp * glm::vec4(positions[i], 1.0f);
+
+    auto const to_screen = [&](glm::vec4 const &c) {
+        glm::vec3 const ndc = glm::vec3(c) / c.w;
+        return glm::vec3{
+            (ndc.x * 0.5f + 0.5f) * static_cast<float>(m_width),
+            (0.5f - ndc.y * 0.5f) * static_cast<float>(m_height), ndc.z
+        };
+    };
+
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        glm::vec4 const &c0 = clip[indices[i]];
+        glm::vec4 const &c1 = clip[indices[i + 1]];
+        glm::vec4 const &c2 = clip[indices[i + 2]];
+        if (behind_near_plane(c0) || behind_near_plane(c1) || behind_near_plane(c2)) continue;
+        rasterize_triangle(to_screen(c0), to_screen(c1), to_screen(c2));
+    }
+}
+
+void occlusion_buffer_t::rasterize_box(aabb_t const &box) {
+    auto const corners = box_corners(box);
+    rasterize(corners, box_indices, glm::mat4{1.0f});
+}
+
+void occlusion_buffer_t::rasterize_triangle(glm::vec3 v0, glm::vec3 v1, glm::vec3 v2) {
+    float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+    if (std::abs(area) < 1e-8f) return;
+    if (area < 0.0f) {
+        std::swap(v1, v2);
+        area = -area;
+    }
+
+    int const min_x = std::max(0, static_cast<int>(std::floor(std::min({v0.x, v1.x, v2.x}))));
+    int const max_x =
+        std::min(m_width - 1, static_cast<int>(std::ceil(std::max({v0.x, v1.x, v2.x}))));
+    int const min_y = std::max(0, static_cast<int>(std::floor(std::min({v0.y, v1.y, v2.y}))));
+    int const max_y =
+        std::min(m_height - 1, static_cast<int>(std::ceil(std::max({v0.y, v1.y, v2.y}))));
+    if (min_x > max_x || min_y > max_y) return;
+
+    // Barycentric weight of v0 is e12 / area, of v1 e20 / area, of v2 e01 / area. NDC z is
+    // affine in screen space, so depth is a plane: z = za*x + zb*y + zc.
+    edge_t const e12 = make_edge(v1, v2);
+    edge_t const e20 = make_edge(v2, v0);
+    edge_t const e01 = make_edge(v0, v1);
+
+    float const dz1 = (v1.z - v0.z) / area;
+    float const dz2 = (v2.z - v0.z) / area;
+    float const za  = e20.a * dz1 + e01.a * dz2;
+    float const zb  = e20.b * dz1 + e01.b * dz2;
+    float const zc  = v0.z + e20.c * dz1 + e01.c * dz2;
+
+    // Rows are walked four pixels at a time from a 4-aligned start; the width is a multiple of
+    // TILE_W so the last group never runs past the row.
+    int const start_x = min_x & ~3;
+
+#ifdef OCCLUSION_SSE2
+    __m128 const lane  = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    __m128 const zero  = _mm_setzero_ps();
+    // Per-lane offsets from the first pixel of a group, and the step to the next group.
+    __m128 const lane0 = _mm_mul_ps(_mm_set1_ps(e12.a), lane);
+    __m128 const lane1 = _mm_mul_ps(_mm_set1_ps(e20.a), lane);
+    __m128 const lane2 = _mm_mul_ps(_mm_set1_ps(e01.a), lane);
+    __m128 const lanez = _mm_mul_ps(_mm_set1_ps(za), lane);
+    __m128 const step0 = _mm_set1_ps(4.0f * e12.a);
+    __m128 const step1 = _mm_set1_ps(4.0f * e20.a);
+    __m128 const step2 = _mm_set1_ps(4.0f * e01.a);
+    __m128 const stepz = _mm_set1_ps(4.0f * za);
+#endif
+
+    for (int y = min_y; y <= max_y; ++y) {
+        float const py  = static_cast<float>(y) + 0.5f;
+        float const px  = static_cast<float>(start_x) + 0.5f;
+        float      *row = m_depth.data() + static_cast<size_t>(y) * m_width;
+
+#ifdef OCCLUSION_SSE2
+        __m128 w0 = _mm_add_ps(_mm_set1_ps(e12.at(px, py)), lane0);
+        __m128 w1 = _mm_add_ps(_mm_set1_ps(e20.at(px, py)), lane1);
+        __m128 w2 = _mm_add_ps(_mm_set1_ps(e01.at(px, py)), lane2);
+        __m128 z  = _mm_add_ps(_mm_set1_ps(za * px + zb * py + zc), lanez);
+        for (int x = start_x; x <= max_x; x += 4) {
+            __m128 const inside = _mm_and_ps(
+                _mm_and_ps(_mm_cmpge_ps(w0, zero), _mm_cmpge_ps(w1, zero)), _mm_cmpge_ps(w2, zero)
+            );
+            __m128 const old    = _mm_loadu_ps(row + x);
+            __m128 const nearer = _mm_min_ps(old, z);
+            __m128 const merged = _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, old));
+            _mm_storeu_ps(row + x, merged);
+            w0 = _mm_add_ps(w0, step0);
+            w1 = _mm_add_ps(w1, step1);
+            w2 = _mm_add_ps(w2, step2);
+            z  = _mm_add_ps(z, stepz);
+        }
+#else
+        for (int x = start_x; x <= max_x; ++x) {
+            float const cx = static_cast<float>(x) + 0.5f;
+            if (e12.at(cx, py) < 0.0f || e20.at(cx, py) < 0.0f || e01.at(cx, py) < 0.0f) continue;
+            row[x] = std::min(row[x], za * cx + zb * py + zc);
+        }
+#endif
+    }
+}
+
+void occlusion_buffer_t::finalize() {
+    for (int ty = 0; ty < m_tiles_y; ++ty) {
+        for (int tx = 0; tx < m_tiles_x; ++tx) {
+            float const *tile = m_depth.data() + static_cast<size_t>(ty * TILE_H) * m_width +
+                                static_cast<size_t>(tx * TILE_W);
+#ifdef OCCLUSION_SSE2
+            __m128 farthest = _mm_setzero_ps();
+            for (int y = 0; y < TILE_H; ++y) {
+                float const *row = tile + static_cast<size_t>(y) * m_width;
+                for (int x = 0; x < TILE_W; x += 4)
+                    farthest = _mm_max_ps(farthest, _mm_loadu_ps(row + x));
+            }
+            farthest = _mm_max_ps(farthest, _mm_shuffle_ps(farthest, farthest, 0x4E));
+            farthest = _mm_max_ps(farthest, _mm_shuffle_ps(farthest, farthest, 0xB1));
+            m_tile_max[ty * m_tiles_x + tx] = _mm_cvtss_f32(farthest);
+#else
+            float farthest = -FLT_MAX;
+            for (int y = 0; y < TILE_H; ++y)
+                for (int x = 0; x < TILE_W; ++x)
+                    farthest = std::max(farthest, tile[static_cast<size_t>(y) * m_width + x]);
+            m_tile_max[ty * m_tiles_x + tx] = farthest;
+#endif
+        }
+    }
+}
+
+bool occlusion_buffer_t::any_farther(int x0, int x1, int y0, int y1, float z) const {
+#ifdef OCCLUSION_SSE2
+    __m128 const lane  = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    __m128 const vz    = _mm_set1_ps(z);
+    __m128 const first = _mm_set1_ps(static_cast<float>(x0));
+    __m128 const last  = _mm_set1_ps(static_cast<float>(x1));
+    for (int y = y0; y <= y1; ++y) {
+        float const *row = m_depth.data() + static_cast<size_t>(y) * m_width;
+        for (int x = x0 & ~3; x <= x1; x += 4) {
+            __m128 const idx   = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), lane);
+            __m128 const valid = _mm_and_ps(_mm_cmpge_ps(idx, first), _mm_cmple_ps(idx, last));
+            __m128 const far   = _mm_cmpge_ps(_mm_loadu_ps(row + x), vz);
+            if (_mm_movemask_ps(_mm_and_ps(valid, far))) return true;
+        }
+    }
+#else
+    for (int y = y0; y <= y1; ++y)
+        for (int x = x0; x <= x1; ++x)
+            if (m_depth[static_cast<size_t>(y) * m_width + x] >= z) return true;
+#endif
+    return false;
+}
+
+visibility_t occlusion_buffer_t::test(aabb_t const &box) const {
+    glm::vec2 lo{FLT_MAX};
+    glm::vec2 hi{-FLT_MAX};
+    float     z_min = FLT_MAX;
+    for (auto const &corner : box_corners(box)) {
+        glm::vec4 const clip = m_view_proj * glm::vec4(corner, 1.0f);
+        if (behind_near_plane(clip)) return visibility_t::visible;
+        glm::vec3 const ndc = glm::vec3(clip) / clip.w;
+        lo                  = glm::min(lo, glm::vec2(ndc));
+        hi                  = glm::max(hi, glm::vec2(ndc));
+        z_min               = std::min(z_min, ndc.z);
+    }
+    if (hi.x < -1.0f || lo.x > 1.0f || hi.y < -1.0f || lo.y > 1.0f || z_min > 1.0f)
+        return visibility_t::off_screen;
+
+    // Every pixel the projected rectangle touches, clamped to the buffer.
+    auto const to_pixel = [](float v, int size) {
+        return std::clamp(static_cast<int>(std::floor(v * static_cast<float>(size))), 0, size - 1);
+    };
+    int const x0 = to_pixel(lo.x * 0.5f + 0.5f, m_width);
+    int const x1 = to_pixel(hi.x * 0.5f + 0.5f, m_width);
+    int const y0 = to_pixel(0.5f - hi.y * 0.5f, m_height);
+    int const y1 = to_pixel(0.5f - lo.y * 0.5f, m_height);
+
+    float const z = z_min - DEPTH_BIAS;
+    for (int ty = y0 / TILE_H; ty <= y1 / TILE_H; ++ty) {
+        for (int tx = x0 / TILE_W; tx <= x1 / TILE_W; ++tx) {
+            // Nearest point behind the farthest occluder texel: hidden across the whole tile.
+            if (z > m_tile_max[ty * m_tiles_x + tx]) continue;
+            int const px0 = std::max(x0, tx * TILE_W);
+            int const px1 = std::min(x1, tx * TILE_W + TILE_W - 1);
+            int const py0 = std::max(y0, ty * TILE_H);
+            int const py1 = std::min(y1, ty * TILE_H + TILE_H - 1);
+            if (any_farther(px0, px1, py0, py1, z)) return visibility_t::visible;
+        }
+    }
+    return visibility_t::occluded;
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// Software occlusion culling. Occluder triangles (boxes or low-poly stand-ins) are rasterized on
+// the CPU into a small depth buffer; occludee bounding boxes are then tested against it before
+// any draw call is issued. Pure CPU: depends only on glm, so it can be exercised without a GPU.
+//
+// Depth is NDC z from the caller's view-projection (smaller = nearer); the buffer clears to the
+// far plane (1.0). A second level stores the farthest depth per TILE_W x TILE_H tile so most
+// occludee tests are decided without touching individual pixels.
+//
+// The inner loops use SSE2 (baseline on x86-64) four pixels at a time, with a scalar fallback on
+// other targets.
+
+struct aabb_t {
+    glm::vec3 min;
+    glm::vec3 max;
+};
+
+enum class visibility_t {
+    visible,
+    occluded,   // entirely behind rasterized occluders
+    off_screen, // outside the view frustum sides or far plane
+};
+
+struct occlusion_buffer_t {
+    static constexpr int TILE_W = 8;
+    static constexpr int TILE_H = 8;
+
+    // Width and height are rounded up to whole tiles.
+    occlusion_buffer_t(int width, int height);
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+
+    // Starts a new frame: resets depth to the far plane and sets the transform used by
+    // rasterize_* and test.
+    void begin(glm::mat4 const &view_proj);
+
+    // Rasterizes indexed triangles (positions in model space). Triangles with a vertex behind the
+    // near plane are skipped rather than clipped: a missing occluder only costs culling
+    // efficiency, never correctness.
+    void rasterize(
+        std::span<glm::vec3 const> positions, std::span<uint16_t const> indices,
+        glm::mat4 const &model
+    );
+
+    // Rasterizes the 12 triangles of a world-space box.
+    void rasterize_box(aabb_t const &box);
+
+    // Rebuilds the tile level. Call once after the last rasterize_* and before test.
+    void finalize();
+
+    // Conservative test of a world-space box against the occluders. Boxes crossing the near
+    // plane are always visible.
+    visibility_t test(aabb_t const &box) const;
+
+    // Pixel depth, for debugging and tests. (0, 0) is the top-left corner.
+    float depth_at(int x, int y) const { return m_depth[y * m_width + x]; }
+    float tile_max_at(int tx, int ty) const { return m_tile_max[ty * m_tiles_x + tx]; }
+
+private:
+    int                m_width;
+    int                m_height;
+    int                m_tiles_x;
+    int                m_tiles_y;
+    glm::mat4          m_view_proj{1.0f};
+    std::vector<float> m_depth;
+    std::vector<float> m_tile_max;
+
+    // Screen-space vertex: x, y in pixels (y down), z in NDC.
+    void rasterize_triangle(glm::vec3 v0, glm::vec3 v1, glm::vec3 v2);
+    bool any_farther(int x0, int x1, int y0, int y1, float z) const;
+};
+
+// Index list for the 12 triangles of box_corners() (both windings are rasterized, so the
+// orientation is irrelevant).
+inline constexpr uint16_t box_indices[36] = {
+    0, 1, 2, 2, 1, 3, // -z
+    4, 6, 5, 5, 6, 7, // +z
+    0, 4, 1, 1, 4, 5, // -y
+    2, 3, 6, 6, 3, 7, // +y
+    0, 2, 4, 4, 2, 6, // -x
+    1, 5, 3, 3, 5, 7, // +x
+};
+
+// Corner i has x from bit 0, y from bit 1 and z from bit 2 (0 = min, 1 = max).
+inline std::array<glm::vec3, 8> box_corners(aabb_t const &box) {
+    std::array<glm::vec3, 8> corners;
+    for (int i = 0; i < 8; ++i)
+        corners[i] = {
+            (i & 1) ? box.max.x : box.min.x, (i & 2) ? box.max.y : box.min.y,
+            (i & 4) ? box.max.z : box.min.z
+        };
+    return corners;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <algorithm>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// Where a sample puts a copy of a model: world position and uniform scale.
+struct model_placement_t {
+    glm::vec3 position;
+    float     scale;
+};
+
+// A copy of placements ordered farthest from eye first, so that blended objects drawn in that
+// order land over whatever is behind them. Squared distances order the same as distances.
+inline std::vector<model_placement_t>
+sorted_back_to_front(std::span<model_placement_t const> placements, glm::vec3 eye) {
+    std::vector<model_placement_t> sorted(placements.begin(), placements.end());
+    std::ranges::sort(sorted, [&](auto const &a, auto const &b) {
+        glm::vec3 const da = a.position - eye;
+        glm::vec3 const db = b.position - eye;
+        return glm::dot(da, da) > glm::dot(db, db);
+    });
+    return sorted;
+}
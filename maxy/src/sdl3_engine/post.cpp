@@ -0,0 +1,307 @@
+#include "post.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+constexpr SDL_GPUTextureFormat TARGET_FORMAT     = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM;
+constexpr Uint32               BLUR_SEGMENT      = 128; // post_blur.comp SEGMENT
+constexpr Uint32               MAX_BLUR_TAP_SETS = POST_MAX_BLUR_RADIUS + 1;
+
+// Covers clip space with one triangle: no diagonal seam, and no quad's worth of helper
+// invocations along it.
+constexpr vertex_t FULLSCREEN_TRIANGLE[] = {
+    {-1.0f, -1.0f, 0.0f},
+    {3.0f, -1.0f, 0.0f},
+    {-1.0f, 3.0f, 0.0f},
+};
+
+// Matches BlurParams in post_blur.frag and post_blur.comp (std140).
+struct blur_params_t {
+    glm::vec2 direction;
+    Uint32    tap_count;
+    Uint32    pad;
+    glm::vec4 taps[MAX_BLUR_TAP_SETS]; // x = offset in texels, y = weight
+};
+
+// Matches KernelParams in post_kernel.frag (std140).
+struct kernel_params_t {
+    glm::vec4 rows[3];
+};
+
+// Weights of the texels 0..radius away in a normalised Gaussian with sigma = radius / 3.
+std::vector<float> gaussian_weights(int radius) {
+    float const sigma = std::max(static_cast<float>(radius) / 3.0f, 0.5f);
+
+    std::vector<float> weights(static_cast<size_t>(radius) + 1);
+    float              total = 0.0f;
+    for (int i = 0; i <= radius; ++i) {
+        weights[i] = std::exp(-0.5f * static_cast<float>(i * i) / (sigma * sigma));
+        total += i == 0 ? weights[i] : 2.0f * weights[i];
+    }
+    for (auto &weight : weights)
+        weight /= total;
+    return weights;
+}
+
+// Texel i and i + 1 weigh w0 and w1; one bilinear fetch at i + w1 / (w0 + w1) returns
+// (w0 * a + w1 * b) / (w0 + w1), so scaling it by w0 + w1 replaces both taps.
+blur_params_t blur_params(int radius, bool linear) {
+    std::vector<float> const weights = gaussian_weights(radius);
+
+    blur_params_t params = {};
+    params.taps[0]       = {0.0f, weights[0], 0.0f, 0.0f};
+    Uint32 count         = 1;
+    if (!linear) {
+        for (int i = 1; i <= radius; ++i)
+            params.taps[count++] = {static_cast<float>(i), weights[i], 0.0f, 0.0f};
+    } else {
+        for (int i = 1; i <= radius; i += 2) {
+            float const w0     = weights[i];
+            float const w1     = i + 1 <= radius ? weights[i + 1] : 0.0f;
+            float const offset = static_cast<float>(i) + w1 / (w0 + w1);
+            params.taps[count++] = {offset, w0 + w1, 0.0f, 0.0f};
+        }
+    }
+    params.tap_count = count;
+    return params;
+}
+
+std::expected<gpu_texture_t, std::string>
+create_target(engine_t const &engine, glm::ivec2 size) {
+    SDL_GPUTextureCreateInfo info = {};
+    info.type                     = SDL_GPU_TEXTURETYPE_2D;
+    info.format                   = TARGET_FORMAT;
+    info.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER |
+                 SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_WRITE;
+    info.width                = static_cast<Uint32>(size.x);
+    info.height               = static_cast<Uint32>(size.y);
+    info.layer_count_or_depth = 1;
+    info.num_levels           = 1;
+
+    SDL_GPUTexture *tex = SDL_CreateGPUTexture(engine.gpu_device, &info);
+    if (!tex) return sdl_error("SDL_CreateGPUTexture (post target) failed");
+    return gpu_texture_t{engine.gpu_device, tex, gpu_texture_bytes(info)};
+}
+
+template <typename Params>
+void fullscreen_pass(
+    post_stack_t const &stack, SDL_GPUCommandBuffer *cmd, gpu_pipeline_t const &pipeline,
+    SDL_GPUTexture *source, SDL_GPUTexture *target, Params const &params
+) {
+    SDL_GPUColorTargetInfo color_info = {};
+    color_info.texture                = target;
+    color_info.load_op                = SDL_GPU_LOADOP_DONT_CARE; // every texel is written
+    color_info.store_op               = SDL_GPU_STOREOP_STORE;
+
+    SDL_GPURenderPass *pass = SDL_BeginGPURenderPass(cmd, &color_info, 1, nullptr);
+    SDL_BindGPUGraphicsPipeline(pass, pipeline.get());
+    SDL_GPUBufferBinding vertices = {stack.triangle.get(), 0};
+    SDL_BindGPUVertexBuffers(pass, 0, &vertices, 1);
+    SDL_GPUTextureSamplerBinding binding = {source, stack.linear_sampler.get()};
+    SDL_BindGPUFragmentSamplers(pass, 0, &binding, 1);
+    push_fragment_uniform(cmd, 0, params);
+    SDL_DrawGPUPrimitives(pass, 3, 1, 0, 0);
+    SDL_EndGPURenderPass(pass);
+}
+
+void compute_blur_pass(
+    post_stack_t const &stack, SDL_GPUCommandBuffer *cmd, SDL_GPUTexture *source,
+    SDL_GPUTexture *target, glm::ivec2 size, blur_params_t const &params
+) {
+    SDL_GPUStorageTextureReadWriteBinding output = {};
+    output.texture                               = target;
+
+    SDL_GPUComputePass *pass = SDL_BeginGPUComputePass(cmd, &output, 1, nullptr, 0);
+    SDL_BindGPUComputePipeline(pass, stack.blur_compute_pipeline.get());
+    SDL_GPUTextureSamplerBinding binding = {source, stack.linear_sampler.get()};
+    SDL_BindGPUComputeSamplers(pass, 0, &binding, 1);
+    SDL_PushGPUComputeUniformData(cmd, 0, &params, sizeof(params));
+
+    bool const   horizontal = params.direction.x > 0.0f;
+    Uint32 const extent     = static_cast<Uint32>(horizontal ? size.x : size.y);
+    Uint32 const lines      = static_cast<Uint32>(horizontal ? size.y : size.x);
+    SDL_DispatchGPUCompute(pass, (extent + BLUR_SEGMENT - 1) / BLUR_SEGMENT, lines, 1);
+    SDL_EndGPUComputePass(pass);
+}
+
+} // namespace
+
+std::expected<SDL_GPUTexture *, std::string>
+post_target_pool_t::acquire(engine_t const &engine, glm::ivec2 size) {
+    for (auto &entry : m_entries) {
+        if (!entry->taken && entry->size == size) {
+            entry->taken = true;
+            return entry->texture.get();
+        }
+    }
+    auto texture = create_target(engine, size);
+    if (!texture) return std::unexpected(texture.error());
+    m_entries.push_back(std::make_unique<entry_t>(std::move(*texture), size, true));
+    return m_entries.back()->texture.get();
+}
+
+void post_target_pool_t::release(SDL_GPUTexture *texture) {
+    for (auto &entry : m_entries) {
+        if (entry->texture.get() == texture) entry->taken = false;
+    }
+}
+
+void post_target_pool_t::release_all() {
+    for (auto &entry : m_entries)
+        entry->taken = false;
+}
+
+void post_target_pool_t::clear() { m_entries.clear(); }
+
+std::expected<post_stack_t, std::string> create_post_stack(engine_t const &engine) {
+    post_stack_t stack;
+
+    auto const fragment_pipeline = [&](std::string_view fragment_shader) {
+        return create_pipeline(
+            engine, {
+                        .vertex_shader            = "shaders/sdl3_engine/post.vert.spv",
+                        .fragment_shader          = fragment_shader,
+                        .fragment_uniform_buffers = 1,
+                        .fragment_samplers        = 1,
+                        .color_target_formats     = std::span(&TARGET_FORMAT, 1),
+                    }
+        );
+    };
+
+    auto downsample = fragment_pipeline("shaders/sdl3_engine/post_downsample.frag.spv");
+    if (!downsample) return std::unexpected(downsample.error());
+    stack.downsample_pipeline = std::move(*downsample);
+
+    auto blur = fragment_pipeline("shaders/sdl3_engine/post_blur.frag.spv");
+    if (!blur) return std::unexpected(blur.error());
+    stack.blur_pipeline = std::move(*blur);
+
+    auto kernel = fragment_pipeline("shaders/sdl3_engine/post_kernel.frag.spv");
+    if (!kernel) return std::unexpected(kernel.error());
+    stack.kernel_pipeline = std::move(*kernel);
+
+    auto color = fragment_pipeline("shaders/sdl3_engine/post_color.frag.spv");
+    if (!color) return std::unexpected(color.error());
+    stack.color_pipeline = std::move(*color);
+
+    auto blur_compute = create_compute_pipeline(engine, "shaders/sdl3_engine/post_blur.comp.spv");
+    if (!blur_compute) return std::unexpected(blur_compute.error());
+    stack.blur_compute_pipeline = std::move(*blur_compute);
+
+    auto sampler = create_sampler(engine, SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE);
+    if (!sampler) return std::unexpected(sampler.error());
+    stack.linear_sampler = std::move(*sampler);
+
+    auto triangle =
+        create_vertex_buffer(engine, FULLSCREEN_TRIANGLE, sizeof(FULLSCREEN_TRIANGLE));
+    if (!triangle) return std::unexpected(triangle.error());
+    stack.triangle = std::move(*triangle);
+
+    return stack;
+}
+
+SDL_GPUTexture *post_stack_t::apply(
+    engine_t const &engine, SDL_GPUCommandBuffer *cmd, SDL_GPUTexture *source, glm::ivec2 size
+) {
+    if (size != pool_size) {
+        pool.clear();
+        pool_size = size;
+    }
+    pool.release_all();
+
+    // Each effect reads whatever size the previous one left and writes the source size, except
+    // the blur, which stays at its own resolution for whoever samples it next.
+    SDL_GPUTexture *current      = source;
+    glm::ivec2      current_size = size;
+
+    auto const target = [&](glm::ivec2 target_size) -> SDL_GPUTexture * {
+        auto texture = pool.acquire(engine, target_size);
+        if (!texture) {
+            SDL_Log("%s", texture.error().c_str());
+            return nullptr;
+        }
+        return *texture;
+    };
+    auto const advance = [&](SDL_GPUTexture *next, glm::ivec2 next_size) {
+        pool.release(current);
+        current      = next;
+        current_size = next_size;
+    };
+
+    for (auto const &effect : effects) {
+        if (!effect.enabled) continue;
+
+        switch (effect.kind) {
+        case post_effect_kind_t::gaussian_blur: {
+            Uint32 const     factor = std::clamp<Uint32>(std::bit_floor(effect.downsample), 1, 4);
+            glm::ivec2 const small  = glm::max(size / static_cast<int>(factor), glm::ivec2(1));
+            int const        radius = std::clamp(
+                static_cast<int>(std::lround(effect.radius / static_cast<float>(factor))), 1,
+                POST_MAX_BLUR_RADIUS
+            );
+
+            // Also when an earlier blur left a different size: the compute passes read and
+            // write texel for texel.
+            if (current_size != small) {
+                SDL_GPUTexture *reduced = target(small);
+                if (!reduced) return current;
+                Uint32 const ratio = std::clamp<Uint32>(
+                    std::bit_floor(static_cast<Uint32>(current_size.x / small.x)), 1, 4
+                );
+                fullscreen_pass(*this, cmd, downsample_pipeline, current, reduced, ratio);
+                advance(reduced, small);
+            }
+
+            blur_params_t params = blur_params(radius, !effect.compute);
+            for (glm::vec2 direction : {glm::vec2(1.0f, 0.0f), glm::vec2(0.0f, 1.0f)}) {
+                SDL_GPUTexture *blurred = target(small);
+                if (!blurred) return current;
+                params.direction = direction;
+                if (effect.compute)
+                    compute_blur_pass(*this, cmd, current, blurred, current_size, params);
+                else
+                    fullscreen_pass(*this, cmd, blur_pipeline, current, blurred, params);
+                advance(blurred, small);
+            }
+            break;
+        }
+        case post_effect_kind_t::kernel: {
+            SDL_GPUTexture *filtered = target(size);
+            if (!filtered) return current;
+            kernel_params_t params = {};
+            for (int row = 0; row < 3; ++row)
+                params.rows[row] = glm::vec4(
+                    effect.kernel[row * 3], effect.kernel[row * 3 + 1], effect.kernel[row * 3 + 2],
+                    0.0f
+                );
+            fullscreen_pass(*this, cmd, kernel_pipeline, current, filtered, params);
+            advance(filtered, size);
+            break;
+        }
+        case post_effect_kind_t::invert:
+        case post_effect_kind_t::greyscale: {
+            SDL_GPUTexture *graded = target(size);
+            if (!graded) return current;
+            Uint32 const mode = effect.kind == post_effect_kind_t::invert ? 0u : 1u;
+            fullscreen_pass(*this, cmd, color_pipeline, current, graded, mode);
+            advance(graded, size);
+            break;
+        }
+        }
+    }
+    return current;
+}
+
+SDL_GPUTexture *post_stack_t::apply(
+    engine_t const &engine, SDL_GPUCommandBuffer *cmd, post_effect_t const &effect,
+    SDL_GPUTexture *source, glm::ivec2 size
+) {
+    std::vector<post_effect_t> stack = std::exchange(effects, {effect});
+    SDL_GPUTexture            *result = apply(engine, cmd, source, size);
+    effects                           = std::move(stack);
+    return result;
+}
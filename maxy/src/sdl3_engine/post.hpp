@@ -0,0 +1,102 @@
+#pragma once
+#include <array>
+#include <expected>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "engine.hpp"
+
+// Post-processing stack: an ordered list of full-screen effects applied to an off-screen colour
+// target, each pass reading the previous result and writing a target from a pool, so a chain of
+// any length ping-pongs between a couple of textures per size.
+//
+// Gaussian blur is separable (a horizontal then a vertical pass, 2r + 1 taps each instead of
+// (2r + 1)^2) and runs at half or quarter resolution on request, which divides its cost by 4 or
+// 16 and its radius in texels by 2 or 4. The fragment variant halves the taps again by letting
+// bilinear filtering blend each pair of neighbours; the compute variant (post_blur.comp) loads
+// a segment of a row into shared memory and sums the taps from there.
+
+enum class post_effect_kind_t {
+    gaussian_blur,
+    kernel,    // 3x3 convolution with post_effect_t::kernel
+    invert,
+    greyscale,
+};
+
+struct post_effect_t {
+    post_effect_kind_t kind    = post_effect_kind_t::gaussian_blur;
+    bool               enabled = true;
+
+    // gaussian_blur
+    float  radius     = 8.0f;  // in source pixels; sigma is radius / 3
+    Uint32 downsample = 2;     // 1, 2 or 4: blur at 1/downsample of the source size per side
+    bool   compute    = false; // shared-memory compute passes instead of bilinear fragment ones
+
+    // kernel: rows top to bottom, as the old screen.frag kernels.
+    std::array<float, 9> kernel = {0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+};
+
+inline constexpr std::array<float, 9> edge_kernel    = {1, 1, 1, 1, -8, 1, 1, 1, 1};
+inline constexpr std::array<float, 9> sharpen_kernel = {0, -1, 0, -1, 5, -1, 0, -1, 0};
+inline constexpr std::array<float, 9> emboss_kernel  = {-2, -1, 0, -1, 1, 1, 0, 1, 2};
+
+// Largest blur radius in texels at the blur's own resolution; larger radii are clamped. 32 at
+// quarter resolution is 128 source pixels.
+constexpr int POST_MAX_BLUR_RADIUS = 32;
+
+// Intermediate targets (R8G8B8A8_UNORM, colour target, sampled and compute-writable), recycled
+// by size. Textures are never freed while the pool lives, except by clear().
+struct post_target_pool_t {
+    // A free texture of `size`, created when none is; taken until released.
+    std::expected<SDL_GPUTexture *, std::string>
+    acquire(engine_t const &engine, glm::ivec2 size);
+    // No-op for textures the pool does not own (e.g. the stack's source).
+    void release(SDL_GPUTexture *texture);
+    void release_all();
+    void clear();
+
+    size_t texture_count() const { return m_entries.size(); }
+
+private:
+    struct entry_t {
+        gpu_texture_t texture;
+        glm::ivec2    size;
+        bool          taken = false;
+    };
+    std::vector<std::unique_ptr<entry_t>> m_entries;
+};
+
+struct post_stack_t {
+    std::vector<post_effect_t> effects; // applied in order; disabled ones are skipped
+
+    gpu_pipeline_t         downsample_pipeline;
+    gpu_pipeline_t         blur_pipeline;
+    gpu_pipeline_t         kernel_pipeline;
+    gpu_pipeline_t         color_pipeline;
+    gpu_compute_pipeline_t blur_compute_pipeline;
+    gpu_sampler_t          linear_sampler;
+    gpu_buffer_t           triangle; // fullscreen triangle, vertex_t positions
+    post_target_pool_t     pool;
+
+    // Records the enabled effects on `source` (`size` pixels). Call outside any render pass,
+    // e.g. from the prepare of the pass that shows the result. Returns the texture holding the
+    // result, which stays valid until the next apply(): source itself when nothing is enabled,
+    // and smaller than `size` when the last effect is a downsampled blur, so sample it with a
+    // linear sampler. If an intermediate target cannot be created, the effects from there on
+    // are skipped.
+    SDL_GPUTexture *apply(
+        engine_t const &engine, SDL_GPUCommandBuffer *cmd, SDL_GPUTexture *source,
+        glm::ivec2 size
+    );
+
+    // Records one effect on its own, for measuring it; same result rules as apply().
+    SDL_GPUTexture *apply(
+        engine_t const &engine, SDL_GPUCommandBuffer *cmd, post_effect_t const &effect,
+        SDL_GPUTexture *source, glm::ivec2 size
+    );
+
+    glm::ivec2 pool_size = {0, 0}; // source size the pool was filled at; other sizes clear it
+};
+
+std::expected<post_stack_t, std::string> create_post_stack(engine_t const &engine);
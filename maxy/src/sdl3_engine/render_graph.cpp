@@ -0,0 +1,322 @@
+#include "render_graph.hpp"
+
+#include <algorithm>
+#include <array>
+#include <format>
+#include <utility>
+
+namespace {
+
+char const *load_op_name(SDL_GPULoadOp op) {
+    switch (op) {
+    case SDL_GPU_LOADOP_LOAD: return "LOAD";
+    case SDL_GPU_LOADOP_CLEAR: return "CLEAR";
+    default: return "DONT_CARE";
+    }
+}
+
+char const *store_op_name(SDL_GPUStoreOp op) {
+    switch (op) {
+    case SDL_GPU_STOREOP_STORE: return "STORE";
+    case SDL_GPU_STOREOP_RESOLVE: return "RESOLVE";
+    case SDL_GPU_STOREOP_RESOLVE_AND_STORE: return "RESOLVE_AND_STORE";
+    default: return "DONT_CARE";
+    }
+}
+
+// The resolve target of colour attachment i, if it has one.
+rg_texture_t resolve_of(rg_pass_t const &pass, size_t i) {
+    return i < pass.resolve.size() ? pass.resolve[i] : rg_none;
+}
+
+double mebibytes(Uint64 bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); }
+
+} // namespace
+
+rg_texture_t render_graph_t::create_texture(rg_texture_desc_t desc) {
+    m_resources.push_back({.desc = std::move(desc)});
+    m_dirty = true;
+    return static_cast<rg_texture_t>(m_resources.size() - 1);
+}
+
+rg_texture_t render_graph_t::import_texture(std::string name, gpu_texture_t const *texture) {
+    m_resources.push_back({.desc = {.name = std::move(name)}, .imported = texture});
+    m_dirty = true;
+    return static_cast<rg_texture_t>(m_resources.size() - 1);
+}
+
+void render_graph_t::add_pass(rg_pass_t pass) {
+    m_passes.push_back(std::move(pass));
+    m_dirty = true;
+}
+
+void render_graph_t::set_size(rg_texture_t id, glm::ivec2 size) {
+    auto &desc = m_resources[id].desc;
+    if (desc.size == size) return;
+    desc.size = size;
+    m_dirty   = true;
+}
+
+SDL_GPUTexture *render_graph_t::texture(rg_texture_t id) const {
+    if (id == rg_swapchain || id >= m_resources.size()) return nullptr;
+    auto const &resource = m_resources[id];
+    if (resource.imported) return resource.imported->get();
+    if (resource.texture == SIZE_MAX) return nullptr;
+    return m_textures[resource.texture].texture.get();
+}
+
+// Walks the passes backwards tracking which textures a later kept pass still needs the contents
+// of. A clearing write ends that need; a loading write or a read starts one.
+std::vector<bool> render_graph_t::cull() const {
+    std::vector<bool> live(m_passes.size(), false);
+    std::vector<bool> needed(m_resources.size(), false);
+
+    for (size_t i = m_passes.size(); i-- > 0;) {
+        auto const &pass = m_passes[i];
+
+        bool keep = pass.keep;
+        auto const visit_write = [&](rg_texture_t id) {
+            if (!transient(id) || needed[id]) keep = true;
+        };
+        for (auto id : pass.color) visit_write(id);
+        for (auto id : pass.resolve)
+            if (id != rg_none) visit_write(id);
+        if (pass.depth != rg_none) visit_write(pass.depth);
+        if (!keep) continue;
+
+        live[i] = true;
+        for (auto id : pass.resolve) // overwritten whole
+            if (id != rg_none) needed[id] = false;
+        for (auto id : pass.color) needed[id] = !pass.clear_color;
+        if (pass.depth != rg_none) needed[pass.depth] = !pass.clear_depth;
+        for (auto id : pass.reads) needed[id] = true;
+    }
+    return live;
+}
+
+std::expected<void, std::string> render_graph_t::allocate(engine_t const &engine) {
+    auto const live = cull();
+
+    for (auto &resource : m_resources) {
+        resource.first   = -1;
+        resource.last    = -1;
+        resource.sampled = false;
+        resource.usage   = 0;
+        resource.texture = SIZE_MAX;
+    }
+    auto const use = [&](rg_texture_t id, int pass, SDL_GPUTextureUsageFlags usage) {
+        auto &resource = m_resources[id];
+        if (resource.first < 0) resource.first = pass;
+        resource.last = pass;
+        resource.usage |= usage;
+    };
+    for (size_t i = 0; i < m_passes.size(); ++i) {
+        if (!live[i]) continue;
+        auto const &pass = m_passes[i];
+        int const   at   = static_cast<int>(i);
+        for (auto id : pass.color) use(id, at, SDL_GPU_TEXTUREUSAGE_COLOR_TARGET);
+        for (auto id : pass.resolve)
+            if (id != rg_none) use(id, at, SDL_GPU_TEXTUREUSAGE_COLOR_TARGET);
+        if (pass.depth != rg_none) use(pass.depth, at, SDL_GPU_TEXTUREUSAGE_DEPTH_STENCIL_TARGET);
+        for (auto id : pass.reads) {
+            use(id, at, SDL_GPU_TEXTUREUSAGE_SAMPLER);
+            m_resources[id].sampled = true;
+        }
+    }
+
+    // Greedy interval assignment in order of first use: a transient takes the first texture of
+    // its kind that the previous holder is done with, else one left over from the last compile,
+    // else a new one. Whatever is left over afterwards is released.
+    auto const window_size = window_pixel_size(engine);
+    auto const swap_format = SDL_GetGPUSwapchainTextureFormat(engine.gpu_device, engine.window);
+    auto       pool        = std::exchange(m_textures, {});
+    m_stats                = {};
+    m_stats.passes         = m_passes.size();
+    m_stats.culled         = static_cast<size_t>(std::ranges::count(live, false));
+
+    std::vector<rg_texture_t> order;
+    for (rg_texture_t id = 0; id < m_resources.size(); ++id)
+        if (transient(id) && m_resources[id].first >= 0) order.push_back(id);
+    std::ranges::stable_sort(order, {}, [&](rg_texture_t id) { return m_resources[id].first; });
+
+    for (auto id : order) {
+        auto &resource = m_resources[id];
+        auto  format   = resource.desc.format;
+        if (format == SDL_GPU_TEXTUREFORMAT_INVALID) format = swap_format;
+        auto size = resource.desc.size == glm::ivec2{0, 0} ? window_size : resource.desc.size;
+        auto const samples = resource.desc.samples;
+
+        auto const fits = [&](texture_t const &t) {
+            return t.format == format && t.size == size && t.samples == samples &&
+                   t.usage == resource.usage;
+        };
+        auto const single = SDL_CalculateGPUTextureFormatSize(
+            format, static_cast<Uint32>(size.x), static_cast<Uint32>(size.y), 1
+        );
+        Uint64 const bytes = Uint64{single} << samples; // SDL_GPU_SAMPLECOUNT_N is log2(N)
+        m_stats.transients += 1;
+        m_stats.unaliased += bytes;
+
+        auto reuse = std::ranges::find_if(m_textures, [&](texture_t const &t) {
+            return fits(t) && t.busy_until < resource.first;
+        });
+        if (reuse == m_textures.end()) {
+            auto pooled = std::ranges::find_if(pool, fits);
+            if (pooled != pool.end()) {
+                m_textures.push_back(std::move(*pooled));
+                pool.erase(pooled);
+            } else {
+                SDL_GPUTextureCreateInfo info = {};
+                info.type                     = SDL_GPU_TEXTURETYPE_2D;
+                info.format                   = format;
+                info.usage                    = resource.usage;
+                info.width                    = static_cast<Uint32>(size.x);
+                info.height                   = static_cast<Uint32>(size.y);
+                info.layer_count_or_depth     = 1;
+                info.num_levels               = 1;
+                info.sample_count             = samples;
+                SDL_GPUTexture *tex = SDL_CreateGPUTexture(engine.gpu_device, &info);
+                if (!tex) return sdl_error("SDL_CreateGPUTexture (render graph) failed");
+                m_textures.push_back({gpu_texture_t{engine.gpu_device, tex, bytes}, format, size,
+                                      samples, resource.usage});
+            }
+            m_stats.aliased += bytes;
+            reuse = m_textures.end() - 1;
+        }
+        reuse->busy_until = resource.last;
+        resource.texture  = static_cast<size_t>(reuse - m_textures.begin());
+    }
+    m_stats.textures = m_textures.size();
+
+    // Load and store ops, now that the order of the kept passes is final.
+    std::vector<bool> written(m_resources.size(), false);
+    auto const later_needs = [&](rg_texture_t id, size_t after) {
+        if (!transient(id)) return true;
+        for (size_t j = after + 1; j < m_passes.size(); ++j) {
+            if (!live[j]) continue;
+            auto const &pass = m_passes[j];
+            if (std::ranges::find(pass.reads, id) != pass.reads.end()) return true;
+            if (std::ranges::find(pass.color, id) != pass.color.end()) return !pass.clear_color;
+            if (pass.depth == id) return !pass.clear_depth;
+        }
+        return false;
+    };
+    auto const attach = [&](rg_texture_t id, size_t pass, bool clear,
+                            rg_texture_t resolve = rg_none) {
+        attachment_t a{id, SDL_GPU_LOADOP_DONT_CARE, SDL_GPU_STOREOP_DONT_CARE, resolve};
+        if (clear) a.load = SDL_GPU_LOADOP_CLEAR;
+        else if (written[id] || m_resources[id].imported) a.load = SDL_GPU_LOADOP_LOAD;
+        bool const store = later_needs(id, pass);
+        if (resolve != rg_none)
+            a.store = store ? SDL_GPU_STOREOP_RESOLVE_AND_STORE : SDL_GPU_STOREOP_RESOLVE;
+        else if (store) a.store = SDL_GPU_STOREOP_STORE;
+        m_stats.dont_care_ops += (a.load == SDL_GPU_LOADOP_DONT_CARE) +
+                                 (a.store == SDL_GPU_STOREOP_DONT_CARE);
+        return a;
+    };
+
+    m_compiled.clear();
+    for (size_t i = 0; i < m_passes.size(); ++i) {
+        if (!live[i]) continue;
+        auto const     &pass = m_passes[i];
+        compiled_pass_t compiled{.pass = i};
+        for (size_t c = 0; c < pass.color.size(); ++c)
+            compiled.color.push_back(
+                attach(pass.color[c], i, pass.clear_color, resolve_of(pass, c))
+            );
+        if (pass.depth != rg_none) compiled.depth = attach(pass.depth, i, pass.clear_depth);
+        for (auto id : pass.color) written[id] = true;
+        for (auto id : pass.resolve)
+            if (id != rg_none) written[id] = true;
+        if (pass.depth != rg_none) written[pass.depth] = true;
+        m_compiled.push_back(std::move(compiled));
+    }
+    return {};
+}
+
+std::expected<void, std::string> render_graph_t::compile(engine_t const &engine) {
+    auto const size = window_pixel_size(engine);
+    if (!m_dirty && size == m_window_size) return {};
+    if (size.x <= 0 || size.y <= 0) return {}; // minimised: nothing is drawn until restored
+    if (auto r = allocate(engine); !r) return r;
+    m_window_size = size;
+    m_dirty       = false;
+    return {};
+}
+
+void render_graph_t::execute(SDL_GPUCommandBuffer *cmd, SDL_GPUTexture *swapchain) const {
+    auto const resolve = [&](rg_texture_t id) {
+        return id == rg_swapchain ? swapchain : texture(id);
+    };
+
+    for (auto const &compiled : m_compiled) {
+        auto const &pass = m_passes[compiled.pass];
+
+        // Aliased textures are never cycled: cycling would give each transient its own backing
+        // texture again, undoing the aliasing.
+        std::array<SDL_GPUColorTargetInfo, MAX_COLOR_TARGETS> color_infos = {};
+        Uint32                                                num_colors  = 0;
+        for (auto const &a : compiled.color) {
+            if (num_colors == MAX_COLOR_TARGETS) break;
+            auto &info       = color_infos[num_colors++];
+            info.texture     = resolve(a.id);
+            info.clear_color = clear_color;
+            info.load_op     = a.load;
+            info.store_op    = a.store;
+            if (a.resolve != rg_none) info.resolve_texture = resolve(a.resolve);
+        }
+
+        SDL_GPUDepthStencilTargetInfo  depth_info = {};
+        SDL_GPUDepthStencilTargetInfo *depth_ptr  = nullptr;
+        if (compiled.depth.id != rg_none) {
+            depth_info.texture          = resolve(compiled.depth.id);
+            depth_info.clear_depth      = 1.0f;
+            depth_info.load_op          = compiled.depth.load;
+            depth_info.store_op         = compiled.depth.store;
+            depth_info.clear_stencil    = 0;
+            depth_info.stencil_load_op  = compiled.depth.load;
+            depth_info.stencil_store_op = compiled.depth.store;
+            depth_ptr                   = &depth_info;
+        }
+
+        if (pass.prepare) pass.prepare(cmd);
+
+        SDL_GPURenderPass *render_pass =
+            SDL_BeginGPURenderPass(cmd, color_infos.data(), num_colors, depth_ptr);
+        if (pass.draw) pass.draw(cmd, render_pass);
+        SDL_EndGPURenderPass(render_pass);
+    }
+}
+
+std::string render_graph_t::report() const {
+    std::string out = "render graph:\n";
+    auto const  describe = [&](attachment_t const &a) {
+        std::string name = m_resources[a.id].desc.name;
+        if (transient(a.id)) name += std::format("#{}", m_resources[a.id].texture);
+        auto out = std::format(" {} ({}/{})", name, load_op_name(a.load), store_op_name(a.store));
+        if (a.resolve != rg_none) out += " -> " + m_resources[a.resolve].desc.name;
+        return out;
+    };
+
+    size_t next = 0;
+    for (size_t i = 0; i < m_passes.size(); ++i) {
+        out += std::format("  {}:", m_passes[i].name);
+        if (next == m_compiled.size() || m_compiled[next].pass != i) {
+            out += " culled\n";
+            continue;
+        }
+        auto const &compiled = m_compiled[next++];
+        for (auto const &a : compiled.color) out += describe(a);
+        if (compiled.depth.id != rg_none) out += describe(compiled.depth);
+        if (!m_passes[i].reads.empty()) out += " reads";
+        for (auto id : m_passes[i].reads) out += " " + m_resources[id].desc.name;
+        out += "\n";
+    }
+    out += std::format(
+        "  {} of {} passes culled; {} transients in {} textures, {:.1f} MiB unaliased, "
+        "{:.1f} MiB aliased; {} DONT_CARE load/store ops",
+        m_stats.culled, m_stats.passes, m_stats.transients, m_stats.textures,
+        mebibytes(m_stats.unaliased), mebibytes(m_stats.aliased), m_stats.dont_care_ops
+    );
+    return out;
+}
@@ -0,0 +1,142 @@
+#pragma once
+#include <cstdint>
+#include <expected>
+#include <string>
+#include <vector>
+
+#include "engine.hpp"
+
+// A frame described as passes that declare the textures they render to and the textures they
+// sample, instead of a fixed list of pass_desc_t over targets the scene allocates itself.
+// compile() derives from the declarations:
+//   culling   - a pass is kept only if what it writes reaches the swapchain, an imported texture
+//               or a pass marked keep; passes only the dropped ones needed go too.
+//   aliasing  - a transient texture lives from the first to the last pass using it. Transients
+//               whose lifetimes do not overlap share one GPU texture when format, size and usage
+//               match, and the textures themselves are pooled across compiles.
+//   load/store ops - an attachment is loaded only when an earlier pass wrote it and this pass
+//               does not clear it, and stored only when a later pass loads or samples it (always
+//               for the swapchain and imported textures). Everything else is DONT_CARE, which
+//               lets tiled GPUs skip the memory traffic.
+//   resolves  - a multisampled colour attachment can be resolved into a single-sampled texture
+//               (the swapchain, say) at the end of its pass; the multisampled samples are then
+//               only stored if a later pass loads them.
+//
+// Transients are window-sized unless given a size and follow window resizes: the graph
+// recompiles when the window size changes or set_size() changes a size. The GPU texture behind a
+// transient can change on every compile, so draw callbacks look it up with texture() each frame.
+
+using rg_texture_t = uint32_t;
+
+constexpr rg_texture_t rg_swapchain = 0; // the swapchain texture of the frame being recorded
+constexpr rg_texture_t rg_none      = UINT32_MAX;
+
+struct rg_texture_desc_t {
+    std::string          name;
+    SDL_GPUTextureFormat format  = SDL_GPU_TEXTUREFORMAT_INVALID; // INVALID: swapchain format
+    glm::ivec2           size    = {0, 0};                        // {0, 0}: window size
+    SDL_GPUSampleCount   samples = SDL_GPU_SAMPLECOUNT_1; // > 1: attachment only, not sampled
+};
+
+struct rg_pass_t {
+    std::string               name;
+    std::vector<rg_texture_t> color;         // colour attachments in slot order
+    rg_texture_t              depth = rg_none;
+    // resolve[i], when given and not rg_none, receives the resolved color[i] when the pass ends.
+    std::vector<rg_texture_t> resolve;
+    std::vector<rg_texture_t> reads;         // textures sampled by prepare or draw
+    bool                      clear_color = true; // else keep what earlier passes drew
+    bool                      clear_depth = true;
+    bool                      keep        = false; // has effects the graph cannot see
+    cmd_fn                    prepare;             // as pass_desc_t::prepare
+    draw_fn                   draw;
+};
+
+class render_graph_t {
+public:
+    rg_texture_t create_texture(rg_texture_desc_t desc);
+    // A texture owned elsewhere whose contents outlive the frame: never aliased, always stored,
+    // and loaded when a pass does not clear it.
+    rg_texture_t import_texture(std::string name, gpu_texture_t const *texture);
+    void         add_pass(rg_pass_t pass);
+    // Changes the size of a transient ({0, 0}: window size); the next compile() reallocates.
+    void set_size(rg_texture_t id, glm::ivec2 size);
+
+    // Culls, allocates and picks load/store ops, unless nothing has changed since the last
+    // compile. Needs the window (for its size and the swapchain format).
+    std::expected<void, std::string> compile(engine_t const &engine);
+    // Records the compiled passes. Call compile() first.
+    void execute(SDL_GPUCommandBuffer *cmd, SDL_GPUTexture *swapchain) const;
+
+    // The GPU texture behind id as of the last compile; null for culled transients.
+    SDL_GPUTexture *texture(rg_texture_t id) const;
+
+    SDL_FColor clear_color = {}; // for every cleared colour attachment
+
+    struct stats_t {
+        size_t passes        = 0;
+        size_t culled        = 0;
+        size_t transients    = 0; // used by the kept passes
+        size_t textures      = 0; // GPU textures behind them
+        Uint64 unaliased     = 0; // bytes with one texture per transient
+        Uint64 aliased       = 0; // bytes actually allocated
+        size_t dont_care_ops = 0; // loads and stores that are DONT_CARE
+    };
+    stats_t const &stats() const { return m_stats; }
+    // One line per pass with its attachments and ops, then the stats.
+    std::string report() const;
+
+private:
+    struct resource_t {
+        rg_texture_desc_t    desc;
+        gpu_texture_t const *imported = nullptr;
+        // Compiled:
+        int                      first   = -1; // first and last kept pass using it
+        int                      last    = -1;
+        bool                     sampled = false;
+        SDL_GPUTextureUsageFlags usage   = 0;
+        size_t                   texture = SIZE_MAX; // into m_textures
+    };
+    struct texture_t {
+        gpu_texture_t            texture;
+        SDL_GPUTextureFormat     format;
+        glm::ivec2               size;
+        SDL_GPUSampleCount       samples;
+        SDL_GPUTextureUsageFlags usage;
+        int                      busy_until = -1; // last pass of the transient holding it
+    };
+    struct attachment_t {
+        rg_texture_t   id;
+        SDL_GPULoadOp  load;
+        SDL_GPUStoreOp store;
+        rg_texture_t   resolve = rg_none;
+    };
+    struct compiled_pass_t {
+        size_t                    pass;
+        std::vector<attachment_t> color;
+        attachment_t              depth = {rg_none, SDL_GPU_LOADOP_DONT_CARE,
+                                           SDL_GPU_STOREOP_DONT_CARE};
+    };
+
+    std::vector<resource_t>      m_resources{{.desc = {.name = "swapchain"}}};
+    std::vector<rg_pass_t>       m_passes;
+    std::vector<texture_t>       m_textures;
+    std::vector<compiled_pass_t> m_compiled;
+    glm::ivec2                   m_window_size = {0, 0};
+    bool                         m_dirty       = true;
+    stats_t                      m_stats;
+
+    bool transient(rg_texture_t id) const {
+        return id != rg_swapchain && !m_resources[id].imported;
+    }
+    std::vector<bool>                cull() const;
+    std::expected<void, std::string> allocate(engine_t const &engine);
+};
+
+// Multi-pass event loop over a render graph: compiles it each frame after update (a no-op
+// unless the window was resized or update called set_size), sets graph.clear_color from
+// get_clear_color() and records it.
+std::expected<void, std::string> run_loop(
+    engine_t &engine, std::function<SDL_FColor()> get_clear_color, render_graph_t &graph,
+    std::function<bool(input_t const &)> update
+);
@@ -0,0 +1,325 @@
+#include "resource_tracking.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <format>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include <imgui.h>
+
+namespace {
+
+constexpr Uint32 WINDOW = 120; // frames the rates average over: two seconds at 60 fps
+
+// Live counts and totals of one type or call site, with the creations and releases of each of
+// the last WINDOW frames in a ring.
+struct tally_t {
+    gpu_resource_counts_t      counts;
+    Uint32                     frame_created = 0, frame_released = 0; // frame not yet ended
+    Uint64                     window_created = 0, window_released = 0;
+    std::array<Uint32, WINDOW> created{}, released{};
+
+    void create(Uint64 bytes) {
+        counts.live += 1;
+        counts.live_bytes += bytes;
+        counts.peak = std::max(counts.peak, counts.live);
+        counts.created += 1;
+        frame_created += 1;
+    }
+
+    void release(Uint64 bytes) {
+        counts.live -= 1;
+        counts.live_bytes -= bytes;
+        counts.released += 1;
+        frame_released += 1;
+    }
+
+    void end_frame(size_t slot) {
+        window_created  = window_created - created[slot] + frame_created;
+        window_released = window_released - released[slot] + frame_released;
+        created[slot]   = std::exchange(frame_created, 0);
+        released[slot]  = std::exchange(frame_released, 0);
+    }
+
+    gpu_resource_counts_t snapshot(Uint32 window) const {
+        gpu_resource_counts_t out = counts;
+        if (window > 0) {
+            out.created_per_frame  = static_cast<float>(window_created) / window;
+            out.released_per_frame = static_cast<float>(window_released) / window;
+        }
+        return out;
+    }
+};
+
+struct site_t {
+    gpu_resource_type_t type;
+    tally_t             tally;
+};
+
+struct record_t {
+    site_t *site;
+    Uint64  bytes;
+};
+
+struct registry_t {
+    std::mutex                                 mutex;
+    std::array<tally_t, GPU_RESOURCE_TYPES>    types;
+    std::unordered_map<std::string, site_t>    sites; // by name; nodes stay put, records point in
+    std::unordered_map<void const *, record_t> live;  // by handle
+    Uint64                                     frames = 0;
+};
+
+std::atomic<bool> tracking_enabled{false};
+
+thread_local std::string const *scope_label = nullptr;
+
+registry_t &registry() {
+    static registry_t instance;
+    return instance;
+}
+
+// GCC and Clang spell out the whole signature; keep the qualified name.
+std::string_view function_name(std::string_view signature) {
+    signature = signature.substr(0, signature.find('('));
+    if (auto const space = signature.rfind(' '); space != std::string_view::npos)
+        signature.remove_prefix(space + 1);
+    constexpr std::string_view anonymous = "{anonymous}::";
+    if (auto const at = signature.rfind(anonymous); at != std::string_view::npos)
+        signature.remove_prefix(at + anonymous.size());
+    return signature;
+}
+
+std::string site_name(std::source_location const &site) {
+    std::string_view file = site.file_name();
+    file.remove_prefix(file.rfind('/') + 1); // npos + 1 == 0
+    auto const where =
+        std::format("{} ({}:{})", function_name(site.function_name()), file, site.line());
+    return scope_label ? std::format("{}: {}", *scope_label, where) : where;
+}
+
+double to_mib(Uint64 bytes) { return static_cast<double>(bytes) / (1 << 20); }
+
+} // namespace
+
+char const *gpu_resource_type_name(gpu_resource_type_t type) {
+    switch (type) {
+    case gpu_resource_type_t::graphics_pipeline: return "graphics pipeline";
+    case gpu_resource_type_t::compute_pipeline: return "compute pipeline";
+    case gpu_resource_type_t::shader: return "shader";
+    case gpu_resource_type_t::buffer: return "buffer";
+    case gpu_resource_type_t::transfer_buffer: return "transfer buffer";
+    case gpu_resource_type_t::texture: return "texture";
+    case gpu_resource_type_t::sampler: return "sampler";
+    case gpu_resource_type_t::other: break;
+    }
+    return "other";
+}
+
+void enable_gpu_resource_tracking(bool enabled) {
+    tracking_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool gpu_resource_tracking() {
+    return tracking_enabled.load(std::memory_order_relaxed);
+}
+
+void track_gpu_resource(
+    gpu_resource_type_t type, void const *handle, Uint64 bytes, std::source_location const &site
+) {
+    if (!gpu_resource_tracking()) return;
+    auto name = site_name(site);
+
+    auto           &r = registry();
+    std::lock_guard lock(r.mutex);
+    auto &entry = r.sites.try_emplace(std::move(name), site_t{.type = type}).first->second;
+    entry.tally.create(bytes);
+    r.types[static_cast<size_t>(type)].create(bytes);
+    r.live.insert_or_assign(handle, record_t{.site = &entry, .bytes = bytes});
+}
+
+void untrack_gpu_resource(void const *handle) {
+    if (!gpu_resource_tracking()) return;
+
+    auto           &r = registry();
+    std::lock_guard lock(r.mutex);
+    auto const      it = r.live.find(handle);
+    if (it == r.live.end()) return; // created before tracking was enabled
+    auto const [site, bytes] = it->second;
+    site->tally.release(bytes);
+    r.types[static_cast<size_t>(site->type)].release(bytes);
+    r.live.erase(it);
+}
+
+Uint64 gpu_texture_bytes(SDL_GPUTextureCreateInfo const &info) {
+    bool const volume = info.type == SDL_GPU_TEXTURETYPE_3D;
+    Uint64     bytes  = 0;
+    for (Uint32 level = 0; level < std::max(info.num_levels, 1u); ++level) {
+        Uint32 const depth = volume ? std::max(info.layer_count_or_depth >> level, 1u)
+                                    : std::max(info.layer_count_or_depth, 1u);
+        bytes += SDL_CalculateGPUTextureFormatSize(
+            info.format, std::max(info.width >> level, 1u), std::max(info.height >> level, 1u),
+            depth
+        );
+    }
+    return bytes << info.sample_count; // SDL_GPU_SAMPLECOUNT_N is log2(N)
+}
+
+gpu_resource_scope_t::gpu_resource_scope_t(std::string label)
+    : m_label(std::move(label)), m_outer(std::exchange(scope_label, &m_label)) {}
+
+gpu_resource_scope_t::~gpu_resource_scope_t() {
+    scope_label = m_outer;
+}
+
+gpu_resource_stats_t gpu_resource_stats() {
+    auto           &r = registry();
+    std::lock_guard lock(r.mutex);
+
+    gpu_resource_stats_t stats{
+        .frames = r.frames,
+        .window = static_cast<Uint32>(std::min<Uint64>(r.frames, WINDOW)),
+    };
+    for (size_t i = 0; i < GPU_RESOURCE_TYPES; ++i)
+        stats.types[i] = r.types[i].snapshot(stats.window);
+    stats.sites.reserve(r.sites.size());
+    for (auto const &[name, site] : r.sites)
+        stats.sites.push_back({name, site.type, site.tally.snapshot(stats.window)});
+    std::ranges::sort(stats.sites, [](auto const &a, auto const &b) {
+        if (a.counts.created_per_frame != b.counts.created_per_frame)
+            return a.counts.created_per_frame > b.counts.created_per_frame;
+        if (a.counts.live_bytes != b.counts.live_bytes)
+            return a.counts.live_bytes > b.counts.live_bytes;
+        return a.counts.live > b.counts.live;
+    });
+    return stats;
+}
+
+void end_gpu_resource_frame() {
+    if (!gpu_resource_tracking()) return;
+
+    auto           &r = registry();
+    std::lock_guard lock(r.mutex);
+    size_t const    slot = r.frames % WINDOW;
+    for (auto &type : r.types) type.end_frame(slot);
+    for (auto &[name, site] : r.sites) site.tally.end_frame(slot);
+    r.frames += 1;
+}
+
+std::string gpu_resource_report(size_t max_sites) {
+    auto const  stats = gpu_resource_stats();
+    std::string out   = std::format(
+        "GPU resources after {} frames (per frame over the last {}):", stats.frames, stats.window
+    );
+    for (size_t i = 0; i < GPU_RESOURCE_TYPES; ++i) {
+        auto const &c = stats.types[i];
+        if (c.created == 0) continue;
+        out += std::format(
+            "\n  {:<18}{:>6} live {:>9.2f} MiB, peak {}, {} created, +{:.2f} -{:.2f} per frame",
+            gpu_resource_type_name(static_cast<gpu_resource_type_t>(i)), c.live,
+            to_mib(c.live_bytes), c.peak, c.created, c.created_per_frame, c.released_per_frame
+        );
+    }
+    size_t const shown = std::min(max_sites, stats.sites.size());
+    if (shown > 0) out += "\n  busiest call sites:";
+    for (auto const &site : std::span(stats.sites).first(shown)) {
+        out += std::format(
+            "\n    +{:.2f} per frame, {} live, {:.2f} MiB: {} {}", site.counts.created_per_frame,
+            site.counts.live, to_mib(site.counts.live_bytes), gpu_resource_type_name(site.type),
+            site.name
+        );
+    }
+    return out;
+}
+
+std::string gpu_resource_leaks() {
+    std::string out;
+    for (auto const &site : gpu_resource_stats().sites) {
+        if (site.counts.live == 0) continue;
+        out += std::format(
+            "{}  {} x{} ({:.2f} MiB): {}", out.empty() ? "" : "\n",
+            gpu_resource_type_name(site.type), site.counts.live, to_mib(site.counts.live_bytes),
+            site.name
+        );
+    }
+    return out;
+}
+
+void draw_gpu_resource_panel() {
+    if (!gpu_resource_tracking()) return;
+    auto const stats = gpu_resource_stats();
+
+    ImGui::SetNextWindowSize(ImVec2(640.f, 420.f), ImGuiCond_Once);
+    ImGui::Begin("GPU resources");
+    ImGui::Text(
+        "%llu frames; rates over the last %u", static_cast<unsigned long long>(stats.frames),
+        stats.window
+    );
+
+    // Creations that keep going once the scene is up are churn: shown in red.
+    auto const rate = [](float per_frame) {
+        if (per_frame > 0.0f) ImGui::TextColored(ImVec4(1.f, .4f, .4f, 1.f), "%.2f", per_frame);
+        else ImGui::TextUnformatted("0");
+    };
+
+    ImGuiTableFlags const flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg;
+    if (ImGui::BeginTable("types", 6, flags)) {
+        ImGui::TableSetupColumn("Type", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("Live");
+        ImGui::TableSetupColumn("Peak");
+        ImGui::TableSetupColumn("MiB");
+        ImGui::TableSetupColumn("Created/frame");
+        ImGui::TableSetupColumn("Released/frame");
+        ImGui::TableHeadersRow();
+        for (size_t i = 0; i < GPU_RESOURCE_TYPES; ++i) {
+            auto const &c = stats.types[i];
+            if (c.created == 0) continue;
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(gpu_resource_type_name(static_cast<gpu_resource_type_t>(i)));
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(c.live));
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(c.peak));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", to_mib(c.live_bytes));
+            ImGui::TableNextColumn();
+            rate(c.created_per_frame);
+            ImGui::TableNextColumn();
+            rate(c.released_per_frame);
+        }
+        ImGui::EndTable();
+    }
+
+    ImGui::SeparatorText("Call sites");
+    ImGuiTableFlags const site_flags = flags | ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY;
+    if (ImGui::BeginTable("sites", 5, site_flags)) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Site", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("Type");
+        ImGui::TableSetupColumn("Live");
+        ImGui::TableSetupColumn("MiB");
+        ImGui::TableSetupColumn("Created/frame");
+        ImGui::TableHeadersRow();
+        for (auto const &site : stats.sites) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(site.name.c_str());
+            if (ImGui::IsItemHovered()) ImGui::SetTooltip("%s", site.name.c_str());
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(gpu_resource_type_name(site.type));
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(site.counts.live));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", to_mib(site.counts.live_bytes));
+            ImGui::TableNextColumn();
+            rate(site.counts.created_per_frame);
+        }
+        ImGui::EndTable();
+    }
+
+    ImGui::End();
+}
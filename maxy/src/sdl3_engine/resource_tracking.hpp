@@ -0,0 +1,117 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <source_location>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+// Optional bookkeeping behind gpu_resource_t, to make leaks and per-frame allocation churn
+// visible. Off unless engine_config_t::track_resources (--track-resources) is set; then every
+// gpu_resource_t that takes ownership of a handle records
+//   type  - from its template argument,
+//   bytes - when its creator passes them, as SDL cannot be asked afterwards (gpu_texture_bytes),
+//   site  - the function, file and line that called the creating helper (create_gpu_buffer,
+//           load_texture, ... forward their caller's), prefixed with the label of the innermost
+//           gpu_resource_scope_t on the thread, so that resources from one call site can still
+//           be told apart by the asset they were loading,
+// and releasing it drops the record. The run loops end a frame after each submit, which turns
+// the counts into creations and releases per frame, log gpu_resource_report with the frame
+// report and show draw_gpu_resource_panel while ImGui is up. Whatever is still live when the
+// engine destroys its device has outlived it and is logged as leaked.
+
+enum class gpu_resource_type_t : Uint8 {
+    graphics_pipeline,
+    compute_pipeline,
+    shader,
+    buffer,
+    transfer_buffer,
+    texture,
+    sampler,
+    other,
+};
+inline constexpr size_t GPU_RESOURCE_TYPES = 8;
+
+char const *gpu_resource_type_name(gpu_resource_type_t type);
+
+template <typename T> constexpr gpu_resource_type_t gpu_resource_type() {
+    using enum gpu_resource_type_t;
+    if constexpr (std::is_same_v<T, SDL_GPUGraphicsPipeline>) return graphics_pipeline;
+    else if constexpr (std::is_same_v<T, SDL_GPUComputePipeline>) return compute_pipeline;
+    else if constexpr (std::is_same_v<T, SDL_GPUShader>) return shader;
+    else if constexpr (std::is_same_v<T, SDL_GPUBuffer>) return buffer;
+    else if constexpr (std::is_same_v<T, SDL_GPUTransferBuffer>) return transfer_buffer;
+    else if constexpr (std::is_same_v<T, SDL_GPUTexture>) return texture;
+    else if constexpr (std::is_same_v<T, SDL_GPUSampler>) return sampler;
+    else return other;
+}
+
+void enable_gpu_resource_tracking(bool enabled);
+bool gpu_resource_tracking();
+
+// Called by gpu_resource_t on taking and giving up a handle; no-ops while tracking is off.
+void track_gpu_resource(
+    gpu_resource_type_t type, void const *handle, Uint64 bytes, std::source_location const &site
+);
+void untrack_gpu_resource(void const *handle);
+
+// Bytes of the texture SDL_CreateGPUTexture makes from info: every mip level of every layer (or
+// depth slice; a cube has six faces), times the sample count.
+Uint64 gpu_texture_bytes(SDL_GPUTextureCreateInfo const &info);
+
+// Labels the resources created on this thread while it lives. Scopes nest; the innermost label
+// is the one recorded.
+class gpu_resource_scope_t {
+public:
+    explicit gpu_resource_scope_t(std::string label);
+    ~gpu_resource_scope_t();
+
+    gpu_resource_scope_t(gpu_resource_scope_t const &)            = delete;
+    gpu_resource_scope_t &operator=(gpu_resource_scope_t const &) = delete;
+
+private:
+    std::string        m_label;
+    std::string const *m_outer;
+};
+
+struct gpu_resource_counts_t {
+    Uint64 live       = 0;
+    Uint64 live_bytes = 0; // of the live resources whose creator passed a size
+    Uint64 peak       = 0; // most live at once
+    Uint64 created    = 0; // since tracking was enabled
+    Uint64 released   = 0;
+    // Averaged over the last gpu_resource_stats_t::window frames. Anything steadily above zero
+    // once a scene is loaded is churn: a resource remade every frame instead of kept.
+    float created_per_frame  = 0.0f;
+    float released_per_frame = 0.0f;
+};
+
+struct gpu_resource_site_t {
+    std::string           name; // "label: function (file:line)"
+    gpu_resource_type_t   type;
+    gpu_resource_counts_t counts;
+};
+
+struct gpu_resource_stats_t {
+    Uint64                                                frames = 0; // ended so far
+    Uint32                                                window = 0; // frames the rates cover
+    std::array<gpu_resource_counts_t, GPU_RESOURCE_TYPES> types{};
+    std::vector<gpu_resource_site_t> sites; // most created per frame first, then most live bytes
+};
+
+gpu_resource_stats_t gpu_resource_stats();
+
+// Ends a frame of the per-frame rates. The run loops call it after every submit.
+void end_gpu_resource_frame();
+
+// Live count, size and rates per type, then the max_sites busiest call sites.
+std::string gpu_resource_report(size_t max_sites = 8);
+
+// The call sites that still own live resources, one line each; empty when there are none.
+std::string gpu_resource_leaks();
+
+// An ImGui window with gpu_resource_stats(); draws nothing while tracking is off. Call between
+// ImGui::NewFrame and ImGui::Render.
+void draw_gpu_resource_panel();
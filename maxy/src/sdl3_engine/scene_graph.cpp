@@ -0,0 +1,58 @@
+#include "scene_graph.hpp"
+
+#include <algorithm>
+
+void scene_graph_t::mark(node_id_t node) {
+    m_dirty[node] = 1;
+    m_first_dirty = std::min<size_t>(m_first_dirty, node);
+}
+
+node_id_t scene_graph_t::add(node_id_t parent, glm::mat4 const &local) {
+    auto const node = static_cast<node_id_t>(size());
+    m_parent.push_back(parent);
+    m_local.push_back(local);
+    m_world.push_back(local);
+    m_dirty.push_back(0);
+    mark(node);
+    return node;
+}
+
+node_id_t scene_graph_t::attach(node_id_t parent, scene_graph_t const &subtree) {
+    auto const base = static_cast<node_id_t>(size());
+    for (size_t i = 0; i < subtree.size(); ++i) {
+        node_id_t const sub_parent = subtree.m_parent[i];
+        add(sub_parent == no_node ? parent : base + sub_parent, subtree.m_local[i]);
+    }
+    return base;
+}
+
+void scene_graph_t::clear() {
+    m_parent.clear();
+    m_local.clear();
+    m_world.clear();
+    m_dirty.clear();
+    m_first_dirty = SIZE_MAX;
+}
+
+void scene_graph_t::set_local(node_id_t node, glm::mat4 const &local) {
+    m_local[node] = local;
+    mark(node);
+}
+
+size_t scene_graph_t::update() {
+    size_t const count = size();
+    if (m_first_dirty >= count) return 0;
+
+    size_t updated = 0;
+    for (size_t i = m_first_dirty; i < count; ++i) {
+        node_id_t const parent = m_parent[i];
+        // Parents come first, so their flag is final by now (and clear when before m_first_dirty).
+        if (parent != no_node) m_dirty[i] |= m_dirty[parent];
+        if (!m_dirty[i]) continue;
+        m_world[i] = parent == no_node ? m_local[i] : m_world[parent] * m_local[i];
+        ++updated;
+    }
+    std::fill(m_dirty.begin() + static_cast<ptrdiff_t>(m_first_dirty), m_dirty.end(), 0);
+    m_first_dirty = SIZE_MAX;
+    return updated;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// Transform hierarchy kept as flat arrays in topological order: a node's parent always comes
+// before it, so one forward pass computes every world matrix from its parent's, with no
+// recursion and no per-node allocation. Like jobs.hpp it needs nothing from SDL (only glm), and
+// the GL samples link it as the SCENE_GRAPH target.
+//
+// set_local() flags a node; update() starts at the first flagged node, passes the flag down to
+// children as it goes, and recomputes only flagged nodes. Nodes before the first flagged one are
+// not even looked at, and the rest cost a flag test unless they actually moved.
+
+using node_id_t = uint32_t;
+
+constexpr node_id_t no_node = UINT32_MAX;
+
+class scene_graph_t {
+public:
+    // Appends a node under `parent` (no_node for a root) and returns its id. Ids are handed out
+    // in order and never change, which is what keeps the arrays topological.
+    node_id_t add(node_id_t parent, glm::mat4 const &local = glm::mat4(1.0f));
+    // Appends all of `subtree` under `parent`, keeping its shape: its node i becomes the returned
+    // id + i, and its roots become children of `parent`.
+    node_id_t attach(node_id_t parent, scene_graph_t const &subtree);
+    void      clear();
+
+    void             set_local(node_id_t node, glm::mat4 const &local);
+    glm::mat4 const &local(node_id_t node) const { return m_local[node]; }
+    // As of the last update().
+    glm::mat4 const &world(node_id_t node) const { return m_world[node]; }
+    node_id_t        parent(node_id_t node) const { return m_parent[node]; }
+    size_t           size() const { return m_parent.size(); }
+
+    // Recomputes the world matrices of the nodes changed since the last call and of everything
+    // below them; returns how many that was.
+    size_t update();
+
+private:
+    std::vector<node_id_t> m_parent;
+    std::vector<glm::mat4> m_local;
+    std::vector<glm::mat4> m_world;
+    std::vector<uint8_t>   m_dirty;
+    size_t                 m_first_dirty = SIZE_MAX;
+
+    void mark(node_id_t node);
+};
@@ -0,0 +1,7 @@
+#version 460 core
+
+// Depth pre-pass fragment stage: no outputs. The pipeline masks colour writes, so the pass
+// produces depth only and drivers can skip fragment work entirely.
+
+void main() {
+}
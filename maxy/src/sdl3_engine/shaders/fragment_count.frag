@@ -0,0 +1,11 @@
+#version 460 core
+
+// Overdraw measurement: every fragment that passes the depth test adds 1.0 to an R16_FLOAT
+// target through additive blending. Summing the target gives the fragment shader invocations
+// of the pass.
+
+layout(location = 0) out vec4 count;
+
+void main() {
+    count = vec4(1.0);
+}
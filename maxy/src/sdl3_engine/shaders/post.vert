@@ -0,0 +1,12 @@
+#version 460 core
+
+// Fullscreen triangle for the post-process passes. Positions come in clip space; texture
+// coordinates follow from them, with v = 0 at the top like the off-screen targets.
+
+layout(location = 0) in vec3 position;
+layout(location = 0) out vec2 frag_tex_coord;
+
+void main() {
+    frag_tex_coord = vec2(position.x, -position.y) * 0.5 + 0.5;
+    gl_Position    = vec4(position.xy, 0.0, 1.0);
+}
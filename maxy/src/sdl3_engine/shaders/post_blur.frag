@@ -0,0 +1,30 @@
+#version 460 core
+
+// One direction of a separable Gaussian. taps[0].y weighs the centre texel; every later tap
+// stands for a pair of neighbouring texels on each side, sampled with one bilinear fetch at the
+// offset (taps[i].x, in texels) that blends them in the right proportion.
+
+layout(location = 0) in vec2 frag_tex_coord;
+layout(location = 0) out vec4 out_color;
+
+layout(set = 2, binding = 0) uniform sampler2D source;
+
+// Matches blur_params_t in post.cpp (std140), shared with post_blur.comp.
+layout(set = 3, binding = 0) uniform BlurParams {
+    vec2 direction; // (1, 0) or (0, 1)
+    uint tap_count;
+    uint pad;
+    vec4 taps[33];
+};
+
+void main() {
+    vec2 texel_step = direction / vec2(textureSize(source, 0));
+
+    vec4 sum = texture(source, frag_tex_coord) * taps[0].y;
+    for (uint i = 1u; i < tap_count; ++i) {
+        vec2 offset = texel_step * taps[i].x;
+        sum += (texture(source, frag_tex_coord + offset) +
+                texture(source, frag_tex_coord - offset)) * taps[i].y;
+    }
+    out_color = sum;
+}
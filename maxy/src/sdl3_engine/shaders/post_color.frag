@@ -0,0 +1,21 @@
+#version 460 core
+
+// Per-pixel colour effects: 0 = invert, 1 = greyscale (Rec. 709 luma).
+
+layout(location = 0) in vec2 frag_tex_coord;
+layout(location = 0) out vec4 out_color;
+
+layout(set = 2, binding = 0) uniform sampler2D source;
+
+layout(set = 3, binding = 0) uniform ColorParams {
+    uint mode;
+};
+
+void main() {
+    vec4 color = texture(source, frag_tex_coord);
+    if (mode == 0u)
+        color.rgb = 1.0 - color.rgb;
+    else
+        color.rgb = vec3(dot(color.rgb, vec3(0.2126, 0.7152, 0.0722)));
+    out_color = color;
+}
@@ -0,0 +1,27 @@
+#version 460 core
+
+// Box filter down by `factor` (2 or 4) per side. One bilinear tap at the right spot averages
+// 2x2 source texels, so this takes (factor / 2)^2 taps rather than factor^2. Factor 1 is a
+// plain bilinear resample.
+
+layout(location = 0) in vec2 frag_tex_coord;
+layout(location = 0) out vec4 out_color;
+
+layout(set = 2, binding = 0) uniform sampler2D source;
+
+layout(set = 3, binding = 0) uniform DownsampleParams {
+    uint factor;
+};
+
+void main() {
+    vec2 texel = 1.0 / vec2(textureSize(source, 0));
+    int  taps  = max(int(factor) / 2, 1);
+
+    vec4 sum = vec4(0.0);
+    for (int y = 0; y < taps; ++y)
+        for (int x = 0; x < taps; ++x) {
+            vec2 offset = (2.0 * vec2(x, y) - float(taps - 1)) * texel;
+            sum += texture(source, frag_tex_coord + offset);
+        }
+    out_color = sum / float(taps * taps);
+}
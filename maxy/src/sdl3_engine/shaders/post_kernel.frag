@@ -0,0 +1,25 @@
+#version 460 core
+
+// 3x3 convolution (edge detection, sharpen, emboss...). Row 0 of the weights is applied one
+// texel up in v, as the old screen.frag kernels were.
+
+layout(location = 0) in vec2 frag_tex_coord;
+layout(location = 0) out vec4 out_color;
+
+layout(set = 2, binding = 0) uniform sampler2D source;
+
+layout(set = 3, binding = 0) uniform KernelParams {
+    vec4 rows[3]; // xyz = weights, left to right
+};
+
+void main() {
+    vec2 texel = 1.0 / vec2(textureSize(source, 0));
+
+    vec4 sum = vec4(0.0);
+    for (int y = 0; y < 3; ++y)
+        for (int x = 0; x < 3; ++x) {
+            vec2 offset = vec2(x - 1, 1 - y) * texel;
+            sum += texture(source, frag_tex_coord + offset) * rows[y][x];
+        }
+    out_color = sum;
+}
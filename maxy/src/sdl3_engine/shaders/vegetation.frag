@@ -0,0 +1,15 @@
+#version 460 core
+
+// Alpha-tested vegetation without multisampling: cut out, hard edges.
+layout(location = 0) in vec2 frag_tex_coord;
+layout(location = 1) flat in vec4 frag_tint;
+
+layout(set = 2, binding = 0) uniform sampler2D diffuse_tex;
+
+layout(location = 0) out vec4 frag_color;
+
+void main() {
+    vec4 color = texture(diffuse_tex, frag_tex_coord);
+    if (color.a < 0.5) discard;
+    frag_color = vec4(color.rgb * frag_tint.rgb, 1.0);
+}
@@ -0,0 +1,65 @@
+#version 460 core
+
+// Crossed-quad sprites of a vegetation_field_t, one instance per plant (see vegetation.hpp).
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec2 tex_coord;
+layout(location = 2) in vec4 instance_position_scale;
+layout(location = 3) in vec3 instance_yaw_rank_phase;
+layout(location = 4) in vec4 instance_tint;
+
+layout(set = 1, binding = 0) uniform View {
+    mat4 view; // rotation only: positions are made camera-relative here
+};
+layout(set = 1, binding = 1) uniform Projection {
+    mat4 projection;
+};
+// Matches vegetation_params_t in vegetation.cpp (std140).
+layout(set = 1, binding = 2) uniform Params {
+    vec4 camera;    // xyz: eye, w: time
+    vec4 distances; // full_distance, cull_distance, thinning (0 or 1)
+};
+
+layout(location = 0) out vec2 frag_tex_coord;
+layout(location = 1) flat out vec4 frag_tint;
+
+const float MAX_WIDEN = 2.5; // as in vegetation.cpp
+
+// vegetation_field_t::keep()
+float keep(float d) {
+    if (distances.z == 0.0 || d <= distances.x) return 1.0;
+    float ratio = distances.x / d;
+    return ratio * ratio * (1.0 - smoothstep(0.8 * distances.y, distances.y, d));
+}
+
+void main() {
+    vec3  origin = instance_position_scale.xyz;
+    float scale  = instance_position_scale.w;
+    float yaw    = instance_yaw_rank_phase.x;
+    float rank   = instance_yaw_rank_phase.y;
+    float phase  = instance_yaw_rank_phase.z;
+
+    // The CPU draws a prefix of each chunk by its nearest point; here each instance goes by its
+    // own distance. Those ranked just inside the kept share shrink to nothing before they go,
+    // and the survivors widen so the field covers the same ground with fewer sprites.
+    // Both factors are 1 at k = 1, so nothing changes where thinning starts.
+    float k      = keep(distance(origin.xz, camera.xz));
+    float fade   = clamp((k - rank) / max(0.2 * k, 1e-4), 0.0, 1.0); // 0 at the cut
+    float shrink = mix(1.0, fade, min((1.0 - k) * 10.0, 1.0));
+    float widen  = min(inversesqrt(max(k, 1e-4)), MAX_WIDEN);
+
+    float c     = cos(yaw), s = sin(yaw);
+    vec3  local = vec3(
+        c * position.x + s * position.z, position.y, c * position.z - s * position.x
+    );
+    local.xz *= widen;
+    local *= scale * shrink;
+
+    // Sway the tops, more the taller the sprite.
+    float height = position.y * position.y * scale;
+    local.x += 0.08 * height * sin(camera.w * 1.7 + phase);
+    local.z += 0.05 * height * sin(camera.w * 1.3 + phase * 1.3);
+
+    gl_Position    = projection * view * vec4(origin + local - camera.xyz, 1.0);
+    frag_tex_coord = tex_coord;
+    frag_tint      = instance_tint;
+}
@@ -0,0 +1,19 @@
+#version 460 core
+
+// Alpha-tested vegetation through alpha-to-coverage: alpha picks how many samples of the pixel
+// the fragment covers, so edges are antialiased by the MSAA resolve and nothing is discarded
+// (discard keeps early depth testing off). Alpha is sharpened to a one-pixel ramp around the
+// cutoff first: the raw texture alpha fades over several texels when magnified and would turn
+// the blades translucent.
+layout(location = 0) in vec2 frag_tex_coord;
+layout(location = 1) flat in vec4 frag_tint;
+
+layout(set = 2, binding = 0) uniform sampler2D diffuse_tex;
+
+layout(location = 0) out vec4 frag_color;
+
+void main() {
+    vec4  color = texture(diffuse_tex, frag_tex_coord);
+    float alpha = clamp((color.a - 0.5) / max(fwidth(color.a), 1e-4) + 0.5, 0.0, 1.0);
+    frag_color  = vec4(color.rgb * frag_tint.rgb, alpha);
+}
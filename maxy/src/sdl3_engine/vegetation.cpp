@@ -0,0 +1,296 @@
+#include "vegetation.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <utility>
+
+#include "hiz.hpp"
+
+namespace {
+
+// Two quads crossed at right angles, 1 m wide and 1 m tall, standing on the origin.
+constexpr std::array<pos_uv_vertex_t, 12> crossed_quad_vertices = {{
+    {{-0.5f, 0.0f, 0.0f}, {0.0f, 0.0f}},
+    {{0.5f, 0.0f, 0.0f}, {1.0f, 0.0f}},
+    {{0.5f, 1.0f, 0.0f}, {1.0f, 1.0f}},
+    {{-0.5f, 0.0f, 0.0f}, {0.0f, 0.0f}},
+    {{0.5f, 1.0f, 0.0f}, {1.0f, 1.0f}},
+    {{-0.5f, 1.0f, 0.0f}, {0.0f, 1.0f}},
+    {{0.0f, 0.0f, -0.5f}, {0.0f, 0.0f}},
+    {{0.0f, 0.0f, 0.5f}, {1.0f, 0.0f}},
+    {{0.0f, 1.0f, 0.5f}, {1.0f, 1.0f}},
+    {{0.0f, 0.0f, -0.5f}, {0.0f, 0.0f}},
+    {{0.0f, 1.0f, 0.5f}, {1.0f, 1.0f}},
+    {{0.0f, 1.0f, -0.5f}, {0.0f, 1.0f}},
+}};
+
+// The vertex shader widens thinned-out instances by up to this much; bounds allow for it.
+constexpr float MAX_WIDEN = 2.5f;
+
+// Matches the Params block of vegetation.vert.
+struct vegetation_params_t {
+    glm::vec4 camera;    // xyz: world-space eye, w: time in seconds
+    glm::vec4 distances; // full_distance, cull_distance, thinning (0 or 1), unused
+};
+
+float lattice(int x, int y, Uint32 seed) {
+    auto h = static_cast<Uint32>(x) * 374761393u + static_cast<Uint32>(y) * 668265263u +
+             seed * 2246822519u;
+    h = (h ^ (h >> 13)) * 1274126177u;
+    h ^= h >> 16;
+    return static_cast<float>(h & 0xFFFF) / 65535.0f;
+}
+
+float value_noise(glm::vec2 p, Uint32 seed) {
+    glm::vec2 const cell = glm::floor(p);
+    glm::vec2 const f    = p - cell;
+    glm::vec2 const t    = f * f * (3.0f - 2.0f * f);
+    int const       x = static_cast<int>(cell.x), y = static_cast<int>(cell.y);
+    float const     bottom = glm::mix(lattice(x, y, seed), lattice(x + 1, y, seed), t.x);
+    float const     top    = glm::mix(lattice(x, y + 1, seed), lattice(x + 1, y + 1, seed), t.x);
+    return glm::mix(bottom, top, t.y);
+}
+
+// Memory order R, G, B, A, as UBYTE4_NORM reads it.
+Uint32 pack_rgba(glm::vec3 const &color) {
+    auto const byte = [](float c) {
+        return static_cast<Uint32>(std::lround(std::clamp(c, 0.0f, 1.0f) * 255.0f));
+    };
+    return byte(color.r) | byte(color.g) << 8 | byte(color.b) << 16 | 0xFFu << 24;
+}
+
+bool outside(std::array<glm::vec4, 6> const &planes, vegetation_chunk_t const &chunk) {
+    for (auto const &plane : planes) {
+        // The corner furthest along the plane's inward normal.
+        glm::vec3 const corner{
+            plane.x > 0.0f ? chunk.max.x : chunk.min.x,
+            plane.y > 0.0f ? chunk.max.y : chunk.min.y,
+            plane.z > 0.0f ? chunk.max.z : chunk.min.z,
+        };
+        if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f) return true;
+    }
+    return false;
+}
+
+// Rejection-samples density.sample() over each chunk in turn, so the instances of a chunk are
+// contiguous and, being drawn uniformly at random, in random order already.
+std::vector<vegetation_instance_t> scatter(
+    density_map_t const &density, vegetation_config_t const &config,
+    std::vector<vegetation_chunk_t> &chunks
+) {
+    glm::vec2 const  extent = config.max - config.min;
+    glm::ivec2 const grid{
+        std::max(1, static_cast<int>(std::ceil(extent.x / config.chunk_size))),
+        std::max(1, static_cast<int>(std::ceil(extent.y / config.chunk_size))),
+    };
+
+    std::mt19937                          rng{config.seed};
+    std::uniform_real_distribution<float> unit{0.0f, 1.0f};
+    std::vector<vegetation_instance_t>    instances;
+
+    for (int cz = 0; cz < grid.y; ++cz) {
+        for (int cx = 0; cx < grid.x; ++cx) {
+            glm::vec2 const lo = config.min + glm::vec2(cx, cz) * config.chunk_size;
+            glm::vec2 const hi = glm::min(lo + config.chunk_size, config.max);
+            auto const      candidates =
+                static_cast<int>(std::lround(config.density * (hi.x - lo.x) * (hi.y - lo.y)));
+
+            vegetation_chunk_t chunk{
+                .min   = {hi.x, 0.0f, hi.y},
+                .max   = {lo.x, 0.0f, lo.y},
+                .first = static_cast<Uint32>(instances.size()),
+            };
+            for (int i = 0; i < candidates; ++i) {
+                glm::vec2 const p = glm::mix(lo, hi, glm::vec2(unit(rng), unit(rng)));
+                if (unit(rng) >= density.sample((p - config.min) / extent)) continue;
+
+                bool const  foliage = unit(rng) < config.foliage;
+                float const scale   = foliage ? 1.6f + unit(rng) : 0.5f + 0.6f * unit(rng);
+                float const shade   = 0.75f + 0.25f * unit(rng);
+                glm::vec3 const tint =
+                    foliage ? glm::vec3(0.45f, 0.6f, 0.35f) * shade
+                            : glm::vec3(0.85f + 0.15f * unit(rng), 1.0f, 0.8f) * shade;
+                instances.push_back({
+                    .position = {p.x, 0.0f, p.y},
+                    .scale    = scale,
+                    .yaw      = 6.2831853f * unit(rng),
+                    .rank     = 0.0f,
+                    .phase    = 6.2831853f * unit(rng),
+                    .tint     = pack_rgba(tint),
+                });
+
+                float const reach = 0.5f * scale * MAX_WIDEN;
+                chunk.min = glm::min(chunk.min, glm::vec3(p.x - reach, 0.0f, p.y - reach));
+                chunk.max = glm::max(chunk.max, glm::vec3(p.x + reach, scale, p.y + reach));
+            }
+            chunk.count = static_cast<Uint32>(instances.size()) - chunk.first;
+            if (chunk.count == 0) continue;
+            for (Uint32 i = 0; i < chunk.count; ++i)
+                instances[chunk.first + i].rank = static_cast<float>(i) / chunk.count;
+            chunks.push_back(chunk);
+        }
+    }
+    return instances;
+}
+
+} // namespace
+
+float density_map_t::sample(glm::vec2 uv) const {
+    if (texels.empty()) return 0.0f;
+    glm::vec2 const  p    = glm::clamp(uv, 0.0f, 1.0f) * glm::vec2(size) - 0.5f;
+    glm::ivec2 const last = size - 1;
+    glm::ivec2 const a    = glm::clamp(glm::ivec2(glm::floor(p)), glm::ivec2(0), last);
+    glm::ivec2 const b    = glm::min(a + 1, last);
+    glm::vec2 const  t    = glm::clamp(p - glm::vec2(a), 0.0f, 1.0f);
+    auto const       at   = [&](int x, int y) { return texels[y * size.x + x] / 255.0f; };
+    return glm::mix(
+        glm::mix(at(a.x, a.y), at(b.x, a.y), t.x), glm::mix(at(a.x, b.y), at(b.x, b.y), t.x), t.y
+    );
+}
+
+density_map_t noise_density_map(glm::ivec2 size, Uint32 seed) {
+    density_map_t map{.size = size, .texels = std::vector<Uint8>(size.x * size.y)};
+    for (int y = 0; y < size.y; ++y) {
+        for (int x = 0; x < size.x; ++x) {
+            glm::vec2 const p = glm::vec2(x, y) / glm::vec2(size) * 6.0f;
+            float           v = 0.0f, amplitude = 0.5f, total = 0.0f;
+            for (int octave = 0; octave < 4; ++octave) {
+                v += amplitude * value_noise(p * static_cast<float>(1 << octave), seed + octave);
+                total += amplitude;
+                amplitude *= 0.5f;
+            }
+            float const coverage = glm::smoothstep(0.35f, 0.65f, v / total);
+            map.texels[y * size.x + x] = static_cast<Uint8>(std::lround(coverage * 255.0f));
+        }
+    }
+    return map;
+}
+
+float vegetation_field_t::keep(float d) const {
+    if (!thinning || d <= config.full_distance) return 1.0f;
+    float const ratio = config.full_distance / d;
+    return ratio * ratio *
+           (1.0f - glm::smoothstep(0.8f * config.cull_distance, config.cull_distance, d));
+}
+
+void vegetation_field_t::cull(glm::mat4 const &view_proj, glm::vec3 const &camera) {
+    auto const planes = frustum_planes(view_proj);
+    m_draws.clear();
+    m_stats = {};
+    for (auto const &chunk : chunks) {
+        float const d = glm::length(glm::clamp(camera, chunk.min, chunk.max) - camera);
+        if (culling && (d > config.cull_distance || outside(planes, chunk))) continue;
+
+        // keep() only falls with distance, so every instance the vertex shader would keep at
+        // its own distance is within the share kept at the chunk's nearest point.
+        auto const count = std::min(
+            chunk.count, static_cast<Uint32>(std::ceil(static_cast<float>(chunk.count) * keep(d)))
+        );
+        if (count == 0) continue;
+        m_draws.push_back({chunk.first, count});
+        ++m_stats.chunks;
+        m_stats.instances += count;
+    }
+}
+
+void vegetation_field_t::draw(
+    SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass, glm::mat4 const &view,
+    glm::mat4 const &projection, glm::vec3 const &camera, float time
+) const {
+    if (m_draws.empty()) return;
+    SDL_BindGPUGraphicsPipeline(pass, pipeline.get());
+    push_vertex_uniform(cmd, 0, view);
+    push_vertex_uniform(cmd, 1, projection);
+    push_vertex_uniform(
+        cmd, 2,
+        vegetation_params_t{
+            .camera    = {camera, time},
+            .distances = {config.full_distance, config.cull_distance, thinning ? 1.0f : 0.0f,
+                          0.0f},
+        }
+    );
+
+    SDL_GPUBufferBinding const buffers[] = {
+        {geometry.vertex_buffer.get(), 0},
+        {instances.get(), 0},
+    };
+    SDL_BindGPUVertexBuffers(pass, 0, buffers, 2);
+    SDL_GPUTextureSamplerBinding const sampler{
+        material.textures[0].get(), material.samplers[0].get()
+    };
+    SDL_BindGPUFragmentSamplers(pass, 0, &sampler, 1);
+
+    for (auto const &[first, count] : m_draws)
+        SDL_DrawGPUPrimitives(pass, geometry.vertex_count, count, 0, first);
+}
+
+memory_usage_t vegetation_field_t::memory_usage() const {
+    memory_usage_t usage = ::memory_usage(geometry);
+    usage.gpu += Uint64{instance_count} * sizeof(vegetation_instance_t);
+    usage.cpu += chunks.size() * sizeof(vegetation_chunk_t) + m_draws.capacity() * sizeof(draw_t);
+    return usage;
+}
+
+std::expected<vegetation_field_t, std::string> create_vegetation_field(
+    engine_t const &engine, density_map_t const &density, vegetation_config_t const &config,
+    SDL_GPUTextureFormat format, SDL_GPUSampleCount samples
+) {
+    if (config.chunk_size <= 0.0f || glm::any(glm::lessThanEqual(config.max, config.min)))
+        return std::unexpected("create_vegetation_field: empty field or chunk size");
+
+    vegetation_field_t field;
+    field.config = config;
+    auto const instances = scatter(density, config, field.chunks);
+    if (instances.empty())
+        return std::unexpected("create_vegetation_field: the density map places nothing");
+    field.instance_count = static_cast<Uint32>(instances.size());
+
+    auto buffer = create_gpu_buffer(
+        engine, SDL_GPU_BUFFERUSAGE_VERTEX,
+        static_cast<Uint32>(instances.size() * sizeof(vegetation_instance_t)), instances.data()
+    );
+    if (!buffer) return std::unexpected(buffer.error());
+    field.instances = std::move(*buffer);
+
+    auto geometry = create_vertex_geometry(
+        engine, crossed_quad_vertices.data(), static_cast<Uint32>(sizeof(crossed_quad_vertices)),
+        static_cast<Uint32>(crossed_quad_vertices.size())
+    );
+    if (!geometry) return std::unexpected(geometry.error());
+    field.geometry = std::move(*geometry);
+
+    // CLAMP_TO_EDGE, as for the chapter 24 grass: REPEAT bleeds the opaque bottom edge into the
+    // transparent top.
+    auto material = create_material(
+        engine, {
+                    .texture_paths = {std::string(ASSETS_PATH) + "textures/grass.png"},
+                    .address_modes = {SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE},
+                }
+    );
+    if (!material) return std::unexpected(material.error());
+    field.material = std::move(*material);
+
+    field.alpha_to_coverage = ALPHA_TO_COVERAGE && samples != SDL_GPU_SAMPLECOUNT_1;
+    SDL_GPUTextureFormat const formats[] = {format};
+    auto pipeline = create_pipeline(
+        engine, {
+                    .vertex_shader   = "shaders/sdl3_engine/vegetation.vert.spv",
+                    .fragment_shader = field.alpha_to_coverage
+                                           ? "shaders/sdl3_engine/vegetation_coverage.frag.spv"
+                                           : "shaders/sdl3_engine/vegetation.frag.spv",
+                    .vertex_uniform_buffers = 3,
+                    .fragment_samplers      = 1,
+                    .vertex_buffer_descs    = vegetation_buffer_descs,
+                    .vertex_attributes      = vegetation_vertex_attributes,
+                    .enable_depth_test      = true,
+                    .color_target_formats   = formats,
+                    .sample_count           = samples,
+                    .alpha_to_coverage      = field.alpha_to_coverage,
+                }
+    );
+    if (!pipeline) return std::unexpected(pipeline.error());
+    field.pipeline = std::move(*pipeline);
+    return field;
+}
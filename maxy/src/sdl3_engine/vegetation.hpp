@@ -0,0 +1,149 @@
+#pragma once
+#include <cstddef>
+#include <expected>
+#include <string>
+#include <vector>
+
+#include "engine.hpp"
+
+// A field of grass and foliage sprites scattered from a density map, drawn as instanced crossed
+// quads. The instances are generated once, grouped by the square chunk of the field they fall
+// in, and uploaded as one instance buffer in chunk order; each frame the CPU only walks the
+// chunks:
+//   culling  - chunks whose bounds are outside the frustum or beyond cull_distance are skipped.
+//   thinning - past full_distance a chunk draws only the first keep(d) of its instances, d being
+//              its nearest point to the camera, with keep falling as (full_distance / d)^2 so
+//              the instances on screen stay roughly constant per pixel. Instances are in random
+//              order within a chunk, so any prefix is an even spread. The vertex shader applies
+//              keep per instance as well, shrinking the ones about to go instead of popping them,
+//              and widens the survivors so the thinned field covers as much ground.
+// Every visible chunk is one SDL_DrawGPUPrimitives call with first_instance at its first
+// instance; nothing is read back from the GPU.
+//
+// Alpha-tested edges use alpha-to-coverage when the pipeline is multisampled and SDL has it (see
+// ALPHA_TO_COVERAGE), and discard otherwise.
+
+// Coverage of the field, from 0 to 255 per texel; texel (0, 0) is the field's min corner.
+struct density_map_t {
+    glm::ivec2         size = {0, 0};
+    std::vector<Uint8> texels; // size.x * size.y, row by row
+
+    // Bilinear, with uv in [0, 1]^2 across the field; returns [0, 1].
+    float sample(glm::vec2 uv) const;
+};
+
+// Value noise over a few octaves, pushed towards 0 and 1 so the field has meadows and bare
+// patches rather than an even grey.
+density_map_t noise_density_map(glm::ivec2 size, Uint32 seed);
+
+struct vegetation_config_t {
+    glm::vec2 min           = {-80.0f, -80.0f}; // field extent on the XZ plane, at y = 0
+    glm::vec2 max           = {80.0f, 80.0f};
+    float     chunk_size    = 8.0f;
+    float     density       = 40.0f;  // instances per square metre where the map is 255
+    float     foliage       = 0.03f;  // share of instances that are larger, darker foliage
+    float     full_distance = 15.0f;  // every instance is drawn up to here
+    float     cull_distance = 120.0f; // and none beyond
+    Uint32    seed          = 1;
+};
+
+// Matches the per-instance inputs of vegetation.vert: 32 bytes.
+struct vegetation_instance_t {
+    glm::vec3 position;
+    float     scale;
+    float     yaw;
+    float     rank;  // position within the chunk over its count: thinning drops the highest
+    float     phase; // offsets the wind sway
+    Uint32    tint;  // RGBA8, multiplies the texture
+};
+static_assert(sizeof(vegetation_instance_t) == 32);
+
+// Slot 0: pos_uv_vertex_t of the crossed quads. Slot 1: vegetation_instance_t, with position and
+// scale at location 2, yaw, rank and phase at location 3 and the tint at location 4.
+inline constexpr SDL_GPUVertexBufferDescription vegetation_buffer_descs[] = {
+    {.slot       = 0,
+     .pitch      = sizeof(pos_uv_vertex_t),
+     .input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX},
+    {.slot       = 1,
+     .pitch      = sizeof(vegetation_instance_t),
+     .input_rate = SDL_GPU_VERTEXINPUTRATE_INSTANCE},
+};
+
+inline constexpr SDL_GPUVertexAttribute vegetation_vertex_attributes[] = {
+    {.location    = 0,
+     .buffer_slot = 0,
+     .format      = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
+     .offset      = static_cast<Uint32>(offsetof(pos_uv_vertex_t, position))},
+    {.location    = 1,
+     .buffer_slot = 0,
+     .format      = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT2,
+     .offset      = static_cast<Uint32>(offsetof(pos_uv_vertex_t, uv))},
+    {.location    = 2,
+     .buffer_slot = 1,
+     .format      = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
+     .offset      = static_cast<Uint32>(offsetof(vegetation_instance_t, position))},
+    {.location    = 3,
+     .buffer_slot = 1,
+     .format      = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
+     .offset      = static_cast<Uint32>(offsetof(vegetation_instance_t, yaw))},
+    {.location    = 4,
+     .buffer_slot = 1,
+     .format      = SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM,
+     .offset      = static_cast<Uint32>(offsetof(vegetation_instance_t, tint))},
+};
+
+struct vegetation_chunk_t {
+    glm::vec3 min, max; // bounds of the instances, sprites included
+    Uint32    first = 0, count = 0;
+};
+
+struct vegetation_field_t {
+    gpu_pipeline_t                  pipeline;
+    gpu_geometry_t                  geometry;  // crossed quads, base at y = 0
+    gpu_buffer_t                    instances; // vegetation_instance_t, in chunk order
+    gpu_material_t                  material;
+    std::vector<vegetation_chunk_t> chunks;
+    vegetation_config_t             config;
+    Uint32                          instance_count    = 0;
+    bool                            alpha_to_coverage = false; // else the pipeline discards
+
+    bool culling  = true;
+    bool thinning = true;
+
+    struct stats_t {
+        size_t chunks    = 0; // drawn
+        size_t instances = 0; // drawn
+    };
+
+    // Share of the instances kept at distance d from the camera: 1 up to full_distance, 0 past
+    // cull_distance. Always 1 with thinning off.
+    float keep(float d) const;
+
+    // Picks the chunks and instance counts to draw this frame. view_proj is the world-space
+    // view-projection (not the camera-relative one) and camera the world-space eye.
+    void cull(glm::mat4 const &view_proj, glm::vec3 const &camera);
+
+    // Draws what the last cull() picked. view is the rotation-only view matrix: positions are
+    // made camera-relative in the vertex shader, as translate(-camera) does for the samples.
+    void draw(
+        SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass, glm::mat4 const &view,
+        glm::mat4 const &projection, glm::vec3 const &camera, float time
+    ) const;
+
+    stats_t const &stats() const { return m_stats; }
+    memory_usage_t memory_usage() const;
+
+private:
+    struct draw_t {
+        Uint32 first, count;
+    };
+    std::vector<draw_t> m_draws;
+    stats_t             m_stats;
+};
+
+// Scatters the field and creates its pipeline for one colour target of the given format and
+// sample count, with a DEPTH_FORMAT depth attachment of the same sample count.
+std::expected<vegetation_field_t, std::string> create_vegetation_field(
+    engine_t const &engine, density_map_t const &density, vegetation_config_t const &config,
+    SDL_GPUTextureFormat format, SDL_GPUSampleCount samples = SDL_GPU_SAMPLECOUNT_1
+);
@@ -0,0 +1,63 @@
+#include "visualizers.hpp"
+
+#include <utility>
+
+namespace {
+
+glm::vec3 to_glm(vertex_t const &v) { return {v.x, v.y, v.z}; }
+
+std::vector<pos_normal_uv_vertex_t> exploded_vertices(model_mesh_t const &mesh) {
+    std::vector<pos_normal_uv_vertex_t> corners;
+    corners.reserve(mesh.indices.size());
+    for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+        auto const &a = mesh.vertices[mesh.indices[i]];
+        auto const &b = mesh.vertices[mesh.indices[i + 1]];
+        auto const &c = mesh.vertices[mesh.indices[i + 2]];
+        glm::vec3 const face = glm::cross(
+            to_glm(b.position) - to_glm(a.position), to_glm(c.position) - to_glm(a.position)
+        );
+        glm::vec3 const n = glm::dot(face, face) > 0.0f ? glm::normalize(face) : glm::vec3(0.0f);
+        for (auto corner : {a, b, c}) {
+            corner.normal = {n.x, n.y, n.z};
+            corners.push_back(corner);
+        }
+    }
+    return corners;
+}
+
+} // namespace
+
+void draw_normal_lines(
+    SDL_GPUCommandBuffer *cmd, gpu_model_t const &model, glm::mat4 const &transform,
+    Uint32 model_slot, SDL_GPURenderPass *pass
+) {
+    for (auto const &mesh : model.meshes) {
+        auto const vertices =
+            static_cast<Uint32>(mesh.geometry.vertex_bytes / sizeof(pos_normal_uv_vertex_t));
+        if (vertices == 0) continue;
+        push_vertex_uniform(cmd, model_slot, transform * model.nodes.world(mesh.node));
+        SDL_GPUBufferBinding binding{mesh.geometry.vertex_buffer.get(), 0};
+        SDL_BindGPUVertexBuffers(pass, 0, &binding, 1);
+        SDL_DrawGPUPrimitives(pass, 2, vertices, 0, 0);
+    }
+}
+
+std::expected<void, std::string> explode_model(engine_t const &engine, gpu_model_t &model) {
+    for (auto &mesh : model.meshes) {
+        if (mesh.geometry.index_count > 0 && mesh.indices.empty())
+            return std::unexpected("explode_model: load the model with retain_cpu_copy");
+        if (mesh.geometry.index_count == 0) continue; // exploded already
+
+        auto corners  = exploded_vertices(mesh);
+        auto geometry = create_vertex_geometry(
+            engine, corners.data(),
+            static_cast<Uint32>(corners.size() * sizeof(pos_normal_uv_vertex_t)),
+            static_cast<Uint32>(corners.size())
+        );
+        if (!geometry) return std::unexpected(geometry.error());
+        mesh.geometry = std::move(*geometry);
+        mesh.vertices = std::move(corners);
+        mesh.indices.clear();
+    }
+    return {};
+}
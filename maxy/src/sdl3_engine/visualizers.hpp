@@ -0,0 +1,44 @@
+#pragma once
+#include <expected>
+#include <string>
+
+#include "engine.hpp"
+#include "model.hpp"
+
+// Chapter 30's normal and explode visualisers without a geometry shader stage, which SDL_GPU
+// does not have. The per-primitive work is either in the vertex buffers already or done once at
+// load time, and the draws are ordinary (instanced) draws.
+
+// Normal lines read the mesh's own vertex buffer as an instance-rate buffer: one instance per
+// vertex, position at location 0 and normal at location 1. Each instance is a LINELIST of two
+// vertices, and the vertex shader moves gl_VertexIndex 1 along the normal.
+inline constexpr SDL_GPUVertexBufferDescription normal_line_buffer_descs[] = {{
+    .slot       = 0,
+    .pitch      = sizeof(pos_normal_uv_vertex_t),
+    .input_rate = SDL_GPU_VERTEXINPUTRATE_INSTANCE,
+}};
+
+inline constexpr SDL_GPUVertexAttribute normal_line_vertex_attributes[] = {
+    {.location    = 0,
+     .buffer_slot = 0,
+     .format      = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
+     .offset      = static_cast<Uint32>(offsetof(pos_normal_uv_vertex_t, position))},
+    {.location    = 1,
+     .buffer_slot = 0,
+     .format      = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
+     .offset      = static_cast<Uint32>(offsetof(pos_normal_uv_vertex_t, normal))},
+};
+
+// Draws the normal of every vertex of model with the bound LINELIST pipeline (made with the
+// descriptions above), pushing transform * each mesh's node matrix to vertex uniform slot
+// model_slot as draw_model does. Meshes made by explode_model show their face normals.
+void draw_normal_lines(
+    SDL_GPUCommandBuffer *cmd, gpu_model_t const &model, glm::mat4 const &transform,
+    Uint32 model_slot, SDL_GPURenderPass *pass
+);
+
+// Replaces the geometry of every mesh with an unindexed copy in which each triangle has its own
+// three vertices, whose normal is the face normal in the space of the mesh: a vertex shader can
+// then push whole triangles apart along it. Needs a model loaded with retain_cpu_copy; the CPU
+// copy is updated to match.
+std::expected<void, std::string> explode_model(engine_t const &engine, gpu_model_t &model);
@@ -1,4 +1,5 @@
 #include "engine.h"
+#include "gl_state.h"
 
 void AbstractEngine::handleFramebufferSizeCallback(GLFWwindow* window, int _width, int _height)
 {
@@ -118,6 +119,7 @@ void AbstractEngine::initWindow()
     {
         throw std::runtime_error("Failed to initialize GLAD");
     }
+    glState::install();
 }
 
 void AbstractEngine::updateProjection()
@@ -6,10 +6,12 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <iostream>
 #include <memory>
 
 #include "key_command.h"
 #include "camera.h"
+#include "program_cache.h"
 
 #define W_WITDH 1280.0f
 #define W_HEIGHT 720.0f
@@ -55,6 +57,8 @@ public:
 
         instance->basicInit();
         instance->sceneInit();
+        // sceneInit builds the scene's shaders
+        std::cout << programCache::report() << std::endl;
 
         return instance;
     }
@@ -0,0 +1,193 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+
+// Shadow copy of the bindings Mesh::draw and Shader::use touch on every draw (program, VAO,
+// active unit and the GL_TEXTURE_2D binding of each unit), used to skip calls that would not
+// change anything.
+//
+// glState::install() swaps glad's pointers for these calls, so the raw glBindTexture & co. in
+// the samples keep the shadow in sync. It runs from AbstractEngine::init; samples that load glad
+// themselves never call it and every call goes straight to the driver.
+namespace glState
+{
+
+const GLuint maxTrackedUnits = 32;
+const GLuint unknown = ~0u; // not bound through us yet: the next call is always issued
+
+struct CallCounts
+{
+    std::uint64_t issued = 0;
+    std::uint64_t skipped = 0;
+};
+
+struct Stats
+{
+    CallCounts program;
+    CallCounts vertexArray;
+    CallCounts activeTexture;
+    CallCounts texture;
+};
+
+struct Shadow
+{
+    GLuint program = unknown;
+    GLuint vertexArray = unknown;
+    GLuint activeUnit = unknown;
+    std::array<GLuint, maxTrackedUnits> texture2D;
+
+    Shadow() { texture2D.fill(unknown); }
+};
+
+struct Driver
+{
+    PFNGLUSEPROGRAMPROC useProgram;
+    PFNGLBINDVERTEXARRAYPROC bindVertexArray;
+    PFNGLACTIVETEXTUREPROC activeTexture;
+    PFNGLBINDTEXTUREPROC bindTexture;
+    PFNGLDELETEVERTEXARRAYSPROC deleteVertexArrays;
+    PFNGLDELETETEXTURESPROC deleteTextures;
+};
+
+inline Shadow shadow;
+inline Driver driver;
+inline Stats stats;
+inline bool installed = false;
+inline bool enabled = true;
+
+// Issues the call unless the shadow already holds value, then records value.
+template <typename Issue>
+inline void apply(GLuint &cached, GLuint value, CallCounts &counts, Issue issue)
+{
+    if (enabled && cached == value)
+    {
+        counts.skipped++;
+        return;
+    }
+    issue();
+    counts.issued++;
+    cached = enabled ? value : unknown;
+}
+
+inline void useProgram(GLuint program)
+{
+    if (!installed)
+        return glUseProgram(program);
+    apply(shadow.program, program, stats.program, [&] { driver.useProgram(program); });
+}
+
+inline void bindVertexArray(GLuint vao)
+{
+    if (!installed)
+        return glBindVertexArray(vao);
+    apply(shadow.vertexArray, vao, stats.vertexArray, [&] { driver.bindVertexArray(vao); });
+}
+
+// unit is an index, not GL_TEXTUREi
+inline void activeTexture(GLuint unit)
+{
+    if (!installed)
+        return glActiveTexture(GL_TEXTURE0 + unit);
+    apply(shadow.activeUnit, unit, stats.activeTexture, [&] { driver.activeTexture(GL_TEXTURE0 + unit); });
+}
+
+inline void bindTexture(GLenum target, GLuint texture)
+{
+    if (!installed)
+        return glBindTexture(target, texture);
+    if (target != GL_TEXTURE_2D || shadow.activeUnit >= maxTrackedUnits)
+    {
+        driver.bindTexture(target, texture);
+        stats.texture.issued++;
+        return;
+    }
+    apply(shadow.texture2D[shadow.activeUnit], texture, stats.texture,
+          [&] { driver.bindTexture(target, texture); });
+}
+
+// Skips the unit switch as well when the texture is already bound there.
+inline void bindTexture(GLuint unit, GLenum target, GLuint texture)
+{
+    if (installed && enabled && target == GL_TEXTURE_2D && unit < maxTrackedUnits &&
+        shadow.texture2D[unit] == texture)
+    {
+        stats.texture.skipped++;
+        return;
+    }
+    activeTexture(unit);
+    bindTexture(target, texture);
+}
+
+inline void APIENTRY useProgramHook(GLuint program) { useProgram(program); }
+inline void APIENTRY bindVertexArrayHook(GLuint vao) { bindVertexArray(vao); }
+inline void APIENTRY activeTextureHook(GLenum texture) { activeTexture(texture - GL_TEXTURE0); }
+inline void APIENTRY bindTextureHook(GLenum target, GLuint texture) { bindTexture(target, texture); }
+
+inline void APIENTRY deleteVertexArraysHook(GLsizei n, const GLuint *arrays)
+{
+    driver.deleteVertexArrays(n, arrays);
+    for (GLsizei i = 0; i < n; i++)
+        if (shadow.vertexArray == arrays[i])
+            shadow.vertexArray = 0;
+}
+
+inline void APIENTRY deleteTexturesHook(GLsizei n, const GLuint *textures)
+{
+    driver.deleteTextures(n, textures);
+    for (GLsizei i = 0; i < n; i++)
+        for (GLuint &bound : shadow.texture2D)
+            if (bound == textures[i])
+                bound = 0;
+}
+
+// Call once right after gladLoadGLLoader.
+inline void install()
+{
+    if (installed)
+        return;
+    driver.useProgram = glad_glUseProgram;
+    driver.bindVertexArray = glad_glBindVertexArray;
+    driver.activeTexture = glad_glActiveTexture;
+    driver.bindTexture = glad_glBindTexture;
+    driver.deleteVertexArrays = glad_glDeleteVertexArrays;
+    driver.deleteTextures = glad_glDeleteTextures;
+
+    glad_glUseProgram = useProgramHook;
+    glad_glBindVertexArray = bindVertexArrayHook;
+    glad_glActiveTexture = activeTextureHook;
+    glad_glBindTexture = bindTextureHook;
+    glad_glDeleteVertexArrays = deleteVertexArraysHook;
+    glad_glDeleteTextures = deleteTexturesHook;
+
+    shadow = Shadow();
+    installed = true;
+}
+
+// Disabled: every call is issued, for before/after comparisons.
+inline void setEnabled(bool on)
+{
+    enabled = on;
+    shadow = Shadow();
+}
+
+inline CallCounts totals()
+{
+    CallCounts sum;
+    for (const CallCounts *counts : {&stats.program, &stats.vertexArray, &stats.activeTexture, &stats.texture})
+    {
+        sum.issued += counts->issued;
+        sum.skipped += counts->skipped;
+    }
+    return sum;
+}
+
+inline void resetStats() { stats = Stats(); }
+
+}
+
+#endif
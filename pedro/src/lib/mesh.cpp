@@ -1,4 +1,5 @@
 #include "mesh.h"
+#include "gl_state.h"
 
 Mesh::Mesh(MeshVertices vertices, MeshIndices indices, MeshTextures textures) :
     vertices(vertices),
@@ -36,6 +37,19 @@ void Mesh::setupMesh()
     glBindVertexArray(0);
 
     nextArrayIndex = 3;
+
+    // retrieve texture number (the N in diffuse_textureN) once instead of on every draw
+    uint diffuseNr = 1;
+    uint specularNr = 1;
+    for (const Texture &texture : textures)
+    {
+        std::string number;
+        if (texture.type == "texture_diffuse")
+            number = std::to_string(diffuseNr++);
+        else if (texture.type == "texture_specular")
+            number = std::to_string(specularNr++);
+        samplerNames.push_back("material." + texture.type + number);
+    }
 }
 
 void Mesh::addInstancing(std::vector<glm::mat4> vertices) {
@@ -67,33 +81,23 @@ void Mesh::addInstancing(std::vector<glm::mat4> vertices) {
 
 void Mesh::draw(Shader &shader, uint instances)
 {
-    uint diffuseNr = 1;
-    uint specularNr = 1;
-
     for(size_t i = 0; i < textures.size(); i++)
     {
-        glActiveTexture(GL_TEXTURE0 + i); // activate proper texture unit before binding
-        // retrieve texture number (the N in diffuse_textureN)
-        std::string number;
-        std::string name = textures[i].type;
-        if(name == "texture_diffuse")
-            number = std::to_string(diffuseNr++);
-        else if(name == "texture_specular")
-            number = std::to_string(specularNr++);
-
-        shader.setInt(("material." + name + number).c_str(), i);
-        glBindTexture(GL_TEXTURE_2D, textures[i].id);
+        shader.setSampler(samplerNames[i], i);
+        glState::bindTexture(i, GL_TEXTURE_2D, textures[i].id);
     }
-    glActiveTexture(GL_TEXTURE0);
+    glState::activeTexture(0);
 
     // draw mesh
-    glBindVertexArray(VAO);
+    glState::bindVertexArray(VAO);
 
     if (instances > 1) {
         glDrawElementsInstanced(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0, instances);
     } else {
         glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
     }
-    
-    glBindVertexArray(0);
+
+    // Unbind like setup does: a VAO left bound would pick up the element buffer of whatever the
+    // caller binds next.
+    glState::bindVertexArray(0);
 }
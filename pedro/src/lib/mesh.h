@@ -46,6 +46,7 @@ private:
 
     uint nextArrayIndex;
     uint VAO, VBO, EBO;
+    std::vector<std::string> samplerNames; // "material.texture_diffuseN" for each texture
     void setupMesh();
 
 };
@@ -0,0 +1,170 @@
+#ifndef PROGRAM_CACHE_H
+#define PROGRAM_CACHE_H
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+// Header-only so the Makefile build needs no new object. Shader::buildProgram asks load() for
+// each program before compiling and hands freshly linked ones to store(). Stages are keyed after
+// #include expansion, so editing an included file is a miss like editing the shader itself.
+// Without GL 4.1 load() always misses and store() is a no-op.
+namespace programCache
+{
+
+struct Stats
+{
+    unsigned hits = 0;     // programs loaded from a binary
+    unsigned misses = 0;   // programs compiled and linked from source
+    unsigned rejected = 0; // binaries the driver refused (also counted as misses)
+    double seconds = 0.0;  // time spent building programs, cached or not
+};
+
+struct FileHeader
+{
+    std::uint32_t magic;
+    std::uint32_t format;
+    std::uint64_t key;
+    std::uint64_t length;
+};
+
+const std::uint32_t fileMagic = 0x4250474c; // "LGPB"
+
+inline std::filesystem::path directory = "shader_cache";
+inline bool enabled = true;
+inline Stats stats;
+
+inline bool available()
+{
+    if (!enabled || !GLAD_GL_VERSION_4_1)
+        return false;
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+// FNV-1a over each string, with a separator so ("ab", "c") and ("a", "bc") differ.
+inline void hashString(std::uint64_t &hash, const std::string &bytes)
+{
+    for (unsigned char c : bytes)
+    {
+        hash ^= c;
+        hash *= 0x100000001b3ull;
+    }
+    hash ^= 0xff;
+    hash *= 0x100000001b3ull;
+}
+
+inline std::string glString(GLenum name)
+{
+    const GLubyte *value = glGetString(name);
+    return value ? reinterpret_cast<const char *>(value) : "";
+}
+
+// stages: (GL shader type, preprocessed source)
+inline std::uint64_t key(const std::vector<std::pair<GLenum, std::string>> &stages)
+{
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+    hashString(hash, glString(GL_VENDOR));
+    hashString(hash, glString(GL_RENDERER));
+    hashString(hash, glString(GL_VERSION));
+    for (const auto &stage : stages)
+    {
+        hashString(hash, std::to_string(stage.first));
+        hashString(hash, stage.second);
+    }
+    return hash;
+}
+
+inline std::filesystem::path entryPath(std::uint64_t key)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return directory / name;
+}
+
+// Returns the program, or 0 when it has to be built from source.
+inline GLuint load(std::uint64_t key)
+{
+    stats.misses++;
+    if (!available())
+        return 0;
+
+    std::ifstream file(entryPath(key), std::ios::binary);
+    FileHeader header{};
+    if (!file || !file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        header.magic != fileMagic || header.key != key)
+        return 0;
+    std::vector<char> binary(header.length);
+    if (!file.read(binary.data(), binary.size()))
+        return 0;
+
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, header.format, binary.data(), (GLsizei)binary.size());
+    GLint success = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        glDeleteProgram(program);
+        file.close();
+        std::error_code ignored;
+        std::filesystem::remove(entryPath(key), ignored);
+        stats.rejected++;
+        return 0;
+    }
+    stats.misses--;
+    stats.hits++;
+    return program;
+}
+
+// Call before glLinkProgram on programs that will be stored.
+inline void prepare(GLuint program)
+{
+    if (available())
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+inline void store(std::uint64_t key, GLuint program)
+{
+    if (!available())
+        return;
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &length, &format, binary.data());
+
+    // Best effort: an unwritable directory just means compiling again next run
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error)
+        return;
+    std::ofstream file(entryPath(key), std::ios::binary | std::ios::trunc);
+    FileHeader header{fileMagic, format, key, (std::uint64_t)length};
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(binary.data(), length);
+}
+
+inline std::string report()
+{
+    char line[160];
+    std::snprintf(line, sizeof(line),
+                  "Shader setup: %u programs (%u from the binary cache, %u rejected) in %.1f ms",
+                  stats.hits + stats.misses, stats.hits, stats.rejected, stats.seconds * 1000.0);
+    return line;
+}
+
+inline void resetStats() { stats = Stats(); }
+
+}
+
+#endif
@@ -1,72 +1,76 @@
 #include "shader.h"
+#include "gl_state.h"
+#include "program_cache.h"
+
+#include <chrono>
+#include <cstdint>
 
 Shader::Shader(const std::string vertexPath, const std::string fragmentPath) 
 {
-    GLuint vertex   = compileShader(vertexPath, GL_VERTEX_SHADER),
-           fragment = compileShader(fragmentPath, GL_FRAGMENT_SHADER);        
-
-    // Shader Program
-    this->program = glCreateProgram();
-    glAttachShader(this->program, vertex);
-    glAttachShader(this->program, fragment);
-    glLinkProgram(this->program);
-    
-    GLint success;
-    GLchar infoLog[512];
-    // Print linking errors if any
-    glGetProgramiv(this->program, GL_LINK_STATUS, &success);
-    if(!success)
-    {
-        glGetProgramInfoLog(this->program, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-    }
-
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
+    this->program = buildProgram({{vertexPath, GL_VERTEX_SHADER}, {fragmentPath, GL_FRAGMENT_SHADER}});
 }
 
 Shader::Shader(const std::string vertexPath, const std::string fragmentPath, const std::string geometryPath)
 {
-    GLuint vertex   = compileShader(vertexPath, GL_VERTEX_SHADER),
-           fragment = compileShader(fragmentPath, GL_FRAGMENT_SHADER),
-           geometry = compileShader(geometryPath, GL_GEOMETRY_SHADER);     
+    this->program = buildProgram({{vertexPath, GL_VERTEX_SHADER},
+                                  {fragmentPath, GL_FRAGMENT_SHADER},
+                                  {geometryPath, GL_GEOMETRY_SHADER}});
+}
 
-    // Shader Program
-    this->program = glCreateProgram();
-    glAttachShader(this->program, vertex);
-    glAttachShader(this->program, fragment);
-    glAttachShader(this->program, geometry);
-    glLinkProgram(this->program);
+GLuint Shader::buildProgram(const std::vector<std::pair<std::string, GLenum>> &stages)
+{
+    auto start = std::chrono::steady_clock::now();
 
-    GLint success;
-    GLchar infoLog[512];
-    // Print linking errors if any
-    glGetProgramiv(this->program, GL_LINK_STATUS, &success);
-    if(!success)
+    std::vector<std::pair<GLenum, std::string>> sources;
+    for (const auto &stage : stages)
+        sources.emplace_back(stage.second, loadShaderSource(stage.first));
+
+    std::uint64_t key = programCache::key(sources);
+    GLuint program = programCache::load(key);
+    if (!program)
     {
-        glGetProgramInfoLog(this->program, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+        std::vector<GLuint> shaders;
+        for (size_t i = 0; i < stages.size(); i++)
+            shaders.push_back(compileShader(stages[i].first, sources[i].second, stages[i].second));
+
+        // Shader Program
+        program = glCreateProgram();
+        programCache::prepare(program);
+        for (GLuint shader : shaders)
+            glAttachShader(program, shader);
+        glLinkProgram(program);
+
+        GLint success;
+        GLchar infoLog[512];
+        // Print linking errors if any
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if(!success)
+        {
+            glGetProgramInfoLog(program, 512, NULL, infoLog);
+            std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+        }
+        else
+            programCache::store(key, program);
+
+        for (GLuint shader : shaders)
+            glDeleteShader(shader);
     }
 
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
-    glDeleteShader(geometry);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    programCache::stats.seconds += elapsed.count();
+    return program;
 }
 
 
-GLuint Shader::compileShader(const std::string shaderPath, uint shaderType) 
+GLuint Shader::compileShader(const std::string &shaderPath, const std::string &source, GLenum shaderType) 
 {    
-    // 1. Retrieve the vertex/fragment source code from filePath
-    std::string shaderCodeString = loadShaderSource(shaderPath);
-
-    const GLchar* shaderCode = shaderCodeString.c_str();
+    const GLchar* shaderCode = source.c_str();
 
-    // 2. Compile shaders
+    // Compile shader
     GLuint shader;
     GLint success;
     GLchar infoLog[512];
 
-    // Vertex Shader
     shader = glCreateShader(shaderType);
     glShaderSource(shader, 1, &shaderCode, NULL);
     glCompileShader(shader);
@@ -84,7 +88,7 @@ GLuint Shader::compileShader(const std::string shaderPath, uint shaderType)
 
 
 void Shader::use() {
-    glUseProgram(this->program);
+    glState::useProgram(this->program);
 }
 
 void Shader::setBool(const std::string uniformName, const bool value) {
@@ -93,6 +97,19 @@ void Shader::setBool(const std::string uniformName, const bool value) {
 
 void Shader::setInt(const std::string uniformName, const int value) {
     glUniform1i(glGetUniformLocation(this->program, uniformName.c_str()), value);
+    auto it = samplerUnits.find(uniformName);
+    if (it != samplerUnits.end())
+        it->second = value;
+}
+
+void Shader::setSampler(const std::string &uniformName, const int unit) {
+    if (glState::enabled) {
+        auto [it, inserted] = samplerUnits.try_emplace(uniformName, unit);
+        if (!inserted && it->second == unit)
+            return;
+        it->second = unit;
+    }
+    glUniform1i(glGetUniformLocation(this->program, uniformName.c_str()), unit);
 }
 
 void Shader::setFloat(const std::string uniformName, const float value) {
@@ -121,8 +138,15 @@ void Shader::setVertexMatrices(glm::mat4 &view, glm::mat4 &model, glm::mat4 &pro
     setMat4("projection", projection);
 }
 
+// Expanded sources by path. Shaders sharing a stage or an include only read and expand it once.
+static std::unordered_map<std::string, std::string> expandedSources;
+
 // Include preprocessor (does not prevent multiple includes, nor include loops, nor multiple #version so careful!)
 std::string loadShaderSource(const std::string& shaderPath) {
+    auto cached = expandedSources.find(shaderPath);
+    if (cached != expandedSources.end())
+        return cached->second;
+
     std::ifstream shaderFile(shaderPath);
 
     std::stringstream buffer;
@@ -150,5 +174,5 @@ std::string loadShaderSource(const std::string& shaderPath) {
         buffer << line << "\n";
     }
 
-    return buffer.str();
+    return expandedSources[shaderPath] = buffer.str();
 }
\ No newline at end of file
@@ -4,6 +4,9 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include <glad/glad.h> 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -23,6 +26,7 @@ public:
     Shader(const std::string vertexPath, const std::string fragmentPath, const std::string geometryPath);
     Shader& operator=(const Shader& other) {
         program = other.program;
+        samplerUnits = other.samplerUnits;
         return *this;
     }
 
@@ -35,13 +39,20 @@ public:
     void setVec4(const std::string uniformName, const glm::vec4 &value);
     void setMat3(const std::string uniformName, const glm::mat3 &value);
     void setMat4(const std::string uniformName, const glm::mat4 &value);
+    // setInt for sampler uniforms, only uploaded when the unit changes
+    void setSampler(const std::string &uniformName, const int unit);
 
     void setVertexMatrices(glm::mat4 &view, glm::mat4 &model, glm::mat4 &projection);
 
 private:
-    GLuint compileShader(std::string shaderPath, uint shaderType);
+    std::unordered_map<std::string, int> samplerUnits;
+
+    // Links the (path, type) stages, going through programCache first
+    GLuint buildProgram(const std::vector<std::pair<std::string, GLenum>> &stages);
+    GLuint compileShader(const std::string &shaderPath, const std::string &source, GLenum shaderType);
 };
 
+// Source with its #includes expanded; each file is read and expanded once per process.
 std::string loadShaderSource(const std::string& filepath);
 
 #endif
\ No newline at end of file